@@ -0,0 +1,137 @@
+#include "BurnEstimator.h"
+#include "Utils.h"
+#include <algorithm>
+
+/**
+ * @brief Constructs an estimator with the given energy costs.
+ * @param settings The energy cost and timing of the exercises.
+ */
+BurnEstimator::BurnEstimator(Settings settings) : settings(settings)
+{
+}
+
+/**
+ * @brief Sets the exercises the plan entries refer to.
+ *
+ * The MET of every exercise is resolved once, into a table indexed by ExerciseId.
+ *
+ * @param exerciseMap The exercises by name.
+ */
+void BurnEstimator::setExercises(const std::map<std::string, Exercise>& exerciseMap)
+{
+    netMetById.clear();
+    for (const auto& pair : exerciseMap)
+    {
+        ExerciseId id = ExerciseIdTable::intern(pair.first);
+        if (id >= netMetById.size())
+        {
+            netMetById.resize(id + 1, -1.0f);
+        }
+        netMetById[id] = settings.met[static_cast<size_t>(pair.second.type)] - 1.0f;
+    }
+}
+
+/**
+ * @brief Computes the MET-hours above rest of a plan on each day.
+ * @param plan The workout plan.
+ * @return The MET-hours of every day.
+ */
+BurnEstimator::DailyValues BurnEstimator::metHours(const WorkoutPlan& plan) const
+{
+    const float unknownMet = settings.met[TYPE_COUNT - 1] - 1.0f;
+    const float restMetHoursPerSet = settings.restSecondsPerSet / 3600.0f * (settings.restMet - 1.0f);
+    const float hoursPerRep = settings.secondsPerRep / 3600.0f;
+
+    DailyValues hours{};
+    for (size_t day = 0; day < DAY_COUNT; ++day)
+    {
+        auto it = plan.weeklyPlan.find(DAYS_OF_WEEK[day]);
+        if (it == plan.weeklyPlan.end())
+        {
+            continue;
+        }
+        for (const auto& exercise : it->second)
+        {
+            float netMet = exercise.exerciseId < netMetById.size() && netMetById[exercise.exerciseId] >= 0 ? netMetById[exercise.exerciseId] : unknownMet;
+            hours[day] += exercise.sets * (exercise.reps * hoursPerRep * netMet + restMetHoursPerSet);
+        }
+    }
+    return hours;
+}
+
+/**
+ * @brief Computes the calories a plan burns on each day.
+ *
+ * One MET-hour burns one kcal per kg of body weight.
+ *
+ * @param plan The workout plan.
+ * @param weight The body weight in kg.
+ * @return The calories of every day.
+ */
+BurnEstimator::DailyValues BurnEstimator::dailyBurn(const WorkoutPlan& plan, float weight) const
+{
+    DailyValues burn = metHours(plan);
+    for (float& value : burn)
+    {
+        value *= weight;
+    }
+    return burn;
+}
+
+/**
+ * @brief Computes the daily calories of every pair of user and plan.
+ *
+ * The MET-hours of every plan are computed first, so the pass over the users is a plain
+ * multiplication of two contiguous arrays.
+ *
+ * @param weights The body weight of every user, in kg.
+ * @param plans The workout plans.
+ * @return The calories, DAY_COUNT values per plan and plans.size() plans per user.
+ */
+std::vector<float> BurnEstimator::batch(const std::vector<float>& weights, const std::vector<const WorkoutPlan*>& plans) const
+{
+    const size_t rowSize = plans.size() * DAY_COUNT;
+    std::vector<float> hours(rowSize);
+    for (size_t plan = 0; plan < plans.size(); ++plan)
+    {
+        DailyValues planHours = metHours(*plans[plan]);
+        std::copy(planHours.begin(), planHours.end(), hours.begin() + plan * DAY_COUNT);
+    }
+
+    std::vector<float> burn(weights.size() * rowSize);
+    for (size_t user = 0; user < weights.size(); ++user)
+    {
+        const float weight = weights[user];
+        float* row = burn.data() + user * rowSize;
+        for (size_t i = 0; i < rowSize; ++i)
+        {
+            row[i] = hours[i] * weight;
+        }
+    }
+    return burn;
+}
+
+/**
+ * @brief Estimates the daily burn of a saved workout plan.
+ *
+ * Reads the workout plan and exercise files, with the default energy costs.
+ *
+ * @param planName The name of the plan in the workout plan file.
+ * @param weight The body weight in kg.
+ * @param burn Receives the calories of every day.
+ * @return False if the plan does not exist.
+ */
+bool BurnEstimator::estimateSavedPlan(const std::string& planName, float weight, DailyValues& burn)
+{
+    auto plans = readFromCSV<WorkoutPlan>("workout_plans.csv");
+    auto it = plans.find(planName);
+    if (it == plans.end())
+    {
+        return false;
+    }
+
+    BurnEstimator estimator{ Settings() };
+    estimator.setExercises(readFromCSV<Exercise>("exercises.csv"));
+    burn = estimator.dailyBurn(it->second, weight);
+    return true;
+}
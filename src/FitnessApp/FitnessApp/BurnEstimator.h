@@ -0,0 +1,112 @@
+#ifndef BURN_ESTIMATOR_H
+#define BURN_ESTIMATOR_H
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+#include "Exercise.h"
+#include "WorkoutPlan.h"
+
+/**
+ * @brief Estimates the calories a workout plan burns on each day of the week.
+ *
+ * Every set is timed from its repetitions, followed by a rest, and weighted by the metabolic
+ * equivalent (MET) of its exercise type. Only the energy above rest is counted, MET minus one,
+ * because the basal metabolic rate already covers the rest.
+ *
+ * Calories are MET-hours times body weight, so the MET-hours of a plan are computed once and
+ * scaled by the weight of every user. A batch over many users and plans therefore costs one
+ * pass per plan plus one multiplication per user, plan and day.
+ */
+class BurnEstimator
+{
+public:
+    /**
+     * @brief Number of days of a plan, Monday first.
+     */
+    static const size_t DAY_COUNT = 7;
+
+    /**
+     * @brief Number of exercise types, including UNKNOWN.
+     */
+    static const size_t TYPE_COUNT = static_cast<size_t>(Exercise::ExerciseType::UNKNOWN) + 1;
+
+    /**
+     * @brief A value for every day of the week, Monday first.
+     */
+    using DailyValues = std::array<float, DAY_COUNT>;
+
+    /**
+     * @brief Energy cost and timing of the exercises.
+     */
+    struct Settings
+    {
+        std::array<float, TYPE_COUNT> met = {
+            5.0f, // Strength
+            5.0f, // Hypertrophy
+            8.0f, // Endurance
+            2.5f, // Flexibility
+            3.0f, // Balance and stability
+            6.0f, // Power
+            5.0f, // Functional
+            7.0f, // Aerobic
+            8.0f, // Anaerobic
+            2.0f, // Recovery and regeneration
+            4.0f  // Unknown, also used for exercises missing from the exercise list
+        }; ///< Metabolic equivalent of every exercise type while working.
+        float secondsPerRep = 4.0f; ///< Time of one repetition.
+        float restSecondsPerSet = 90.0f; ///< Rest after every set.
+        float restMet = 1.5f; ///< Metabolic equivalent while resting between sets.
+    };
+
+    /**
+     * @brief Constructs an estimator with the given energy costs.
+     * @param settings The energy cost and timing of the exercises.
+     */
+    explicit BurnEstimator(Settings settings);
+
+    /**
+     * @brief Sets the exercises the plan entries refer to.
+     * @param exerciseMap The exercises by name.
+     */
+    void setExercises(const std::map<std::string, Exercise>& exerciseMap);
+
+    /**
+     * @brief Computes the MET-hours above rest of a plan on each day.
+     * @param plan The workout plan.
+     * @return The MET-hours of every day.
+     */
+    DailyValues metHours(const WorkoutPlan& plan) const;
+
+    /**
+     * @brief Computes the calories a plan burns on each day.
+     * @param plan The workout plan.
+     * @param weight The body weight in kg.
+     * @return The calories of every day.
+     */
+    DailyValues dailyBurn(const WorkoutPlan& plan, float weight) const;
+
+    /**
+     * @brief Computes the daily calories of every pair of user and plan.
+     * @param weights The body weight of every user, in kg.
+     * @param plans The workout plans.
+     * @return The calories, DAY_COUNT values per plan and plans.size() plans per user.
+     */
+    std::vector<float> batch(const std::vector<float>& weights, const std::vector<const WorkoutPlan*>& plans) const;
+
+    /**
+     * @brief Estimates the daily burn of a saved workout plan.
+     * @param planName The name of the plan in the workout plan file.
+     * @param weight The body weight in kg.
+     * @param burn Receives the calories of every day.
+     * @return False if the plan does not exist.
+     */
+    static bool estimateSavedPlan(const std::string& planName, float weight, DailyValues& burn);
+
+private:
+    Settings settings; ///< The energy cost and timing of the exercises.
+    std::vector<float> netMetById; ///< MET above rest of every exercise, indexed by ExerciseId; negative if unknown.
+};
+
+#endif // BURN_ESTIMATOR_H
@@ -0,0 +1,166 @@
+#include "CalorieBatch.h"
+#include <algorithm>
+
+namespace
+{
+    const size_t GENDER_COUNT = 2; ///< Number of Profile::Gender values.
+    const size_t ACTIVITY_LEVEL_COUNT = 5; ///< Number of Profile::ActivityLevel values.
+    const size_t FITNESS_GOAL_COUNT = 3; ///< Number of Goals::FitnessGoal values.
+
+    /**
+     * @brief Maps an enum value to a table index, with every value out of range sharing the last index.
+     * @param value The enum value.
+     * @param lastIndex The index of values out of range.
+     * @return The index.
+     */
+    template<typename Enum>
+    std::uint8_t tableIndex(Enum value, size_t lastIndex)
+    {
+        // Negative values wrap to large ones and are clamped as well
+        return static_cast<std::uint8_t>(std::min(static_cast<size_t>(value), lastIndex));
+    }
+}
+
+/**
+ * @brief Removes every user.
+ */
+void CalorieBatch::clear()
+{
+    weights.clear();
+    heights.clear();
+    ages.clear();
+    genders.clear();
+    activityLevels.clear();
+    fitnessGoals.clear();
+    workoutBurns.clear();
+    customFlags.clear();
+    customCalories.clear();
+    basalMetabolicRates.clear();
+    energyExpenditures.clear();
+    dailyCalories.clear();
+}
+
+/**
+ * @brief Reserves room for a number of users.
+ * @param count The number of users.
+ */
+void CalorieBatch::reserve(size_t count)
+{
+    weights.reserve(count);
+    heights.reserve(count);
+    ages.reserve(count);
+    genders.reserve(count);
+    activityLevels.reserve(count);
+    fitnessGoals.reserve(count);
+    workoutBurns.reserve(count);
+    customFlags.reserve(count);
+    customCalories.reserve(count);
+}
+
+/**
+ * @brief Adds a user.
+ *
+ * A workout plan replaces the activity level with the sedentary one plus the burn of the plan,
+ * as in Goals, so that choice is made here rather than in compute(). Enum values out of range
+ * are mapped to the table slots holding what the scalar path gives them: the female offset,
+ * an activity factor of 1 and no goal offset.
+ *
+ * @param profile The profile.
+ * @param goals The goals, including the workout plan burn and custom calories.
+ */
+void CalorieBatch::add(const Profile& profile, const Goals& goals)
+{
+    const bool hasWorkoutPlan = !goals.getWorkoutPlan().empty();
+    weights.push_back(profile.getWeight());
+    heights.push_back(profile.getHeight());
+    ages.push_back(profile.getAge());
+    genders.push_back(tableIndex(profile.getGender(), GENDER_COUNT - 1));
+    activityLevels.push_back(tableIndex(hasWorkoutPlan ? Profile::ActivityLevel::SEDENTARY : profile.getActivityLevel(), ACTIVITY_LEVEL_COUNT));
+    fitnessGoals.push_back(tableIndex(goals.getFitnessGoal(), FITNESS_GOAL_COUNT));
+    workoutBurns.push_back(hasWorkoutPlan ? goals.getWorkoutBurn() : 0.0f);
+    customFlags.push_back(goals.usesCustomCalories() ? 1 : 0);
+    customCalories.push_back(goals.usesCustomCalories() ? goals.getDailyCalories() : 0.0f);
+}
+
+/**
+ * @brief Gets the number of users.
+ * @return The number of users added since the last clear().
+ */
+size_t CalorieBatch::size() const
+{
+    return weights.size();
+}
+
+/**
+ * @brief Computes the figures of every user.
+ *
+ * The constants are read from Profile and Goals once, into tables indexed by the enum values,
+ * and each output is computed in its own pass over the input columns. The activity and goal
+ * tables end with the value Profile and Goals give to an unknown enum value.
+ */
+void CalorieBatch::compute()
+{
+    float genderOffsets[GENDER_COUNT];
+    for (size_t gender = 0; gender < GENDER_COUNT; ++gender)
+    {
+        genderOffsets[gender] = Profile::genderOffset(static_cast<Profile::Gender>(gender));
+    }
+    float activityFactors[ACTIVITY_LEVEL_COUNT + 1];
+    for (size_t level = 0; level <= ACTIVITY_LEVEL_COUNT; ++level)
+    {
+        activityFactors[level] = Profile::activityFactor(static_cast<Profile::ActivityLevel>(level));
+    }
+    float goalOffsets[FITNESS_GOAL_COUNT + 1];
+    for (size_t goal = 0; goal <= FITNESS_GOAL_COUNT; ++goal)
+    {
+        goalOffsets[goal] = Goals::goalOffset(static_cast<Goals::FitnessGoal>(goal));
+    }
+
+    const size_t count = size();
+    basalMetabolicRates.resize(count);
+    energyExpenditures.resize(count);
+    dailyCalories.resize(count);
+
+    // Same expression as Profile::calculateBasalMetabolicRate
+    for (size_t i = 0; i < count; ++i)
+    {
+        basalMetabolicRates[i] = 10 * weights[i] + 6.25f * heights[i] - 5 * ages[i] + genderOffsets[genders[i]];
+    }
+    // Adding 0 for users without a workout plan leaves the product unchanged
+    for (size_t i = 0; i < count; ++i)
+    {
+        energyExpenditures[i] = basalMetabolicRates[i] * activityFactors[activityLevels[i]] + workoutBurns[i];
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float calculated = energyExpenditures[i] + goalOffsets[fitnessGoals[i]];
+        dailyCalories[i] = customFlags[i] != 0 ? customCalories[i] : calculated;
+    }
+}
+
+/**
+ * @brief Gets the basal metabolic rates, as Profile::calculateBasalMetabolicRate.
+ * @return The rates, in the order the users were added.
+ */
+const std::vector<float>& CalorieBatch::getBasalMetabolicRates() const
+{
+    return basalMetabolicRates;
+}
+
+/**
+ * @brief Gets the total daily energy expenditures, the basal metabolic rate times the activity factor plus any workout plan burn.
+ * @return The expenditures, in the order the users were added.
+ */
+const std::vector<float>& CalorieBatch::getEnergyExpenditures() const
+{
+    return energyExpenditures;
+}
+
+/**
+ * @brief Gets the daily calorie targets, as Goals::getDailyCalories.
+ * @return The targets, in the order the users were added.
+ */
+const std::vector<float>& CalorieBatch::getDailyCalories() const
+{
+    return dailyCalories;
+}
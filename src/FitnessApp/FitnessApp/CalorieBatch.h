@@ -0,0 +1,86 @@
+#ifndef CALORIE_BATCH_H
+#define CALORIE_BATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "Profile.h"
+#include "Goals.h"
+
+/**
+ * @brief Daily calorie figures of many users, computed column by column.
+ *
+ * The inputs of every user are split into one array per field, and the gender, activity level
+ * and fitness goal are kept as small indices into tables of the constants Profile and Goals use.
+ * compute() is then one loop without branches over contiguous arrays, which compilers map to
+ * SIMD registers.
+ *
+ * Every figure is the same expression, evaluated in the same order, as the scalar path of
+ * Profile and Goals, so the results are identical to calling them user by user.
+ */
+class CalorieBatch
+{
+public:
+    /**
+     * @brief Removes every user.
+     */
+    void clear();
+
+    /**
+     * @brief Reserves room for a number of users.
+     * @param count The number of users.
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Adds a user.
+     * @param profile The profile.
+     * @param goals The goals, including the workout plan burn and custom calories.
+     */
+    void add(const Profile& profile, const Goals& goals);
+
+    /**
+     * @brief Gets the number of users.
+     * @return The number of users added since the last clear().
+     */
+    size_t size() const;
+
+    /**
+     * @brief Computes the figures of every user.
+     */
+    void compute();
+
+    /**
+     * @brief Gets the basal metabolic rates, as Profile::calculateBasalMetabolicRate.
+     * @return The rates, in the order the users were added.
+     */
+    const std::vector<float>& getBasalMetabolicRates() const;
+
+    /**
+     * @brief Gets the total daily energy expenditures, the basal metabolic rate times the activity factor plus any workout plan burn.
+     * @return The expenditures, in the order the users were added.
+     */
+    const std::vector<float>& getEnergyExpenditures() const;
+
+    /**
+     * @brief Gets the daily calorie targets, as Goals::getDailyCalories.
+     * @return The targets, in the order the users were added.
+     */
+    const std::vector<float>& getDailyCalories() const;
+
+private:
+    std::vector<float> weights; ///< Weight of every user in kg.
+    std::vector<float> heights; ///< Height of every user in cm.
+    std::vector<int> ages; ///< Age of every user.
+    std::vector<std::uint8_t> genders; ///< Gender of every user, as a Profile::Gender index; female if unknown.
+    std::vector<std::uint8_t> activityLevels; ///< Activity level of every user, as a Profile::ActivityLevel index; sedentary with a workout plan, one past the last level if unknown.
+    std::vector<std::uint8_t> fitnessGoals; ///< Fitness goal of every user, as a Goals::FitnessGoal index; one past the last goal if unknown.
+    std::vector<float> workoutBurns; ///< Average daily burn of the workout plan of every user, 0 without one.
+    std::vector<std::uint8_t> customFlags; ///< 1 for users with custom calories, 0 otherwise.
+    std::vector<float> customCalories; ///< Custom calories of every user, 0 without them.
+
+    std::vector<float> basalMetabolicRates; ///< Computed basal metabolic rates.
+    std::vector<float> energyExpenditures; ///< Computed total daily energy expenditures.
+    std::vector<float> dailyCalories; ///< Computed daily calorie targets.
+};
+
+#endif // CALORIE_BATCH_H
@@ -0,0 +1,113 @@
+#include "ExclusionFilter.h"
+
+/**
+ * @brief Compiles a set of exclusions against a food catalog.
+ * @param catalog The food catalog to compile against.
+ * @param terms Lower case food or category names to exclude.
+ */
+ExclusionFilter::ExclusionFilter(const FoodCatalog& catalog, const std::set<std::string>& terms) : excludedFoods(catalog.size())
+{
+    for (const auto& term : terms)
+    {
+        bool matched = false;
+
+        std::uint64_t bit;
+        if (catalog.findCategoryBit(term, bit))
+        {
+            // Categories past the 64th have no bit and are matched through their foods only
+            excludedCategories |= bit;
+            for (size_t index : catalog.indicesInCategory(term))
+            {
+                excludedFoods.set(index);
+            }
+            matched = true;
+        }
+
+        size_t index;
+        if (catalog.findIndex(term, index))
+        {
+            excludedFoods.set(index);
+            matched = true;
+        }
+
+        if (matched)
+        {
+            this->terms.insert(term);
+        }
+        else
+        {
+            unknownTerms.insert(term);
+        }
+    }
+}
+
+/**
+ * @brief Checks whether the filter excludes anything.
+ * @return True if no food or category is excluded.
+ */
+bool ExclusionFilter::empty() const
+{
+    return terms.empty();
+}
+
+/**
+ * @brief Checks whether a catalog food is excluded.
+ * @param index The index of the food in the catalog.
+ * @return True if the food or one of its categories is excluded.
+ */
+bool ExclusionFilter::excludesFood(size_t index) const
+{
+    return excludedFoods.test(index);
+}
+
+/**
+ * @brief Checks whether a food item is excluded, including items missing from the catalog.
+ * @param foodItem The food item to check.
+ * @return True if the food or one of its categories is excluded.
+ */
+bool ExclusionFilter::excludesItem(const FoodItem& foodItem) const
+{
+    if (terms.count(foodItem.name) > 0)
+    {
+        return true;
+    }
+    for (const auto& category : foodItem.categories)
+    {
+        if (terms.count(category) > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks whether a plan contains any excluded food.
+ *
+ * The category test also catches plan foods that are no longer in the catalog.
+ *
+ * @param mask The precomputed masks of the plan.
+ * @return True if the plan must be rejected.
+ */
+bool ExclusionFilter::rejects(const PlanMask& mask) const
+{
+    return (mask.categories & excludedCategories) != 0 || mask.foods.intersects(excludedFoods);
+}
+
+/**
+ * @brief Gets the compiled exclusion terms.
+ * @return The food and category names that matched the catalog.
+ */
+const std::set<std::string>& ExclusionFilter::getTerms() const
+{
+    return terms;
+}
+
+/**
+ * @brief Gets the terms that matched neither a food nor a category.
+ * @return The unknown terms.
+ */
+const std::set<std::string>& ExclusionFilter::getUnknownTerms() const
+{
+    return unknownTerms;
+}
@@ -0,0 +1,79 @@
+#ifndef EXCLUSION_FILTER_H
+#define EXCLUSION_FILTER_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include "FoodCatalog.h"
+#include "FoodItem.h"
+
+/**
+ * @brief Set of foods and categories a generated plan must not contain.
+ *
+ * The exclusions are compiled once per generation request into a category mask and a
+ * food mask over the catalog. Excluding a category also sets the bits of all of its foods,
+ * so testing a catalog candidate is a single bit test, and a template is rejected by
+ * ANDing its precomputed PlanMask against the compiled masks.
+ */
+class ExclusionFilter
+{
+public:
+    /**
+     * @brief Default constructor, creates a filter that excludes nothing.
+     */
+    ExclusionFilter() = default;
+
+    /**
+     * @brief Compiles a set of exclusions against a food catalog.
+     * @param catalog The food catalog to compile against.
+     * @param terms Lower case food or category names to exclude.
+     */
+    ExclusionFilter(const FoodCatalog& catalog, const std::set<std::string>& terms);
+
+    /**
+     * @brief Checks whether the filter excludes anything.
+     * @return True if no food or category is excluded.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Checks whether a catalog food is excluded.
+     * @param index The index of the food in the catalog.
+     * @return True if the food or one of its categories is excluded.
+     */
+    bool excludesFood(size_t index) const;
+
+    /**
+     * @brief Checks whether a food item is excluded, including items missing from the catalog.
+     * @param foodItem The food item to check.
+     * @return True if the food or one of its categories is excluded.
+     */
+    bool excludesItem(const FoodItem& foodItem) const;
+
+    /**
+     * @brief Checks whether a plan contains any excluded food.
+     * @param mask The precomputed masks of the plan.
+     * @return True if the plan must be rejected.
+     */
+    bool rejects(const PlanMask& mask) const;
+
+    /**
+     * @brief Gets the compiled exclusion terms.
+     * @return The food and category names that matched the catalog.
+     */
+    const std::set<std::string>& getTerms() const;
+
+    /**
+     * @brief Gets the terms that matched neither a food nor a category.
+     * @return The unknown terms.
+     */
+    const std::set<std::string>& getUnknownTerms() const;
+
+private:
+    std::uint64_t excludedCategories = 0; ///< Bits of the excluded categories.
+    FoodMask excludedFoods; ///< Excluded foods, including all foods of excluded categories.
+    std::set<std::string> terms; ///< Terms that matched a food or a category.
+    std::set<std::string> unknownTerms; ///< Terms that matched nothing.
+};
+
+#endif // EXCLUSION_FILTER_H
@@ -0,0 +1,68 @@
+#include "ExerciseIdTable.h"
+
+/**
+ * @brief Gets the id of a name, adding the name if it is new.
+ * @param name The exercise name.
+ * @return The id of the name.
+ */
+ExerciseId ExerciseIdTable::intern(std::string_view name)
+{
+    ExerciseIdTable& table = instance();
+    auto it = table.ids.find(name);
+    if (it != table.ids.end())
+    {
+        return it->second;
+    }
+
+    ExerciseId id = static_cast<ExerciseId>(table.names.size());
+    table.names.emplace_back(name);
+    table.ids.emplace(table.names.back(), id);
+    return id;
+}
+
+/**
+ * @brief Gets the id of a name without adding it.
+ * @param name The exercise name.
+ * @param id Receives the id if the name is known.
+ * @return True if the name is known.
+ */
+bool ExerciseIdTable::find(std::string_view name, ExerciseId& id)
+{
+    const ExerciseIdTable& table = instance();
+    auto it = table.ids.find(name);
+    if (it == table.ids.end())
+    {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+/**
+ * @brief Gets the name of an id.
+ * @param id An id returned by intern().
+ * @return The exercise name.
+ */
+const std::string& ExerciseIdTable::name(ExerciseId id)
+{
+    return instance().names.at(id);
+}
+
+/**
+ * @brief Gets the number of interned names, which is one more than the largest id.
+ * @return The number of names.
+ */
+size_t ExerciseIdTable::size()
+{
+    return instance().names.size();
+}
+
+/**
+ * @brief Gets the table shared by all workout plans.
+ * @return The table.
+ */
+ExerciseIdTable& ExerciseIdTable::instance()
+{
+    static ExerciseIdTable table;
+    return table;
+}
@@ -0,0 +1,65 @@
+#ifndef EXERCISE_ID_TABLE_H
+#define EXERCISE_ID_TABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Compact reference to an exercise name, see ExerciseIdTable.
+ */
+using ExerciseId = std::uint32_t;
+
+/**
+ * @brief Process-wide intern table giving every exercise name a small, stable id.
+ *
+ * Workout plans repeat the same few exercise names many times, so they store ids instead of
+ * strings. Ids are never reused or removed: a renamed exercise gets the id of its new name,
+ * and plans still referring to a deleted exercise keep resolving to its name.
+ */
+class ExerciseIdTable
+{
+public:
+    /**
+     * @brief Gets the id of a name, adding the name if it is new.
+     * @param name The exercise name.
+     * @return The id of the name.
+     */
+    static ExerciseId intern(std::string_view name);
+
+    /**
+     * @brief Gets the id of a name without adding it.
+     * @param name The exercise name.
+     * @param id Receives the id if the name is known.
+     * @return True if the name is known.
+     */
+    static bool find(std::string_view name, ExerciseId& id);
+
+    /**
+     * @brief Gets the name of an id.
+     * @param id An id returned by intern().
+     * @return The exercise name.
+     */
+    static const std::string& name(ExerciseId id);
+
+    /**
+     * @brief Gets the number of interned names, which is one more than the largest id.
+     * @return The number of names.
+     */
+    static size_t size();
+
+private:
+    /**
+     * @brief Gets the table shared by all workout plans.
+     * @return The table.
+     */
+    static ExerciseIdTable& instance();
+
+    std::deque<std::string> names; ///< Name of every id; a deque keeps the returned references valid.
+    std::map<std::string_view, ExerciseId, std::less<>> ids; ///< Id of every name, viewing the strings in names.
+};
+
+#endif // EXERCISE_ID_TABLE_H
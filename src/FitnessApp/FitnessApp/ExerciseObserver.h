@@ -0,0 +1,39 @@
+#ifndef EXERCISE_OBSERVER_H
+#define EXERCISE_OBSERVER_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Receives changes to the exercises, so that data referring to them can follow.
+ */
+class ExerciseObserver
+{
+public:
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~ExerciseObserver() = default;
+
+    /**
+     * @brief Called after an exercise was renamed.
+     * @param oldName The previous name.
+     * @param newName The new name.
+     */
+    virtual void exerciseRenamed(const std::string& oldName, const std::string& newName) = 0;
+
+    /**
+     * @brief Called after an exercise was deleted.
+     * @param name The name of the deleted exercise.
+     */
+    virtual void exerciseRemoved(const std::string& name) = 0;
+
+    /**
+     * @brief Lists what refers to an exercise.
+     * @param name The exercise name.
+     * @return A description of every user of the exercise.
+     */
+    virtual std::vector<std::string> usersOf(const std::string& name) const = 0;
+};
+
+#endif // EXERCISE_OBSERVER_H
@@ -0,0 +1,132 @@
+#include "ExerciseUsageIndex.h"
+#include <algorithm>
+
+/**
+ * @brief Replaces the index with the entries of the given plans.
+ * @param plans The plans by name.
+ */
+void ExerciseUsageIndex::build(const std::map<std::string, WorkoutPlan>& plans)
+{
+    occurrences.clear();
+    for (const auto& pair : plans)
+    {
+        indexPlan(pair.first, pair.second);
+    }
+}
+
+/**
+ * @brief Adds the entries of a plan.
+ * @param planName The key of the plan in the plan map.
+ * @param plan The plan, which must not be indexed yet.
+ */
+void ExerciseUsageIndex::indexPlan(const std::string& planName, const WorkoutPlan& plan)
+{
+    for (const auto& day : plan.weeklyPlan)
+    {
+        for (size_t position = 0; position < day.second.size(); ++position)
+        {
+            occurrences[day.second[position].exerciseId].push_back({ planName, day.first, position });
+        }
+    }
+}
+
+/**
+ * @brief Removes the entries of a plan.
+ * @param planName The key of the plan in the plan map.
+ * @param plan The plan as it was indexed.
+ */
+void ExerciseUsageIndex::removePlan(const std::string& planName, const WorkoutPlan& plan)
+{
+    std::set<ExerciseId> ids;
+    for (const auto& day : plan.weeklyPlan)
+    {
+        for (const auto& exercise : day.second)
+        {
+            ids.insert(exercise.exerciseId);
+        }
+    }
+
+    for (const auto& id : ids)
+    {
+        auto it = occurrences.find(id);
+        if (it == occurrences.end())
+        {
+            continue;
+        }
+        auto& list = it->second;
+        list.erase(std::remove_if(list.begin(), list.end(),
+            [&](const Occurrence& occurrence) { return occurrence.plan == planName; }), list.end());
+        if (list.empty())
+        {
+            occurrences.erase(it);
+        }
+    }
+}
+
+/**
+ * @brief Gets the uses of an exercise.
+ * @param name The exercise name.
+ * @return The occurrences of the exercise.
+ */
+const std::vector<ExerciseUsageIndex::Occurrence>& ExerciseUsageIndex::find(const std::string& name) const
+{
+    static const std::vector<Occurrence> none;
+    ExerciseId id;
+    if (!ExerciseIdTable::find(name, id))
+    {
+        return none;
+    }
+    auto it = occurrences.find(id);
+    return it != occurrences.end() ? it->second : none;
+}
+
+/**
+ * @brief Gets the plans that use an exercise.
+ * @param name The exercise name.
+ * @return The names of the plans.
+ */
+std::set<std::string> ExerciseUsageIndex::plansUsing(const std::string& name) const
+{
+    std::set<std::string> plans;
+    for (const auto& occurrence : find(name))
+    {
+        plans.insert(occurrence.plan);
+    }
+    return plans;
+}
+
+/**
+ * @brief Renames an exercise in every entry that uses it.
+ * @param plans The indexed plans, updated in place.
+ * @param oldName The previous exercise name.
+ * @param newName The new exercise name.
+ * @return The names of the plans that changed.
+ */
+std::set<std::string> ExerciseUsageIndex::renameExercise(std::map<std::string, WorkoutPlan>& plans, const std::string& oldName, const std::string& newName)
+{
+    std::set<std::string> touched;
+    ExerciseId oldId;
+    if (oldName == newName || !ExerciseIdTable::find(oldName, oldId))
+    {
+        return touched;
+    }
+    auto it = occurrences.find(oldId);
+    if (it == occurrences.end())
+    {
+        return touched;
+    }
+
+    // Positions do not change, so the occurrences move to the new id as they are
+    ExerciseId newId = ExerciseIdTable::intern(newName);
+    std::vector<Occurrence> moved = std::move(it->second);
+    occurrences.erase(it);
+    for (const auto& occurrence : moved)
+    {
+        plans.at(occurrence.plan).weeklyPlan.at(occurrence.day)[occurrence.position].exerciseId = newId;
+        touched.insert(occurrence.plan);
+    }
+
+    auto& target = occurrences[newId];
+    target.insert(target.end(), moved.begin(), moved.end());
+    return touched;
+}
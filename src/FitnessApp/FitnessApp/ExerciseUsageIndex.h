@@ -0,0 +1,78 @@
+#ifndef EXERCISE_USAGE_INDEX_H
+#define EXERCISE_USAGE_INDEX_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WorkoutPlan.h"
+
+/**
+ * @brief Reverse index from exercise names to the workout plan entries that use them.
+ *
+ * Every entry is addressed by plan, day and position within the day, so renaming an exercise
+ * touches exactly the entries listed for it instead of scanning every plan. The index has to
+ * be told about every plan mutation through indexPlan() and removePlan().
+ */
+class ExerciseUsageIndex
+{
+public:
+    /**
+     * @brief One use of an exercise in a workout plan.
+     */
+    struct Occurrence
+    {
+        std::string plan; ///< Key of the plan in the plan map.
+        std::string day; ///< Day of the week.
+        size_t position; ///< Index of the entry within the day.
+    };
+
+    /**
+     * @brief Replaces the index with the entries of the given plans.
+     * @param plans The plans by name.
+     */
+    void build(const std::map<std::string, WorkoutPlan>& plans);
+
+    /**
+     * @brief Adds the entries of a plan.
+     * @param planName The key of the plan in the plan map.
+     * @param plan The plan, which must not be indexed yet.
+     */
+    void indexPlan(const std::string& planName, const WorkoutPlan& plan);
+
+    /**
+     * @brief Removes the entries of a plan.
+     * @param planName The key of the plan in the plan map.
+     * @param plan The plan as it was indexed.
+     */
+    void removePlan(const std::string& planName, const WorkoutPlan& plan);
+
+    /**
+     * @brief Gets the uses of an exercise.
+     * @param name The exercise name.
+     * @return The occurrences of the exercise.
+     */
+    const std::vector<Occurrence>& find(const std::string& name) const;
+
+    /**
+     * @brief Gets the plans that use an exercise.
+     * @param name The exercise name.
+     * @return The names of the plans.
+     */
+    std::set<std::string> plansUsing(const std::string& name) const;
+
+    /**
+     * @brief Renames an exercise in every entry that uses it.
+     * @param plans The indexed plans, updated in place.
+     * @param oldName The previous exercise name.
+     * @param newName The new exercise name.
+     * @return The names of the plans that changed.
+     */
+    std::set<std::string> renameExercise(std::map<std::string, WorkoutPlan>& plans, const std::string& oldName, const std::string& newName);
+
+private:
+    std::unordered_map<ExerciseId, std::vector<Occurrence>> occurrences; ///< Exercise id to its uses.
+};
+
+#endif // EXERCISE_USAGE_INDEX_H
@@ -205,8 +205,33 @@ void ExerciseViewModel::modify()
         return;
     }
 
-    handleExerciseModification(exerciseMap[names[choice - 1]]);
+    // Work on a copy, so a renamed exercise is stored under its new name
+    const std::string oldName = names[choice - 1];
+    Exercise exercise = exerciseMap[oldName];
+    handleExerciseModification(exercise);
+    bool renamed = false;
+    if (exercise.name != oldName)
+    {
+        if (confirmOverwrite(exerciseMap, exercise.name))
+        {
+            exerciseMap.erase(oldName);
+            renamed = true;
+        }
+        else
+        {
+            exercise.name = oldName;
+        }
+    }
+    exerciseMap[exercise.name] = exercise;
+
     overwriteCSV(filename, exerciseMap);
+    if (renamed)
+    {
+        for (auto observer : observers)
+        {
+            observer->exerciseRenamed(oldName, exercise.name);
+        }
+    }
     std::cout << "Exercise modified.\n";
 }
 
@@ -257,6 +282,16 @@ void ExerciseViewModel::reload()
     exerciseMap = readFromCSV<Exercise>(filename);
 }
 
+/**
+ * @brief Register an observer to be notified of renamed and deleted exercises
+ *
+ * @param observer The observer, which must outlive this view model
+ */
+void ExerciseViewModel::addObserver(ExerciseObserver* observer)
+{
+    observers.push_back(observer);
+}
+
 /**
  * @brief Print the details of a given exercise
  *
@@ -305,6 +340,22 @@ void ExerciseViewModel::printMuscleGroupSelection(const std::vector<std::string>
  */
 bool ExerciseViewModel::confirmDeletion(const std::string& name) const
 {
+    std::vector<std::string> users;
+    for (auto observer : observers)
+    {
+        auto observerUsers = observer->usersOf(name);
+        users.insert(users.end(), observerUsers.begin(), observerUsers.end());
+    }
+    if (!users.empty())
+    {
+        std::cout << name << " is used by:";
+        for (const auto& user : users)
+        {
+            std::cout << " " << user << ";";
+        }
+        std::cout << "\nThese plans keep it, flagged as missing from the exercise list.\n";
+    }
+
     const auto& exercise = exerciseMap.at(name);
     std::string confirm;
     do
@@ -407,6 +458,10 @@ void ExerciseViewModel::handleExerciseDeletion(std::map<std::string, Exercise>&
     {
         exerciseMap.erase(names[choice - 1]);
         overwriteCSV(filename, exerciseMap);
+        for (auto observer : observers)
+        {
+            observer->exerciseRemoved(names[choice - 1]);
+        }
         std::cout << "Exercise deleted.\n";
     }
     else
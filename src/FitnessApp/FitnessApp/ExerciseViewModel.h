@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include "Exercise.h"
+#include "ExerciseObserver.h"
 #include "ViewModel.h"
 
 /**
@@ -52,9 +53,17 @@ public:
      */
     void reload() override;
 
+    /**
+     * @brief Register an observer to be notified of renamed and deleted exercises.
+     *
+     * @param observer The observer, which must outlive this view model.
+     */
+    void addObserver(ExerciseObserver* observer);
+
 private:
     std::string filename; ///< The filename to read/write exercise items.
     std::map<std::string, Exercise> exerciseMap; ///< Map of exercise names to Exercise objects.
+    std::vector<ExerciseObserver*> observers; ///< Notified after exercises are renamed or deleted.
 
     /**
      * @brief Display all exercises.
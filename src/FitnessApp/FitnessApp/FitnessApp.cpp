@@ -6,15 +6,22 @@
 FitnessApp::FitnessApp()
     : exerciseViewModel("exercises.csv"),
     foodViewModel("food_items.csv"),
+    userRegistry("users.bin", "users.bin.idx", UserRegistry::Settings()),
     workoutPlanViewModel("workout_plans.csv"),
     exerciseView(exerciseViewModel),
     foodView(foodViewModel),
-    profileView(profile, goals),
+    profileView(profile, goals, userRegistry),
     workoutPlanView(workoutPlanViewModel),
-    nutritionPlanViewModel("nutrition_plans.csv"),
+    nutritionPlanViewModel("nutrition_plans.csv", userRegistry),
     nutritionPlanView(nutritionPlanViewModel),
-    mainView(exerciseView, foodView, profileView, workoutPlanView, nutritionPlanView)
+    workoutLogViewModel("workout_log.bin"),
+    workoutLogView(workoutLogViewModel),
+    mainView(exerciseView, foodView, profileView, workoutPlanView, nutritionPlanView, workoutLogView)
 {
+    // Plans embed copies of the food items, so they follow every change made to them
+    foodViewModel.addObserver(&nutritionPlanViewModel);
+    // Workout plans refer to exercises by name
+    exerciseViewModel.addObserver(&workoutPlanViewModel);
 }
 
 /**
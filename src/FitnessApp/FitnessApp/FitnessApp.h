@@ -8,11 +8,14 @@
 #include "ProfileView.h"
 #include "Profile.h"
 #include "Goals.h"
+#include "UserRegistry.h"
 #include "WorkoutPlanView.h"
 #include "WorkoutPlanViewModel.h"
 #include "MainView.h"
 #include "NutritionPlanView.h"
 #include "NutritionPlanViewModel.h"
+#include "WorkoutLogView.h"
+#include "WorkoutLogViewModel.h"
 
 /**
  * @brief The main application class that initializes and runs the fitness application.
@@ -35,6 +38,7 @@ private:
     FoodViewModel foodViewModel; ///< The view model for food items.
     Profile profile; ///< The user's profile.
     Goals goals; ///< The user's fitness goals.
+    UserRegistry userRegistry; ///< The profiles and goals of all users.
     WorkoutPlanViewModel workoutPlanViewModel; ///< The view model for workout plans.
     ExerciseView exerciseView; ///< The view for displaying exercises.
     FoodView foodView; ///< The view for displaying food items.
@@ -42,6 +46,8 @@ private:
     WorkoutPlanView workoutPlanView; ///< The view for displaying workout plans.
     NutritionPlanViewModel nutritionPlanViewModel; ///< The view model for nutrition plans.
     NutritionPlanView nutritionPlanView; ///< The view for displaying nutrition plans.
+    WorkoutLogViewModel workoutLogViewModel; ///< The view model for the workout log.
+    WorkoutLogView workoutLogView; ///< The view for logging and reviewing workout sessions.
     MainView mainView; ///< The main view that combines all other views.
 };
 
@@ -0,0 +1,460 @@
+#include "FoodCatalog.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include "Nutrients.h"
+
+namespace
+{
+    const size_t kernelWidth = 8; ///< Number of foods processed together by nutrientTotals.
+
+    /**
+     * @brief Calculates the macro profile of a food, the point it has in the substitute tree.
+     * @param foodItem The food item.
+     * @param profile Receives the calories per gram from protein, carbohydrates and fats.
+     */
+    void macroProfile(const FoodItem& foodItem, float* profile)
+    {
+        // Values in FoodItem are given per 100 grams
+        profile[0] = foodItem.protein * 4 / 100.0f;
+        profile[1] = foodItem.carbohydrates * 4 / 100.0f;
+        profile[2] = foodItem.fats * 9 / 100.0f;
+    }
+}
+
+/**
+ * @brief Builds the catalog from a map of food items.
+ * @param foodItemMap The map of food items to index.
+ */
+FoodCatalog::FoodCatalog(const std::map<std::string, FoodItem>& foodItemMap)
+{
+    items.reserve(foodItemMap.size());
+    macroTable.reserve(foodItemMap.size() * MACRO_COUNT);
+
+    for (const auto& pair : foodItemMap)
+    {
+        const FoodItem& foodItem = pair.second;
+        size_t index = items.size();
+
+        items.push_back(foodItem);
+        indexByName[pair.first] = index;
+
+        // Values in FoodItem are given per 100 grams
+        macroTable.push_back(foodItem.calories / 100.0f);
+        macroTable.push_back(foodItem.protein / 100.0f);
+        macroTable.push_back(foodItem.carbohydrates / 100.0f);
+        macroTable.push_back(foodItem.fats / 100.0f);
+
+        for (const auto& category : foodItem.categories)
+        {
+            indicesByCategory[category].push_back(index);
+        }
+    }
+
+    // Number the categories in name order, one bit each while they fit into a mask
+    size_t bitIndex = 0;
+    for (const auto& pair : indicesByCategory)
+    {
+        categoryBits[pair.first] = bitIndex < 64 ? (std::uint64_t(1) << bitIndex) : 0;
+        bitIndex++;
+    }
+
+    categoryMasks.assign(items.size(), 0);
+    for (const auto& pair : indicesByCategory)
+    {
+        for (size_t index : pair.second)
+        {
+            categoryMasks[index] |= categoryBits[pair.first];
+        }
+    }
+
+    // Nutrient columns: the macros, then the known nutrients in display order, then any others by name
+    std::set<std::string> presentNutrients;
+    for (const auto& foodItem : items)
+    {
+        for (const auto& nutrient : foodItem.nutrients)
+        {
+            presentNutrients.insert(nutrient.first);
+        }
+    }
+    nutrientNames = { "calories", "protein", "carbohydrates", "fats" };
+    for (const auto& nutrient : knownNutrients())
+    {
+        if (presentNutrients.erase(nutrient.name) > 0)
+        {
+            nutrientNames.push_back(nutrient.name);
+        }
+    }
+    nutrientNames.insert(nutrientNames.end(), presentNutrients.begin(), presentNutrients.end());
+
+    std::vector<float> profiles(items.size() * MacroKdTree::DIMENSIONS);
+    for (size_t index = 0; index < items.size(); ++index)
+    {
+        macroProfile(items[index], &profiles[index * MacroKdTree::DIMENSIONS]);
+    }
+    profileTree = MacroKdTree(profiles);
+    categoryTrees.clear();
+    for (const auto& pair : indicesByCategory)
+    {
+        categoryTrees.emplace(pair.first, MacroKdTree(profiles, pair.second));
+    }
+
+    foodStride = (items.size() + kernelWidth - 1) / kernelWidth * kernelWidth;
+    nutrientMatrix.assign(nutrientNames.size() * foodStride, 0.0f);
+    for (size_t index = 0; index < items.size(); ++index)
+    {
+        for (size_t macro = 0; macro < MACRO_COUNT; ++macro)
+        {
+            nutrientMatrix[macro * foodStride + index] = macroTable[index * MACRO_COUNT + macro];
+        }
+        for (size_t nutrient = MACRO_COUNT; nutrient < nutrientNames.size(); ++nutrient)
+        {
+            auto it = items[index].nutrients.find(nutrientNames[nutrient]);
+            if (it != items[index].nutrients.end())
+            {
+                nutrientMatrix[nutrient * foodStride + index] = it->second / 100.0f;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of food items in the catalog.
+ * @return The number of food items.
+ */
+size_t FoodCatalog::size() const
+{
+    return items.size();
+}
+
+/**
+ * @brief Gets the food item stored at a given index.
+ * @param index The index of the food item.
+ * @return The food item.
+ */
+const FoodItem& FoodCatalog::item(size_t index) const
+{
+    return items[index];
+}
+
+/**
+ * @brief Gets the per-gram macros of a food item.
+ * @param index The index of the food item.
+ * @return Pointer to MACRO_COUNT values ordered as in the Macro enum.
+ */
+const float* FoodCatalog::macrosPerGram(size_t index) const
+{
+    return &macroTable[index * MACRO_COUNT];
+}
+
+/**
+ * @brief Looks up the index of a food item by name.
+ * @param name The name of the food item.
+ * @param index Receives the index if the food item was found.
+ * @return True if the food item is in the catalog, false otherwise.
+ */
+bool FoodCatalog::findIndex(const std::string& name, size_t& index) const
+{
+    auto it = indexByName.find(name);
+    if (it == indexByName.end())
+    {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+/**
+ * @brief Gets the indices of all food items belonging to a category.
+ * @param category The category name.
+ * @return The indices of the food items in the category (empty if unknown).
+ */
+const std::vector<size_t>& FoodCatalog::indicesInCategory(const std::string& category) const
+{
+    static const std::vector<size_t> empty;
+    auto it = indicesByCategory.find(category);
+    return it != indicesByCategory.end() ? it->second : empty;
+}
+
+/**
+ * @brief Calculates how many grams of a food item provide the given calories.
+ * @param index The index of the food item.
+ * @param calories The calories to match.
+ * @return The amount in grams, or 0 if the food item has no calories.
+ */
+float FoodCatalog::gramsForCalories(size_t index, float calories) const
+{
+    float caloriesPerGram = macrosPerGram(index)[CALORIES];
+    return caloriesPerGram > 0 ? calories / caloriesPerGram : 0.0f;
+}
+
+/**
+ * @brief Gets the category bits of a food item.
+ * @param index The index of the food item.
+ * @return The category mask of the food item.
+ */
+std::uint64_t FoodCatalog::categoryMask(size_t index) const
+{
+    return categoryMasks[index];
+}
+
+/**
+ * @brief Looks up the bit of a category.
+ * @param category The category name.
+ * @param bit Receives the category bit, or 0 if the category has no bit.
+ * @return True if the category is in the catalog, false otherwise.
+ */
+bool FoodCatalog::findCategoryBit(const std::string& category, std::uint64_t& bit) const
+{
+    auto it = categoryBits.find(category);
+    if (it == categoryBits.end())
+    {
+        return false;
+    }
+    bit = it->second;
+    return true;
+}
+
+/**
+ * @brief Gets the number of nutrient columns, the four macros included.
+ * @return The number of nutrients.
+ */
+size_t FoodCatalog::nutrientCount() const
+{
+    return nutrientNames.size();
+}
+
+/**
+ * @brief Gets the name of a nutrient column.
+ * @param nutrient The column index; the first MACRO_COUNT columns are the macros.
+ * @return The nutrient name.
+ */
+const std::string& FoodCatalog::nutrientName(size_t nutrient) const
+{
+    return nutrientNames[nutrient];
+}
+
+/**
+ * @brief Builds the dense portion vector of a plan for nutrientTotals.
+ *
+ * Foods that are not in the catalog are skipped.
+ *
+ * @param meals The meals of the plan.
+ * @return Grams of every catalog food in the plan, zero for the others.
+ */
+std::vector<float> FoodCatalog::portionVector(const std::map<std::string, std::vector<std::pair<FoodItem, float>>>& meals) const
+{
+    std::vector<float> portions(foodStride, 0.0f);
+    for (const auto& meal : meals)
+    {
+        for (const auto& foodPair : meal.second)
+        {
+            size_t index;
+            if (findIndex(foodPair.first.name, index))
+            {
+                portions[index] += foodPair.second;
+            }
+        }
+    }
+    return portions;
+}
+
+/**
+ * @brief Calculates the nutrient totals of a portion vector.
+ *
+ * Every total is the dot product of a contiguous nutrient column with the portion vector.
+ * The columns are padded to a multiple of kernelWidth and summed in kernelWidth independent
+ * lanes, which compilers map to SIMD registers. Every nutrient is a pass over every catalog
+ * food, whether or not the plan contains it, so the cost is the catalog size times the number
+ * of nutrients, divided by kernelWidth in vector multiply-adds.
+ *
+ * @param portions The portion vector, see portionVector.
+ * @param totals Receives nutrientCount() totals.
+ */
+void FoodCatalog::nutrientTotals(const std::vector<float>& portions, float* totals) const
+{
+    const float* grams = portions.data();
+    for (size_t nutrient = 0; nutrient < nutrientNames.size(); ++nutrient)
+    {
+        const float* column = nutrientMatrix.data() + nutrient * foodStride;
+        float lanes[kernelWidth] = {};
+        for (size_t food = 0; food < foodStride; food += kernelWidth)
+        {
+            for (size_t lane = 0; lane < kernelWidth; ++lane)
+            {
+                lanes[lane] += column[food + lane] * grams[food + lane];
+            }
+        }
+
+        float sum = 0;
+        for (size_t lane = 0; lane < kernelWidth; ++lane)
+        {
+            sum += lanes[lane];
+        }
+        totals[nutrient] = sum;
+    }
+}
+
+/**
+ * @brief Calculates the category and food masks of a nutrition plan.
+ *
+ * Foods that are not in the catalog contribute their category bits only.
+ *
+ * @param meals The meals of the plan.
+ * @return The masks of the plan.
+ */
+PlanMask FoodCatalog::planMask(const std::map<std::string, std::vector<std::pair<FoodItem, float>>>& meals) const
+{
+    PlanMask mask;
+    mask.foods = FoodMask(items.size());
+
+    for (const auto& meal : meals)
+    {
+        for (const auto& foodPair : meal.second)
+        {
+            size_t index;
+            if (findIndex(foodPair.first.name, index))
+            {
+                mask.categories |= categoryMasks[index];
+                mask.foods.set(index);
+                continue;
+            }
+
+            for (const auto& category : foodPair.first.categories)
+            {
+                std::uint64_t bit;
+                if (findCategoryBit(category, bit))
+                {
+                    mask.categories |= bit;
+                }
+            }
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief Creates a mask with room for the given number of foods, all bits cleared.
+ * @param foodCount The number of foods in the catalog.
+ */
+FoodMask::FoodMask(size_t foodCount) : words((foodCount + 63) / 64, 0)
+{
+}
+
+/**
+ * @brief Sets the bit of a food.
+ * @param index The index of the food in the catalog.
+ */
+void FoodMask::set(size_t index)
+{
+    words[index / 64] |= std::uint64_t(1) << (index % 64);
+}
+
+/**
+ * @brief Tests the bit of a food.
+ * @param index The index of the food in the catalog.
+ * @return True if the bit is set, false otherwise.
+ */
+bool FoodMask::test(size_t index) const
+{
+    return index / 64 < words.size() && (words[index / 64] >> (index % 64) & 1) != 0;
+}
+
+/**
+ * @brief Checks whether two masks have a bit in common.
+ * @param other The mask to compare with.
+ * @return True if any food is set in both masks.
+ */
+bool FoodMask::intersects(const FoodMask& other) const
+{
+    size_t count = std::min(words.size(), other.words.size());
+    std::uint64_t common = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        common |= words[i] & other.words[i];
+    }
+    return common != 0;
+}
+
+/**
+ * @brief Checks whether any bit is set.
+ * @return True if at least one food is set.
+ */
+bool FoodMask::any() const
+{
+    for (std::uint64_t word : words)
+    {
+        if (word != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Suggests catalog foods to use instead of a food.
+ *
+ * Only foods sharing a category with the replaced food are suggested, or any food if it has
+ * no categories. A food with calories is only replaced by foods with calories, so that every
+ * suggestion can be given the calories of the replaced portion.
+ *
+ * Every category has its own tree, so a search only visits the foods of the categories of the
+ * replaced food. The nearest foods of each category are merged, a food of several categories
+ * counting once.
+ *
+ * @param foodItem The food to replace.
+ * @param grams The portion of the food to replace.
+ * @param count Maximum number of suggestions.
+ * @param isAllowed Returns true for catalog indices that may be suggested.
+ * @return The suggestions, closest macro profile first.
+ */
+std::vector<Substitute> FoodCatalog::suggestSubstitutes(const FoodItem& foodItem, float grams, size_t count, const std::function<bool(size_t)>& isAllowed) const
+{
+    const bool needsCalories = foodItem.calories > 0;
+    auto accept = [&](size_t index) {
+        return (!needsCalories || items[index].calories > 0) && items[index].name != foodItem.name && isAllowed(index);
+    };
+
+    float profile[MacroKdTree::DIMENSIONS];
+    macroProfile(foodItem, profile);
+    std::vector<std::pair<size_t, float>> nearest;
+    if (foodItem.categories.empty())
+    {
+        nearest = profileTree.nearest(profile, count, accept);
+    }
+    else
+    {
+        for (const auto& category : foodItem.categories)
+        {
+            auto tree = categoryTrees.find(category);
+            if (tree != categoryTrees.end())
+            {
+                auto categoryNearest = tree->second.nearest(profile, count, accept);
+                nearest.insert(nearest.end(), categoryNearest.begin(), categoryNearest.end());
+            }
+        }
+        std::sort(nearest.begin(), nearest.end(), [](const std::pair<size_t, float>& a, const std::pair<size_t, float>& b) {
+            return a.second != b.second ? a.second < b.second : a.first < b.first;
+        });
+        nearest.erase(std::unique(nearest.begin(), nearest.end()), nearest.end());
+        if (nearest.size() > count)
+        {
+            nearest.resize(count);
+        }
+    }
+
+    // FoodItem values are given per 100 grams
+    float calories = foodItem.calories * grams / 100.0f;
+    std::vector<Substitute> substitutes;
+    substitutes.reserve(nearest.size());
+    for (const auto& entry : nearest)
+    {
+        Substitute substitute;
+        substitute.index = entry.first;
+        substitute.grams = needsCalories ? gramsForCalories(entry.first, calories) : grams;
+        substitute.distance = std::sqrt(entry.second);
+        substitutes.push_back(substitute);
+    }
+    return substitutes;
+}
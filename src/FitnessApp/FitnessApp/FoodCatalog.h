@@ -0,0 +1,239 @@
+#ifndef FOOD_CATALOG_H
+#define FOOD_CATALOG_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <map>
+#include "FoodItem.h"
+#include "MacroKdTree.h"
+
+/**
+ * @brief Fixed-size bitset over the food indices of a FoodCatalog.
+ */
+class FoodMask
+{
+public:
+    /**
+     * @brief Default constructor, creates an empty mask.
+     */
+    FoodMask() = default;
+
+    /**
+     * @brief Creates a mask with room for the given number of foods, all bits cleared.
+     * @param foodCount The number of foods in the catalog.
+     */
+    explicit FoodMask(size_t foodCount);
+
+    /**
+     * @brief Sets the bit of a food.
+     * @param index The index of the food in the catalog.
+     */
+    void set(size_t index);
+
+    /**
+     * @brief Tests the bit of a food.
+     * @param index The index of the food in the catalog.
+     * @return True if the bit is set, false otherwise.
+     */
+    bool test(size_t index) const;
+
+    /**
+     * @brief Checks whether two masks have a bit in common.
+     * @param other The mask to compare with.
+     * @return True if any food is set in both masks.
+     */
+    bool intersects(const FoodMask& other) const;
+
+    /**
+     * @brief Checks whether any bit is set.
+     * @return True if at least one food is set.
+     */
+    bool any() const;
+
+private:
+    std::vector<std::uint64_t> words; ///< Bits of the foods, 64 per word.
+};
+
+/**
+ * @brief Precomputed masks of everything a nutrition plan contains.
+ */
+struct PlanMask
+{
+    std::uint64_t categories = 0; ///< Union of the category bits of the plan's foods.
+    FoodMask foods; ///< Catalog foods of the plan.
+};
+
+/**
+ * @brief A catalog food suggested in place of another food.
+ */
+struct Substitute
+{
+    size_t index = 0; ///< Index of the substitute in the food catalog.
+    float grams = 0; ///< Amount of the substitute with the calories of the replaced portion.
+    float distance = 0; ///< Distance of the macro profiles in kcal per gram.
+};
+
+/**
+ * @brief Read-only snapshot of the food items laid out for plan generation.
+ *
+ * The catalog is built once from the food item map and then shared by every plan
+ * generated from it. Per-gram macros are stored contiguously per food and the
+ * foods of each category are indexed up front, so generators do not need to walk
+ * the food item map for every day they produce.
+ *
+ * All nutrients (the four macros followed by every further nutrient found in the
+ * food items) are also kept as a dense nutrient-major matrix, one contiguous column
+ * of per-gram amounts per nutrient, so plan totals are a matrix-vector product.
+ *
+ * Substitutes are found with a k-d tree over the macro profile of every food, the
+ * calories per gram coming from protein, carbohydrates and fats.
+ */
+class FoodCatalog
+{
+public:
+    /**
+     * @brief Column indices of the per-gram macro table.
+     */
+    enum Macro
+    {
+        CALORIES,
+        PROTEIN,
+        CARBS,
+        FATS,
+        MACRO_COUNT
+    };
+
+    /**
+     * @brief Default constructor, creates an empty catalog.
+     */
+    FoodCatalog() = default;
+
+    /**
+     * @brief Builds the catalog from a map of food items.
+     * @param foodItemMap The map of food items to index.
+     */
+    explicit FoodCatalog(const std::map<std::string, FoodItem>& foodItemMap);
+
+    /**
+     * @brief Gets the number of food items in the catalog.
+     * @return The number of food items.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the food item stored at a given index.
+     * @param index The index of the food item.
+     * @return The food item.
+     */
+    const FoodItem& item(size_t index) const;
+
+    /**
+     * @brief Gets the per-gram macros of a food item.
+     * @param index The index of the food item.
+     * @return Pointer to MACRO_COUNT values ordered as in the Macro enum.
+     */
+    const float* macrosPerGram(size_t index) const;
+
+    /**
+     * @brief Looks up the index of a food item by name.
+     * @param name The name of the food item.
+     * @param index Receives the index if the food item was found.
+     * @return True if the food item is in the catalog, false otherwise.
+     */
+    bool findIndex(const std::string& name, size_t& index) const;
+
+    /**
+     * @brief Gets the indices of all food items belonging to a category.
+     * @param category The category name.
+     * @return The indices of the food items in the category (empty if unknown).
+     */
+    const std::vector<size_t>& indicesInCategory(const std::string& category) const;
+
+    /**
+     * @brief Calculates how many grams of a food item provide the given calories.
+     * @param index The index of the food item.
+     * @param calories The calories to match.
+     * @return The amount in grams, or 0 if the food item has no calories.
+     */
+    float gramsForCalories(size_t index, float calories) const;
+
+    /**
+     * @brief Gets the category bits of a food item.
+     *
+     * Only the first 64 categories (in name order) have a bit; foods of further
+     * categories have to be matched through a FoodMask instead.
+     *
+     * @param index The index of the food item.
+     * @return The category mask of the food item.
+     */
+    std::uint64_t categoryMask(size_t index) const;
+
+    /**
+     * @brief Looks up the bit of a category.
+     * @param category The category name.
+     * @param bit Receives the category bit, or 0 if the category has no bit.
+     * @return True if the category is in the catalog, false otherwise.
+     */
+    bool findCategoryBit(const std::string& category, std::uint64_t& bit) const;
+
+    /**
+     * @brief Gets the number of nutrient columns, the four macros included.
+     * @return The number of nutrients.
+     */
+    size_t nutrientCount() const;
+
+    /**
+     * @brief Gets the name of a nutrient column.
+     * @param nutrient The column index; the first MACRO_COUNT columns are the macros.
+     * @return The nutrient name.
+     */
+    const std::string& nutrientName(size_t nutrient) const;
+
+    /**
+     * @brief Builds the dense portion vector of a plan for nutrientTotals.
+     * @param meals The meals of the plan.
+     * @return Grams of every catalog food in the plan, zero for the others.
+     */
+    std::vector<float> portionVector(const std::map<std::string, std::vector<std::pair<FoodItem, float>>>& meals) const;
+
+    /**
+     * @brief Calculates the nutrient totals of a portion vector, in one pass over every catalog food per nutrient.
+     * @param portions The portion vector, see portionVector.
+     * @param totals Receives nutrientCount() totals.
+     */
+    void nutrientTotals(const std::vector<float>& portions, float* totals) const;
+
+    /**
+     * @brief Calculates the category and food masks of a nutrition plan.
+     * @param meals The meals of the plan.
+     * @return The masks of the plan.
+     */
+    PlanMask planMask(const std::map<std::string, std::vector<std::pair<FoodItem, float>>>& meals) const;
+
+    /**
+     * @brief Suggests catalog foods to use instead of a food.
+     * @param foodItem The food to replace.
+     * @param grams The portion of the food to replace.
+     * @param count Maximum number of suggestions.
+     * @param isAllowed Returns true for catalog indices that may be suggested.
+     * @return The suggestions, closest macro profile first.
+     */
+    std::vector<Substitute> suggestSubstitutes(const FoodItem& foodItem, float grams, size_t count, const std::function<bool(size_t)>& isAllowed) const;
+
+private:
+    std::vector<FoodItem> items; ///< Food items in name order.
+    std::vector<float> macroTable; ///< Per-gram macros, MACRO_COUNT values per food item.
+    std::map<std::string, size_t> indexByName; ///< Food item name to index.
+    std::map<std::string, std::vector<size_t>> indicesByCategory; ///< Category to food item indices.
+    std::map<std::string, std::uint64_t> categoryBits; ///< Category to its bit (0 past the 64th category).
+    std::vector<std::uint64_t> categoryMasks; ///< Category bits of each food item.
+    std::vector<std::string> nutrientNames; ///< Name of each nutrient column.
+    std::vector<float> nutrientMatrix; ///< Per-gram nutrients, one column of foodStride values per nutrient.
+    size_t foodStride = 0; ///< Number of foods rounded up to a multiple of the kernel width.
+    MacroKdTree profileTree; ///< Nearest neighbour index over the macro profiles of the foods.
+    std::map<std::string, MacroKdTree> categoryTrees; ///< Nearest neighbour index over the macro profiles of the foods of each category.
+};
+
+#endif // FOOD_CATALOG_H
@@ -1,4 +1,5 @@
 #include "FoodItem.h"
+#include "Nutrients.h"
 
 /**
  * @brief Serializes the food item to a CSV stream.
@@ -12,7 +13,12 @@ void FoodItem::toCSV(std::ostream& os) const
     {
         os << category << ";";
     }
-    os << "," << calories << "," << protein << "," << carbohydrates << "," << fats << "," << portion << "\n";
+    os << "," << calories << "," << protein << "," << carbohydrates << "," << fats << "," << portion;
+    for (const auto& nutrient : nutrients)
+    {
+        os << "," << nutrient.first << "=" << nutrient.second;
+    }
+    os << "\n";
 }
 
 /**
@@ -27,7 +33,7 @@ bool FoodItem::fromCSV(std::istream& is)
     if (std::getline(is, name, ',') && std::getline(is, categoriesStr, ',') &&
         std::getline(is, calStr, ',') && std::getline(is, proteinStr, ',') &&
         std::getline(is, carbStr, ',') && std::getline(is, fatsStr, ',') &&
-        std::getline(is, portionStr))
+        std::getline(is, portionStr, ','))
     {
         std::stringstream ss(categoriesStr);
         std::string category;
@@ -41,6 +47,18 @@ bool FoodItem::fromCSV(std::istream& is)
         carbohydrates = std::stof(carbStr);
         fats = std::stof(fatsStr);
         portion = std::stof(portionStr);
+
+        // Optional nutrient columns, files without them end after the portion size
+        std::string field;
+        while (std::getline(is, field, ','))
+        {
+            std::string nutrientName;
+            float amount;
+            if (parseNutrientField(field, nutrientName, amount))
+            {
+                nutrients[nutrientName] = amount;
+            }
+        }
         return true;
     }
     return false;
@@ -58,5 +76,9 @@ void FoodItem::displayNutritionalValues(float quantity) const
     std::cout << "Protein: " << (protein * quantity / 100) << " g\n";
     std::cout << "Carbohydrates: " << (carbohydrates * quantity / 100) << " g\n";
     std::cout << "Fats: " << (fats * quantity / 100) << " g\n";
+    for (const auto& nutrient : nutrients)
+    {
+        std::cout << nutrient.first << ": " << (nutrient.second * quantity / 100) << " " << nutrientUnit(nutrient.first) << "\n";
+    }
     std::cout << "Portion size: " << portion << " grams\n";
 }
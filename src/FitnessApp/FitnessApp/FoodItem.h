@@ -6,6 +6,7 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <map>
 
 /**
  * @brief Class representing a food item with nutritional information.
@@ -20,6 +21,7 @@ public:
     float carbohydrates = 0; ///< Carbohydrate content per 100 grams.
     float fats = 0; ///< Fat content per 100 grams.
     float portion = 0; ///< Portion size in grams.
+    std::map<std::string, float> nutrients; ///< Optional further nutrients per 100 grams (fiber, sodium, vitamins...), keyed by lower case name.
 
     /**
      * @brief Default constructor.
@@ -45,6 +47,8 @@ public:
     /**
      * @brief Serializes the food item to a CSV stream.
      *
+     * Nutrients are written as additional "name=value" columns after the portion size.
+     *
      * @param os Output stream to write to.
      */
     void toCSV(std::ostream& os) const;
@@ -52,6 +56,8 @@ public:
     /**
      * @brief Parses a food item from a CSV stream.
      *
+     * Any number of "name=value" nutrient columns may follow the portion size.
+     *
      * @param is Input stream to read from.
      * @return True if parsing was successful, false otherwise.
      */
@@ -0,0 +1,46 @@
+#ifndef FOOD_OBSERVER_H
+#define FOOD_OBSERVER_H
+
+#include <string>
+#include <vector>
+#include "FoodItem.h"
+
+/**
+ * @brief Receives changes to the food items, so that data referring to them can follow.
+ */
+class FoodObserver
+{
+public:
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~FoodObserver() = default;
+
+    /**
+     * @brief Called after a food item was renamed.
+     * @param oldName The previous name.
+     * @param foodItem The food item under its new name.
+     */
+    virtual void foodRenamed(const std::string& oldName, const FoodItem& foodItem) = 0;
+
+    /**
+     * @brief Called after a food item was added or its values changed.
+     * @param foodItem The food item.
+     */
+    virtual void foodModified(const FoodItem& foodItem) = 0;
+
+    /**
+     * @brief Called after a food item was deleted.
+     * @param name The name of the deleted food item.
+     */
+    virtual void foodRemoved(const std::string& name) = 0;
+
+    /**
+     * @brief Lists what refers to a food item.
+     * @param name The food name.
+     * @return A description of every user of the food item.
+     */
+    virtual std::vector<std::string> usersOf(const std::string& name) const = 0;
+};
+
+#endif // FOOD_OBSERVER_H
@@ -0,0 +1,182 @@
+#include "FoodUsageIndex.h"
+#include <algorithm>
+
+/**
+ * @brief Replaces the index with the entries of the given plans.
+ * @param plans The plans by name.
+ */
+void FoodUsageIndex::build(const std::map<std::string, NutritionPlan>& plans)
+{
+    occurrences.clear();
+    for (const auto& pair : plans)
+    {
+        indexPlan(pair.second);
+    }
+}
+
+/**
+ * @brief Adds the entries of a plan.
+ * @param plan The plan, which must not be indexed yet.
+ */
+void FoodUsageIndex::indexPlan(const NutritionPlan& plan)
+{
+    for (const auto& meal : plan.meals)
+    {
+        indexMeal(plan.name, meal.first, meal.second);
+    }
+}
+
+/**
+ * @brief Removes the entries of a plan.
+ * @param plan The plan as it was indexed.
+ */
+void FoodUsageIndex::removePlan(const NutritionPlan& plan)
+{
+    for (const auto& meal : plan.meals)
+    {
+        removeMeal(plan.name, meal.first, meal.second);
+    }
+}
+
+/**
+ * @brief Gets the uses of a food.
+ * @param name The food name.
+ * @return The occurrences of the food.
+ */
+const std::vector<FoodUsageIndex::Occurrence>& FoodUsageIndex::find(const std::string& name) const
+{
+    static const std::vector<Occurrence> none;
+    auto it = occurrences.find(name);
+    return it != occurrences.end() ? it->second : none;
+}
+
+/**
+ * @brief Gets the plans that use a food.
+ * @param name The food name.
+ * @return The names of the plans.
+ */
+std::set<std::string> FoodUsageIndex::plansUsing(const std::string& name) const
+{
+    std::set<std::string> plans;
+    for (const auto& occurrence : find(name))
+    {
+        plans.insert(occurrence.plan);
+    }
+    return plans;
+}
+
+/**
+ * @brief Renames a food in every entry that uses it.
+ * @param plans The indexed plans, updated in place.
+ * @param oldName The previous food name.
+ * @param foodItem The food item under its new name.
+ * @return The names of the plans that changed.
+ */
+std::set<std::string> FoodUsageIndex::renameFood(std::map<std::string, NutritionPlan>& plans, const std::string& oldName, const FoodItem& foodItem)
+{
+    auto it = occurrences.find(oldName);
+    if (it == occurrences.end() || oldName == foodItem.name)
+    {
+        return updateFood(plans, foodItem);
+    }
+
+    // Positions do not change, so the occurrences move to the new name as they are; a food
+    // already using the new name is replaced, so its entries are updated as well
+    std::vector<Occurrence> moved = std::move(it->second);
+    occurrences.erase(it);
+    auto& target = occurrences[foodItem.name];
+    target.insert(target.end(), moved.begin(), moved.end());
+    return updateFood(plans, foodItem);
+}
+
+/**
+ * @brief Replaces the copy of a food in every entry that uses it.
+ * @param plans The indexed plans, updated in place.
+ * @param foodItem The new values of the food item.
+ * @return The names of the plans that changed.
+ */
+std::set<std::string> FoodUsageIndex::updateFood(std::map<std::string, NutritionPlan>& plans, const FoodItem& foodItem)
+{
+    std::set<std::string> touched;
+    for (const auto& occurrence : find(foodItem.name))
+    {
+        plans.at(occurrence.plan).meals.at(occurrence.meal)[occurrence.position].first = foodItem;
+        touched.insert(occurrence.plan);
+    }
+    return touched;
+}
+
+/**
+ * @brief Removes a food from every meal that uses it.
+ *
+ * Entries after a removed one move up, so the affected meals are re-indexed as a whole.
+ *
+ * @param plans The indexed plans, updated in place.
+ * @param name The food name.
+ * @return The names of the plans that changed.
+ */
+std::set<std::string> FoodUsageIndex::removeFood(std::map<std::string, NutritionPlan>& plans, const std::string& name)
+{
+    std::set<std::pair<std::string, std::string>> meals;
+    for (const auto& occurrence : find(name))
+    {
+        meals.insert({ occurrence.plan, occurrence.meal });
+    }
+
+    std::set<std::string> touched;
+    for (const auto& meal : meals)
+    {
+        auto& mealItems = plans.at(meal.first).meals.at(meal.second);
+        removeMeal(meal.first, meal.second, mealItems);
+        mealItems.erase(std::remove_if(mealItems.begin(), mealItems.end(),
+            [&](const std::pair<FoodItem, float>& foodPair) { return foodPair.first.name == name; }), mealItems.end());
+        indexMeal(meal.first, meal.second, mealItems);
+        touched.insert(meal.first);
+    }
+    return touched;
+}
+
+/**
+ * @brief Adds the entries of one meal.
+ * @param planName The plan name.
+ * @param mealName The meal name.
+ * @param mealItems The entries of the meal.
+ */
+void FoodUsageIndex::indexMeal(const std::string& planName, const std::string& mealName, const std::vector<std::pair<FoodItem, float>>& mealItems)
+{
+    for (size_t position = 0; position < mealItems.size(); ++position)
+    {
+        occurrences[mealItems[position].first.name].push_back({ planName, mealName, position });
+    }
+}
+
+/**
+ * @brief Removes the entries of one meal.
+ * @param planName The plan name.
+ * @param mealName The meal name.
+ * @param mealItems The entries of the meal as they were indexed.
+ */
+void FoodUsageIndex::removeMeal(const std::string& planName, const std::string& mealName, const std::vector<std::pair<FoodItem, float>>& mealItems)
+{
+    std::set<std::string> names;
+    for (const auto& foodPair : mealItems)
+    {
+        names.insert(foodPair.first.name);
+    }
+
+    for (const auto& name : names)
+    {
+        auto it = occurrences.find(name);
+        if (it == occurrences.end())
+        {
+            continue;
+        }
+        auto& list = it->second;
+        list.erase(std::remove_if(list.begin(), list.end(),
+            [&](const Occurrence& occurrence) { return occurrence.plan == planName && occurrence.meal == mealName; }), list.end());
+        if (list.empty())
+        {
+            occurrences.erase(it);
+        }
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef FOOD_USAGE_INDEX_H
+#define FOOD_USAGE_INDEX_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "FoodItem.h"
+#include "NutritionPlan.h"
+
+/**
+ * @brief Reverse index from food names to the plan entries that use them.
+ *
+ * Every entry is addressed by plan, meal and position within the meal, so a change to a food
+ * touches exactly the entries listed for it instead of scanning every plan. The index has to
+ * be told about every plan mutation through indexPlan() and removePlan().
+ */
+class FoodUsageIndex
+{
+public:
+    /**
+     * @brief One use of a food in a plan.
+     */
+    struct Occurrence
+    {
+        std::string plan; ///< Name of the plan.
+        std::string meal; ///< Name of the meal.
+        size_t position; ///< Index of the entry within the meal.
+    };
+
+    /**
+     * @brief Replaces the index with the entries of the given plans.
+     * @param plans The plans by name.
+     */
+    void build(const std::map<std::string, NutritionPlan>& plans);
+
+    /**
+     * @brief Adds the entries of a plan.
+     * @param plan The plan, which must not be indexed yet.
+     */
+    void indexPlan(const NutritionPlan& plan);
+
+    /**
+     * @brief Removes the entries of a plan.
+     * @param plan The plan as it was indexed.
+     */
+    void removePlan(const NutritionPlan& plan);
+
+    /**
+     * @brief Gets the uses of a food.
+     * @param name The food name.
+     * @return The occurrences of the food.
+     */
+    const std::vector<Occurrence>& find(const std::string& name) const;
+
+    /**
+     * @brief Gets the plans that use a food.
+     * @param name The food name.
+     * @return The names of the plans.
+     */
+    std::set<std::string> plansUsing(const std::string& name) const;
+
+    /**
+     * @brief Renames a food in every entry that uses it.
+     * @param plans The indexed plans, updated in place.
+     * @param oldName The previous food name.
+     * @param foodItem The food item under its new name.
+     * @return The names of the plans that changed.
+     */
+    std::set<std::string> renameFood(std::map<std::string, NutritionPlan>& plans, const std::string& oldName, const FoodItem& foodItem);
+
+    /**
+     * @brief Replaces the copy of a food in every entry that uses it.
+     * @param plans The indexed plans, updated in place.
+     * @param foodItem The new values of the food item.
+     * @return The names of the plans that changed.
+     */
+    std::set<std::string> updateFood(std::map<std::string, NutritionPlan>& plans, const FoodItem& foodItem);
+
+    /**
+     * @brief Removes a food from every meal that uses it.
+     * @param plans The indexed plans, updated in place.
+     * @param name The food name.
+     * @return The names of the plans that changed.
+     */
+    std::set<std::string> removeFood(std::map<std::string, NutritionPlan>& plans, const std::string& name);
+
+private:
+    /**
+     * @brief Adds the entries of one meal.
+     * @param planName The plan name.
+     * @param mealName The meal name.
+     * @param mealItems The entries of the meal.
+     */
+    void indexMeal(const std::string& planName, const std::string& mealName, const std::vector<std::pair<FoodItem, float>>& mealItems);
+
+    /**
+     * @brief Removes the entries of one meal.
+     * @param planName The plan name.
+     * @param mealName The meal name.
+     * @param mealItems The entries of the meal as they were indexed.
+     */
+    void removeMeal(const std::string& planName, const std::string& mealName, const std::vector<std::pair<FoodItem, float>>& mealItems);
+
+    std::unordered_map<std::string, std::vector<Occurrence>> occurrences; ///< Food name to its uses.
+};
+
+#endif // FOOD_USAGE_INDEX_H
@@ -1,16 +1,19 @@
 #include "FoodViewModel.h"
 #include "Utils.h"
+#include "Nutrients.h"
 #include <iostream>
 #include <set>
+#include <algorithm>
 
 /**
  * @brief Construct a new FoodViewModel::FoodViewModel object
  *
  * @param file The filename to read food items from
  */
-FoodViewModel::FoodViewModel(const std::string& file) : filename(file)
+FoodViewModel::FoodViewModel(const std::string& file) : filename(file), recipeBook("recipes.csv")
 {
     foodItemMap = readFromCSV<FoodItem>(filename);
+    refreshRecipes("");
 }
 
 /**
@@ -42,7 +45,21 @@ void FoodViewModel::displayFoodItem(const FoodItem& foodItem) const
     displayCategoriesOfFoodItem(foodItem);
     std::cout << ", Calories: " << foodItem.calories
         << " kcal, Protein: " << foodItem.protein << " g, Carbohydrates: "
-        << foodItem.carbohydrates << " g, Fats: " << foodItem.fats << " g, Portion: " << foodItem.portion << " g\n";
+        << foodItem.carbohydrates << " g, Fats: " << foodItem.fats << " g, Portion: " << foodItem.portion << " g";
+    for (const auto& nutrient : foodItem.nutrients)
+    {
+        std::cout << ", " << nutrient.first << ": " << nutrient.second << " " << nutrientUnit(nutrient.first);
+    }
+    const Recipe* recipe = recipeBook.find(foodItem.name);
+    if (recipe != nullptr)
+    {
+        std::cout << ", Ingredients: ";
+        for (size_t i = 0; i < recipe->ingredients.size(); ++i)
+        {
+            std::cout << (i > 0 ? "; " : "") << recipe->ingredients[i].first << " " << recipe->ingredients[i].second << " g";
+        }
+    }
+    std::cout << "\n";
 }
 
 /**
@@ -155,9 +172,37 @@ void FoodViewModel::add()
         return;
     }
 
+    std::string recipeChoice;
+    do
+    {
+        std::cout << "Is this a recipe made of other food items? (yes/no): ";
+        std::getline(std::cin, recipeChoice);
+    } while (recipeChoice != "yes" && recipeChoice != "no");
+
     FoodItem foodItem;
 
     foodItem.name = name;
+    if (recipeChoice == "yes")
+    {
+        // The values of a recipe are derived from its ingredients
+        foodItem.categories.insert("recipe");
+        modifyCategories(foodItem);
+
+        Recipe recipe;
+        recipe.name = name;
+        while (!modifyIngredients(recipe, "Enter ingredients as name=grams separated by ';': "))
+        {
+            std::cout << "A recipe needs at least one ingredient.\n";
+        }
+        foodItem.portion = recipe.totalGrams();
+        getOptionalInput(foodItem.portion, "Enter portion size in grams (or press enter for the whole recipe): ");
+
+        recipeBook.setRecipe(recipe);
+        foodItemMap[name] = foodItem;
+        refreshRecipes(name);
+        return;
+    }
+
     modifyCategories(foodItem);
 
     getValidInput(foodItem.calories, "Enter calories per 100 grams: ");
@@ -165,9 +210,18 @@ void FoodViewModel::add()
     getValidInput(foodItem.carbohydrates, "Enter carbohydrates per 100 grams: ");
     getValidInput(foodItem.fats, "Enter fats per 100 grams: ");
     getOptionalInput(foodItem.portion, "Enter portion size in grams (or press enter to skip): ");
+    modifyNutrients(foodItem, "Enter other nutrients per 100 grams as name=value separated by ';' (or press enter to skip): ");
 
     foodItemMap[name] = foodItem;
     writeToCSV(filename, foodItem);
+    for (auto observer : observers)
+    {
+        observer->foodModified(foodItem);
+    }
+
+    // A plain food replacing a recipe of the same name
+    recipeBook.removeRecipe(name);
+    refreshRecipes(name);
 }
 
 /**
@@ -220,6 +274,7 @@ void FoodViewModel::modifyCategories(FoodItem& foodItem)
  */
 void FoodViewModel::handleFoodModification(FoodItem& foodItem)
 {
+    const Recipe* recipe = recipeBook.find(foodItem.name);
     std::string newName;
     std::cout << "Enter new food name (or press enter to keep current): ";
     std::getline(std::cin, newName);
@@ -230,11 +285,171 @@ void FoodViewModel::handleFoodModification(FoodItem& foodItem)
 
     modifyCategories(foodItem);
 
+    if (recipe != nullptr)
+    {
+        // The values of a recipe are derived from its ingredients
+        Recipe modified = *recipe;
+        if (modifyIngredients(modified, "Enter new ingredients as name=grams separated by ';' (or press enter to keep current): "))
+        {
+            recipeBook.setRecipe(modified);
+        }
+        getOptionalInput(foodItem.portion, "Enter new portion size in grams (or press enter to keep current): ");
+        return;
+    }
+
     getOptionalInput(foodItem.calories, "Enter new calories per 100 grams (or press enter to keep current): ");
     getOptionalInput(foodItem.protein, "Enter new protein per 100 grams (or press enter to keep current): ");
     getOptionalInput(foodItem.carbohydrates, "Enter new carbohydrates per 100 grams (or press enter to keep current): ");
     getOptionalInput(foodItem.fats, "Enter new fats per 100 grams (or press enter to keep current): ");
     getOptionalInput(foodItem.portion, "Enter new portion size in grams (or press enter to keep current): ");
+    modifyNutrients(foodItem, "Enter other nutrients per 100 grams as name=value separated by ';', 0 removes a nutrient (or press enter to keep current): ");
+}
+
+/**
+ * @brief Read nutrients beyond the four macros for a food item
+ *
+ * @param foodItem The food item whose nutrients will be modified
+ * @param prompt The prompt to display
+ */
+void FoodViewModel::modifyNutrients(FoodItem& foodItem, const std::string& prompt)
+{
+    while (true)
+    {
+        std::string input;
+        std::cout << prompt;
+        std::getline(std::cin, input);
+        if (input.empty())
+        {
+            return;
+        }
+
+        std::map<std::string, float> entered;
+        std::stringstream ss(input);
+        std::string field;
+        bool valid = true;
+        while (std::getline(ss, field, ';'))
+        {
+            std::string name;
+            float value;
+            if (!parseNutrientField(field, name, value))
+            {
+                std::cout << "Invalid nutrient '" << field << "'. ";
+                valid = false;
+                break;
+            }
+            entered[name] = value;
+        }
+        if (!valid)
+        {
+            continue;
+        }
+
+        for (const auto& nutrient : entered)
+        {
+            if (nutrient.second == 0)
+            {
+                foodItem.nutrients.erase(nutrient.first);
+            }
+            else
+            {
+                foodItem.nutrients[nutrient.first] = nutrient.second;
+            }
+        }
+        return;
+    }
+}
+
+/**
+ * @brief Read the ingredients of a recipe
+ *
+ * @param recipe The recipe whose ingredients will be replaced
+ * @param prompt The prompt to display
+ * @return True if new ingredients were entered, false if the input was skipped
+ */
+bool FoodViewModel::modifyIngredients(Recipe& recipe, const std::string& prompt)
+{
+    while (true)
+    {
+        std::string input;
+        std::cout << prompt;
+        std::getline(std::cin, input);
+        if (input.empty())
+        {
+            return false;
+        }
+
+        Recipe entered;
+        entered.name = recipe.name;
+        std::stringstream ss(input);
+        std::string field;
+        bool valid = true;
+        while (std::getline(ss, field, ';'))
+        {
+            size_t separator = field.rfind('=');
+            size_t first = field.find_first_not_of(" \t");
+            float grams;
+            if (separator == std::string::npos || first >= separator || !stringToFloat(field.substr(separator + 1), grams))
+            {
+                std::cout << "Invalid ingredient '" << field << "'. ";
+                valid = false;
+                break;
+            }
+            size_t last = field.find_last_not_of(" \t", separator - 1);
+            entered.ingredients.emplace_back(field.substr(first, last - first + 1), grams);
+        }
+        if (!valid)
+        {
+            continue;
+        }
+
+        std::string error;
+        if (!recipeBook.validate(entered, foodItemMap, error))
+        {
+            std::cout << error << " ";
+            continue;
+        }
+
+        recipe = entered;
+        return true;
+    }
+}
+
+/**
+ * @brief Recompute the recipes affected by a change and save the food items if any changed
+ *
+ * @param changedName The food item that was added, modified or removed, or an empty string after a reload
+ */
+void FoodViewModel::refreshRecipes(const std::string& changedName)
+{
+    if (!changedName.empty())
+    {
+        recipeBook.invalidate(changedName);
+    }
+
+    std::vector<std::string> changed = recipeBook.refresh(foodItemMap);
+    if (changed.empty())
+    {
+        return;
+    }
+    overwriteCSV(filename, foodItemMap);
+    for (const auto& name : changed)
+    {
+        for (auto observer : observers)
+        {
+            observer->foodModified(foodItemMap[name]);
+        }
+    }
+
+    changed.erase(std::remove(changed.begin(), changed.end(), changedName), changed.end());
+    if (!changedName.empty() && !changed.empty())
+    {
+        std::cout << "Recipes updated:";
+        for (const auto& name : changed)
+        {
+            std::cout << " " << name << ";";
+        }
+        std::cout << "\n";
+    }
 }
 
 /**
@@ -290,8 +505,39 @@ void FoodViewModel::modify()
         return;
     }
 
-    handleFoodModification(foodItemMap[names[choice - 1]]);
+    // Work on a copy, so a renamed food item is stored under its new name
+    const std::string oldName = names[choice - 1];
+    FoodItem foodItem = foodItemMap[oldName];
+    handleFoodModification(foodItem);
+    bool renamed = false;
+    if (foodItem.name != oldName)
+    {
+        if (confirmOverwrite(foodItemMap, foodItem.name))
+        {
+            foodItemMap.erase(oldName);
+            recipeBook.renameFood(oldName, foodItem.name);
+            renamed = true;
+        }
+        else
+        {
+            foodItem.name = oldName;
+        }
+    }
+    foodItemMap[foodItem.name] = foodItem;
+
     overwriteCSV(filename, foodItemMap);
+    for (auto observer : observers)
+    {
+        if (renamed)
+        {
+            observer->foodRenamed(oldName, foodItem);
+        }
+        else
+        {
+            observer->foodModified(foodItem);
+        }
+    }
+    refreshRecipes(foodItem.name);
     std::cout << "Food modified.\n";
 }
 
@@ -302,6 +548,34 @@ void FoodViewModel::modify()
  */
 void FoodViewModel::confirmAndDeleteFoodItem(const std::string& name)
 {
+    std::set<std::string> recipes = recipeBook.dependentsOf(name);
+    if (!recipes.empty())
+    {
+        std::cout << name << " is an ingredient of:";
+        for (const auto& recipe : recipes)
+        {
+            std::cout << " " << recipe << ";";
+        }
+        std::cout << "\nRemove it from these recipes before deleting it.\n";
+        return;
+    }
+
+    std::vector<std::string> users;
+    for (auto observer : observers)
+    {
+        auto observerUsers = observer->usersOf(name);
+        users.insert(users.end(), observerUsers.begin(), observerUsers.end());
+    }
+    if (!users.empty())
+    {
+        std::cout << name << " is used by:";
+        for (const auto& user : users)
+        {
+            std::cout << " " << user << ";";
+        }
+        std::cout << "\nDeleting it removes it from these plans.\n";
+    }
+
     const auto& foodItem = foodItemMap[name];
     std::string confirm;
     do
@@ -317,7 +591,12 @@ void FoodViewModel::confirmAndDeleteFoodItem(const std::string& name)
     if (confirm == "yes")
     {
         foodItemMap.erase(name);
+        recipeBook.removeRecipe(name);
         overwriteCSV(filename, foodItemMap);
+        for (auto observer : observers)
+        {
+            observer->foodRemoved(name);
+        }
         std::cout << "Food item deleted.\n";
     }
     else
@@ -423,6 +702,7 @@ void FoodViewModel::remove()
 void FoodViewModel::importFromFile(const std::string& filename)
 {
     auto items = readFromCSV<FoodItem>(filename);
+    std::vector<std::string> imported;
     for (const auto& item : items)
     {
         auto it = foodItemMap.find(item.first);
@@ -459,17 +739,26 @@ void FoodViewModel::importFromFile(const std::string& filename)
                 std::getline(std::cin >> std::ws, choice);
             } while (choice != "yes" && choice != "no");
 
-            if (choice == "yes")
+            if (choice != "yes")
             {
-                foodItemMap[item.first] = newFoodItem;
+                continue;
             }
         }
-        else
+        foodItemMap[item.first] = item.second;
+        imported.push_back(item.first);
+        recipeBook.invalidate(item.first);
+        // A plain food replacing a recipe of the same name, as in add()
+        recipeBook.removeRecipe(item.first);
+    }
+    overwriteCSV("food_items.csv", foodItemMap);
+    for (const auto& name : imported)
+    {
+        for (auto observer : observers)
         {
-            foodItemMap[item.first] = item.second;
+            observer->foodModified(foodItemMap[name]);
         }
     }
-    overwriteCSV("food_items.csv", foodItemMap);
+    refreshRecipes("");
 }
 
 /**
@@ -478,4 +767,15 @@ void FoodViewModel::importFromFile(const std::string& filename)
 void FoodViewModel::reload()
 {
     foodItemMap = readFromCSV<FoodItem>(filename);
+    refreshRecipes("");
+}
+
+/**
+ * @brief Register an observer to be notified of changes to the food items
+ *
+ * @param observer The observer, which must outlive this view model
+ */
+void FoodViewModel::addObserver(FoodObserver* observer)
+{
+    observers.push_back(observer);
 }
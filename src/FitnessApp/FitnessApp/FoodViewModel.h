@@ -3,7 +3,10 @@
 
 #include "ViewModel.h"
 #include "FoodItem.h"
+#include "RecipeBook.h"
+#include "FoodObserver.h"
 #include <map>
+#include <vector>
 
 /**
  * @class FoodViewModel
@@ -68,9 +71,18 @@ public:
      */
     void reload() override;
 
+    /**
+     * @brief Register an observer to be notified of changes to the food items.
+     *
+     * @param observer The observer, which must outlive this view model.
+     */
+    void addObserver(FoodObserver* observer);
+
 private:
     std::string filename; ///< The filename containing the food items.
     std::map<std::string, FoodItem> foodItemMap; ///< Map to store food items.
+    RecipeBook recipeBook; ///< Recipes whose values are derived from other food items.
+    std::vector<FoodObserver*> observers; ///< Notified after food items are renamed, modified or deleted.
 
     /**
      * @brief Display the categories of a given food item.
@@ -119,6 +131,30 @@ private:
      */
     void handleFoodModification(FoodItem& foodItem);
 
+    /**
+     * @brief Read nutrients beyond the four macros for a food item.
+     *
+     * @param foodItem The food item whose nutrients will be modified.
+     * @param prompt The prompt to display.
+     */
+    void modifyNutrients(FoodItem& foodItem, const std::string& prompt);
+
+    /**
+     * @brief Read the ingredients of a recipe.
+     *
+     * @param recipe The recipe whose ingredients will be replaced.
+     * @param prompt The prompt to display.
+     * @return True if new ingredients were entered, false if the input was skipped.
+     */
+    bool modifyIngredients(Recipe& recipe, const std::string& prompt);
+
+    /**
+     * @brief Recompute the recipes affected by a change and save the food items if any changed.
+     *
+     * @param changedName The food item that was added, modified or removed, or an empty string after a reload.
+     */
+    void refreshRecipes(const std::string& changedName);
+
     /**
      * @brief Handle the deletion of food items.
      *
@@ -0,0 +1,367 @@
+#include "GenerationTelemetry.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+    const char* const macroNames[FoodCatalog::MACRO_COUNT] = { "calories", "protein", "carbs", "fats" };
+
+    /**
+     * @brief Writes a string as a quoted JSON string.
+     * @param os The stream to write to.
+     * @param text The string.
+     */
+    void writeJSONString(std::ostream& os, const std::string& text)
+    {
+        os << '"';
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+                }
+                else
+                {
+                    os << c;
+                }
+            }
+        }
+        os << '"';
+    }
+
+    /**
+     * @brief Writes a histogram as a JSON object with its bounds and counts.
+     * @param os The stream to write to.
+     * @param histogram The histogram.
+     */
+    void writeJSONHistogram(std::ostream& os, const GenerationTelemetry::Histogram& histogram)
+    {
+        os << "{\"upperBounds\": [";
+        for (size_t i = 0; i < histogram.upperBounds.size(); ++i)
+        {
+            os << (i > 0 ? ", " : "") << histogram.upperBounds[i];
+        }
+        os << "], \"counts\": [";
+        for (size_t i = 0; i < histogram.counts.size(); ++i)
+        {
+            os << (i > 0 ? ", " : "") << histogram.counts[i];
+        }
+        os << "]}";
+    }
+
+    /**
+     * @brief Prints a histogram as one line of "bucket: count" entries.
+     * @param os The stream to print to.
+     * @param label Label in front of the line.
+     * @param histogram The histogram.
+     */
+    void printHistogram(std::ostream& os, const std::string& label, const GenerationTelemetry::Histogram& histogram)
+    {
+        os << "  " << std::left << std::setw(14) << label << std::right;
+        for (size_t i = 0; i < histogram.counts.size(); ++i)
+        {
+            if (i < histogram.upperBounds.size())
+            {
+                os << " <=" << histogram.upperBounds[i];
+            }
+            else
+            {
+                os << " >" << histogram.upperBounds.back();
+            }
+            os << ": " << histogram.counts[i];
+        }
+        os << std::endl;
+    }
+}
+
+/**
+ * @brief Stores how far a finished plan is from its targets.
+ * @param plan The finished plan.
+ * @param targets The macro targets of the plan.
+ */
+void GenerationRecord::setResult(const NutritionPlan& plan, const MacroTargets& targets)
+{
+    float totals[FoodCatalog::MACRO_COUNT];
+    MacroTargets::planTotals(plan, totals);
+    for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+    {
+        residuals[m] = totals[m] - targets.amounts[m];
+        toleranceUnits[m] = std::abs(residuals[m]) / (std::max(targets.amounts[m], 1.0f) * targets.tolerances[m]);
+    }
+    withinTolerance = targets.isWithinTolerance(totals);
+}
+
+/**
+ * @brief Default constructor, creates a histogram with a single bucket.
+ */
+GenerationTelemetry::Histogram::Histogram() : counts(1, 0)
+{
+}
+
+/**
+ * @brief Creates an empty histogram.
+ * @param upperBounds Inclusive upper bounds of the buckets, in increasing order.
+ */
+GenerationTelemetry::Histogram::Histogram(std::vector<double> upperBounds)
+    : upperBounds(std::move(upperBounds)), counts(this->upperBounds.size() + 1, 0)
+{
+}
+
+/**
+ * @brief Counts a value.
+ * @param value The value.
+ */
+void GenerationTelemetry::Histogram::add(double value)
+{
+    size_t bucket = std::lower_bound(upperBounds.begin(), upperBounds.end(), value) - upperBounds.begin();
+    counts[bucket]++;
+}
+
+/**
+ * @brief Constructs an empty telemetry.
+ * @param maxRecords Number of most recent records kept in full.
+ */
+GenerationTelemetry::GenerationTelemetry(size_t maxRecords)
+    : maxRecords(maxRecords), totalMilliseconds({ 1, 5, 10, 50, 100, 500 })
+{
+    for (auto& histogram : residuals)
+    {
+        // Residuals are measured in tolerance units, so everything up to 1 is within tolerance
+        histogram = Histogram({ 0.1, 0.25, 0.5, 1, 2, 5 });
+    }
+}
+
+/**
+ * @brief Adds the record of a finished generation.
+ * @param record The record.
+ */
+void GenerationTelemetry::add(const GenerationRecord& record)
+{
+    generationCount++;
+    templateCounts[record.templateName]++;
+    if (record.cacheHit)
+    {
+        cacheHits++;
+    }
+    else if (record.withinTolerance)
+    {
+        withinTolerance++;
+    }
+    totalMilliseconds.add(record.milliseconds);
+
+    for (const auto& phase : record.phases)
+    {
+        auto found = phases.find(phase.name);
+        if (found == phases.end())
+        {
+            PhaseStats stats;
+            stats.iterations = Histogram({ 1, 2, 5, 10, 20, 50, 100, 500, 1000 });
+            stats.milliseconds = Histogram({ 0.01, 0.1, 1, 10, 100 });
+            found = phases.emplace(phase.name, stats).first;
+            phaseOrder.push_back(phase.name);
+        }
+
+        PhaseStats& stats = found->second;
+        stats.runs++;
+        if (phase.iterationLimit > 0 && phase.iterations >= phase.iterationLimit)
+        {
+            stats.limitHits++;
+        }
+        stats.totalMilliseconds += phase.milliseconds;
+        stats.iterations.add(phase.iterations);
+        stats.milliseconds.add(phase.milliseconds);
+    }
+
+    // A cached plan was already counted when it was generated
+    if (!record.cacheHit)
+    {
+        for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+        {
+            residuals[m].add(record.toleranceUnits[m]);
+        }
+    }
+
+    records.push_back(record);
+    if (records.size() > maxRecords)
+    {
+        records.pop_front();
+    }
+}
+
+/**
+ * @brief Gets the number of generations recorded.
+ * @return The number of generations.
+ */
+size_t GenerationTelemetry::getGenerationCount() const
+{
+    return generationCount;
+}
+
+/**
+ * @brief Prints the aggregated histograms.
+ * @param os The stream to print to.
+ */
+void GenerationTelemetry::printReport(std::ostream& os) const
+{
+    // The caller may have left the stream in fixed notation
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os.unsetf(std::ios::floatfield);
+    os.precision(6);
+
+    os << "Generations: " << generationCount << " (" << cacheHits << " from cache), "
+        << withinTolerance << " of " << generationCount - cacheHits << " generated plans within tolerance" << std::endl;
+    if (generationCount > 0)
+    {
+        printDetails(os);
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+/**
+ * @brief Prints the histograms of the phases, residuals and templates.
+ * @param os The stream to print to.
+ */
+void GenerationTelemetry::printDetails(std::ostream& os) const
+{
+    printHistogram(os, "Total ms", totalMilliseconds);
+
+    os << "Phases:" << std::endl;
+    for (const auto& name : phaseOrder)
+    {
+        const PhaseStats& stats = phases.at(name);
+        os << " " << name << ": " << stats.runs << " runs, " << stats.limitHits << " at iteration limit, "
+            << stats.totalMilliseconds / stats.runs << " ms average" << std::endl;
+        printHistogram(os, "Iterations", stats.iterations);
+        printHistogram(os, "Milliseconds", stats.milliseconds);
+    }
+
+    os << "Residuals in tolerance units:" << std::endl;
+    for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+    {
+        printHistogram(os, macroNames[m], residuals[m]);
+    }
+
+    os << "Templates:" << std::endl;
+    for (const auto& entry : templateCounts)
+    {
+        os << "  " << entry.first << ": " << entry.second << std::endl;
+    }
+}
+
+/**
+ * @brief Writes the histograms and the recent records as JSON.
+ * @param os The stream to write to.
+ */
+void GenerationTelemetry::toJSON(std::ostream& os) const
+{
+    os << "{" << std::endl;
+    os << "  \"generations\": " << generationCount << "," << std::endl;
+    os << "  \"cacheHits\": " << cacheHits << "," << std::endl;
+    os << "  \"withinTolerance\": " << withinTolerance << "," << std::endl;
+    os << "  \"totalMilliseconds\": ";
+    writeJSONHistogram(os, totalMilliseconds);
+    os << "," << std::endl;
+
+    os << "  \"phases\": {";
+    for (size_t i = 0; i < phaseOrder.size(); ++i)
+    {
+        const PhaseStats& stats = phases.at(phaseOrder[i]);
+        os << (i > 0 ? "," : "") << std::endl << "    ";
+        writeJSONString(os, phaseOrder[i]);
+        os << ": {\"runs\": " << stats.runs << ", \"limitHits\": " << stats.limitHits
+            << ", \"totalMilliseconds\": " << stats.totalMilliseconds << ", \"iterations\": ";
+        writeJSONHistogram(os, stats.iterations);
+        os << ", \"milliseconds\": ";
+        writeJSONHistogram(os, stats.milliseconds);
+        os << "}";
+    }
+    os << std::endl << "  }," << std::endl;
+
+    os << "  \"residualToleranceUnits\": {";
+    for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+    {
+        os << (m > 0 ? "," : "") << std::endl << "    \"" << macroNames[m] << "\": ";
+        writeJSONHistogram(os, residuals[m]);
+    }
+    os << std::endl << "  }," << std::endl;
+
+    os << "  \"templates\": {";
+    bool first = true;
+    for (const auto& entry : templateCounts)
+    {
+        os << (first ? "" : ",") << std::endl << "    ";
+        writeJSONString(os, entry.first);
+        os << ": " << entry.second;
+        first = false;
+    }
+    os << std::endl << "  }," << std::endl;
+
+    os << "  \"records\": [";
+    first = true;
+    for (const auto& record : records)
+    {
+        os << (first ? "" : ",") << std::endl << "    {\"template\": ";
+        writeJSONString(os, record.templateName);
+        os << ", \"mode\": ";
+        writeJSONString(os, record.mode);
+        os << ", \"cacheHit\": " << (record.cacheHit ? "true" : "false")
+            << ", \"foodsReplaced\": " << (record.foodsReplaced ? "true" : "false")
+            << ", \"milliseconds\": " << record.milliseconds << ", \"phases\": [";
+        for (size_t i = 0; i < record.phases.size(); ++i)
+        {
+            const auto& phase = record.phases[i];
+            os << (i > 0 ? ", " : "") << "{\"name\": ";
+            writeJSONString(os, phase.name);
+            os << ", \"iterations\": " << phase.iterations << ", \"iterationLimit\": " << phase.iterationLimit
+                << ", \"milliseconds\": " << phase.milliseconds << "}";
+        }
+        os << "], \"residuals\": {";
+        for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+        {
+            os << (m > 0 ? ", " : "") << "\"" << macroNames[m] << "\": " << record.residuals[m];
+        }
+        os << "}, \"withinTolerance\": " << (record.withinTolerance ? "true" : "false") << "}";
+        first = false;
+    }
+    os << std::endl << "  ]" << std::endl;
+    os << "}" << std::endl;
+}
+
+/**
+ * @brief Writes the histograms and the recent records to a JSON file.
+ * @param filename The file to write.
+ * @return True if the file was written, false otherwise.
+ */
+bool GenerationTelemetry::saveJSON(const std::string& filename) const
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    toJSON(file);
+    return true;
+}
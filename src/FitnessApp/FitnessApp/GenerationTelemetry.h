@@ -0,0 +1,173 @@
+#ifndef GENERATION_TELEMETRY_H
+#define GENERATION_TELEMETRY_H
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "FoodCatalog.h"
+#include "MacroTargets.h"
+
+/**
+ * @brief What happened during the generation of one plan.
+ */
+struct GenerationRecord
+{
+    /**
+     * @brief One step of the generation pipeline.
+     */
+    struct Phase
+    {
+        std::string name; ///< Name of the phase.
+        int iterations = 0; ///< Iterations the phase ran.
+        int iterationLimit = 0; ///< Iteration limit of the phase, 0 if it has none.
+        double milliseconds = 0; ///< Wall time of the phase.
+    };
+
+    std::string templateName; ///< Name of the template the plan was built from.
+    std::string mode; ///< Generation strategy ("heuristic", "optimizer" or "weekly").
+    bool cacheHit = false; ///< True if the plan was taken from the plan cache.
+    bool foodsReplaced = false; ///< True if excluded foods had to be replaced in the template.
+    std::vector<Phase> phases; ///< The phases in the order they ran.
+    float residuals[FoodCatalog::MACRO_COUNT] = {}; ///< Final totals minus targets, indexed by FoodCatalog::Macro.
+    float toleranceUnits[FoodCatalog::MACRO_COUNT] = {}; ///< Absolute residuals divided by their tolerance.
+    bool withinTolerance = false; ///< True if every macro ended within its tolerance.
+    double milliseconds = 0; ///< Wall time of the whole generation.
+
+    /**
+     * @brief Runs a phase and records its iterations and wall time.
+     * @tparam Step Callable returning the number of iterations it ran.
+     * @param name Name of the phase.
+     * @param iterationLimit Iteration limit of the phase, 0 if it has none.
+     * @param step The phase to run.
+     * @return The number of iterations the phase ran.
+     */
+    template <typename Step>
+    int measure(const std::string& name, int iterationLimit, Step step)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Phase phase;
+        phase.name = name;
+        phase.iterationLimit = iterationLimit;
+        phase.iterations = step();
+        phase.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        phases.push_back(phase);
+        return phase.iterations;
+    }
+
+    /**
+     * @brief Stores how far a finished plan is from its targets.
+     * @param plan The finished plan.
+     * @param targets The macro targets of the plan.
+     */
+    void setResult(const NutritionPlan& plan, const MacroTargets& targets);
+};
+
+/**
+ * @brief Collects generation records and aggregates them into histograms.
+ *
+ * Histograms cover every generation since the telemetry was created, while only the most
+ * recent records are kept in full. Both can be printed as a report or written as JSON, so
+ * that runs of different releases can be compared.
+ */
+class GenerationTelemetry
+{
+public:
+    /**
+     * @brief Counts values in buckets with fixed upper bounds.
+     */
+    struct Histogram
+    {
+        std::vector<double> upperBounds; ///< Inclusive upper bound of every bucket but the last, which is unbounded.
+        std::vector<size_t> counts; ///< Number of values per bucket, one more than upperBounds.
+
+        /**
+         * @brief Default constructor, creates a histogram with a single bucket.
+         */
+        Histogram();
+
+        /**
+         * @brief Creates an empty histogram.
+         * @param upperBounds Inclusive upper bounds of the buckets, in increasing order.
+         */
+        explicit Histogram(std::vector<double> upperBounds);
+
+        /**
+         * @brief Counts a value.
+         * @param value The value.
+         */
+        void add(double value);
+    };
+
+    /**
+     * @brief Aggregates of one phase over all generations.
+     */
+    struct PhaseStats
+    {
+        size_t runs = 0; ///< Number of times the phase ran.
+        size_t limitHits = 0; ///< Number of runs that reached the iteration limit.
+        double totalMilliseconds = 0; ///< Wall time of all runs.
+        Histogram iterations; ///< Distribution of the iterations per run.
+        Histogram milliseconds; ///< Distribution of the wall time per run.
+    };
+
+    /**
+     * @brief Constructs an empty telemetry.
+     * @param maxRecords Number of most recent records kept in full.
+     */
+    explicit GenerationTelemetry(size_t maxRecords = 500);
+
+    /**
+     * @brief Adds the record of a finished generation.
+     * @param record The record.
+     */
+    void add(const GenerationRecord& record);
+
+    /**
+     * @brief Gets the number of generations recorded.
+     * @return The number of generations.
+     */
+    size_t getGenerationCount() const;
+
+    /**
+     * @brief Prints the aggregated histograms.
+     * @param os The stream to print to.
+     */
+    void printReport(std::ostream& os) const;
+
+    /**
+     * @brief Writes the histograms and the recent records as JSON.
+     * @param os The stream to write to.
+     */
+    void toJSON(std::ostream& os) const;
+
+    /**
+     * @brief Writes the histograms and the recent records to a JSON file.
+     * @param filename The file to write.
+     * @return True if the file was written, false otherwise.
+     */
+    bool saveJSON(const std::string& filename) const;
+
+private:
+    /**
+     * @brief Prints the histograms of the phases, residuals and templates.
+     * @param os The stream to print to.
+     */
+    void printDetails(std::ostream& os) const;
+
+    size_t maxRecords; ///< Number of most recent records kept in full.
+    std::deque<GenerationRecord> records; ///< The most recent records, oldest first.
+    size_t generationCount = 0; ///< Number of generations recorded.
+    size_t cacheHits = 0; ///< Number of generations answered by the plan cache.
+    size_t withinTolerance = 0; ///< Number of generated plans within every tolerance, cache hits excluded.
+    std::map<std::string, PhaseStats> phases; ///< Aggregates per phase name.
+    std::vector<std::string> phaseOrder; ///< Phase names in the order they first ran.
+    Histogram residuals[FoodCatalog::MACRO_COUNT]; ///< Distribution of the residuals in tolerance units per macro.
+    Histogram totalMilliseconds; ///< Distribution of the wall time per generation.
+    std::map<std::string, size_t> templateCounts; ///< Number of generations per template.
+};
+
+#endif // GENERATION_TELEMETRY_H
@@ -1,10 +1,11 @@
 #include "Goals.h"
+#include "Utils.h"
 
 /**
  * @brief Default constructor for the Goals class.
  */
 Goals::Goals()
-    : targetWeight(0), bodyFatPercentage(0), fitnessGoal(FitnessGoal::MAINTENANCE), customCalories(0), useCustomCalories(false), profile(nullptr)
+    : targetWeight(0), bodyFatPercentage(0), fitnessGoal(FitnessGoal::MAINTENANCE), customCalories(0), useCustomCalories(false), profile(nullptr), workoutBurn(0)
 {
 }
 
@@ -55,11 +56,15 @@ void Goals::displayGoals() const
         std::cout << "Maintenance\n";
         break;
     }
+    if (!workoutPlan.empty())
+    {
+        std::cout << "Workout Plan: " << workoutPlan << " (" << workoutBurn << " kcal per day on average)\n";
+    }
     std::cout << "Daily Calories: " << getDailyCalories() << "\n";
 }
 
 /**
- * @brief Sets custom daily calories and saves it to a file.
+ * @brief Sets custom daily calories.
  *
  * @param calories The custom daily calories.
  */
@@ -67,7 +72,6 @@ void Goals::setCustomCalories(float calories)
 {
     customCalories = calories;
     useCustomCalories = true;
-    saveToCSV("goals.csv");
 }
 
 /**
@@ -76,7 +80,6 @@ void Goals::setCustomCalories(float calories)
 void Goals::resetToCalculatedCalories()
 {
     useCustomCalories = false;
-    saveToCSV("goals.csv");
 }
 
 /**
@@ -101,17 +104,41 @@ float Goals::calculateDailyCalories() const
         return 2000; // Default value if profile is not set
     }
 
-    float baseCalories = profile->calculateDailyCalories();
+    // A workout plan accounts for the training, so the rest of the day counts as sedentary
+    float baseCalories = workoutPlan.empty()
+        ? profile->calculateDailyCalories()
+        : profile->calculateBasalMetabolicRate() * Profile::activityFactor(Profile::ActivityLevel::SEDENTARY) + workoutBurn;
 
+    return baseCalories + goalOffset(fitnessGoal);
+}
+
+/**
+ * @brief Checks whether the daily calories were set by the user.
+ *
+ * @return true if custom calories are used, false if they are calculated.
+ */
+bool Goals::usesCustomCalories() const
+{
+    return useCustomCalories;
+}
+
+/**
+ * @brief Gets the calories the fitness goal adds to the daily caloric needs.
+ *
+ * @param fitnessGoal The fitness goal.
+ * @return The calories to add, negative for a deficit.
+ */
+float Goals::goalOffset(FitnessGoal fitnessGoal)
+{
     switch (fitnessGoal)
     {
     case FitnessGoal::WEIGHT_LOSS:
-        return baseCalories - 500;
+        return -500.0f;
     case FitnessGoal::MUSCLE_GAIN:
-        return baseCalories + 500;
+        return 500.0f;
     case FitnessGoal::MAINTENANCE:
     default:
-        return baseCalories;
+        return 0.0f;
     }
 }
 
@@ -136,8 +163,8 @@ void Goals::saveToCSV(const std::string& filename) const
     std::ofstream file(filename);
     if (file.is_open())
     {
-        file << targetWeight << ',' << bodyFatPercentage << ','
-            << static_cast<int>(fitnessGoal) << ',' << customCalories << ',' << useCustomCalories << '\n';
+        toCSV(file);
+        file << '\n';
         file.close();
     }
     else
@@ -151,7 +178,7 @@ void Goals::saveToCSV(const std::string& filename) const
  *
  * @param filename The name of the file to load the goals information.
  * @return true If the file was successfully loaded.
- * @return false If the file could not be opened.
+ * @return false If the file could not be opened or is malformed.
  */
 bool Goals::loadFromCSV(const std::string& filename)
 {
@@ -162,18 +189,11 @@ bool Goals::loadFromCSV(const std::string& filename)
         if (std::getline(file, line))
         {
             std::istringstream ss(line);
-            std::string token;
-
-            std::getline(ss, token, ',');
-            targetWeight = std::stof(token);
-            std::getline(ss, token, ',');
-            bodyFatPercentage = std::stof(token);
-            std::getline(ss, token, ',');
-            fitnessGoal = static_cast<FitnessGoal>(std::stoi(token));
-            std::getline(ss, token, ',');
-            customCalories = std::stof(token);
-            std::getline(ss, token, ',');
-            useCustomCalories = std::stoi(token);
+            if (!fromCSV(ss))
+            {
+                std::cerr << "Malformed goals in " << filename << ": " << line << std::endl;
+                return false;
+            }
         }
         file.close();
         return true;
@@ -185,6 +205,58 @@ bool Goals::loadFromCSV(const std::string& filename)
     }
 }
 
+/**
+ * @brief Writes the goals information as comma-separated fields, without a line break.
+ *
+ * @param os The stream to write to.
+ */
+void Goals::toCSV(std::ostream& os) const
+{
+    os << targetWeight << ',' << bodyFatPercentage << ','
+        << static_cast<int>(fitnessGoal) << ',' << customCalories << ',' << useCustomCalories << ',' << workoutPlan;
+}
+
+/**
+ * @brief Reads the goals information written by toCSV, up to the end of the line.
+ *
+ * The goals are left unchanged unless every field is valid.
+ *
+ * @param is The stream to read from.
+ * @return true if every field was read, false if the stream ended early, a number is malformed,
+ * or the fitness goal or custom calorie flag is out of range.
+ */
+bool Goals::fromCSV(std::istream& is)
+{
+    std::string targetWeightField, bodyFatField, goalField, customCaloriesField, customFlagField;
+    float targetWeightValue = 0.0f, bodyFatValue = 0.0f, customCaloriesValue = 0.0f;
+    int goalValue = 0, customFlagValue = 0;
+    if (!std::getline(is, targetWeightField, ',') || !std::getline(is, bodyFatField, ',') || !std::getline(is, goalField, ',')
+        || !std::getline(is, customCaloriesField, ',') || !std::getline(is, customFlagField, ',')
+        || !stringToFloat(targetWeightField, targetWeightValue) || !stringToFloat(bodyFatField, bodyFatValue)
+        || !stringToInt(goalField, goalValue) || !stringToFloat(customCaloriesField, customCaloriesValue)
+        || !stringToInt(customFlagField, customFlagValue))
+    {
+        return false;
+    }
+    if (goalValue < static_cast<int>(FitnessGoal::WEIGHT_LOSS) || goalValue > static_cast<int>(FitnessGoal::MAINTENANCE)
+        || (customFlagValue != 0 && customFlagValue != 1))
+    {
+        return false;
+    }
+
+    targetWeight = targetWeightValue;
+    bodyFatPercentage = bodyFatValue;
+    fitnessGoal = static_cast<FitnessGoal>(goalValue);
+    customCalories = customCaloriesValue;
+    useCustomCalories = customFlagValue != 0;
+    // Files saved before workout plans were linked end here
+    if (!std::getline(is, workoutPlan, ','))
+    {
+        workoutPlan.clear();
+    }
+    return true;
+}
+
 /**
  * @brief Gets the fitness goal.
  *
@@ -243,3 +315,51 @@ std::string Goals::getFitnessGoalString() const
         return "Maintenance";
     }
 }
+
+/**
+ * @brief Sets the workout plan whose calorie burn replaces the activity level.
+ *
+ * The burn of the plan is set separately with setWorkoutBurn.
+ *
+ * @param planName The name of the workout plan, or an empty string to use the activity level.
+ */
+void Goals::setWorkoutPlan(const std::string& planName)
+{
+    workoutPlan = planName;
+    if (workoutPlan.empty())
+    {
+        workoutBurn = 0;
+    }
+    recalculateDailyCalories();
+}
+
+/**
+ * @brief Gets the workout plan whose calorie burn replaces the activity level.
+ *
+ * @return const std::string& The name of the workout plan, or an empty string if the activity level is used.
+ */
+const std::string& Goals::getWorkoutPlan() const
+{
+    return workoutPlan;
+}
+
+/**
+ * @brief Sets the average daily calorie burn of the workout plan.
+ *
+ * @param calories The calories burned by training, averaged over the week.
+ */
+void Goals::setWorkoutBurn(float calories)
+{
+    workoutBurn = calories;
+    recalculateDailyCalories();
+}
+
+/**
+ * @brief Gets the average daily calorie burn of the workout plan.
+ *
+ * @return float The calories burned by training, averaged over the week.
+ */
+float Goals::getWorkoutBurn() const
+{
+    return workoutBurn;
+}
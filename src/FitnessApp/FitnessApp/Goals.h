@@ -67,6 +67,21 @@ public:
      */
     float getDailyCalories() const;
 
+    /**
+     * @brief Checks whether the daily calories were set by the user.
+     *
+     * @return true if custom calories are used, false if they are calculated.
+     */
+    bool usesCustomCalories() const;
+
+    /**
+     * @brief Gets the calories the fitness goal adds to the daily caloric needs.
+     *
+     * @param fitnessGoal The fitness goal.
+     * @return The calories to add, negative for a deficit.
+     */
+    static float goalOffset(FitnessGoal fitnessGoal);
+
     /**
      * @brief Saves the goals information to a CSV file.
      *
@@ -82,6 +97,22 @@ public:
      */
     bool loadFromCSV(const std::string& filename);
 
+    /**
+     * @brief Writes the goals information as comma-separated fields, without a line break.
+     *
+     * @param os The stream to write to.
+     */
+    void toCSV(std::ostream& os) const;
+
+    /**
+     * @brief Reads the goals information written by toCSV, up to the end of the line.
+     *
+     * @param is The stream to read from.
+     * @return true if every field was read, false if the stream ended early, a number is malformed,
+     * or the fitness goal or custom calorie flag is out of range.
+     */
+    bool fromCSV(std::istream& is);
+
     /**
      * @brief Gets the current fitness goal.
      *
@@ -117,6 +148,34 @@ public:
      */
     std::string getFitnessGoalString() const;
 
+    /**
+     * @brief Sets the workout plan whose calorie burn replaces the activity level.
+     *
+     * @param planName The name of the workout plan, or an empty string to use the activity level.
+     */
+    void setWorkoutPlan(const std::string& planName);
+
+    /**
+     * @brief Gets the workout plan whose calorie burn replaces the activity level.
+     *
+     * @return The name of the workout plan, or an empty string if the activity level is used.
+     */
+    const std::string& getWorkoutPlan() const;
+
+    /**
+     * @brief Sets the average daily calorie burn of the workout plan.
+     *
+     * @param calories The calories burned by training, averaged over the week.
+     */
+    void setWorkoutBurn(float calories);
+
+    /**
+     * @brief Gets the average daily calorie burn of the workout plan.
+     *
+     * @return The calories burned by training, averaged over the week.
+     */
+    float getWorkoutBurn() const;
+
 private:
     float targetWeight; ///< The target weight in kilograms.
     float bodyFatPercentage; ///< The target body fat percentage.
@@ -124,6 +183,8 @@ private:
     float customCalories; ///< The custom daily caloric intake.
     bool useCustomCalories; ///< Flag indicating if custom calories are used.
     const Profile* profile; ///< Pointer to the Profile object.
+    std::string workoutPlan; ///< The workout plan whose calorie burn replaces the activity level, if any.
+    float workoutBurn; ///< The average daily calorie burn of the workout plan.
 
     /**
      * @brief Calculates the daily caloric needs based on the profile and fitness goals.
@@ -0,0 +1,178 @@
+#include "MacroKdTree.h"
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    /**
+     * @brief Lists the indices of all items.
+     * @param itemCount The number of items.
+     * @return The indices 0 to itemCount - 1.
+     */
+    std::vector<size_t> allItems(size_t itemCount)
+    {
+        std::vector<size_t> items(itemCount);
+        std::iota(items.begin(), items.end(), 0);
+        return items;
+    }
+}
+
+/**
+ * @brief Builds the tree.
+ * @param points DIMENSIONS coordinates per item, item i starting at points[i * DIMENSIONS].
+ */
+MacroKdTree::MacroKdTree(const std::vector<float>& points) : MacroKdTree(points, allItems(points.size() / DIMENSIONS))
+{
+}
+
+/**
+ * @brief Builds the tree over some of the items.
+ * @param points DIMENSIONS coordinates per item, item i starting at points[i * DIMENSIONS].
+ * @param items The indices of the items to include; queries return these indices.
+ */
+MacroKdTree::MacroKdTree(const std::vector<float>& points, std::vector<size_t> items) : order(std::move(items))
+{
+    size_t itemCount = order.size();
+    coordinates = points;
+    axes.assign(itemCount, 0);
+    build(0, itemCount);
+
+    // Store the coordinates in tree order so a search reads them sequentially
+    coordinates.resize(itemCount * DIMENSIONS);
+    for (size_t position = 0; position < itemCount; ++position)
+    {
+        std::copy(points.begin() + order[position] * DIMENSIONS, points.begin() + (order[position] + 1) * DIMENSIONS,
+            coordinates.begin() + position * DIMENSIONS);
+    }
+}
+
+/**
+ * @brief Arranges a range of items into a subtree.
+ *
+ * The range is split at its median along the axis with the widest spread.
+ *
+ * @param begin First position of the range.
+ * @param end One past the last position of the range.
+ */
+void MacroKdTree::build(size_t begin, size_t end)
+{
+    if (end - begin <= 1)
+    {
+        return;
+    }
+
+    // coordinates still holds the points in item order here
+    int axis = 0;
+    float widestSpread = -1;
+    for (int d = 0; d < DIMENSIONS; ++d)
+    {
+        auto bounds = std::minmax_element(order.begin() + begin, order.begin() + end,
+            [&](size_t a, size_t b) { return coordinates[a * DIMENSIONS + d] < coordinates[b * DIMENSIONS + d]; });
+        float spread = coordinates[*bounds.second * DIMENSIONS + d] - coordinates[*bounds.first * DIMENSIONS + d];
+        if (spread > widestSpread)
+        {
+            widestSpread = spread;
+            axis = d;
+        }
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+        [&](size_t a, size_t b) { return coordinates[a * DIMENSIONS + axis] < coordinates[b * DIMENSIONS + axis]; });
+    axes[middle] = static_cast<unsigned char>(axis);
+
+    build(begin, middle);
+    build(middle + 1, end);
+}
+
+/**
+ * @brief Finds the items nearest to a query point.
+ * @param query DIMENSIONS coordinates of the query point.
+ * @param count Maximum number of items to return.
+ * @param accept Returns true for item indices that may be returned.
+ * @return Pairs of item index and squared distance, nearest first.
+ */
+std::vector<std::pair<size_t, float>> MacroKdTree::nearest(const float* query, size_t count, const std::function<bool(size_t)>& accept) const
+{
+    std::vector<std::pair<float, size_t>> best;
+    if (count > 0)
+    {
+        search(0, order.size(), query, count, accept, best);
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    std::vector<std::pair<size_t, float>> result;
+    result.reserve(best.size());
+    for (const auto& entry : best)
+    {
+        result.emplace_back(entry.second, entry.first);
+    }
+    return result;
+}
+
+/**
+ * @brief Searches a subtree for the nearest accepted items.
+ * @param begin First position of the subtree.
+ * @param end One past the last position of the subtree.
+ * @param query The query point.
+ * @param count Maximum number of items to keep.
+ * @param accept Returns true for item indices that may be returned.
+ * @param best Max-heap of squared distance and item index of the best items so far.
+ */
+void MacroKdTree::search(size_t begin, size_t end, const float* query, size_t count, const std::function<bool(size_t)>& accept,
+    std::vector<std::pair<float, size_t>>& best) const
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    const float* point = &coordinates[middle * DIMENSIONS];
+
+    if (accept(order[middle]))
+    {
+        float distance = 0;
+        for (int d = 0; d < DIMENSIONS; ++d)
+        {
+            float difference = point[d] - query[d];
+            distance += difference * difference;
+        }
+
+        if (best.size() < count)
+        {
+            best.emplace_back(distance, order[middle]);
+            std::push_heap(best.begin(), best.end());
+        }
+        else if (distance < best.front().first)
+        {
+            std::pop_heap(best.begin(), best.end());
+            best.back() = { distance, order[middle] };
+            std::push_heap(best.begin(), best.end());
+        }
+    }
+
+    float offset = query[axes[middle]] - point[axes[middle]];
+    bool queryOnLeft = offset < 0;
+    if (queryOnLeft)
+    {
+        search(begin, middle, query, count, accept, best);
+    }
+    else
+    {
+        search(middle + 1, end, query, count, accept, best);
+    }
+
+    // The far side can only hold closer items if the splitting plane is closer than the k-th best
+    if (best.size() < count || offset * offset < best.front().first)
+    {
+        if (queryOnLeft)
+        {
+            search(middle + 1, end, query, count, accept, best);
+        }
+        else
+        {
+            search(begin, middle, query, count, accept, best);
+        }
+    }
+}
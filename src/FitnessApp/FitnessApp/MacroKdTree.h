@@ -0,0 +1,74 @@
+#ifndef MACRO_KD_TREE_H
+#define MACRO_KD_TREE_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Static k-d tree for nearest neighbour queries over macro profiles.
+ *
+ * The tree is stored implicitly: the points are reordered so that the median of every
+ * range is its node and the two halves are its subtrees, which keeps the whole tree in
+ * two flat arrays. Queries descend into the nearer subtree first and skip the farther
+ * one whenever the splitting plane is beyond the current k-th best distance.
+ */
+class MacroKdTree
+{
+public:
+    static const int DIMENSIONS = 3; ///< Number of coordinates per point.
+
+    /**
+     * @brief Default constructor, creates an empty tree.
+     */
+    MacroKdTree() = default;
+
+    /**
+     * @brief Builds the tree.
+     * @param points DIMENSIONS coordinates per item, item i starting at points[i * DIMENSIONS].
+     */
+    explicit MacroKdTree(const std::vector<float>& points);
+
+    /**
+     * @brief Builds the tree over some of the items.
+     * @param points DIMENSIONS coordinates per item, item i starting at points[i * DIMENSIONS].
+     * @param items The indices of the items to include; queries return these indices.
+     */
+    MacroKdTree(const std::vector<float>& points, std::vector<size_t> items);
+
+    /**
+     * @brief Finds the items nearest to a query point.
+     * @param query DIMENSIONS coordinates of the query point.
+     * @param count Maximum number of items to return.
+     * @param accept Returns true for item indices that may be returned.
+     * @return Pairs of item index and squared distance, nearest first.
+     */
+    std::vector<std::pair<size_t, float>> nearest(const float* query, size_t count, const std::function<bool(size_t)>& accept) const;
+
+private:
+    /**
+     * @brief Arranges a range of items into a subtree.
+     * @param begin First position of the range.
+     * @param end One past the last position of the range.
+     */
+    void build(size_t begin, size_t end);
+
+    /**
+     * @brief Searches a subtree for the nearest accepted items.
+     * @param begin First position of the subtree.
+     * @param end One past the last position of the subtree.
+     * @param query The query point.
+     * @param count Maximum number of items to keep.
+     * @param accept Returns true for item indices that may be returned.
+     * @param best Max-heap of squared distance and item index of the best items so far.
+     */
+    void search(size_t begin, size_t end, const float* query, size_t count, const std::function<bool(size_t)>& accept,
+        std::vector<std::pair<float, size_t>>& best) const;
+
+    std::vector<size_t> order; ///< Item index at each tree position.
+    std::vector<float> coordinates; ///< DIMENSIONS coordinates at each tree position.
+    std::vector<unsigned char> axes; ///< Splitting axis at each tree position.
+};
+
+#endif // MACRO_KD_TREE_H
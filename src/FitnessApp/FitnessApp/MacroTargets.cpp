@@ -0,0 +1,127 @@
+#include "MacroTargets.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Gets the target calories.
+ * @return The target calories.
+ */
+float MacroTargets::calories() const
+{
+    return amounts[FoodCatalog::CALORIES];
+}
+
+/**
+ * @brief Gets the target protein.
+ * @return The target protein in grams.
+ */
+float MacroTargets::protein() const
+{
+    return amounts[FoodCatalog::PROTEIN];
+}
+
+/**
+ * @brief Calculates the cost of plan totals.
+ *
+ * The loop runs over the four macro lanes with no data-dependent branches, so the compiler
+ * can evaluate it as a single vector operation.
+ *
+ * @param totals The totals of the plan, indexed by FoodCatalog::Macro.
+ * @return The sum of squared deviations, each measured in units of its tolerance.
+ */
+float MacroTargets::cost(const float* totals) const
+{
+    float sum = 0;
+    for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+    {
+        float error = (totals[m] - amounts[m]) / (std::max(amounts[m], 1.0f) * tolerances[m]);
+        sum += error * error;
+    }
+    return sum;
+}
+
+/**
+ * @brief Checks whether plan totals meet every target within its tolerance.
+ * @param totals The totals of the plan, indexed by FoodCatalog::Macro.
+ * @return True if every macro is within its tolerance.
+ */
+bool MacroTargets::isWithinTolerance(const float* totals) const
+{
+    for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+    {
+        if (std::abs(totals[m] - amounts[m]) > std::max(amounts[m], 1.0f) * tolerances[m])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Calculates the totals of a plan.
+ * @param plan The nutrition plan.
+ * @param totals Receives the totals, indexed by FoodCatalog::Macro.
+ */
+void MacroTargets::planTotals(const NutritionPlan& plan, float* totals)
+{
+    std::fill(totals, totals + FoodCatalog::MACRO_COUNT, 0.0f);
+    for (const auto& meal : plan.meals)
+    {
+        for (const auto& foodPair : meal.second)
+        {
+            // Values in FoodItem are given per 100 grams
+            float factor = foodPair.second / 100;
+            totals[FoodCatalog::CALORIES] += foodPair.first.calories * factor;
+            totals[FoodCatalog::PROTEIN] += foodPair.first.protein * factor;
+            totals[FoodCatalog::CARBS] += foodPair.first.carbohydrates * factor;
+            totals[FoodCatalog::FATS] += foodPair.first.fats * factor;
+        }
+    }
+}
+
+/**
+ * @brief Constructs a model with the given settings.
+ * @param settings The model settings.
+ */
+MacroTargetModel::MacroTargetModel(Settings settings) : settings(settings)
+{
+}
+
+/**
+ * @brief Derives the daily macro targets.
+ *
+ * If protein and fats alone exceed the daily calories, carbohydrates are set to zero.
+ *
+ * @param goals The goals, with the profile already set.
+ * @param profile The profile.
+ * @return The macro targets.
+ */
+MacroTargets MacroTargetModel::derive(const Goals& goals, const Profile& profile) const
+{
+    const GoalSplit* split = &settings.maintenance;
+    switch (goals.getFitnessGoal())
+    {
+    case Goals::FitnessGoal::WEIGHT_LOSS:
+        split = &settings.weightLoss;
+        break;
+    case Goals::FitnessGoal::MUSCLE_GAIN:
+        split = &settings.muscleGain;
+        break;
+    case Goals::FitnessGoal::MAINTENANCE:
+        split = &settings.maintenance;
+        break;
+    }
+
+    MacroTargets targets;
+    float calories = goals.getDailyCalories();
+    float protein = profile.getWeight() * split->proteinPerKilogram;
+    float fats = calories * split->fatCalorieShare / 9;
+    float carbs = std::max(0.0f, (calories - protein * 4 - fats * 9) / 4);
+
+    targets.amounts[FoodCatalog::CALORIES] = calories;
+    targets.amounts[FoodCatalog::PROTEIN] = protein;
+    targets.amounts[FoodCatalog::CARBS] = carbs;
+    targets.amounts[FoodCatalog::FATS] = fats;
+    std::copy(settings.tolerances, settings.tolerances + FoodCatalog::MACRO_COUNT, targets.tolerances);
+    return targets;
+}
@@ -0,0 +1,106 @@
+#ifndef MACRO_TARGETS_H
+#define MACRO_TARGETS_H
+
+#include "FoodCatalog.h"
+#include "NutritionPlan.h"
+#include "Goals.h"
+#include "Profile.h"
+
+/**
+ * @brief Daily targets for calories, protein, carbohydrates and fats.
+ *
+ * Values are indexed by FoodCatalog::Macro, so they line up with the per-gram rows of the
+ * food catalog and all four macros can be scored in one pass.
+ */
+struct MacroTargets
+{
+    float amounts[FoodCatalog::MACRO_COUNT] = {}; ///< Target kcal and grams of protein, carbs and fats.
+    float tolerances[FoodCatalog::MACRO_COUNT] = { 0.02f, 0.05f, 0.10f, 0.10f }; ///< Allowed relative deviation of each macro.
+
+    /**
+     * @brief Gets the target calories.
+     * @return The target calories.
+     */
+    float calories() const;
+
+    /**
+     * @brief Gets the target protein.
+     * @return The target protein in grams.
+     */
+    float protein() const;
+
+    /**
+     * @brief Calculates the cost of plan totals.
+     * @param totals The totals of the plan, indexed by FoodCatalog::Macro.
+     * @return The sum of squared deviations, each measured in units of its tolerance.
+     */
+    float cost(const float* totals) const;
+
+    /**
+     * @brief Checks whether plan totals meet every target within its tolerance.
+     * @param totals The totals of the plan, indexed by FoodCatalog::Macro.
+     * @return True if every macro is within its tolerance.
+     */
+    bool isWithinTolerance(const float* totals) const;
+
+    /**
+     * @brief Calculates the totals of a plan.
+     * @param plan The nutrition plan.
+     * @param totals Receives the totals, indexed by FoodCatalog::Macro.
+     */
+    static void planTotals(const NutritionPlan& plan, float* totals);
+};
+
+/**
+ * @brief Derives macro targets from the fitness goal and the profile.
+ *
+ * Protein is set per kilogram of body weight and fats as a share of the daily calories;
+ * carbohydrates fill the remaining calories.
+ */
+class MacroTargetModel
+{
+public:
+    /**
+     * @brief Macro split of one fitness goal.
+     */
+    struct GoalSplit
+    {
+        float proteinPerKilogram; ///< Grams of protein per kilogram of body weight.
+        float fatCalorieShare; ///< Share of the daily calories coming from fats.
+    };
+
+    /**
+     * @brief Tunable parameters of the model.
+     */
+    struct Settings
+    {
+        GoalSplit weightLoss = { 1.6f, 0.30f }; ///< Split for Goals::FitnessGoal::WEIGHT_LOSS.
+        GoalSplit muscleGain = { 2.2f, 0.25f }; ///< Split for Goals::FitnessGoal::MUSCLE_GAIN.
+        GoalSplit maintenance = { 1.6f, 0.30f }; ///< Split for Goals::FitnessGoal::MAINTENANCE.
+        float tolerances[FoodCatalog::MACRO_COUNT] = { 0.02f, 0.05f, 0.10f, 0.10f }; ///< Allowed relative deviation of each macro.
+    };
+
+    /**
+     * @brief Constructs a model with default settings.
+     */
+    MacroTargetModel() = default;
+
+    /**
+     * @brief Constructs a model with the given settings.
+     * @param settings The model settings.
+     */
+    explicit MacroTargetModel(Settings settings);
+
+    /**
+     * @brief Derives the daily macro targets.
+     * @param goals The goals, with the profile already set.
+     * @param profile The profile.
+     * @return The macro targets.
+     */
+    MacroTargets derive(const Goals& goals, const Profile& profile) const;
+
+private:
+    Settings settings; ///< The model settings.
+};
+
+#endif // MACRO_TARGETS_H
@@ -10,15 +10,17 @@
  * @param pv Reference to the ProfileView component.
  * @param wpv Reference to the WorkoutPlanView component.
  * @param nv Reference to the NutritionPlanView component.
+ * @param wlv Reference to the WorkoutLogView component.
  */
-MainView::MainView(ExerciseView& ev, FoodView& fv, ProfileView& pv, WorkoutPlanView& wpv, NutritionPlanView& nv)
-    : exerciseView(ev), foodView(fv), profileView(pv), workoutPlanView(wpv), nutritionPlanView(nv)
+MainView::MainView(ExerciseView& ev, FoodView& fv, ProfileView& pv, WorkoutPlanView& wpv, NutritionPlanView& nv, WorkoutLogView& wlv)
+    : exerciseView(ev), foodView(fv), profileView(pv), workoutPlanView(wpv), nutritionPlanView(nv), workoutLogView(wlv)
 {
     menuOptions = {
         {"Profile", [this]() { profileView.display(); }},
         {"Exercises", [this]() { exerciseView.display(); }},
         {"Food", [this]() { foodView.display(); }},
         {"Workout Plans", [this]() { workoutPlanView.display(); }},
+        {"Workout Log", [this]() { workoutLogView.display(); }},
         {"Nutrition Plans", [this]() { nutritionPlanView.display(); }},
         {"Exit", [this]() { exit(0); }}
     };
@@ -7,6 +7,7 @@
 #include "FoodView.h"
 #include "ProfileView.h"
 #include "NutritionPlanView.h"
+#include "WorkoutLogView.h"
 
 /**
  * @class MainView
@@ -23,8 +24,9 @@ public:
      * @param profileView Reference to the ProfileView component.
      * @param workoutPlanView Reference to the WorkoutPlanView component.
      * @param nutritionPlanView Reference to the NutritionPlanView component.
+     * @param workoutLogView Reference to the WorkoutLogView component.
      */
-    MainView(ExerciseView& exerciseView, FoodView& foodView, ProfileView& profileView, WorkoutPlanView& workoutPlanView, NutritionPlanView& nutritionPlanView);
+    MainView(ExerciseView& exerciseView, FoodView& foodView, ProfileView& profileView, WorkoutPlanView& workoutPlanView, NutritionPlanView& nutritionPlanView, WorkoutLogView& workoutLogView);
 
     /**
      * @brief Displays the main view menu.
@@ -37,6 +39,7 @@ private:
     ProfileView& profileView; ///< Reference to the ProfileView component.
     WorkoutPlanView& workoutPlanView; ///< Reference to the WorkoutPlanView component.
     NutritionPlanView& nutritionPlanView; ///< Reference to the NutritionPlanView component.
+    WorkoutLogView& workoutLogView; ///< Reference to the WorkoutLogView component.
     std::vector<MenuOption> menuOptions; ///< Vector of menu options.
 };
 
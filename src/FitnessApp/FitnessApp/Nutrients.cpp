@@ -0,0 +1,88 @@
+#include "Nutrients.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+/**
+ * @brief Gets the nutrients the application knows units for, in display order.
+ * @return The known nutrients.
+ */
+const std::vector<NutrientInfo>& knownNutrients()
+{
+    static const std::vector<NutrientInfo> nutrients = {
+        { "fiber", "g" },
+        { "sugar", "g" },
+        { "saturated fat", "g" },
+        { "cholesterol", "mg" },
+        { "sodium", "mg" },
+        { "potassium", "mg" },
+        { "calcium", "mg" },
+        { "iron", "mg" },
+        { "magnesium", "mg" },
+        { "zinc", "mg" },
+        { "vitamin a", "mcg" },
+        { "vitamin b6", "mg" },
+        { "vitamin b12", "mcg" },
+        { "vitamin c", "mg" },
+        { "vitamin d", "mcg" },
+        { "vitamin e", "mg" },
+        { "vitamin k", "mcg" },
+        { "folate", "mcg" }
+    };
+    return nutrients;
+}
+
+/**
+ * @brief Gets the unit of a nutrient.
+ * @param name The nutrient name.
+ * @return The unit, or "g" for nutrients that are not known.
+ */
+std::string nutrientUnit(const std::string& name)
+{
+    for (const auto& nutrient : knownNutrients())
+    {
+        if (nutrient.name == name)
+        {
+            return nutrient.unit;
+        }
+    }
+    return "g";
+}
+
+/**
+ * @brief Parses a "name=value" nutrient field.
+ * @param field The field to parse.
+ * @param name Receives the lower case nutrient name.
+ * @param value Receives the amount per 100 grams.
+ * @return True if the field is a valid nutrient field, false otherwise.
+ */
+bool parseNutrientField(const std::string& field, std::string& name, float& value)
+{
+    size_t separator = field.find('=');
+    if (separator == std::string::npos)
+    {
+        return false;
+    }
+
+    size_t first = field.find_first_not_of(" \t");
+    size_t last = field.find_last_not_of(" \t", separator - 1);
+    if (first >= separator || last == std::string::npos)
+    {
+        return false;
+    }
+    name = field.substr(first, last - first + 1);
+    if (name.find(',') != std::string::npos)
+    {
+        return false; // Would break the CSV column layout
+    }
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    const char* begin = field.c_str() + separator + 1;
+    char* end = nullptr;
+    value = std::strtof(begin, &end);
+    while (end != nullptr && std::isspace(static_cast<unsigned char>(*end)))
+    {
+        ++end;
+    }
+    return end != begin && end != nullptr && *end == '\0' && value >= 0;
+}
@@ -0,0 +1,38 @@
+#ifndef NUTRIENTS_H
+#define NUTRIENTS_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Name and unit of a nutrient beyond the four macros.
+ */
+struct NutrientInfo
+{
+    std::string name; ///< Lower case nutrient name as used in the CSV files.
+    std::string unit; ///< Unit of the amount per 100 grams.
+};
+
+/**
+ * @brief Gets the nutrients the application knows units for, in display order.
+ * @return The known nutrients.
+ */
+const std::vector<NutrientInfo>& knownNutrients();
+
+/**
+ * @brief Gets the unit of a nutrient.
+ * @param name The nutrient name.
+ * @return The unit, or "g" for nutrients that are not known.
+ */
+std::string nutrientUnit(const std::string& name);
+
+/**
+ * @brief Parses a "name=value" nutrient field.
+ * @param field The field to parse.
+ * @param name Receives the lower case nutrient name.
+ * @param value Receives the amount per 100 grams.
+ * @return True if the field is a valid nutrient field, false otherwise.
+ */
+bool parseNutrientField(const std::string& field, std::string& name, float& value);
+
+#endif // NUTRIENTS_H
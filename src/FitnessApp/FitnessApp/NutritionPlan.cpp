@@ -10,7 +10,16 @@
 void NutritionPlan::toCSV(std::ostream& os) const
 {
     os << name << ",";
+    mealsToCSV(os);
+    os << "\n";
+}
 
+/**
+ * @brief Writes the meal fields of the nutrition plan, each followed by a comma, to the given output stream.
+ * @param os The output stream to write the CSV data to.
+ */
+void NutritionPlan::mealsToCSV(std::ostream& os) const
+{
     for (const auto& mealName : MEAL_NAMES)
     {
         auto it = meals.find(mealName);
@@ -28,7 +37,6 @@ void NutritionPlan::toCSV(std::ostream& os) const
         }
         os << ",";
     }
-    os << "\n";
 }
 
 /**
@@ -37,6 +37,12 @@ public:
      */
     void toCSV(std::ostream& os) const;
 
+    /**
+     * @brief Writes only the meal fields of the nutrition plan (without name and line end) to the given output stream.
+     * @param os The output stream to write the CSV data to.
+     */
+    void mealsToCSV(std::ostream& os) const;
+
     /**
      * @brief Loads the nutrition plan from CSV format from the given input stream.
      * @param is The input stream to read the CSV data from.
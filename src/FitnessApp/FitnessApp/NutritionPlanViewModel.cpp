@@ -1,17 +1,23 @@
 #define NOMINMAX
 #include "NutritionPlanViewModel.h"
 #include "Utils.h"
+#include "Nutrients.h"
 #include <iostream>
 #include <sstream>
 #include <set>
 #include <iomanip> 
 #include <random>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <chrono>
 
 /**
  * @brief Constructor to initialize NutritionPlanViewModel with a filename.
  * @param filename The filename from which to load nutrition plans.
+ * @param userRegistry The registry holding the profile and goals of the active user.
  */
-NutritionPlanViewModel::NutritionPlanViewModel(const std::string& filename) : filename(filename)
+NutritionPlanViewModel::NutritionPlanViewModel(const std::string& filename, UserRegistry& userRegistry) : filename(filename), userRegistry(userRegistry)
 {
     reload();
 }
@@ -141,8 +147,10 @@ void NutritionPlanViewModel::handleRemoveFood(NutritionPlan& selectedPlan, const
         }
         // Remove the selected food item from the meal
         auto it = selectedPlan.meals[mealName].begin() + (removeChoice - 1);
+        std::pair<FoodItem, float> removedFood = *it;
         selectedPlan.meals[mealName].erase(it);
         std::cout << "Food item removed from " << mealName << ".\n";
+        handleSubstituteFood(selectedPlan, mealName, removedFood, removeChoice - 1);
         std::cout << "Press Enter to continue...\n";
         std::cin.get();
         break;
@@ -150,6 +158,57 @@ void NutritionPlanViewModel::handleRemoveFood(NutritionPlan& selectedPlan, const
     printWindowSizedSeparator();
 }
 
+/**
+ * @brief Offer foods similar to a removed food and add the chosen one in its place.
+ *
+ * The suggestions share a category with the removed food, have the closest macro profile per
+ * gram and come with the amount that matches the calories of the removed portion.
+ *
+ * @param selectedPlan The nutrition plan being modified.
+ * @param mealName The name of the meal being modified.
+ * @param removedFood The removed food item and its quantity.
+ * @param position The position the removed food had in the meal.
+ */
+void NutritionPlanViewModel::handleSubstituteFood(NutritionPlan& selectedPlan, const std::string& mealName, const std::pair<FoodItem, float>& removedFood, size_t position)
+{
+    const size_t suggestionCount = 5;
+
+    std::set<std::string> planFoods;
+    for (const auto& meal : selectedPlan.meals)
+    {
+        for (const auto& foodPair : meal.second)
+        {
+            planFoods.insert(foodPair.first.name);
+        }
+    }
+
+    auto substitutes = foodCatalog.suggestSubstitutes(removedFood.first, removedFood.second, suggestionCount,
+        [&](size_t index) { return planFoods.count(foodCatalog.item(index).name) == 0; });
+    if (substitutes.empty())
+    {
+        return;
+    }
+
+    std::cout << "Similar foods with the same calories:\n";
+    for (size_t i = 0; i < substitutes.size(); ++i)
+    {
+        std::cout << i + 1 << ".";
+        printFoodItem(foodCatalog.item(substitutes[i].index), substitutes[i].grams);
+    }
+
+    int substituteChoice;
+    getValidInput(substituteChoice, "Enter the number of a food to add instead (or '0' to skip): ", 0, static_cast<int>(substitutes.size()));
+    if (substituteChoice == 0)
+    {
+        return;
+    }
+
+    const Substitute& substitute = substitutes[substituteChoice - 1];
+    auto& mealItems = selectedPlan.meals[mealName];
+    mealItems.insert(mealItems.begin() + std::min(position, mealItems.size()), { foodCatalog.item(substitute.index), substitute.grams });
+    std::cout << foodCatalog.item(substitute.index).name << " added to " << mealName << ".\n";
+}
+
 /**
  * @brief Modify a nutrition plan by adding or removing food items.
  * @param selectedPlan The nutrition plan being modified.
@@ -158,6 +217,9 @@ void NutritionPlanViewModel::handleRemoveFood(NutritionPlan& selectedPlan, const
 void NutritionPlanViewModel::modifyNutritionPlan(NutritionPlan& selectedPlan, const std::map<std::string, FoodItem>& foodItemMap)
 {
     std::string foodName;
+    const NutritionPlan originalPlan = selectedPlan;
+    NutritionPlan baseline = selectedPlan;
+    PortionBalancer::LockedPortions editedFoods;
 
     for (const auto& mealName : MEAL_NAMES)
     {
@@ -166,7 +228,7 @@ void NutritionPlanViewModel::modifyNutritionPlan(NutritionPlan& selectedPlan, co
             std::cout << "Current foods in " << mealName << ":\n";
             displayCurrentFoods(selectedPlan.meals[mealName]);
 
-            std::cout << "Enter 'add' to add a new food, 'remove' to remove a food, 'done' to finish modifying " << mealName << ": ";
+            std::cout << "Enter 'add' to add a new food, 'remove' to remove a food, 'rebalance' to fit the other portions to the targets, 'done' to finish modifying " << mealName << ": ";
             std::getline(std::cin >> std::ws, foodName);
 
             printWindowSizedSeparator();
@@ -183,6 +245,13 @@ void NutritionPlanViewModel::modifyNutritionPlan(NutritionPlan& selectedPlan, co
             {
                 handleRemoveFood(selectedPlan, mealName);
             }
+            else if (foodName == "rebalance")
+            {
+                // Portions set by an earlier rebalance stay free, the user's own edits stay locked
+                collectEditedFoods(selectedPlan, baseline, editedFoods);
+                rebalancePlan(selectedPlan, originalPlan, editedFoods);
+                baseline = selectedPlan;
+            }
             else
             {
                 std::cout << "Invalid input.\n";
@@ -191,6 +260,125 @@ void NutritionPlanViewModel::modifyNutritionPlan(NutritionPlan& selectedPlan, co
     }
 }
 
+/**
+ * @brief Add the foods of a plan that differ from a baseline to the set of edited foods.
+ *
+ * A food counts as edited if the baseline has no food of that name and amount in the same meal.
+ *
+ * @param plan The nutrition plan being modified.
+ * @param baseline The plan as it was after the last rebalance.
+ * @param editedFoods The set of edited foods to extend.
+ */
+void NutritionPlanViewModel::collectEditedFoods(const NutritionPlan& plan, const NutritionPlan& baseline, PortionBalancer::LockedPortions& editedFoods)
+{
+    for (const auto& meal : plan.meals)
+    {
+        auto baselineMeal = baseline.meals.find(meal.first);
+        for (const auto& foodPair : meal.second)
+        {
+            bool unchanged = baselineMeal != baseline.meals.end() && std::any_of(baselineMeal->second.begin(), baselineMeal->second.end(),
+                [&](const std::pair<FoodItem, float>& baselinePair)
+                {
+                    return baselinePair.first.name == foodPair.first.name && baselinePair.second == foodPair.second;
+                });
+            if (!unchanged)
+            {
+                editedFoods.insert({ meal.first, foodPair.first.name });
+            }
+        }
+    }
+}
+
+/**
+ * @brief Re-solve the portions of a modified plan while keeping the edited foods fixed.
+ *
+ * The balancer is warm-started from the current portions, so it only needs a few sweeps
+ * to absorb the edits. The new totals are derived from the old ones by adding the change
+ * of every portion that moved, instead of summing the whole plan again.
+ *
+ * @param plan The nutrition plan being modified.
+ * @param originalPlan The plan as it was before modifying.
+ * @param editedFoods The foods added or changed by the user.
+ */
+void NutritionPlanViewModel::rebalancePlan(NutritionPlan& plan, const NutritionPlan& originalPlan, const PortionBalancer::LockedPortions& editedFoods)
+{
+    MacroTargets targets;
+    std::cout << "Rebalance towards:\n1. Your daily targets\n2. The totals of the plan before modifying\n";
+    int targetChoice;
+    getValidInput(targetChoice, "Enter choice: ", 1, 2);
+    if (targetChoice == 1)
+    {
+        PlanRequest request;
+        if (!loadPersonalTargets(request))
+        {
+            return;
+        }
+        targets = request.targets;
+    }
+    else
+    {
+        MacroTargets::planTotals(originalPlan, targets.amounts);
+    }
+
+    std::vector<float> previousGrams;
+    size_t freeCount = 0;
+    for (const auto& meal : plan.meals)
+    {
+        for (const auto& foodPair : meal.second)
+        {
+            previousGrams.push_back(foodPair.second);
+            freeCount += editedFoods.count({ meal.first, foodPair.first.name }) == 0 ? 1 : 0;
+        }
+    }
+    if (freeCount == 0)
+    {
+        std::cout << "Every food in the plan was edited, there is nothing to rebalance.\n";
+        printWindowSizedSeparator();
+        return;
+    }
+
+    float before[FoodCatalog::MACRO_COUNT];
+    MacroTargets::planTotals(plan, before);
+
+    int iterations = portionBalancer.balance(plan, targets, editedFoods);
+    portionDiscretizer.discretize(plan, targets, editedFoods);
+
+    // Balancing neither adds nor reorders foods, so the entries line up with previousGrams
+    float after[FoodCatalog::MACRO_COUNT];
+    std::copy(before, before + FoodCatalog::MACRO_COUNT, after);
+    size_t entry = 0;
+    size_t changedCount = 0;
+    for (const auto& meal : plan.meals)
+    {
+        for (const auto& foodPair : meal.second)
+        {
+            float delta = (foodPair.second - previousGrams[entry++]) / 100;
+            if (delta != 0)
+            {
+                changedCount++;
+                after[FoodCatalog::CALORIES] += foodPair.first.calories * delta;
+                after[FoodCatalog::PROTEIN] += foodPair.first.protein * delta;
+                after[FoodCatalog::CARBS] += foodPair.first.carbohydrates * delta;
+                after[FoodCatalog::FATS] += foodPair.first.fats * delta;
+            }
+        }
+    }
+
+    // Drop foods the balancing reduced to nothing
+    for (auto& meal : plan.meals)
+    {
+        auto& mealItems = meal.second;
+        mealItems.erase(std::remove_if(mealItems.begin(), mealItems.end(),
+            [](const std::pair<FoodItem, float>& foodPair) { return foodPair.second <= 0; }), mealItems.end());
+    }
+
+    std::cout << "Rebalanced " << changedCount << " of " << freeCount << " portions in " << iterations << " iterations, "
+        << previousGrams.size() - freeCount << " edited foods kept.\n";
+    printMacroLine("Before", before);
+    printMacroLine("After", after);
+    printTargets(targets);
+}
+
 /**
  * @brief Display current foods in a meal.
  * @param mealItems The list of food items in the meal.
@@ -213,9 +401,13 @@ int viewOptions()
     std::cout << "View Options:\n";
     std::cout << "1. View All\n";
     std::cout << "2. Generate Plan by Goals\n";
-    std::cout << "3. Cancel\n";
+    std::cout << "3. Generate Optimized Plan by Goals\n";
+    std::cout << "4. Generate Weekly Plan by Goals\n";
+    std::cout << "5. Generation Report\n";
+    std::cout << "6. Shopping List\n";
+    std::cout << "7. Cancel\n";
 
-    return 3;
+    return 7;
 }
 
 /**
@@ -244,6 +436,23 @@ void NutritionPlanViewModel::view()
         viewPersonalizedPlan();
         break;
     case 3:
+    {
+        getOptionalInput(optimizerSettings.budgetMilliseconds, "Enter optimization time per plan in milliseconds (or press enter to keep "
+            + std::to_string(optimizerSettings.budgetMilliseconds) + "): ");
+        optimizerSettings.budgetMilliseconds = std::max(100, optimizerSettings.budgetMilliseconds);
+        viewPersonalizedPlan(GenerationMode::OPTIMIZER);
+        break;
+    }
+    case 4:
+        viewPersonalizedWeeklyPlan();
+        break;
+    case 5:
+        viewGenerationReport();
+        break;
+    case 6:
+        viewShoppingList();
+        break;
+    case 7:
         std::cout << "View operation cancelled.\n";
         break;
     default:
@@ -351,48 +560,188 @@ void NutritionPlanViewModel::displayPlan(const NutritionPlan& plan)
 
     // Print total nutrients for the entire plan
     printPlanTotal(totalPlan);
+    printNutrientTotals(plan);
 }
 
 /**
- * @brief Try loading profile and goals from CSV files.
- * @param profileFilename The filename of the profile CSV.
- * @param goalsFilename The filename of the goals CSV.
- * @param profile The Profile object to load data into.
- * @param goals The Goals object to load data into.
- * @return True if both profile and goals are loaded successfully, otherwise false.
+ * @brief Print the totals of the nutrients beyond the four macros, if the food items provide any.
+ *
+ * Catalog foods are summed by the catalog's matrix-vector kernel; foods missing from the
+ * catalog contribute their own nutrient values.
+ *
+ * @param plan The nutrition plan.
  */
-bool tryLoadProfileAndGoals(const std::string& profileFilename, const std::string& goalsFilename, Profile& profile, Goals& goals)
+void NutritionPlanViewModel::printNutrientTotals(const NutritionPlan& plan)
 {
-    if (!profile.loadFromCSV(profileFilename) || !goals.loadFromCSV(goalsFilename))
+    const size_t nutrientCount = foodCatalog.nutrientCount();
+    if (nutrientCount <= FoodCatalog::MACRO_COUNT)
+    {
+        return;
+    }
+
+    std::vector<float> totals(nutrientCount);
+    foodCatalog.nutrientTotals(foodCatalog.portionVector(plan.meals), totals.data());
+
+    for (const auto& meal : plan.meals)
+    {
+        for (const auto& foodPair : meal.second)
+        {
+            size_t index;
+            if (foodCatalog.findIndex(foodPair.first.name, index))
+            {
+                continue;
+            }
+            for (size_t nutrient = FoodCatalog::MACRO_COUNT; nutrient < nutrientCount; ++nutrient)
+            {
+                auto it = foodPair.first.nutrients.find(foodCatalog.nutrientName(nutrient));
+                if (it != foodPair.first.nutrients.end())
+                {
+                    totals[nutrient] += it->second * foodPair.second / 100;
+                }
+            }
+        }
+    }
+
+    // Only nutrients the plan's foods actually provide are listed
+    std::string separator = "Other nutrients: ";
+    for (size_t nutrient = FoodCatalog::MACRO_COUNT; nutrient < nutrientCount; ++nutrient)
+    {
+        if (totals[nutrient] > 0)
+        {
+            const std::string& name = foodCatalog.nutrientName(nutrient);
+            std::cout << separator << name << " " << totals[nutrient] << " " << nutrientUnit(name);
+            separator = ", ";
+        }
+    }
+    if (separator == ", ")
+    {
+        std::cout << "\n";
+        printWindowSizedSeparator();
+    }
+}
+
+/**
+ * @brief Load the profile and goals of the active user and derive the daily macro targets.
+ * @param request Receives the goal and the daily macro targets.
+ * @return True if the profile and goals were loaded, false otherwise.
+ */
+bool NutritionPlanViewModel::loadPersonalTargets(PlanRequest& request)
+{
+    Goals goals;
+    Profile profile;
+
+    if (!userRegistry.load(userRegistry.getActiveUser(), profile, goals))
     {
         std::cerr << "Error loading profile or goals.\n";
         return false;
     }
+
+    // The daily calories follow the average burn of the workout plan, and weekly plans its burn on each day
+    request.dayCalorieOffsets.clear();
+    BurnEstimator::DailyValues burn;
+    if (!goals.getWorkoutPlan().empty() && BurnEstimator::estimateSavedPlan(goals.getWorkoutPlan(), profile.getWeight(), burn))
+    {
+        float average = 0.0f;
+        for (float calories : burn)
+        {
+            average += calories / burn.size();
+        }
+        goals.setWorkoutBurn(average);
+        for (float calories : burn)
+        {
+            request.dayCalorieOffsets.push_back(calories - average);
+        }
+    }
+    else
+    {
+        goals.setWorkoutPlan("");
+    }
+
+    request.goal = goals.getFitnessGoal();
+    request.targets = macroTargetModel.derive(goals, profile);
     return true;
 }
 
 /**
- * @brief View a personalized nutrition plan based on goals.
+ * @brief Print the macro targets a plan was generated for.
+ * @param targets The macro targets.
  */
-void NutritionPlanViewModel::viewPersonalizedPlan()
+void NutritionPlanViewModel::printTargets(const MacroTargets& targets)
 {
-    Goals goals;
-    Profile profile;
+    printMacroLine("Targets", targets.amounts);
+    printWindowSizedSeparator();
+}
+
+/**
+ * @brief Print a line of macro amounts.
+ * @param label The label of the line.
+ * @param amounts The amounts, indexed by FoodCatalog::Macro.
+ */
+void NutritionPlanViewModel::printMacroLine(const std::string& label, const float* amounts)
+{
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << label << ": " << amounts[FoodCatalog::CALORIES] << " kcal (Protein: " << amounts[FoodCatalog::PROTEIN]
+        << " g, Carbohydrates: " << amounts[FoodCatalog::CARBS] << " g, Fats: " << amounts[FoodCatalog::FATS] << " g)\n";
+}
+
+/**
+ * @brief Ask the user for foods and categories to exclude and compile them.
+ * @return The compiled exclusions.
+ */
+ExclusionFilter NutritionPlanViewModel::promptExclusions()
+{
+    std::cout << "Available categories:";
+    for (const auto& category : getAvailableCategories(foodItemMap))
+    {
+        std::cout << " " << category << ";";
+    }
+    std::cout << "\n";
+
+    std::string input;
+    std::cout << "Enter foods or categories to exclude separated by commas (or press enter for none): ";
+    std::getline(std::cin, input);
+
+    std::set<std::string> terms;
+    std::stringstream ss(input);
+    std::string term;
+    while (std::getline(ss, term, ','))
+    {
+        size_t first = term.find_first_not_of(" \t");
+        if (first == std::string::npos)
+        {
+            continue;
+        }
+        size_t last = term.find_last_not_of(" \t");
+        terms.insert(toLower(term.substr(first, last - first + 1)));
+    }
 
-    if (!tryLoadProfileAndGoals("profile.csv", "goals.csv", profile, goals)) return;
+    ExclusionFilter exclusions(foodCatalog, terms);
+    for (const auto& unknown : exclusions.getUnknownTerms())
+    {
+        std::cout << "Unknown food or category '" << unknown << "' ignored.\n";
+    }
+    return exclusions;
+}
+
+/**
+ * @brief View a personalized nutrition plan based on goals.
+ * @param mode The generation strategy.
+ */
+void NutritionPlanViewModel::viewPersonalizedPlan(GenerationMode mode)
+{
+    PlanRequest request;
 
-    goals.setProfile(&profile);
-    float requiredCalories = goals.getDailyCalories();
-    float requiredProtein = (goals.getFitnessGoal() == Goals::FitnessGoal::MUSCLE_GAIN) ?
-        profile.getWeight() * 2.2f : profile.getWeight() * 1.6f;
+    if (!loadPersonalTargets(request)) return;
+    request.exclusions = promptExclusions();
 
     while (true)
     {
-        NutritionPlan randomPlan = generateNextPlan(requiredCalories, requiredProtein);
+        NutritionPlan randomPlan = generateNextPlan(request, mode);
 
         clearScreen();
         printLabel("Viewing generated nutrition plan");
         displayPlan(randomPlan);
+        printTargets(request.targets);
 
         std::string choice;
         do
@@ -421,6 +770,216 @@ void NutritionPlanViewModel::viewPersonalizedPlan()
     }
 }
 
+/**
+ * @brief Print the convergence and quality statistics of the plans generated in this session.
+ *
+ * The statistics can additionally be saved as JSON to compare them between runs.
+ */
+void NutritionPlanViewModel::viewGenerationReport()
+{
+    printLabel("Generation report");
+    telemetry.printReport(std::cout);
+    printWindowSizedSeparator();
+
+    if (telemetry.getGenerationCount() == 0)
+    {
+        return;
+    }
+
+    std::string filename = "generation_telemetry.json";
+    getOptionalInput(filename, "Enter a file to save the report as JSON (or press enter for " + filename + "), or 'no' to skip: ");
+    if (filename != "no" && telemetry.saveJSON(filename))
+    {
+        std::cout << "Report saved to " << filename << ".\n";
+    }
+}
+
+/**
+ * @brief Build and print a shopping list for one or more plans.
+ *
+ * Plans are looked up by name among the templates, the saved personal plan and the saved
+ * weekly plans; a weekly plan contributes all seven days.
+ */
+void NutritionPlanViewModel::viewShoppingList()
+{
+    std::string input;
+    std::cout << "Enter plan names separated by commas (or press enter for all templates): ";
+    std::getline(std::cin, input);
+
+    std::vector<const NutritionPlan*> plans;
+    std::map<std::string, NutritionPlan> personalPlans;
+    std::map<std::string, WeeklyNutritionPlan> weeklyPlans;
+    bool savedPlansLoaded = false;
+
+    std::stringstream ss(input);
+    std::string name;
+    while (std::getline(ss, name, ','))
+    {
+        size_t first = name.find_first_not_of(" \t");
+        if (first == std::string::npos)
+        {
+            continue;
+        }
+        name = name.substr(first, name.find_last_not_of(" \t") - first + 1);
+
+        auto planIt = nutritionPlanMap.find(name);
+        if (planIt != nutritionPlanMap.end())
+        {
+            plans.push_back(&planIt->second);
+            continue;
+        }
+
+        if (!savedPlansLoaded)
+        {
+            personalPlans = readFromCSV<NutritionPlan, FoodItem>("personal_nutritional_plan.csv", foodItemMap);
+            weeklyPlans = readFromCSV<WeeklyNutritionPlan, FoodItem>("weekly_nutrition_plans.csv", foodItemMap);
+            savedPlansLoaded = true;
+        }
+
+        auto personalIt = personalPlans.find(name);
+        auto weeklyIt = weeklyPlans.find(name);
+        if (personalIt != personalPlans.end())
+        {
+            plans.push_back(&personalIt->second);
+        }
+        else if (weeklyIt != weeklyPlans.end())
+        {
+            for (const auto& day : weeklyIt->second.dailyPlans)
+            {
+                plans.push_back(&day.second);
+            }
+        }
+        else
+        {
+            std::cout << "Unknown plan '" << name << "' ignored.\n";
+        }
+    }
+
+    if (input.find_first_not_of(" \t,") == std::string::npos)
+    {
+        for (const auto& pair : nutritionPlanMap)
+        {
+            plans.push_back(&pair.second);
+        }
+    }
+
+    int people = 1;
+    getOptionalInput(people, "Enter the number of people to shop for (or press enter for 1): ");
+    people = std::max(1, people);
+
+    ShoppingList shoppingList;
+    shoppingList.build(plans, static_cast<float>(people));
+
+    printLabel("Shopping list");
+    if (shoppingList.empty())
+    {
+        std::cout << "Nothing to buy.\n";
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& category : shoppingList.getCategories())
+    {
+        std::cout << category.first << ":\n";
+        for (const auto& item : category.second)
+        {
+            std::cout << "  " << item.foodItem.name << ": " << item.grams << " g";
+            if (item.servings > 0)
+            {
+                std::cout << " (" << item.servings << " servings)";
+            }
+            std::cout << "\n";
+        }
+    }
+    printWindowSizedSeparator();
+}
+
+/**
+ * @brief Display a weekly nutrition plan day by day, followed by the weekly average.
+ * @param plan The weekly nutrition plan to display.
+ */
+void NutritionPlanViewModel::displayWeeklyPlan(const WeeklyNutritionPlan& plan)
+{
+    std::cout << "Weekly plan: " << plan.name << "\n";
+    printWindowSizedSeparator();
+
+    TotalNutrients weeklyTotal;
+
+    for (const auto& day : DAYS_OF_WEEK)
+    {
+        auto it = plan.dailyPlans.find(day);
+        if (it == plan.dailyPlans.end())
+        {
+            continue;
+        }
+
+        displayPlan(it->second);
+
+        float dayTotals[FoodCatalog::MACRO_COUNT];
+        MacroTargets::planTotals(it->second, dayTotals);
+        weeklyTotal.calories += dayTotals[FoodCatalog::CALORIES];
+        weeklyTotal.protein += dayTotals[FoodCatalog::PROTEIN];
+        weeklyTotal.carbs += dayTotals[FoodCatalog::CARBS];
+        weeklyTotal.fats += dayTotals[FoodCatalog::FATS];
+    }
+
+    float days = static_cast<float>(std::max<size_t>(1, plan.dailyPlans.size()));
+    std::cout << "Daily average: " << weeklyTotal.calories / days << " kcal (Protein: " << weeklyTotal.protein / days
+        << " g, Carbohydrates: " << weeklyTotal.carbs / days << " g, Fats: " << weeklyTotal.fats / days << " g)\n";
+    printWindowSizedSeparator();
+}
+
+/**
+ * @brief View a personalized weekly nutrition plan based on goals.
+ */
+void NutritionPlanViewModel::viewPersonalizedWeeklyPlan()
+{
+    PlanRequest request;
+
+    if (!loadPersonalTargets(request)) return;
+    request.exclusions = promptExclusions();
+
+    while (true)
+    {
+        WeeklyNutritionPlan weeklyPlan = generateWeeklyPlan(request);
+
+        clearScreen();
+        printLabel("Viewing generated weekly nutrition plan");
+        displayWeeklyPlan(weeklyPlan);
+        printTargets(request.targets);
+
+        std::string choice;
+        do
+        {
+            std::cout << "Do you want to generate another weekly plan? (yes/no) or save (save): ";
+            std::getline(std::cin >> std::ws, choice);
+        } while (choice != "yes" && choice != "no" && choice != "save");
+
+        if (choice == "no")
+        {
+            break;
+        }
+        else if (choice == "save")
+        {
+            std::string planName;
+            std::cout << "Enter plan name: ";
+            std::getline(std::cin >> std::ws, planName);
+            weeklyPlan.name = planName;
+
+            auto weeklyPlans = readFromCSV<WeeklyNutritionPlan, FoodItem>("weekly_nutrition_plans.csv", foodItemMap);
+            if (!confirmOverwrite(weeklyPlans, planName))
+            {
+                break;
+            }
+            weeklyPlans[planName] = weeklyPlan;
+
+            overwriteCSV("weekly_nutrition_plans.csv", weeklyPlans);
+            std::cout << "Weekly plan saved.\n";
+            break;
+        }
+    }
+}
+
 /**
  * @brief Add a new nutrition plan.
  */
@@ -444,8 +1003,15 @@ void NutritionPlanViewModel::add()
 
     NutritionPlan plan(name, meals);
     modifyNutritionPlan(plan, foodItemMap);
+    auto existing = nutritionPlanMap.find(name);
+    if (existing != nutritionPlanMap.end())
+    {
+        foodUsageIndex.removePlan(existing->second);
+    }
     nutritionPlanMap[name] = plan;
+    foodUsageIndex.indexPlan(plan);
     overwriteCSV(filename, nutritionPlanMap);
+    indexTemplates();
 }
 
 /**
@@ -468,8 +1034,11 @@ void NutritionPlanViewModel::modify()
     }
 
     auto& selectedPlan = nutritionPlanMap[selectedPlanName];
+    foodUsageIndex.removePlan(selectedPlan);
     modifyNutritionPlan(selectedPlan, foodItemMap);
+    foodUsageIndex.indexPlan(selectedPlan);
     overwriteCSV(filename, nutritionPlanMap);
+    indexTemplates();
 }
 
 /**
@@ -528,7 +1097,9 @@ void NutritionPlanViewModel::importFromFile(const std::string& filename)
         }
     }
 
+    foodUsageIndex.build(nutritionPlanMap);
     overwriteCSV("nutrition_plans.csv", nutritionPlanMap);
+    indexTemplates();
 }
 
 /**
@@ -538,6 +1109,209 @@ void NutritionPlanViewModel::reload()
 {
     foodItemMap = readFromCSV<FoodItem>("food_items.csv");
     nutritionPlanMap = readFromCSV<NutritionPlan, FoodItem>(filename, foodItemMap);
+    foodUsageIndex.build(nutritionPlanMap);
+    foodCatalog = FoodCatalog(foodItemMap);
+    indexTemplates();
+}
+
+/**
+ * @brief Rename a food in the template plans using it and in the saved plans.
+ *
+ * Only the plan entries listed in the usage index are touched, and the plan file is written
+ * once, only if a template plan changed.
+ *
+ * @param oldName The previous food name.
+ * @param foodItem The food item under its new name.
+ */
+void NutritionPlanViewModel::foodRenamed(const std::string& oldName, const FoodItem& foodItem)
+{
+    auto touched = foodUsageIndex.renameFood(nutritionPlanMap, oldName, foodItem);
+    updateSavedPlans([&](NutritionPlan& plan)
+        {
+            bool changed = false;
+            for (auto& meal : plan.meals)
+            {
+                for (auto& foodPair : meal.second)
+                {
+                    if (foodPair.first.name == oldName)
+                    {
+                        foodPair.first = foodItem;
+                        changed = true;
+                    }
+                }
+            }
+            return changed;
+        });
+
+    foodItemMap.erase(oldName);
+    foodItemMap[foodItem.name] = foodItem;
+    if (!touched.empty())
+    {
+        overwriteCSV(filename, nutritionPlanMap);
+        std::cout << "Renamed '" << oldName << "' in " << touched.size() << " nutrition plan(s).\n";
+    }
+    refreshFoodData();
+}
+
+/**
+ * @brief Update the copies of a food in the template plans using it and in the saved plans.
+ * @param foodItem The new or changed food item.
+ */
+void NutritionPlanViewModel::foodModified(const FoodItem& foodItem)
+{
+    auto touched = foodUsageIndex.updateFood(nutritionPlanMap, foodItem);
+    updateSavedPlans([&](NutritionPlan& plan)
+        {
+            bool changed = false;
+            for (auto& meal : plan.meals)
+            {
+                for (auto& foodPair : meal.second)
+                {
+                    if (foodPair.first.name == foodItem.name)
+                    {
+                        foodPair.first = foodItem;
+                        changed = true;
+                    }
+                }
+            }
+            return changed;
+        });
+
+    foodItemMap[foodItem.name] = foodItem;
+    if (!touched.empty())
+    {
+        overwriteCSV(filename, nutritionPlanMap);
+    }
+    refreshFoodData();
+}
+
+/**
+ * @brief Remove a deleted food from the template plans using it and from the saved plans.
+ * @param name The name of the deleted food item.
+ */
+void NutritionPlanViewModel::foodRemoved(const std::string& name)
+{
+    auto touched = foodUsageIndex.removeFood(nutritionPlanMap, name);
+    updateSavedPlans([&](NutritionPlan& plan)
+        {
+            bool changed = false;
+            for (auto& meal : plan.meals)
+            {
+                auto& mealItems = meal.second;
+                size_t count = mealItems.size();
+                mealItems.erase(std::remove_if(mealItems.begin(), mealItems.end(),
+                    [&](const std::pair<FoodItem, float>& foodPair) { return foodPair.first.name == name; }), mealItems.end());
+                changed = changed || mealItems.size() != count;
+            }
+            return changed;
+        });
+
+    foodItemMap.erase(name);
+    if (!touched.empty())
+    {
+        overwriteCSV(filename, nutritionPlanMap);
+        std::cout << "Removed '" << name << "' from " << touched.size() << " nutrition plan(s).\n";
+    }
+    refreshFoodData();
+}
+
+/**
+ * @brief List the template plans using a food.
+ * @param name The food name.
+ * @return The names of the template plans.
+ */
+std::vector<std::string> NutritionPlanViewModel::usersOf(const std::string& name) const
+{
+    auto plans = foodUsageIndex.plansUsing(name);
+    return std::vector<std::string>(plans.begin(), plans.end());
+}
+
+/**
+ * @brief Apply a food change to the saved personal and weekly plans and rewrite the files that changed.
+ *
+ * The saved plans are not indexed, as there are only a few of them and they are read on demand
+ * everywhere else as well.
+ *
+ * @param edit Applies the change to one plan and returns true if the plan changed.
+ */
+void NutritionPlanViewModel::updateSavedPlans(const std::function<bool(NutritionPlan&)>& edit)
+{
+    const std::string personalFile = "personal_nutritional_plan.csv";
+    const std::string weeklyFile = "weekly_nutrition_plans.csv";
+
+    if (std::ifstream(personalFile).is_open())
+    {
+        auto personalPlans = readFromCSV<NutritionPlan, FoodItem>(personalFile, foodItemMap);
+        bool changed = false;
+        for (auto& pair : personalPlans)
+        {
+            changed = edit(pair.second) || changed;
+        }
+        if (changed)
+        {
+            overwriteCSV(personalFile, personalPlans);
+        }
+    }
+
+    if (std::ifstream(weeklyFile).is_open())
+    {
+        auto weeklyPlans = readFromCSV<WeeklyNutritionPlan, FoodItem>(weeklyFile, foodItemMap);
+        bool changed = false;
+        for (auto& pair : weeklyPlans)
+        {
+            for (auto& day : pair.second.dailyPlans)
+            {
+                changed = edit(day.second) || changed;
+            }
+        }
+        if (changed)
+        {
+            overwriteCSV(weeklyFile, weeklyPlans);
+        }
+    }
+}
+
+/**
+ * @brief Rebuild the food catalog and template masks after foodItemMap changed.
+ */
+void NutritionPlanViewModel::refreshFoodData()
+{
+    foodCatalog = FoodCatalog(foodItemMap);
+    indexTemplates();
+}
+
+/**
+ * @brief Recompute the food and category masks of all template plans and invalidate the plan cache if they changed.
+ *
+ * The masks let generation reject a template against any exclusion set without walking its meals.
+ * Cached plans survive a reload as long as the templates and food items are unchanged.
+ */
+void NutritionPlanViewModel::indexTemplates()
+{
+    templateMasks.clear();
+    for (const auto& pair : nutritionPlanMap)
+    {
+        templateMasks[pair.first] = foodCatalog.planMask(pair.second.meals);
+    }
+    planCache.invalidate(dataFingerprint());
+}
+
+/**
+ * @brief Calculate a fingerprint of the template plans and food items.
+ * @return A hash of the CSV representation of the plans and food items.
+ */
+size_t NutritionPlanViewModel::dataFingerprint() const
+{
+    std::stringstream ss;
+    for (const auto& pair : foodItemMap)
+    {
+        pair.second.toCSV(ss);
+    }
+    for (const auto& pair : nutritionPlanMap)
+    {
+        pair.second.toCSV(ss);
+    }
+    return std::hash<std::string>()(ss.str());
 }
 
 /**
@@ -595,8 +1369,10 @@ void NutritionPlanViewModel::confirmAndRemovePlan(const std::string& selectedPla
         return;
     }
 
+    foodUsageIndex.removePlan(plan);
     nutritionPlanMap.erase(selectedPlanName);
     overwriteCSV(filename, nutritionPlanMap);
+    indexTemplates();
     std::cout << "Nutrition plan '" << selectedPlanName << "' deleted.\n";
 }
 
@@ -618,11 +1394,72 @@ void NutritionPlanViewModel::shufflePlanNames()
 
 /**
  * @brief Generate the next nutrition plan in the shuffled order.
- * @param targetCalories The target number of calories for the nutrition plan.
- * @param targetProtein The target amount of protein for the nutrition plan.
+ *
+ * Templates containing excluded foods are skipped before any portion work is done. Only if
+ * every template is rejected are the excluded foods of one replaced by allowed foods.
+ * Requests with nearly the same targets, goal and exclusions are answered from planCache
+ * once it holds enough different plans for them.
+ *
+ * @param request The targets and exclusions of the plan.
+ * @param mode The generation strategy; OPTIMIZER refines the heuristic plan for optimizerSettings.budgetMilliseconds.
  * @return The generated nutrition plan.
  */
-NutritionPlan NutritionPlanViewModel::generateNextPlan(float targetCalories, float targetProtein)
+NutritionPlan NutritionPlanViewModel::generateNextPlan(const PlanRequest& request, GenerationMode mode)
+{
+    // The optimizer budget is part of the key, so a longer budget is not answered with plans of a shorter one
+    int variant = mode == GenerationMode::OPTIMIZER ? optimizerSettings.budgetMilliseconds : 0;
+    PlanCache::Key key = planCache.makeKey(request.targets.calories(), request.targets.protein(),
+        static_cast<int>(request.goal), variant, request.exclusions.getTerms());
+
+    GenerationRecord record;
+    record.mode = mode == GenerationMode::OPTIMIZER ? "optimizer" : "heuristic";
+    auto start = std::chrono::steady_clock::now();
+
+    NutritionPlan plan;
+    if (planCache.lookup(key, plan))
+    {
+        record.cacheHit = true;
+        record.templateName = plan.name;
+        record.setResult(plan, request.targets);
+        record.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        telemetry.add(record);
+        return plan;
+    }
+
+    plan = nextTemplate(request.exclusions);
+    record.templateName = plan.name;
+    if (isTemplateExcluded(plan, request.exclusions))
+    {
+        record.foodsReplaced = true;
+        removeExcludedFoods(plan, request.exclusions);
+    }
+
+    plan = fitPlanToTargets(plan, request.targets, record);
+
+    if (mode == GenerationMode::OPTIMIZER)
+    {
+        PlanOptimizer optimizer(foodCatalog, optimizerSettings);
+        record.measure("optimize", 0, [&]
+            {
+                plan = optimizer.optimize(plan, request.targets, request.exclusions);
+                return static_cast<int>(std::min<long>(optimizer.getMoveCount(), std::numeric_limits<int>::max()));
+            });
+        record.measure("discretize optimized", 0, [&] { return portionDiscretizer.discretize(plan, request.targets); });
+    }
+
+    record.setResult(plan, request.targets);
+    record.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    telemetry.add(record);
+
+    planCache.store(key, plan);
+    return plan;
+}
+
+/**
+ * @brief Get the next template plan in the shuffled order.
+ * @return The next template plan.
+ */
+const NutritionPlan& NutritionPlanViewModel::nextTemplate()
 {
     if (nutritionPlanMap.empty())
     {
@@ -636,38 +1473,339 @@ NutritionPlan NutritionPlanViewModel::generateNextPlan(float targetCalories, flo
         currentPlanIndex = 0;
     }
 
-    const int maxIterations = 1000;
-
     // Select the next plan in the shuffled order
-    NutritionPlan selectedPlan = nutritionPlanMap.at(shuffledPlanNames[currentPlanIndex]);
-    currentPlanIndex++;  // Move to the next plan
+    return nutritionPlanMap.at(shuffledPlanNames[currentPlanIndex++]);
+}
+
+/**
+ * @brief Get the next template plan in the shuffled order that contains no excluded food.
+ * @param exclusions The compiled exclusions.
+ * @return The next allowed template plan, or the last one tried if every template is rejected.
+ */
+const NutritionPlan& NutritionPlanViewModel::nextTemplate(const ExclusionFilter& exclusions)
+{
+    const NutritionPlan* plan = &nextTemplate();
+
+    // Try each template at most once
+    for (size_t attempt = 1; attempt < nutritionPlanMap.size() && isTemplateExcluded(*plan, exclusions); ++attempt)
+    {
+        plan = &nextTemplate();
+    }
+    return *plan;
+}
+
+/**
+ * @brief Check a template plan against the exclusions using its precomputed masks.
+ * @param plan The template plan.
+ * @param exclusions The compiled exclusions.
+ * @return True if the plan contains an excluded food.
+ */
+bool NutritionPlanViewModel::isTemplateExcluded(const NutritionPlan& plan, const ExclusionFilter& exclusions) const
+{
+    if (exclusions.empty())
+    {
+        return false;
+    }
+
+    auto it = templateMasks.find(plan.name);
+    if (it == templateMasks.end())
+    {
+        return exclusions.rejects(foodCatalog.planMask(plan.meals));
+    }
+    return exclusions.rejects(it->second);
+}
+
+/**
+ * @brief Replace excluded foods of a plan with allowed foods of a shared category, or drop them.
+ * @param plan The nutrition plan to modify.
+ * @param exclusions The compiled exclusions.
+ */
+void NutritionPlanViewModel::removeExcludedFoods(NutritionPlan& plan, const ExclusionFilter& exclusions)
+{
+    substituteFoods(plan, foodCatalog,
+        [&](const FoodItem& foodItem) { return exclusions.excludesItem(foodItem); },
+        [&](size_t index) { return !exclusions.excludesFood(index); });
+}
 
-    NutritionPlan newPlan = selectedPlan;  // Start with a copy of the selected plan
+/**
+ * @brief Adjust the portions of a template plan so that it meets the macro targets.
+ *
+ * The calorie and protein heuristics bring the template close to the targets, then all four
+ * macros are balanced together and the portions are snapped to whole servings, half servings
+ * or 5 gram steps.
+ *
+ * @param newPlan The template plan to adjust.
+ * @param targets The macro targets.
+ * @return The adjusted nutrition plan.
+ */
+NutritionPlan NutritionPlanViewModel::fitPlanToTargets(NutritionPlan newPlan, const MacroTargets& targets, GenerationRecord& record)
+{
+    const int maxIterations = 1000;
+    const float targetCalories = targets.calories();
+    const float targetProtein = targets.protein();
 
     float currentCalories = 0;
     float currentProtein = 0;
 
-    // Calculate the current calories and protein of the selected plan
-    calculateCurrentValues(selectedPlan, currentCalories, currentProtein);
+    // Calculate the current calories and protein of the template plan
+    calculateCurrentValues(newPlan, currentCalories, currentProtein);
 
     // Reduce portions if the current calories are too high
-    adjustPortions(newPlan, currentCalories, currentProtein, targetCalories, maxIterations, true);
+    record.measure("reduce calories", maxIterations,
+        [&] { return adjustPortions(newPlan, currentCalories, currentProtein, targetCalories, maxIterations, true); });
 
     // Increase protein intake if it is below the target
-    adjustProtein(newPlan, currentProtein, targetProtein, currentCalories, maxIterations, true);
+    record.measure("increase protein", maxIterations,
+        [&] { return adjustProtein(newPlan, currentProtein, targetProtein, currentCalories, maxIterations, true); });
 
     // Decrease protein intake if it is above the target
-    adjustProtein(newPlan, currentProtein, targetProtein, currentCalories, maxIterations, false);
+    record.measure("decrease protein", maxIterations,
+        [&] { return adjustProtein(newPlan, currentProtein, targetProtein, currentCalories, maxIterations, false); });
 
     // Add non-protein items to match caloric needs
-    adjustNonProteinItems(newPlan, currentCalories, targetCalories, currentProtein, maxIterations);
+    record.measure("add non-protein", maxIterations,
+        [&] { return adjustNonProteinItems(newPlan, currentCalories, targetCalories, currentProtein, maxIterations); });
 
     // Final adjustment to ensure the values are within the goals
-    finalAdjustment(newPlan, currentCalories, targetCalories, currentProtein, targetProtein);
+    record.measure("final adjustment", maxIterations,
+        [&] { return finalAdjustment(newPlan, currentCalories, targetCalories, currentProtein, targetProtein); });
+
+    // Balance calories, protein, carbohydrates and fats together
+    record.measure("balance", portionBalancer.getSettings().maxIterations,
+        [&] { return portionBalancer.balance(newPlan, targets); });
+
+    // Replace fractional grams with realistic serving amounts
+    record.measure("discretize", 0,
+        [&] { return portionDiscretizer.discretize(newPlan, targets); });
+
+    // Drop foods the balancing reduced to nothing
+    for (auto& meal : newPlan.meals)
+    {
+        auto& mealItems = meal.second;
+        mealItems.erase(std::remove_if(mealItems.begin(), mealItems.end(),
+            [](const std::pair<FoodItem, float>& foodPair) { return foodPair.second <= 0; }), mealItems.end());
+    }
 
     return newPlan;
 }
 
+/**
+ * @brief Generate seven coordinated daily plans whose weekly average meets the targets.
+ *
+ * The food catalog (per-gram macros and category pools) is shared by all days.
+ * Each day is aimed at what is left of the weekly budget, so deviations of earlier days are
+ * balanced out by later ones, and no food appears on more than maxFoodRepeatsPerWeek days.
+ *
+ * @param request The average daily targets and the exclusions of the plan.
+ * @return The generated weekly nutrition plan.
+ */
+WeeklyNutritionPlan NutritionPlanViewModel::generateWeeklyPlan(const PlanRequest& request)
+{
+    const FoodCatalog& catalog = foodCatalog;
+    const size_t dayCount = DAYS_OF_WEEK.size();
+
+    WeeklyNutritionPlan weeklyPlan;
+    std::map<std::string, int> foodUsage;
+    float weeklyTotals[FoodCatalog::MACRO_COUNT] = {};
+
+    // Training days get the calories they burn above the weekly average, as carbohydrates
+    std::vector<MacroTargets> plannedTargets(dayCount, request.targets);
+    for (size_t day = 0; day < dayCount && day < request.dayCalorieOffsets.size(); ++day)
+    {
+        float offset = request.dayCalorieOffsets[day];
+        plannedTargets[day].amounts[FoodCatalog::CALORIES] += offset;
+        plannedTargets[day].amounts[FoodCatalog::CARBS] = std::max(0.0f, plannedTargets[day].amounts[FoodCatalog::CARBS] + offset / 4);
+    }
+
+    float plannedTotals[FoodCatalog::MACRO_COUNT] = {};
+    for (size_t day = 0; day < dayCount; ++day)
+    {
+        // Spread what is left behind or ahead of plan over the remaining days, within 10% of the day's target
+        float remainingDays = static_cast<float>(dayCount - day);
+        MacroTargets dayTargets = plannedTargets[day];
+        for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+        {
+            float target = plannedTargets[day].amounts[m];
+            float remaining = target + (plannedTotals[m] - weeklyTotals[m]) / remainingDays;
+            dayTargets.amounts[m] = std::min(std::max(remaining, target * 0.9f), target * 1.1f);
+            plannedTotals[m] += target;
+        }
+
+        GenerationRecord record;
+        record.mode = "weekly";
+        auto start = std::chrono::steady_clock::now();
+
+        NutritionPlan dayTemplate = selectWeeklyTemplate(foodUsage, request.exclusions);
+        record.templateName = dayTemplate.name;
+        if (isTemplateExcluded(dayTemplate, request.exclusions))
+        {
+            record.foodsReplaced = true;
+            removeExcludedFoods(dayTemplate, request.exclusions);
+        }
+        enforceFoodVariety(dayTemplate, catalog, foodUsage, request.exclusions);
+
+        NutritionPlan dayPlan = fitPlanToTargets(dayTemplate, dayTargets, record);
+        record.setResult(dayPlan, dayTargets);
+        record.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        telemetry.add(record);
+        dayPlan.name = DAYS_OF_WEEK[day];
+
+        std::set<std::string> dayFoods;
+        for (const auto& meal : dayPlan.meals)
+        {
+            for (const auto& foodPair : meal.second)
+            {
+                dayFoods.insert(foodPair.first.name);
+            }
+        }
+        for (const auto& foodName : dayFoods)
+        {
+            foodUsage[foodName]++;
+        }
+
+        float dayTotals[FoodCatalog::MACRO_COUNT];
+        MacroTargets::planTotals(dayPlan, dayTotals);
+        for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+        {
+            weeklyTotals[m] += dayTotals[m];
+        }
+
+        weeklyPlan.dailyPlans[dayPlan.name] = dayPlan;
+    }
+
+    return weeklyPlan;
+}
+
+/**
+ * @brief Select the template plan that repeats the fewest foods already used up this week.
+ * @param foodUsage Number of days each food has been used so far.
+ * @param exclusions The compiled exclusions; excluded templates are only used as a last resort.
+ * @return A copy of the selected template plan.
+ */
+NutritionPlan NutritionPlanViewModel::selectWeeklyTemplate(const std::map<std::string, int>& foodUsage, const ExclusionFilter& exclusions)
+{
+    const NutritionPlan* bestTemplate = nullptr;
+    size_t bestOverCap = 0;
+
+    // Try each template at most once, in the shuffled order
+    for (size_t attempt = 0; attempt < nutritionPlanMap.size(); ++attempt)
+    {
+        const NutritionPlan& candidate = nextTemplate();
+
+        if (isTemplateExcluded(candidate, exclusions))
+        {
+            if (bestTemplate == nullptr)
+            {
+                bestTemplate = &candidate;
+                bestOverCap = std::numeric_limits<size_t>::max();
+            }
+            continue;
+        }
+
+        size_t overCap = 0;
+        for (const auto& meal : candidate.meals)
+        {
+            for (const auto& foodPair : meal.second)
+            {
+                auto it = foodUsage.find(foodPair.first.name);
+                if (it != foodUsage.end() && it->second >= maxFoodRepeatsPerWeek)
+                {
+                    overCap++;
+                }
+            }
+        }
+
+        if (bestTemplate == nullptr || overCap < bestOverCap)
+        {
+            bestTemplate = &candidate;
+            bestOverCap = overCap;
+        }
+        if (bestOverCap == 0)
+        {
+            break;
+        }
+    }
+
+    return *bestTemplate;
+}
+
+/**
+ * @brief Replace foods that reached the weekly repeat cap with calorie-matched foods of the same category.
+ *
+ * Foods without an allowed substitute are dropped, so the cap always holds; the portions of the
+ * remaining foods make up for them when the plan is fitted to the targets.
+ *
+ * @param plan The nutrition plan to modify.
+ * @param catalog The food catalog shared by all days of the week.
+ * @param foodUsage Number of days each food has been used so far.
+ * @param exclusions The compiled exclusions, excluded foods are never used as substitutes.
+ */
+void NutritionPlanViewModel::enforceFoodVariety(NutritionPlan& plan, const FoodCatalog& catalog, const std::map<std::string, int>& foodUsage, const ExclusionFilter& exclusions)
+{
+    auto isUsedUp = [&](const std::string& foodName)
+    {
+        auto it = foodUsage.find(foodName);
+        return it != foodUsage.end() && it->second >= maxFoodRepeatsPerWeek;
+    };
+
+    substituteFoods(plan, catalog,
+        [&](const FoodItem& foodItem) { return isUsedUp(foodItem.name); },
+        [&](size_t index) { return !isUsedUp(catalog.item(index).name) && !exclusions.excludesFood(index); });
+}
+
+/**
+ * @brief Replace foods of a plan with calorie-matched foods of a shared category, or drop them.
+ *
+ * The substitute is the food of a shared category with the closest macro profile per gram,
+ * see FoodCatalog::suggestSubstitutes, so the plan keeps roughly the same macros. Foods
+ * without an allowed substitute are removed.
+ *
+ * @param plan The nutrition plan to modify.
+ * @param catalog The food catalog to take substitutes from.
+ * @param mustReplace Returns true for food items that have to be replaced.
+ * @param isAllowed Returns true for catalog indices that may be used as substitutes.
+ */
+void NutritionPlanViewModel::substituteFoods(NutritionPlan& plan, const FoodCatalog& catalog, const std::function<bool(const FoodItem&)>& mustReplace,
+    const std::function<bool(size_t)>& isAllowed)
+{
+    std::set<std::string> planFoods;
+    for (const auto& meal : plan.meals)
+    {
+        for (const auto& foodPair : meal.second)
+        {
+            planFoods.insert(foodPair.first.name);
+        }
+    }
+
+    for (auto& meal : plan.meals)
+    {
+        auto& mealItems = meal.second;
+        for (auto it = mealItems.begin(); it != mealItems.end();)
+        {
+            if (!mustReplace(it->first))
+            {
+                ++it;
+                continue;
+            }
+
+            auto substitutes = catalog.suggestSubstitutes(it->first, it->second, 1,
+                [&](size_t candidate) { return planFoods.count(catalog.item(candidate).name) == 0 && isAllowed(candidate); });
+
+            if (!substitutes.empty())
+            {
+                const FoodItem& substitute = catalog.item(substitutes.front().index);
+                planFoods.insert(substitute.name);
+                *it = { substitute, substitutes.front().grams };
+                ++it;
+            }
+            else
+            {
+                it = mealItems.erase(it);
+            }
+        }
+    }
+}
+
 /**
  * @brief Calculate current calories and protein in a plan.
  * @param plan The nutrition plan to calculate values for.
@@ -697,8 +1835,9 @@ void NutritionPlanViewModel::calculateCurrentValues(const NutritionPlan& plan, f
  * @param target The target value to adjust towards (calories or protein).
  * @param maxIterations The maximum number of iterations to attempt adjustments.
  * @param isReducing True if reducing portions, false if increasing portions.
+ * @return The number of iterations performed.
  */
-void NutritionPlanViewModel::adjustPortions(NutritionPlan& plan, float& currentCalories, float& currentProtein, float target, int maxIterations, bool isReducing)
+int NutritionPlanViewModel::adjustPortions(NutritionPlan& plan, float& currentCalories, float& currentProtein, float target, int maxIterations, bool isReducing)
 {
     int iterationCount = 0;
 
@@ -717,6 +1856,7 @@ void NutritionPlanViewModel::adjustPortions(NutritionPlan& plan, float& currentC
         calculateCurrentValues(plan, currentCalories, currentProtein);
         iterationCount++;
     }
+    return iterationCount;
 }
 
 /**
@@ -727,8 +1867,9 @@ void NutritionPlanViewModel::adjustPortions(NutritionPlan& plan, float& currentC
  * @param currentCalories The current total calories in the plan.
  * @param maxIterations The maximum number of iterations to attempt adjustments.
  * @param isIncreasing True if increasing protein intake, false if decreasing protein intake.
+ * @return The number of iterations performed.
  */
-void NutritionPlanViewModel::adjustProtein(NutritionPlan& plan, float& currentProtein, float targetProtein, float& currentCalories, int maxIterations, bool isIncreasing)
+int NutritionPlanViewModel::adjustProtein(NutritionPlan& plan, float& currentProtein, float targetProtein, float& currentCalories, int maxIterations, bool isIncreasing)
 {
     int iterationCount = 0;
 
@@ -751,13 +1892,14 @@ void NutritionPlanViewModel::adjustProtein(NutritionPlan& plan, float& currentPr
 
                     if ((isIncreasing ? currentProtein >= targetProtein : currentProtein <= targetProtein))
                     {
-                        return;
+                        return iterationCount + 1;
                     }
                 }
             }
         }
         iterationCount++;
     }
+    return iterationCount;
 }
 
 /**
@@ -767,8 +1909,9 @@ void NutritionPlanViewModel::adjustProtein(NutritionPlan& plan, float& currentPr
  * @param targetCalories The target caloric value to adjust towards.
  * @param currentProtein The current total protein in the plan.
  * @param maxIterations The maximum number of iterations to attempt adjustments.
+ * @return The number of iterations performed.
  */
-void NutritionPlanViewModel::adjustNonProteinItems(NutritionPlan& plan, float& currentCalories, float targetCalories, float& currentProtein, int maxIterations)
+int NutritionPlanViewModel::adjustNonProteinItems(NutritionPlan& plan, float& currentCalories, float targetCalories, float& currentProtein, int maxIterations)
 {
     int iterationCount = 0;
 
@@ -802,6 +1945,7 @@ void NutritionPlanViewModel::adjustNonProteinItems(NutritionPlan& plan, float& c
         }
         iterationCount++;
     }
+    return iterationCount;
 }
 
 /**
@@ -811,8 +1955,9 @@ void NutritionPlanViewModel::adjustNonProteinItems(NutritionPlan& plan, float& c
  * @param targetCalories The target caloric value to adjust towards.
  * @param currentProtein The current total protein in the plan.
  * @param targetProtein The target protein value to adjust towards.
+ * @return The number of iterations of the longer of its protein and calorie loops.
  */
-void NutritionPlanViewModel::finalAdjustment(NutritionPlan& plan, float& currentCalories, float targetCalories, float& currentProtein, float targetProtein)
+int NutritionPlanViewModel::finalAdjustment(NutritionPlan& plan, float& currentCalories, float targetCalories, float& currentProtein, float targetProtein)
 {
     const int maxIterations = 1000;
     int iterationCount = 0;
@@ -834,7 +1979,7 @@ void NutritionPlanViewModel::finalAdjustment(NutritionPlan& plan, float& current
     }
 
     // Final adjustment to reduce protein if it is too high
-    adjustProtein(plan, currentProtein, targetProtein, currentCalories, maxIterations, false);
+    int proteinIterations = adjustProtein(plan, currentProtein, targetProtein, currentCalories, maxIterations, false);
 
     // Final adjustment to add non-protein items if calories are too low
     while (currentCalories < targetCalories && iterationCount < maxIterations)
@@ -867,4 +2012,5 @@ void NutritionPlanViewModel::finalAdjustment(NutritionPlan& plan, float& current
         }
         iterationCount++;
     }
+    return std::max(proteinIterations, iterationCount);
 }
@@ -1,13 +1,28 @@
 #ifndef NUTRITION_PLAN_VIEW_MODEL_H
 #define NUTRITION_PLAN_VIEW_MODEL_H
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
 #include "NutritionPlan.h"
+#include "WeeklyNutritionPlan.h"
 #include "FoodItem.h"
+#include "FoodCatalog.h"
+#include "FoodObserver.h"
+#include "FoodUsageIndex.h"
+#include "ExclusionFilter.h"
+#include "PlanOptimizer.h"
+#include "PortionDiscretizer.h"
+#include "PlanCache.h"
+#include "MacroTargets.h"
+#include "PortionBalancer.h"
+#include "GenerationTelemetry.h"
+#include "ShoppingList.h"
 #include "Goals.h"
+#include "BurnEstimator.h"
 #include "Profile.h"
+#include "UserRegistry.h"
 #include "ViewModel.h"
 
 /**
@@ -21,17 +36,38 @@ struct TotalNutrients
     float fats = 0;
 };
 
+/**
+ * @brief Parameters of one plan generation request.
+ */
+struct PlanRequest
+{
+    MacroTargets targets; ///< Daily macro targets and tolerances.
+    Goals::FitnessGoal goal = Goals::FitnessGoal::MAINTENANCE; ///< Fitness goal the targets were derived from.
+    ExclusionFilter exclusions; ///< Foods and categories the plan must not contain.
+    std::vector<float> dayCalorieOffsets; ///< Training calories of each day, Monday first, above the weekly average; empty without a workout plan.
+};
+
 /**
  * @brief ViewModel class for managing and manipulating nutrition plans.
  */
-class NutritionPlanViewModel : public ViewModel
+class NutritionPlanViewModel : public ViewModel, public FoodObserver
 {
 public:
+    /**
+     * @brief Strategy used to generate a plan from a template.
+     */
+    enum class GenerationMode
+    {
+        HEURISTIC, ///< Fast portion adjustment of a single template.
+        OPTIMIZER  ///< Multi-threaded metaheuristic search seeded by the heuristic, runs for a time budget.
+    };
+
     /**
      * @brief Constructor to initialize the NutritionPlanViewModel with a file name.
      * @param filename The name of the file containing the nutrition plans.
+     * @param userRegistry The registry holding the profile and goals of the active user.
      */
-    NutritionPlanViewModel(const std::string& filename);
+    NutritionPlanViewModel(const std::string& filename, UserRegistry& userRegistry);
 
     /**
      * @brief Display the nutrition plans.
@@ -64,13 +100,50 @@ public:
      */
     void reload() override;
 
+    /**
+     * @brief Rename a food in the template plans using it and in the saved plans.
+     * @param oldName The previous food name.
+     * @param foodItem The food item under its new name.
+     */
+    void foodRenamed(const std::string& oldName, const FoodItem& foodItem) override;
+
+    /**
+     * @brief Update the copies of a food in the template plans using it and in the saved plans.
+     * @param foodItem The new or changed food item.
+     */
+    void foodModified(const FoodItem& foodItem) override;
+
+    /**
+     * @brief Remove a deleted food from the template plans using it and from the saved plans.
+     * @param name The name of the deleted food item.
+     */
+    void foodRemoved(const std::string& name) override;
+
+    /**
+     * @brief List the template plans using a food.
+     * @param name The food name.
+     * @return The names of the template plans.
+     */
+    std::vector<std::string> usersOf(const std::string& name) const override;
+
 private:
     std::string filename; /**< The name of the file containing the nutrition plans. */
+    UserRegistry& userRegistry; /**< The registry holding the profile and goals of the active user. */
     std::map<std::string, NutritionPlan> nutritionPlanMap; /**< Map of nutrition plans. */
     std::map<std::string, FoodItem> foodItemMap; /**< Map of food items. */
+    FoodCatalog foodCatalog; /**< Generation-friendly snapshot of foodItemMap, rebuilt on reload. */
+    FoodUsageIndex foodUsageIndex; /**< Where each food is used in the template plans, kept in step with nutritionPlanMap. */
+    std::map<std::string, PlanMask> templateMasks; /**< Precomputed food and category masks of each template plan. */
+    PlanOptimizer::Settings optimizerSettings; /**< Settings of the metaheuristic generation mode. */
+    MacroTargetModel macroTargetModel; /**< Derives the macro targets from the goals and profile. */
+    PortionBalancer portionBalancer; /**< Balances generated portions against all four macro targets. */
+    PortionDiscretizer portionDiscretizer; /**< Snaps generated portions to serving units. */
+    PlanCache planCache; /**< Generated plans of recent requests, invalidated when templates or food items change. */
+    GenerationTelemetry telemetry; /**< Convergence and quality statistics of the plans generated in this session. */
     size_t currentPlanIndex = 0; /**< Current index of the nutrition plan. */
     std::vector<std::string> shuffledPlanNames; /**< Vector of shuffled plan names. */
     const int proteinPerHundredGrams = 15; /**< Protein amount per hundred grams. */
+    const int maxFoodRepeatsPerWeek = 3; /**< Maximum number of days a food may appear in a weekly plan. */
 
     /**
      * @brief Modify a nutrition plan.
@@ -80,12 +153,126 @@ private:
     void modifyNutritionPlan(NutritionPlan& selectedPlan, const std::map<std::string, FoodItem>& foodItemMap);
 
     /**
-     * @brief Generate the next nutrition plan based on the target calories and protein.
-     * @param targetCalories The target calories.
-     * @param targetProtein The target protein.
+     * @brief Add the foods of a plan that differ from a baseline to the set of edited foods.
+     * @param plan The nutrition plan being modified.
+     * @param baseline The plan as it was after the last rebalance.
+     * @param editedFoods The set of edited foods to extend.
+     */
+    void collectEditedFoods(const NutritionPlan& plan, const NutritionPlan& baseline, PortionBalancer::LockedPortions& editedFoods);
+
+    /**
+     * @brief Re-solve the portions of a modified plan while keeping the edited foods fixed.
+     * @param plan The nutrition plan being modified.
+     * @param originalPlan The plan as it was before modifying.
+     * @param editedFoods The foods added or changed by the user.
+     */
+    void rebalancePlan(NutritionPlan& plan, const NutritionPlan& originalPlan, const PortionBalancer::LockedPortions& editedFoods);
+
+    /**
+     * @brief Generate the next nutrition plan for a generation request.
+     * @param request The targets and exclusions of the plan.
+     * @param mode The generation strategy.
      * @return The generated nutrition plan.
      */
-    NutritionPlan generateNextPlan(float targetCalories, float targetProtein);
+    NutritionPlan generateNextPlan(const PlanRequest& request, GenerationMode mode = GenerationMode::HEURISTIC);
+
+    /**
+     * @brief Get the next template plan in the shuffled order.
+     * @return The next template plan.
+     */
+    const NutritionPlan& nextTemplate();
+
+    /**
+     * @brief Get the next template plan in the shuffled order that contains no excluded food.
+     * @param exclusions The compiled exclusions.
+     * @return The next allowed template plan, or the last one tried if every template is rejected.
+     */
+    const NutritionPlan& nextTemplate(const ExclusionFilter& exclusions);
+
+    /**
+     * @brief Recompute the food and category masks of all template plans and invalidate the plan cache if they changed.
+     */
+    void indexTemplates();
+
+    /**
+     * @brief Calculate a fingerprint of the template plans and food items.
+     * @return A hash of the CSV representation of the plans and food items.
+     */
+    size_t dataFingerprint() const;
+
+    /**
+     * @brief Apply a food change to the saved personal and weekly plans and rewrite the files that changed.
+     *
+     * The files are read with the food items as they were before the change.
+     *
+     * @param edit Applies the change to one plan and returns true if the plan changed.
+     */
+    void updateSavedPlans(const std::function<bool(NutritionPlan&)>& edit);
+
+    /**
+     * @brief Rebuild the food catalog and template masks after foodItemMap changed.
+     */
+    void refreshFoodData();
+
+    /**
+     * @brief Check a template plan against the exclusions using its precomputed masks.
+     * @param plan The template plan.
+     * @param exclusions The compiled exclusions.
+     * @return True if the plan contains an excluded food.
+     */
+    bool isTemplateExcluded(const NutritionPlan& plan, const ExclusionFilter& exclusions) const;
+
+    /**
+     * @brief Replace excluded foods of a plan with allowed foods of a shared category, or drop them.
+     * @param plan The nutrition plan to modify.
+     * @param exclusions The compiled exclusions.
+     */
+    void removeExcludedFoods(NutritionPlan& plan, const ExclusionFilter& exclusions);
+
+    /**
+     * @brief Replace foods of a plan with calorie-matched foods of a shared category, or drop them.
+     * @param plan The nutrition plan to modify.
+     * @param catalog The food catalog to take substitutes from.
+     * @param mustReplace Returns true for food items that have to be replaced.
+     * @param isAllowed Returns true for catalog indices that may be used as substitutes.
+     */
+    void substituteFoods(NutritionPlan& plan, const FoodCatalog& catalog, const std::function<bool(const FoodItem&)>& mustReplace,
+        const std::function<bool(size_t)>& isAllowed);
+
+    /**
+     * @brief Adjust the portions of a template plan so that it meets the macro targets.
+     *
+     * The resulting portions are snapped to whole servings, half servings or 5 gram steps.
+     * @param plan The template plan to adjust.
+     * @param targets The macro targets.
+     * @param record Receives the iterations and wall time of every phase.
+     * @return The adjusted nutrition plan.
+     */
+    NutritionPlan fitPlanToTargets(NutritionPlan plan, const MacroTargets& targets, GenerationRecord& record);
+
+    /**
+     * @brief Generate seven coordinated daily plans whose weekly average meets the targets.
+     * @param request The average daily targets and the exclusions of the plan.
+     * @return The generated weekly nutrition plan.
+     */
+    WeeklyNutritionPlan generateWeeklyPlan(const PlanRequest& request);
+
+    /**
+     * @brief Select the template plan that repeats the fewest foods already used up this week.
+     * @param foodUsage Number of days each food has been used so far.
+     * @param exclusions The compiled exclusions; excluded templates are only used as a last resort.
+     * @return A copy of the selected template plan.
+     */
+    NutritionPlan selectWeeklyTemplate(const std::map<std::string, int>& foodUsage, const ExclusionFilter& exclusions);
+
+    /**
+     * @brief Replace foods that reached the weekly repeat cap with calorie-matched foods of the same category, or drop them.
+     * @param plan The nutrition plan to modify.
+     * @param catalog The food catalog shared by all days of the week.
+     * @param foodUsage Number of days each food has been used so far.
+     * @param exclusions The compiled exclusions, excluded foods are never used as substitutes.
+     */
+    void enforceFoodVariety(NutritionPlan& plan, const FoodCatalog& catalog, const std::map<std::string, int>& foodUsage, const ExclusionFilter& exclusions);
 
     /**
      * @brief Shuffle the plan names.
@@ -108,8 +295,9 @@ private:
      * @param target The target value for adjustment.
      * @param maxIterations The maximum number of iterations for adjustment.
      * @param isReducing Flag to indicate if the adjustment is for reducing or increasing.
+     * @return The number of iterations performed.
      */
-    void adjustPortions(NutritionPlan& plan, float& currentCalories, float& currentProtein, float target, int maxIterations, bool isReducing);
+    int adjustPortions(NutritionPlan& plan, float& currentCalories, float& currentProtein, float target, int maxIterations, bool isReducing);
 
     /**
      * @brief Adjust the protein intake in the nutrition plan.
@@ -119,8 +307,9 @@ private:
      * @param currentCalories The current calories.
      * @param maxIterations The maximum number of iterations for adjustment.
      * @param isIncreasing Flag to indicate if the adjustment is for increasing or decreasing.
+     * @return The number of iterations performed.
      */
-    void adjustProtein(NutritionPlan& plan, float& currentProtein, float targetProtein, float& currentCalories, int maxIterations, bool isIncreasing);
+    int adjustProtein(NutritionPlan& plan, float& currentProtein, float targetProtein, float& currentCalories, int maxIterations, bool isIncreasing);
 
     /**
      * @brief Add non-protein items to match the caloric needs.
@@ -129,8 +318,9 @@ private:
      * @param targetCalories The target calories.
      * @param currentProtein The current protein.
      * @param maxIterations The maximum number of iterations for adjustment.
+     * @return The number of iterations performed.
      */
-    void adjustNonProteinItems(NutritionPlan& plan, float& currentCalories, float targetCalories, float& currentProtein, int maxIterations);
+    int adjustNonProteinItems(NutritionPlan& plan, float& currentCalories, float targetCalories, float& currentProtein, int maxIterations);
 
     /**
      * @brief Perform final adjustments to ensure the values are within the goals.
@@ -139,8 +329,9 @@ private:
      * @param targetCalories The target calories.
      * @param currentProtein The current protein.
      * @param targetProtein The target protein.
+     * @return The number of iterations of the longer of its protein and calorie loops.
      */
-    void finalAdjustment(NutritionPlan& plan, float& currentCalories, float targetCalories, float& currentProtein, float targetProtein);
+    int finalAdjustment(NutritionPlan& plan, float& currentCalories, float targetCalories, float& currentProtein, float targetProtein);
 
     // Helper functions for view and modification operations
 
@@ -165,6 +356,15 @@ private:
      */
     void handleRemoveFood(NutritionPlan& selectedPlan, const std::string& mealName);
 
+    /**
+     * @brief Offer foods similar to a removed food and add the chosen one in its place.
+     * @param selectedPlan The selected nutrition plan.
+     * @param mealName The name of the meal.
+     * @param removedFood The removed food item and its quantity.
+     * @param position The position the removed food had in the meal.
+     */
+    void handleSubstituteFood(NutritionPlan& selectedPlan, const std::string& mealName, const std::pair<FoodItem, float>& removedFood, size_t position);
+
     /**
      * @brief Get the available categories from the food item map.
      * @param foodItemMap The map of food items.
@@ -179,8 +379,37 @@ private:
 
     /**
      * @brief View a personalized nutrition plan based on goals.
+     * @param mode The generation strategy.
+     */
+    void viewPersonalizedPlan(GenerationMode mode = GenerationMode::HEURISTIC);
+
+    /**
+     * @brief View a personalized weekly nutrition plan based on goals.
      */
-    void viewPersonalizedPlan();
+    void viewPersonalizedWeeklyPlan();
+
+    /**
+     * @brief Print the convergence and quality statistics of the plans generated in this session.
+     */
+    void viewGenerationReport();
+
+    /**
+     * @brief Build and print a shopping list for one or more plans.
+     */
+    void viewShoppingList();
+
+    /**
+     * @brief Load the profile and goals of the active user and derive the daily macro targets.
+     * @param request Receives the goal and the daily macro targets.
+     * @return True if the profile and goals were loaded, false otherwise.
+     */
+    bool loadPersonalTargets(PlanRequest& request);
+
+    /**
+     * @brief Ask the user for foods and categories to exclude and compile them.
+     * @return The compiled exclusions.
+     */
+    ExclusionFilter promptExclusions();
 
     /**
      * @brief Display a nutrition plan.
@@ -188,6 +417,25 @@ private:
      */
     void displayPlan(const NutritionPlan& plan);
 
+    /**
+     * @brief Print the macro targets a plan was generated for.
+     * @param targets The macro targets.
+     */
+    void printTargets(const MacroTargets& targets);
+
+    /**
+     * @brief Print a line of macro amounts.
+     * @param label The label of the line.
+     * @param amounts The amounts, indexed by FoodCatalog::Macro.
+     */
+    void printMacroLine(const std::string& label, const float* amounts);
+
+    /**
+     * @brief Display a weekly nutrition plan day by day.
+     * @param plan The weekly nutrition plan to display.
+     */
+    void displayWeeklyPlan(const WeeklyNutritionPlan& plan);
+
     /**
      * @brief Select a nutrition plan for modification or deletion.
      * @param action The action to be performed (modify/delete).
@@ -220,6 +468,12 @@ private:
      * @param totalPlan The total nutrients for the entire plan.
      */
     void printPlanTotal(TotalNutrients totalPlan);
+
+    /**
+     * @brief Print the totals of the nutrients beyond the four macros, if the food items provide any.
+     * @param plan The nutrition plan.
+     */
+    void printNutrientTotals(const NutritionPlan& plan);
 };
 
 #endif // NUTRITION_PLAN_VIEW_MODEL_H
@@ -0,0 +1,190 @@
+#include "PlanCache.h"
+#include <cmath>
+#include <tuple>
+
+/**
+ * @brief Orders keys for use in a map.
+ * @param other The key to compare with.
+ * @return True if this key is ordered before the other key.
+ */
+bool PlanCache::Key::operator<(const Key& other) const
+{
+    return std::tie(calorieBucket, proteinBucket, goal, variant, exclusions)
+        < std::tie(other.calorieBucket, other.proteinBucket, other.goal, other.variant, other.exclusions);
+}
+
+/**
+ * @brief Constructs an empty cache.
+ * @param capacity Maximum number of keys kept.
+ * @param solutionsPerKey Number of different plans collected per key.
+ * @param calorieQuantum Width of a calorie bucket in kcal.
+ * @param proteinQuantum Width of a protein bucket in grams.
+ */
+PlanCache::PlanCache(size_t capacity, size_t solutionsPerKey, float calorieQuantum, float proteinQuantum)
+    : capacity(capacity), solutionsPerKey(solutionsPerKey), calorieQuantum(calorieQuantum), proteinQuantum(proteinQuantum)
+{
+}
+
+/**
+ * @brief Builds the key of a generation request.
+ * @param targetCalories The target calories.
+ * @param targetProtein The target protein.
+ * @param goal The fitness goal.
+ * @param variant The generation strategy and its settings.
+ * @param exclusions The excluded foods and categories.
+ * @return The key of the request.
+ */
+PlanCache::Key PlanCache::makeKey(float targetCalories, float targetProtein, int goal, int variant, const std::set<std::string>& exclusions) const
+{
+    Key key;
+    key.calorieBucket = static_cast<int>(std::lround(targetCalories / calorieQuantum));
+    key.proteinBucket = static_cast<int>(std::lround(targetProtein / proteinQuantum));
+    key.goal = goal;
+    key.variant = variant;
+    for (const auto& term : exclusions)
+    {
+        key.exclusions += term + ";";
+    }
+    return key;
+}
+
+/**
+ * @brief Gets the next cached plan of a key.
+ *
+ * Hits rotate through the stored plans, so asking for another plan still yields a different one.
+ *
+ * @param key The key of the request.
+ * @param plan Receives the cached plan on a hit.
+ * @return True on a hit, false if the key is missing or still collecting plans.
+ */
+bool PlanCache::lookup(const Key& key, NutritionPlan& plan)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    if (it == entries.end() || !isComplete(it->second))
+    {
+        misses++;
+        return false;
+    }
+
+    Entry& entry = it->second;
+    recentKeys.splice(recentKeys.begin(), recentKeys, entry.position);
+    plan = entry.solutions[entry.next];
+    entry.next = (entry.next + 1) % entry.solutions.size();
+    hits++;
+    return true;
+}
+
+/**
+ * @brief Adds a generated plan to a key unless a plan with the same foods is already stored.
+ * @param key The key of the request.
+ * @param plan The generated plan.
+ */
+void PlanCache::store(const Key& key, const NutritionPlan& plan)
+{
+    std::set<std::string> foods;
+    for (const auto& meal : plan.meals)
+    {
+        for (const auto& foodPair : meal.second)
+        {
+            foods.insert(foodPair.first.name);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    if (it == entries.end())
+    {
+        recentKeys.push_front(key);
+        it = entries.emplace(key, Entry()).first;
+        it->second.position = recentKeys.begin();
+
+        if (entries.size() > capacity)
+        {
+            entries.erase(recentKeys.back());
+            recentKeys.pop_back();
+        }
+    }
+    else
+    {
+        recentKeys.splice(recentKeys.begin(), recentKeys, it->second.position);
+    }
+
+    Entry& entry = it->second;
+    entry.storeAttempts++;
+    if (entry.solutions.size() >= solutionsPerKey)
+    {
+        return;
+    }
+    for (const auto& storedFoods : entry.solutionFoods)
+    {
+        if (storedFoods == foods)
+        {
+            return;
+        }
+    }
+    entry.solutions.push_back(plan);
+    entry.solutionFoods.push_back(foods);
+}
+
+/**
+ * @brief Drops all entries if the data the plans were generated from has changed.
+ * @param fingerprint Fingerprint of the current templates and food items.
+ */
+void PlanCache::invalidate(size_t fingerprint)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (fingerprint != this->fingerprint)
+    {
+        entries.clear();
+        recentKeys.clear();
+        this->fingerprint = fingerprint;
+    }
+}
+
+/**
+ * @brief Drops all entries.
+ */
+void PlanCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    entries.clear();
+    recentKeys.clear();
+}
+
+/**
+ * @brief Gets the number of lookups answered from the cache.
+ * @return The number of hits.
+ */
+size_t PlanCache::getHits() const
+{
+    return hits.load();
+}
+
+/**
+ * @brief Gets the number of lookups that required generating a plan.
+ * @return The number of misses.
+ */
+size_t PlanCache::getMisses() const
+{
+    return misses.load();
+}
+
+/**
+ * @brief Checks whether a key has collected enough plans to answer lookups.
+ *
+ * A key that keeps receiving plans with the same foods (e.g. because exclusions leave a single
+ * template) is considered complete after twice as many attempts as it has slots.
+ *
+ * @param entry The entry of the key.
+ * @return True if lookups can be answered from the entry.
+ */
+bool PlanCache::isComplete(const Entry& entry) const
+{
+    return !entry.solutions.empty()
+        && (entry.solutions.size() >= solutionsPerKey || entry.storeAttempts >= 2 * solutionsPerKey);
+}
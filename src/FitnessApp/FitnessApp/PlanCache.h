@@ -0,0 +1,135 @@
+#ifndef PLAN_CACHE_H
+#define PLAN_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "NutritionPlan.h"
+
+/**
+ * @brief Thread-safe LRU cache of generated nutrition plans.
+ *
+ * Requests are keyed by their targets quantized to calorieQuantum and proteinQuantum, the
+ * fitness goal, the generation strategy and the exclusions, so users with nearly identical
+ * targets share entries. Every key collects several plans with different foods; once a key
+ * is complete, lookups cycle through its plans instead of generating new ones.
+ */
+class PlanCache
+{
+public:
+    /**
+     * @brief Identifies a class of equivalent generation requests.
+     */
+    struct Key
+    {
+        int calorieBucket = 0; ///< Target calories divided by the calorie quantum.
+        int proteinBucket = 0; ///< Target protein divided by the protein quantum.
+        int goal = 0; ///< The fitness goal.
+        int variant = 0; ///< The generation strategy and its settings.
+        std::string exclusions; ///< The excluded foods and categories.
+
+        /**
+         * @brief Orders keys for use in a map.
+         * @param other The key to compare with.
+         * @return True if this key is ordered before the other key.
+         */
+        bool operator<(const Key& other) const;
+    };
+
+    /**
+     * @brief Constructs an empty cache.
+     * @param capacity Maximum number of keys kept.
+     * @param solutionsPerKey Number of different plans collected per key.
+     * @param calorieQuantum Width of a calorie bucket in kcal.
+     * @param proteinQuantum Width of a protein bucket in grams.
+     */
+    PlanCache(size_t capacity = 64, size_t solutionsPerKey = 8, float calorieQuantum = 50.0f, float proteinQuantum = 5.0f);
+
+    /**
+     * @brief Builds the key of a generation request.
+     * @param targetCalories The target calories.
+     * @param targetProtein The target protein.
+     * @param goal The fitness goal.
+     * @param variant The generation strategy and its settings.
+     * @param exclusions The excluded foods and categories.
+     * @return The key of the request.
+     */
+    Key makeKey(float targetCalories, float targetProtein, int goal, int variant, const std::set<std::string>& exclusions) const;
+
+    /**
+     * @brief Gets the next cached plan of a key.
+     * @param key The key of the request.
+     * @param plan Receives the cached plan on a hit.
+     * @return True on a hit, false if the key is missing or still collecting plans.
+     */
+    bool lookup(const Key& key, NutritionPlan& plan);
+
+    /**
+     * @brief Adds a generated plan to a key unless a plan with the same foods is already stored.
+     * @param key The key of the request.
+     * @param plan The generated plan.
+     */
+    void store(const Key& key, const NutritionPlan& plan);
+
+    /**
+     * @brief Drops all entries if the data the plans were generated from has changed.
+     * @param fingerprint Fingerprint of the current templates and food items.
+     */
+    void invalidate(size_t fingerprint);
+
+    /**
+     * @brief Drops all entries.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of lookups answered from the cache.
+     * @return The number of hits.
+     */
+    size_t getHits() const;
+
+    /**
+     * @brief Gets the number of lookups that required generating a plan.
+     * @return The number of misses.
+     */
+    size_t getMisses() const;
+
+private:
+    /**
+     * @brief Cached plans of one key.
+     */
+    struct Entry
+    {
+        std::vector<NutritionPlan> solutions; ///< Plans with pairwise different foods.
+        std::vector<std::set<std::string>> solutionFoods; ///< Foods of each plan, used for the diversity check.
+        size_t storeAttempts = 0; ///< Number of plans offered to this key.
+        size_t next = 0; ///< Index of the plan returned by the next hit.
+        std::list<Key>::iterator position; ///< Position of the key in the LRU order.
+    };
+
+    size_t capacity; ///< Maximum number of keys kept.
+    size_t solutionsPerKey; ///< Number of different plans collected per key.
+    float calorieQuantum; ///< Width of a calorie bucket in kcal.
+    float proteinQuantum; ///< Width of a protein bucket in grams.
+    size_t fingerprint = 0; ///< Fingerprint of the data the entries were generated from.
+
+    mutable std::mutex mutex; ///< Guards the entries and the LRU order.
+    std::map<Key, Entry> entries; ///< Cached plans by key.
+    std::list<Key> recentKeys; ///< Keys from most to least recently used.
+    std::atomic<size_t> hits{ 0 }; ///< Number of hits.
+    std::atomic<size_t> misses{ 0 }; ///< Number of misses.
+
+    /**
+     * @brief Checks whether a key has collected enough plans to answer lookups.
+     * @param entry The entry of the key.
+     * @return True if lookups can be answered from the entry.
+     */
+    bool isComplete(const Entry& entry) const;
+};
+
+#endif // PLAN_CACHE_H
@@ -0,0 +1,312 @@
+#include "PlanOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "Utils.h"
+
+/**
+ * @brief Constructs an optimizer over the given food catalog.
+ *
+ * An exchange interval below 1 is raised to 1, so chains exchange after every iteration.
+ *
+ * @param catalog The food catalog used for food swaps and macro lookups.
+ * @param settings The optimizer settings.
+ */
+PlanOptimizer::PlanOptimizer(const FoodCatalog& catalog, Settings settings) : catalog(catalog), settings(settings)
+{
+    this->settings.exchangeInterval = std::max(1, this->settings.exchangeInterval);
+}
+
+/**
+ * @brief Optimizes a plan towards the macro targets.
+ *
+ * Foods of the seed that are not in the catalog are kept unchanged and only count towards the totals.
+ *
+ * @param seed The plan to start all chains from.
+ * @param targets The macro targets and tolerances.
+ * @param exclusions Foods that food swaps must not introduce.
+ * @return The best plan found within the time budget.
+ */
+NutritionPlan PlanOptimizer::optimize(const NutritionPlan& seed, const MacroTargets& targets, const ExclusionFilter& exclusions)
+{
+    this->targets = targets;
+    this->exclusions = exclusions;
+    moveCount = 0;
+
+    Candidate start;
+    std::map<std::string, std::vector<std::pair<FoodItem, float>>> fixedItems;
+    for (size_t meal = 0; meal < MEAL_NAMES.size(); ++meal)
+    {
+        auto it = seed.meals.find(MEAL_NAMES[meal]);
+        if (it == seed.meals.end())
+        {
+            continue;
+        }
+
+        for (const auto& foodPair : it->second)
+        {
+            size_t food;
+            if (catalog.findIndex(foodPair.first.name, food))
+            {
+                start.slots.push_back({ meal, food, foodPair.second });
+            }
+            else
+            {
+                fixedItems[it->first].push_back(foodPair);
+            }
+        }
+    }
+    NutritionPlan fixedPlan;
+    fixedPlan.meals = fixedItems;
+    MacroTargets::planTotals(fixedPlan, fixedTotals);
+    start.cost = evaluate(start.slots);
+
+    unsigned chainCount = settings.threadCount != 0 ? settings.threadCount : std::max(1u, std::thread::hardware_concurrency());
+    mailboxes.reset(new std::atomic<Candidate*>[chainCount]);
+    for (unsigned chain = 0; chain < chainCount; ++chain)
+    {
+        mailboxes[chain].store(nullptr);
+    }
+
+    std::vector<Candidate> bests(chainCount);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(settings.budgetMilliseconds);
+
+    // The calling thread runs the first chain itself
+    std::vector<std::thread> threads;
+    for (unsigned chain = 1; chain < chainCount; ++chain)
+    {
+        threads.emplace_back(&PlanOptimizer::runChain, this, chain, chainCount, start, deadline, std::ref(bests[chain]));
+    }
+    runChain(0, chainCount, start, deadline, bests[0]);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Free elites that were sent but never collected
+    for (unsigned chain = 0; chain < chainCount; ++chain)
+    {
+        delete mailboxes[chain].exchange(nullptr);
+    }
+
+    const Candidate* best = &start;
+    for (const auto& candidate : bests)
+    {
+        if (candidate.cost < best->cost)
+        {
+            best = &candidate;
+        }
+    }
+
+    NutritionPlan result;
+    result.name = seed.name;
+    for (const auto& mealName : MEAL_NAMES)
+    {
+        result.meals[mealName] = fixedItems[mealName];
+    }
+    for (const auto& slot : best->slots)
+    {
+        // Drop foods the optimizer reduced to nothing
+        if (slot.grams >= 0.5f)
+        {
+            result.meals[MEAL_NAMES[slot.meal]].emplace_back(catalog.item(slot.food), slot.grams);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Calculates the cost of a solution.
+ *
+ * All four macros are accumulated together from the catalog's contiguous per-gram rows,
+ * so scoring a slot is one multiply-add over four lanes.
+ *
+ * @param slots The foods of the solution.
+ * @return The cost of the solution's macro totals, see MacroTargets::cost.
+ */
+float PlanOptimizer::evaluate(const std::vector<Slot>& slots) const
+{
+    float totals[FoodCatalog::MACRO_COUNT];
+    std::copy(fixedTotals, fixedTotals + FoodCatalog::MACRO_COUNT, totals);
+    for (const auto& slot : slots)
+    {
+        const float* macros = catalog.macrosPerGram(slot.food);
+        for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+        {
+            totals[m] += macros[m] * slot.grams;
+        }
+    }
+    return targets.cost(totals);
+}
+
+/**
+ * @brief Runs one annealing chain until the deadline.
+ * @param chain Index of the chain.
+ * @param chainCount Total number of chains.
+ * @param current The starting solution.
+ * @param deadline The time at which the chain stops.
+ * @param best Receives the best solution found by the chain.
+ */
+void PlanOptimizer::runChain(unsigned chain, unsigned chainCount, Candidate current, std::chrono::steady_clock::time_point deadline, Candidate& best)
+{
+    // Costs are measured in tolerance units, a cost of 1 is a single macro at the edge of its tolerance
+    const float initialTemperature = 2.0f;
+    const float finalTemperatureRatio = 0.001f;
+
+    std::mt19937 rng(std::random_device{}() + chain);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    const auto start = std::chrono::steady_clock::now();
+    const float totalSeconds = std::max(std::chrono::duration<float>(deadline - start).count(), 0.001f);
+    float temperature = initialTemperature;
+
+    best = current;
+    std::vector<Slot> next;
+
+    long iteration = 1;
+    for (; ; ++iteration)
+    {
+        // Reading the clock is comparatively expensive, so the schedule is updated in batches
+        if (iteration % 256 == 0)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+            {
+                break;
+            }
+            float progress = std::chrono::duration<float>(now - start).count() / totalSeconds;
+            temperature = initialTemperature * std::pow(finalTemperatureRatio, progress);
+        }
+
+        next = current.slots;
+        mutate(next, rng);
+        float cost = evaluate(next);
+
+        if (cost <= current.cost || unit(rng) < std::exp((current.cost - cost) / temperature))
+        {
+            current.slots.swap(next);
+            current.cost = cost;
+            if (cost < best.cost)
+            {
+                best = current;
+            }
+        }
+
+        if (chainCount > 1 && iteration % settings.exchangeInterval == 0)
+        {
+            // Send the best solution to the next chain; an elite it has not collected yet is replaced
+            delete mailboxes[(chain + 1) % chainCount].exchange(new Candidate(best));
+
+            std::unique_ptr<Candidate> incoming(mailboxes[chain].exchange(nullptr));
+            if (incoming)
+            {
+                Candidate child;
+                child.slots = crossover(current.slots, incoming->slots, rng);
+                child.cost = evaluate(child.slots);
+
+                const Candidate& adopted = child.cost < incoming->cost ? child : *incoming;
+                if (adopted.cost < current.cost)
+                {
+                    current = adopted;
+                    if (current.cost < best.cost)
+                    {
+                        best = current;
+                    }
+                }
+            }
+        }
+    }
+
+    // The iteration that found the deadline did not evaluate a move
+    moveCount += iteration - 1;
+}
+
+/**
+ * @brief Gets the number of moves all chains evaluated in the last optimization.
+ * @return The number of moves.
+ */
+long PlanOptimizer::getMoveCount() const
+{
+    return moveCount;
+}
+
+/**
+ * @brief Applies a random move (portion change or food swap) to a solution.
+ * @param slots The solution to modify.
+ * @param rng The random generator of the chain.
+ */
+void PlanOptimizer::mutate(std::vector<Slot>& slots, std::mt19937& rng) const
+{
+    if (slots.empty())
+    {
+        return;
+    }
+
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    Slot& slot = slots[std::uniform_int_distribution<size_t>(0, slots.size() - 1)(rng)];
+
+    if (unit(rng) < settings.swapProbability)
+    {
+        const auto& categories = catalog.item(slot.food).categories;
+        if (!categories.empty())
+        {
+            auto category = categories.begin();
+            std::advance(category, std::uniform_int_distribution<size_t>(0, categories.size() - 1)(rng));
+            const auto& pool = catalog.indicesInCategory(*category);
+            size_t food = pool[std::uniform_int_distribution<size_t>(0, pool.size() - 1)(rng)];
+
+            bool inPlan = std::any_of(slots.begin(), slots.end(), [food](const Slot& other) { return other.food == food; });
+            if (!inPlan && !exclusions.excludesFood(food) && catalog.item(food).calories > 0)
+            {
+                // Keep the calories of the slot so the swap does not disturb the totals too much
+                float calories = slot.grams * catalog.macrosPerGram(slot.food)[FoodCatalog::CALORIES];
+                slot.food = food;
+                slot.grams = std::min(catalog.gramsForCalories(food, calories), settings.maxPortion);
+                return;
+            }
+        }
+    }
+
+    std::normal_distribution<float> step(0.0f, 25.0f);
+    slot.grams = std::min(std::max(slot.grams + step(rng), 0.0f), settings.maxPortion);
+}
+
+/**
+ * @brief Combines two solutions slot by slot.
+ *
+ * Both solutions descend from the same seed, so their slots line up meal by meal.
+ *
+ * @param own The solution of the receiving chain.
+ * @param elite The elite received from another chain.
+ * @param rng The random generator of the chain.
+ * @return The combined solution.
+ */
+std::vector<PlanOptimizer::Slot> PlanOptimizer::crossover(const std::vector<Slot>& own, const std::vector<Slot>& elite, std::mt19937& rng) const
+{
+    std::vector<Slot> child = own;
+    std::bernoulli_distribution takeElite(0.5);
+
+    for (size_t i = 0; i < std::min(child.size(), elite.size()); ++i)
+    {
+        if (!takeElite(rng))
+        {
+            continue;
+        }
+
+        size_t food = elite[i].food;
+        bool duplicate = false;
+        for (size_t j = 0; j < child.size(); ++j)
+        {
+            if (j != i && child[j].food == food)
+            {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate)
+        {
+            child[i] = elite[i];
+        }
+    }
+    return child;
+}
@@ -0,0 +1,122 @@
+#ifndef PLAN_OPTIMIZER_H
+#define PLAN_OPTIMIZER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include "NutritionPlan.h"
+#include "FoodCatalog.h"
+#include "ExclusionFilter.h"
+#include "MacroTargets.h"
+
+/**
+ * @brief Anytime metaheuristic optimizer for nutrition plans.
+ *
+ * Every thread runs its own simulated annealing chain over the portion sizes of a plan and
+ * over swaps of foods for other foods of the same category. Chains periodically send their
+ * best plan to the next chain through a lock-free mailbox, where it is recombined with the
+ * receiving chain's state (a genetic crossover). The best plan seen by any chain is returned
+ * when the wall-clock budget runs out.
+ */
+class PlanOptimizer
+{
+public:
+    /**
+     * @brief Tunable parameters of the optimizer.
+     */
+    struct Settings
+    {
+        int budgetMilliseconds = 2000; ///< Wall-clock budget of one optimization.
+        unsigned threadCount = 0; ///< Number of chains, 0 uses all hardware threads.
+        int exchangeInterval = 2000; ///< Iterations between two elite exchanges, at least 1.
+        float swapProbability = 0.2f; ///< Probability that a move swaps a food instead of changing a portion.
+        float maxPortion = 600.0f; ///< Largest portion size in grams a move may produce.
+    };
+
+    /**
+     * @brief Constructs an optimizer over the given food catalog.
+     * @param catalog The food catalog used for food swaps and macro lookups.
+     * @param settings The optimizer settings.
+     */
+    PlanOptimizer(const FoodCatalog& catalog, Settings settings);
+
+    /**
+     * @brief Optimizes a plan towards the macro targets.
+     * @param seed The plan to start all chains from.
+     * @param targets The macro targets and tolerances.
+     * @param exclusions Foods that food swaps must not introduce.
+     * @return The best plan found within the time budget.
+     */
+    NutritionPlan optimize(const NutritionPlan& seed, const MacroTargets& targets, const ExclusionFilter& exclusions = ExclusionFilter());
+
+    /**
+     * @brief Gets the number of moves all chains evaluated in the last optimization.
+     * @return The number of moves.
+     */
+    long getMoveCount() const;
+
+private:
+    /**
+     * @brief One food of the plan being optimized.
+     */
+    struct Slot
+    {
+        size_t meal; ///< Index into MEAL_NAMES.
+        size_t food; ///< Index into the food catalog.
+        float grams; ///< Portion size in grams.
+    };
+
+    /**
+     * @brief A complete solution with its cost.
+     */
+    struct Candidate
+    {
+        std::vector<Slot> slots; ///< Foods of the plan.
+        float cost = 0; ///< Cost of the solution, lower is better.
+    };
+
+    const FoodCatalog& catalog; ///< The food catalog.
+    Settings settings; ///< The optimizer settings.
+    MacroTargets targets; ///< Macro targets of the current optimization.
+    float fixedTotals[FoodCatalog::MACRO_COUNT] = {}; ///< Macros of plan foods missing from the catalog.
+    ExclusionFilter exclusions; ///< Exclusions of the current optimization.
+    std::unique_ptr<std::atomic<Candidate*>[]> mailboxes; ///< One mailbox per chain, owned by the receiver.
+    std::atomic<long> moveCount{ 0 }; ///< Moves evaluated by all chains of the current optimization.
+
+    /**
+     * @brief Calculates the cost of a solution.
+     * @param slots The foods of the solution.
+     * @return The cost of the solution's macro totals, see MacroTargets::cost.
+     */
+    float evaluate(const std::vector<Slot>& slots) const;
+
+    /**
+     * @brief Runs one annealing chain until the deadline.
+     * @param chain Index of the chain.
+     * @param chainCount Total number of chains.
+     * @param current The starting solution.
+     * @param deadline The time at which the chain stops.
+     * @param best Receives the best solution found by the chain.
+     */
+    void runChain(unsigned chain, unsigned chainCount, Candidate current, std::chrono::steady_clock::time_point deadline, Candidate& best);
+
+    /**
+     * @brief Applies a random move (portion change or food swap) to a solution.
+     * @param slots The solution to modify.
+     * @param rng The random generator of the chain.
+     */
+    void mutate(std::vector<Slot>& slots, std::mt19937& rng) const;
+
+    /**
+     * @brief Combines two solutions slot by slot.
+     * @param own The solution of the receiving chain.
+     * @param elite The elite received from another chain.
+     * @param rng The random generator of the chain.
+     * @return The combined solution.
+     */
+    std::vector<Slot> crossover(const std::vector<Slot>& own, const std::vector<Slot>& elite, std::mt19937& rng) const;
+};
+
+#endif // PLAN_OPTIMIZER_H
@@ -0,0 +1,374 @@
+#include "PlanSimilarityIndex.h"
+#include "Utils.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+namespace
+{
+    /**
+     * @brief Mixes a 64-bit value into a well-distributed hash (SplitMix64 finalizer).
+     * @param value The value to mix.
+     * @return The mixed value.
+     */
+    std::uint64_t mix(std::uint64_t value)
+    {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief Collects the entries of one day of a plan as sortable keys.
+     * @param plan The plan.
+     * @param day The day of the week.
+     * @return The entries as (name, sets, reps), sorted and unique.
+     */
+    std::set<std::tuple<std::string, int, int>> entriesOf(const WorkoutPlan& plan, const std::string& day)
+    {
+        std::set<std::tuple<std::string, int, int>> entries;
+        auto it = plan.weeklyPlan.find(day);
+        if (it != plan.weeklyPlan.end())
+        {
+            for (const auto& exercise : it->second)
+            {
+                entries.insert({ exercise.exerciseName(), exercise.sets, exercise.reps });
+            }
+        }
+        return entries;
+    }
+}
+
+/**
+ * @brief Constructs an empty index.
+ * @param settings The shape of the signatures and the near-duplicate threshold.
+ */
+PlanSimilarityIndex::PlanSimilarityIndex(Settings settings) : settings(settings)
+{
+}
+
+/**
+ * @brief Replaces the index with the given plans.
+ * @param plans The plans by name.
+ */
+void PlanSimilarityIndex::build(const std::map<std::string, WorkoutPlan>& plans)
+{
+    entries.clear();
+    slotByName.clear();
+    buckets.clear();
+    entries.reserve(plans.size());
+    for (const auto& pair : plans)
+    {
+        indexPlan(pair.first, pair.second);
+    }
+}
+
+/**
+ * @brief Adds a plan, replacing it if its name is already indexed.
+ *
+ * The old slot of a replaced plan is only marked as removed, so the buckets never have to be
+ * searched for it.
+ *
+ * @param planName The key of the plan in the plan map.
+ * @param plan The plan.
+ */
+void PlanSimilarityIndex::indexPlan(const std::string& planName, const WorkoutPlan& plan)
+{
+    removePlan(planName);
+
+    Entry entry;
+    entry.name = planName;
+    entry.features = featuresOf(plan);
+    entry.signature = signatureOf(entry.features);
+
+    size_t slot = entries.size();
+    for (size_t band = 0; band < settings.bands; ++band)
+    {
+        buckets[bucketKey(entry.signature, band)].push_back(slot);
+    }
+    entries.push_back(std::move(entry));
+    slotByName[planName] = slot;
+}
+
+/**
+ * @brief Removes a plan.
+ * @param planName The key of the plan in the plan map.
+ */
+void PlanSimilarityIndex::removePlan(const std::string& planName)
+{
+    auto it = slotByName.find(planName);
+    if (it == slotByName.end())
+    {
+        return;
+    }
+    entries[it->second].removed = true;
+    slotByName.erase(it);
+}
+
+/**
+ * @brief Finds the indexed plans that are near-duplicates of a plan.
+ *
+ * Only the plans sharing at least one bucket with the plan are compared with it.
+ *
+ * @param plan The plan to look up, indexed or not.
+ * @param ignoredName An indexed plan to leave out, usually the plan itself.
+ * @return The near-duplicates, most similar first.
+ */
+std::vector<PlanSimilarityIndex::Match> PlanSimilarityIndex::findSimilar(const WorkoutPlan& plan, const std::string& ignoredName) const
+{
+    std::vector<std::uint64_t> features = featuresOf(plan);
+    std::vector<std::uint32_t> signature = signatureOf(features);
+
+    std::set<size_t> candidates;
+    for (size_t band = 0; band < settings.bands; ++band)
+    {
+        auto it = buckets.find(bucketKey(signature, band));
+        if (it != buckets.end())
+        {
+            candidates.insert(it->second.begin(), it->second.end());
+        }
+    }
+
+    std::vector<Match> matches;
+    for (size_t slot : candidates)
+    {
+        const Entry& entry = entries[slot];
+        if (entry.removed || entry.name == ignoredName)
+        {
+            continue;
+        }
+        float value = jaccard(features, entry.features);
+        if (value >= settings.minSimilarity)
+        {
+            matches.push_back({ entry.name, value });
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.similarity != b.similarity ? a.similarity > b.similarity : a.plan < b.plan;
+    });
+    return matches;
+}
+
+/**
+ * @brief Groups the indexed plans into clusters of near-duplicates.
+ *
+ * Every bucket proposes its plans as pairs, confirmed pairs are joined with a union-find, and
+ * each pair is verified once however many buckets it shares.
+ *
+ * @return The clusters of at least two plans, each sorted by name.
+ */
+std::vector<std::vector<std::string>> PlanSimilarityIndex::clusters() const
+{
+    std::vector<size_t> parent(entries.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](size_t slot) {
+        while (parent[slot] != slot)
+        {
+            parent[slot] = parent[parent[slot]];
+            slot = parent[slot];
+        }
+        return slot;
+    };
+
+    std::set<std::pair<size_t, size_t>> checked;
+    for (const auto& bucket : buckets)
+    {
+        const auto& slots = bucket.second;
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            if (entries[slots[i]].removed)
+            {
+                continue;
+            }
+            for (size_t j = i + 1; j < slots.size(); ++j)
+            {
+                if (entries[slots[j]].removed || !checked.insert({ slots[i], slots[j] }).second)
+                {
+                    continue;
+                }
+                if (find(slots[i]) != find(slots[j])
+                    && jaccard(entries[slots[i]].features, entries[slots[j]].features) >= settings.minSimilarity)
+                {
+                    parent[find(slots[i])] = find(slots[j]);
+                }
+            }
+        }
+    }
+
+    std::map<size_t, std::vector<std::string>> groups;
+    for (const auto& pair : slotByName)
+    {
+        groups[find(pair.second)].push_back(pair.first);
+    }
+
+    std::vector<std::vector<std::string>> result;
+    for (auto& group : groups)
+    {
+        if (group.second.size() > 1)
+        {
+            result.push_back(std::move(group.second));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Computes the exact Jaccard index of two plans.
+ * @param first The first plan.
+ * @param second The second plan.
+ * @return The Jaccard index of their entries, 1 for two empty plans.
+ */
+float PlanSimilarityIndex::similarity(const WorkoutPlan& first, const WorkoutPlan& second)
+{
+    return jaccard(featuresOf(first), featuresOf(second));
+}
+
+/**
+ * @brief Describes how to turn one plan into another.
+ * @param from The plan to start from.
+ * @param to The plan to end with.
+ * @return One line per day that differs, listing the entries to add and remove.
+ */
+std::vector<std::string> PlanSimilarityIndex::describeDifferences(const WorkoutPlan& from, const WorkoutPlan& to)
+{
+    std::vector<std::string> lines;
+    for (const auto& day : DAYS_OF_WEEK)
+    {
+        auto fromEntries = entriesOf(from, day);
+        auto toEntries = entriesOf(to, day);
+        if (fromEntries == toEntries)
+        {
+            continue;
+        }
+
+        std::ostringstream line;
+        line << day << ":";
+        for (const auto& entry : toEntries)
+        {
+            if (fromEntries.count(entry) == 0)
+            {
+                line << " +" << std::get<0>(entry) << " " << std::get<1>(entry) << "x" << std::get<2>(entry);
+            }
+        }
+        for (const auto& entry : fromEntries)
+        {
+            if (toEntries.count(entry) == 0)
+            {
+                line << " -" << std::get<0>(entry) << " " << std::get<1>(entry) << "x" << std::get<2>(entry);
+            }
+        }
+        lines.push_back(line.str());
+    }
+    return lines;
+}
+
+/**
+ * @brief Hashes the entries of a plan.
+ *
+ * An entry is identified by its day, exercise name, sets and reps, so the same exercise with
+ * a different prescription or on another day counts as a different entry.
+ *
+ * @param plan The plan.
+ * @return The hashes, sorted and unique.
+ */
+std::vector<std::uint64_t> PlanSimilarityIndex::featuresOf(const WorkoutPlan& plan)
+{
+    std::vector<std::uint64_t> features;
+    for (size_t day = 0; day < DAYS_OF_WEEK.size(); ++day)
+    {
+        auto it = plan.weeklyPlan.find(DAYS_OF_WEEK[day]);
+        if (it == plan.weeklyPlan.end())
+        {
+            continue;
+        }
+        for (const auto& exercise : it->second)
+        {
+            std::uint64_t prescription = (static_cast<std::uint64_t>(day) << 32) | (static_cast<std::uint64_t>(exercise.sets) << 16) | exercise.reps;
+            features.push_back(mix(std::hash<std::string>{}(exercise.exerciseName()) ^ mix(prescription)));
+        }
+    }
+    std::sort(features.begin(), features.end());
+    features.erase(std::unique(features.begin(), features.end()), features.end());
+    return features;
+}
+
+/**
+ * @brief Computes the MinHash signature of a feature set.
+ *
+ * Slot i holds the smallest value of the i-th hash function over the features; the hash
+ * functions are the feature hash mixed with a different seed.
+ *
+ * @param features The feature hashes.
+ * @return The signature, bands * rowsPerBand slots.
+ */
+std::vector<std::uint32_t> PlanSimilarityIndex::signatureOf(const std::vector<std::uint64_t>& features) const
+{
+    std::vector<std::uint32_t> signature(settings.bands * settings.rowsPerBand, std::numeric_limits<std::uint32_t>::max());
+    for (size_t i = 0; i < signature.size(); ++i)
+    {
+        const std::uint64_t seed = mix(i + 1);
+        for (std::uint64_t feature : features)
+        {
+            signature[i] = std::min(signature[i], static_cast<std::uint32_t>(mix(feature ^ seed) >> 32));
+        }
+    }
+    return signature;
+}
+
+/**
+ * @brief Hashes one band of a signature into a bucket key.
+ * @param signature The signature.
+ * @param band The band index.
+ * @return The bucket key, which also encodes the band.
+ */
+std::uint64_t PlanSimilarityIndex::bucketKey(const std::vector<std::uint32_t>& signature, size_t band) const
+{
+    std::uint64_t key = mix(band);
+    for (size_t row = 0; row < settings.rowsPerBand; ++row)
+    {
+        key = mix(key ^ signature[band * settings.rowsPerBand + row]);
+    }
+    return key;
+}
+
+/**
+ * @brief Computes the Jaccard index of two sorted feature sets.
+ * @param first The first feature set.
+ * @param second The second feature set.
+ * @return The Jaccard index, 1 for two empty sets.
+ */
+float PlanSimilarityIndex::jaccard(const std::vector<std::uint64_t>& first, const std::vector<std::uint64_t>& second)
+{
+    if (first.empty() && second.empty())
+    {
+        return 1.0f;
+    }
+
+    size_t shared = 0;
+    auto a = first.begin();
+    auto b = second.begin();
+    while (a != first.end() && b != second.end())
+    {
+        if (*a < *b)
+        {
+            ++a;
+        }
+        else if (*b < *a)
+        {
+            ++b;
+        }
+        else
+        {
+            ++shared;
+            ++a;
+            ++b;
+        }
+    }
+    return static_cast<float>(shared) / static_cast<float>(first.size() + second.size() - shared);
+}
@@ -0,0 +1,152 @@
+#ifndef PLAN_SIMILARITY_INDEX_H
+#define PLAN_SIMILARITY_INDEX_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WorkoutPlan.h"
+
+/**
+ * @brief Finds near-duplicate workout plans with MinHash signatures and locality-sensitive hashing.
+ *
+ * A plan is treated as the set of its (day, exercise, sets, reps) entries, and two plans are
+ * as similar as the Jaccard index of their sets. Every plan gets a MinHash signature whose
+ * slots agree between two plans with a probability equal to that index. The signature is cut
+ * into bands, and plans sharing a band land in the same bucket, so a lookup only compares the
+ * plans sharing a bucket with it instead of the whole library. Candidates are then confirmed
+ * with the exact Jaccard index.
+ *
+ * Like ExerciseUsageIndex, the index has to be told about every plan mutation through
+ * indexPlan() and removePlan().
+ */
+class PlanSimilarityIndex
+{
+public:
+    /**
+     * @brief Shape of the signatures and the similarity that counts as a near-duplicate.
+     */
+    struct Settings
+    {
+        size_t bands = 16; ///< Number of bands the signature is cut into.
+        size_t rowsPerBand = 4; ///< Signature slots per band; with 16 bands, plans about 50% similar become candidates.
+        float minSimilarity = 0.6f; ///< Smallest Jaccard index of near-duplicates.
+    };
+
+    /**
+     * @brief A plan similar to the one looked up.
+     */
+    struct Match
+    {
+        std::string plan; ///< Key of the plan in the plan map.
+        float similarity; ///< Jaccard index of the entries of both plans.
+    };
+
+    /**
+     * @brief Constructs an empty index.
+     * @param settings The shape of the signatures and the near-duplicate threshold.
+     */
+    explicit PlanSimilarityIndex(Settings settings);
+
+    /**
+     * @brief Replaces the index with the given plans.
+     * @param plans The plans by name.
+     */
+    void build(const std::map<std::string, WorkoutPlan>& plans);
+
+    /**
+     * @brief Adds a plan, replacing it if its name is already indexed.
+     * @param planName The key of the plan in the plan map.
+     * @param plan The plan.
+     */
+    void indexPlan(const std::string& planName, const WorkoutPlan& plan);
+
+    /**
+     * @brief Removes a plan.
+     * @param planName The key of the plan in the plan map.
+     */
+    void removePlan(const std::string& planName);
+
+    /**
+     * @brief Finds the indexed plans that are near-duplicates of a plan.
+     * @param plan The plan to look up, indexed or not.
+     * @param ignoredName An indexed plan to leave out, usually the plan itself.
+     * @return The near-duplicates, most similar first.
+     */
+    std::vector<Match> findSimilar(const WorkoutPlan& plan, const std::string& ignoredName = "") const;
+
+    /**
+     * @brief Groups the indexed plans into clusters of near-duplicates.
+     *
+     * Plans are in the same cluster if a chain of near-duplicate pairs links them.
+     *
+     * @return The clusters of at least two plans, each sorted by name.
+     */
+    std::vector<std::vector<std::string>> clusters() const;
+
+    /**
+     * @brief Computes the exact Jaccard index of two plans.
+     * @param first The first plan.
+     * @param second The second plan.
+     * @return The Jaccard index of their entries, 1 for two empty plans.
+     */
+    static float similarity(const WorkoutPlan& first, const WorkoutPlan& second);
+
+    /**
+     * @brief Describes how to turn one plan into another.
+     * @param from The plan to start from.
+     * @param to The plan to end with.
+     * @return One line per day that differs, listing the entries to add and remove.
+     */
+    static std::vector<std::string> describeDifferences(const WorkoutPlan& from, const WorkoutPlan& to);
+
+private:
+    /**
+     * @brief An indexed plan.
+     */
+    struct Entry
+    {
+        std::string name; ///< Key of the plan in the plan map.
+        std::vector<std::uint64_t> features; ///< Hashes of the plan entries, sorted and unique.
+        std::vector<std::uint32_t> signature; ///< MinHash signature of the features.
+        bool removed = false; ///< Whether the plan has been removed; its slot is reused on the next build.
+    };
+
+    /**
+     * @brief Hashes the entries of a plan.
+     * @param plan The plan.
+     * @return The hashes, sorted and unique.
+     */
+    static std::vector<std::uint64_t> featuresOf(const WorkoutPlan& plan);
+
+    /**
+     * @brief Computes the MinHash signature of a feature set.
+     * @param features The feature hashes.
+     * @return The signature, bands * rowsPerBand slots.
+     */
+    std::vector<std::uint32_t> signatureOf(const std::vector<std::uint64_t>& features) const;
+
+    /**
+     * @brief Hashes one band of a signature into a bucket key.
+     * @param signature The signature.
+     * @param band The band index.
+     * @return The bucket key, which also encodes the band.
+     */
+    std::uint64_t bucketKey(const std::vector<std::uint32_t>& signature, size_t band) const;
+
+    /**
+     * @brief Computes the Jaccard index of two sorted feature sets.
+     * @param first The first feature set.
+     * @param second The second feature set.
+     * @return The Jaccard index, 1 for two empty sets.
+     */
+    static float jaccard(const std::vector<std::uint64_t>& first, const std::vector<std::uint64_t>& second);
+
+    Settings settings; ///< The shape of the signatures and the near-duplicate threshold.
+    std::vector<Entry> entries; ///< Indexed plans, in insertion order.
+    std::map<std::string, size_t> slotByName; ///< Position in entries of every indexed plan.
+    std::unordered_map<std::uint64_t, std::vector<size_t>> buckets; ///< Positions in entries by bucket key.
+};
+
+#endif // PLAN_SIMILARITY_INDEX_H
@@ -0,0 +1,274 @@
+#include "PortionBalancer.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    const int macroCount = FoodCatalog::MACRO_COUNT;
+
+    /**
+     * @brief Solves a symmetric positive definite system by Cholesky decomposition.
+     * @param matrix Row-major system matrix, overwritten by its factor.
+     * @param vector Right-hand side, receives the solution.
+     * @return False if the matrix is not positive definite.
+     */
+    bool solveSymmetric(double matrix[macroCount][macroCount], double* vector)
+    {
+        for (int i = 0; i < macroCount; ++i)
+        {
+            for (int j = 0; j <= i; ++j)
+            {
+                double sum = matrix[i][j];
+                for (int k = 0; k < j; ++k)
+                {
+                    sum -= matrix[i][k] * matrix[j][k];
+                }
+                if (i == j)
+                {
+                    if (sum <= 0)
+                    {
+                        return false;
+                    }
+                    matrix[i][i] = std::sqrt(sum);
+                }
+                else
+                {
+                    matrix[i][j] = sum / matrix[j][j];
+                }
+            }
+        }
+
+        for (int i = 0; i < macroCount; ++i)
+        {
+            for (int k = 0; k < i; ++k)
+            {
+                vector[i] -= matrix[i][k] * vector[k];
+            }
+            vector[i] /= matrix[i][i];
+        }
+        for (int i = macroCount - 1; i >= 0; --i)
+        {
+            for (int k = i + 1; k < macroCount; ++k)
+            {
+                vector[i] -= matrix[k][i] * vector[k];
+            }
+            vector[i] /= matrix[i][i];
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Constructs a balancer with the given settings.
+ * @param settings The balancer settings.
+ */
+PortionBalancer::PortionBalancer(Settings settings) : settings(settings)
+{
+}
+
+/**
+ * @brief Balances the portions of a plan.
+ *
+ * Minimizes half the sum of the weighted squared macro deviations plus the anchor term with
+ * an active set method. Portions at a bound whose gradient points outwards are held fixed;
+ * for the others the Newton step is found with the Woodbury identity. If the step would take
+ * a portion out of range, it is shortened so that this portion stops at the bound. Every
+ * iteration lowers the cost, and a full step from the right set of fixed portions lands on
+ * the exact optimum.
+ *
+ * @param plan The nutrition plan to modify.
+ * @param targets The macro targets.
+ * @param locked Portions kept as they are; they still count towards the totals.
+ * @return The number of iterations performed.
+ */
+int PortionBalancer::balance(NutritionPlan& plan, const MacroTargets& targets, const LockedPortions& locked) const
+{
+    std::vector<std::pair<FoodItem, float>*> entries;
+    std::vector<float> rows;
+    std::vector<float> anchors;
+    std::vector<double> anchorWeights;
+    for (auto& meal : plan.meals)
+    {
+        for (auto& foodPair : meal.second)
+        {
+            if (locked.count({ meal.first, foodPair.first.name }) > 0)
+            {
+                continue;
+            }
+
+            entries.push_back(&foodPair);
+            anchors.push_back(foodPair.second);
+            float anchorScale = std::max(foodPair.second, 50.0f);
+            anchorWeights.push_back(settings.anchorWeight / (anchorScale * anchorScale));
+            // Values in FoodItem are given per 100 grams
+            rows.push_back(foodPair.first.calories / 100.0f);
+            rows.push_back(foodPair.first.protein / 100.0f);
+            rows.push_back(foodPair.first.carbohydrates / 100.0f);
+            rows.push_back(foodPair.first.fats / 100.0f);
+        }
+    }
+
+    double weights[macroCount];
+    double residuals[macroCount];
+    float totals[macroCount];
+    MacroTargets::planTotals(plan, totals);
+    for (int m = 0; m < macroCount; ++m)
+    {
+        double scale = std::max(targets.amounts[m], 1.0f) * targets.tolerances[m];
+        weights[m] = 1 / (scale * scale);
+        residuals[m] = totals[m] - targets.amounts[m];
+    }
+
+    const size_t count = entries.size();
+    std::vector<double> grams(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        grams[i] = entries[i]->second;
+    }
+
+    std::vector<double> gradient(count);
+    std::vector<double> direction(count);
+    std::vector<char> isFree(count);
+
+    int iteration = 0;
+    while (iteration < settings.maxIterations && count > 0)
+    {
+        iteration++;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* row = &rows[i * macroCount];
+            gradient[i] = anchorWeights[i] * (grams[i] - anchors[i]);
+            for (int m = 0; m < macroCount; ++m)
+            {
+                gradient[i] += weights[m] * row[m] * residuals[m];
+            }
+            bool atLowerBound = grams[i] <= 0 && gradient[i] >= 0;
+            bool atUpperBound = grams[i] >= settings.maxPortion && gradient[i] <= 0;
+            isFree[i] = !(atLowerBound || atUpperBound);
+        }
+
+        double step = 1;
+        size_t blocking = count;
+        bool singular = false;
+        while (true)
+        {
+            // Newton system restricted to the free portions: (D + A^T W A) d = -g
+            double system[macroCount][macroCount] = {};
+            double projected[macroCount] = {};
+            for (int m = 0; m < macroCount; ++m)
+            {
+                system[m][m] = 1 / weights[m];
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!isFree[i])
+                {
+                    continue;
+                }
+                const float* row = &rows[i * macroCount];
+                double inverseWeight = 1 / anchorWeights[i];
+                for (int m = 0; m < macroCount; ++m)
+                {
+                    projected[m] += row[m] * gradient[i] * inverseWeight;
+                    for (int n = 0; n <= m; ++n)
+                    {
+                        system[m][n] += row[m] * row[n] * inverseWeight;
+                    }
+                }
+            }
+            for (int m = 0; m < macroCount; ++m)
+            {
+                for (int n = m + 1; n < macroCount; ++n)
+                {
+                    system[m][n] = system[n][m];
+                }
+            }
+            if (!solveSymmetric(system, projected))
+            {
+                singular = true;
+                break;
+            }
+
+            // Woodbury: d = -D^-1 g + D^-1 A^T (W^-1 + A D^-1 A^T)^-1 A D^-1 g
+            // The step is cut where the first free portion reaches a bound
+            step = 1;
+            blocking = count;
+            for (size_t i = 0; i < count; ++i)
+            {
+                direction[i] = 0;
+                if (!isFree[i])
+                {
+                    continue;
+                }
+                const float* row = &rows[i * macroCount];
+                double correction = 0;
+                for (int m = 0; m < macroCount; ++m)
+                {
+                    correction += row[m] * projected[m];
+                }
+                direction[i] = (correction - gradient[i]) / anchorWeights[i];
+
+                double room = direction[i] < 0 ? grams[i] : settings.maxPortion - grams[i];
+                if (std::abs(direction[i]) * step > room)
+                {
+                    step = room / std::abs(direction[i]);
+                    blocking = i;
+                }
+            }
+
+            // A portion already at its bound blocks any progress, so it is held there as well
+            if (blocking == count || step > 0)
+            {
+                break;
+            }
+            isFree[blocking] = false;
+        }
+        // The portions of the earlier iterations are kept
+        if (singular)
+        {
+            break;
+        }
+
+        double largestStep = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            double newGrams = grams[i] + step * direction[i];
+            if (i == blocking)
+            {
+                newGrams = direction[i] < 0 ? 0 : settings.maxPortion;
+            }
+            newGrams = std::min(std::max(newGrams, 0.0), static_cast<double>(settings.maxPortion));
+            double change = newGrams - grams[i];
+            const float* row = &rows[i * macroCount];
+            for (int m = 0; m < macroCount; ++m)
+            {
+                residuals[m] += row[m] * change;
+            }
+            grams[i] = newGrams;
+            largestStep = std::max(largestStep, std::abs(change));
+        }
+
+        // A full step is the exact optimum for the current set of portions at a bound
+        if (blocking == count && largestStep < settings.convergenceGrams)
+        {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        entries[i]->second = static_cast<float>(grams[i]);
+    }
+    return iteration;
+}
+
+/**
+ * @brief Gets the balancer settings.
+ * @return The balancer settings.
+ */
+const PortionBalancer::Settings& PortionBalancer::getSettings() const
+{
+    return settings;
+}
@@ -0,0 +1,73 @@
+#ifndef PORTION_BALANCER_H
+#define PORTION_BALANCER_H
+
+#include <set>
+#include <string>
+#include <utility>
+#include "NutritionPlan.h"
+#include "MacroTargets.h"
+
+/**
+ * @brief Balances the portions of a plan against all four macro targets at once.
+ *
+ * Runs projected Newton iterations on the portion sizes: every iteration solves for the
+ * exact minimizer of MacroTargets::cost over the portions that are not held at a bound,
+ * then projects the step onto the allowed range. A weak anchor towards the starting
+ * portions keeps the character of the template, so foods are not dropped just because
+ * another food fits the macros slightly better.
+ *
+ * The cost only has four macro terms, so the Newton system is a diagonal plus a rank-four
+ * update and is solved through a 4x4 system in time linear in the number of portions.
+ * Balancing starts from the current portions, so a plan that is already close to the
+ * targets, e.g. after a manual edit, converges in one or two iterations.
+ */
+class PortionBalancer
+{
+public:
+    /**
+     * @brief Tunable parameters of the balancer.
+     */
+    struct Settings
+    {
+        int maxIterations = 50; ///< Maximum number of Newton iterations.
+        float maxPortion = 600.0f; ///< Largest portion size in grams.
+        float anchorWeight = 0.01f; ///< Weight of the pull towards the starting portions.
+        float convergenceGrams = 0.05f; ///< Stop once no portion moves by more than this in an iteration.
+    };
+
+    /**
+     * @brief Portions that must not be changed, as pairs of meal name and food name.
+     */
+    using LockedPortions = std::set<std::pair<std::string, std::string>>;
+
+    /**
+     * @brief Constructs a balancer with default settings.
+     */
+    PortionBalancer() = default;
+
+    /**
+     * @brief Constructs a balancer with the given settings.
+     * @param settings The balancer settings.
+     */
+    explicit PortionBalancer(Settings settings);
+
+    /**
+     * @brief Balances the portions of a plan.
+     * @param plan The nutrition plan to modify.
+     * @param targets The macro targets.
+     * @param locked Portions kept as they are; they still count towards the totals.
+     * @return The number of iterations performed.
+     */
+    int balance(NutritionPlan& plan, const MacroTargets& targets, const LockedPortions& locked = LockedPortions()) const;
+
+    /**
+     * @brief Gets the balancer settings.
+     * @return The balancer settings.
+     */
+    const Settings& getSettings() const;
+
+private:
+    Settings settings; ///< The balancer settings.
+};
+
+#endif // PORTION_BALANCER_H
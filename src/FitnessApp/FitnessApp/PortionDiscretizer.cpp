@@ -0,0 +1,237 @@
+#include "PortionDiscretizer.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs a discretizer with the given settings.
+ * @param settings The discretizer settings.
+ */
+PortionDiscretizer::PortionDiscretizer(Settings settings) : settings(settings)
+{
+}
+
+/**
+ * @brief Lists the rounded amounts around a portion.
+ *
+ * Whole servings are free, half servings and gram steps carry a growing penalty, and every
+ * choice is additionally penalized by its relative distance from the current amount.
+ *
+ * @param foodItem The food item of the portion.
+ * @param grams The current amount in grams.
+ * @return The candidate amounts.
+ */
+std::vector<PortionDiscretizer::Choice> PortionDiscretizer::choicesFor(const FoodItem& foodItem, float grams) const
+{
+    std::vector<Choice> choices;
+
+    auto addChoice = [&](float amount, float unitPenalty)
+    {
+        if (amount < settings.gramStep)
+        {
+            return;
+        }
+        float penalty = unitPenalty + std::abs(amount - grams) / std::max(grams, 1.0f);
+        for (auto& choice : choices)
+        {
+            if (std::abs(choice.grams - amount) < 0.01f)
+            {
+                choice.penalty = std::min(choice.penalty, penalty);
+                return;
+            }
+        }
+        choices.push_back({ amount, penalty });
+    };
+
+    if (foodItem.portion > 0)
+    {
+        float serving = foodItem.portion;
+        addChoice(std::floor(grams / serving) * serving, 0.0f);
+        addChoice(std::ceil(grams / serving) * serving, 0.0f);
+
+        float halfServing = serving / 2;
+        addChoice(std::floor(grams / halfServing) * halfServing, 0.5f);
+        addChoice(std::ceil(grams / halfServing) * halfServing, 0.5f);
+    }
+
+    addChoice(std::floor(grams / settings.gramStep) * settings.gramStep, 1.0f);
+    addChoice(std::ceil(grams / settings.gramStep) * settings.gramStep, 1.0f);
+
+    if (choices.empty())
+    {
+        addChoice(settings.gramStep, 1.0f);
+    }
+    return choices;
+}
+
+/**
+ * @brief Replaces the portions of a plan with serving-based amounts.
+ *
+ * The DP walks over the plan's foods; its state is the calorie and protein deviation of the
+ * plan from the targets, quantized into buckets. For every reachable bucket only the path with
+ * the lowest rounding penalty (plus its weighted carbohydrate and fat deviation) is kept, so the
+ * work grows with foods times buckets instead of exponentially with the number of foods.
+ *
+ * @param plan The nutrition plan to modify.
+ * @param targets The macro targets and tolerances.
+ * @param locked Portions kept as they are; they still count towards the totals.
+ * @return The number of portions rounded, one DP stage each.
+ */
+int PortionDiscretizer::discretize(NutritionPlan& plan, const MacroTargets& targets, const PortionBalancer::LockedPortions& locked) const
+{
+    const float targetCalories = targets.amounts[FoodCatalog::CALORIES];
+    const float targetProtein = targets.amounts[FoodCatalog::PROTEIN];
+
+    std::vector<std::pair<FoodItem, float>*> entries;
+    std::vector<std::vector<Choice>> entryChoices;
+    float deviation[FoodCatalog::MACRO_COUNT];
+    MacroTargets::planTotals(plan, deviation);
+    for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+    {
+        deviation[m] -= targets.amounts[m];
+    }
+    float calorieReach = 0;
+    float proteinReach = 0;
+
+    for (auto& meal : plan.meals)
+    {
+        for (auto& foodPair : meal.second)
+        {
+            if (foodPair.second <= 0 || locked.count({ meal.first, foodPair.first.name }) > 0)
+            {
+                continue;
+            }
+
+            entries.push_back(&foodPair);
+            entryChoices.push_back(choicesFor(foodPair.first, foodPair.second));
+
+            // Track how far the choices can move the totals to size the DP grid
+            float maxDelta = 0;
+            for (const auto& choice : entryChoices.back())
+            {
+                maxDelta = std::max(maxDelta, std::abs(choice.grams - foodPair.second));
+            }
+            calorieReach += maxDelta * foodPair.first.calories / 100;
+            proteinReach += maxDelta * std::abs(foodPair.first.protein) / 100;
+        }
+    }
+
+    if (entries.empty())
+    {
+        return 0;
+    }
+
+    const int maxBuckets = 201;
+    float calorieWindow = std::abs(deviation[FoodCatalog::CALORIES]) + calorieReach;
+    float proteinWindow = std::abs(deviation[FoodCatalog::PROTEIN]) + proteinReach;
+    float calorieResolution = std::max(settings.calorieResolution, 2 * calorieWindow / (maxBuckets - 1));
+    float proteinResolution = std::max(settings.proteinResolution, 2 * proteinWindow / (maxBuckets - 1));
+    int calorieBuckets = static_cast<int>(std::ceil(2 * calorieWindow / calorieResolution)) + 1;
+    int proteinBuckets = static_cast<int>(std::ceil(2 * proteinWindow / proteinResolution)) + 1;
+
+    auto bucketOf = [&](float calories, float protein)
+    {
+        int c = std::min(std::max(static_cast<int>(std::lround((calories + calorieWindow) / calorieResolution)), 0), calorieBuckets - 1);
+        int p = std::min(std::max(static_cast<int>(std::lround((protein + proteinWindow) / proteinResolution)), 0), proteinBuckets - 1);
+        return c * proteinBuckets + p;
+    };
+
+    // Carbohydrate and fat deviation in units of their tolerance
+    const float carbScale = std::max(targets.amounts[FoodCatalog::CARBS], 1.0f) * targets.tolerances[FoodCatalog::CARBS];
+    const float fatScale = std::max(targets.amounts[FoodCatalog::FATS], 1.0f) * targets.tolerances[FoodCatalog::FATS];
+    auto secondaryCost = [&](float carbs, float fats)
+    {
+        float carbError = carbs / carbScale;
+        float fatError = fats / fatScale;
+        return settings.secondaryWeight * (carbError * carbError + fatError * fatError);
+    };
+
+    struct Node
+    {
+        int bucket;
+        float penalty;
+        float rank;
+        float deviation[FoodCatalog::MACRO_COUNT];
+        int parent;
+        int choice;
+    };
+
+    std::vector<std::vector<Node>> layers(entries.size() + 1);
+    Node root = { bucketOf(deviation[FoodCatalog::CALORIES], deviation[FoodCatalog::PROTEIN]), 0.0f, 0.0f, {}, -1, -1 };
+    std::copy(deviation, deviation + FoodCatalog::MACRO_COUNT, root.deviation);
+    layers[0].push_back(root);
+    std::vector<int> nodeInBucket(static_cast<size_t>(calorieBuckets) * proteinBuckets, -1);
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const FoodItem& foodItem = entries[i]->first;
+        const float rows[FoodCatalog::MACRO_COUNT] = { foodItem.calories / 100.0f, foodItem.protein / 100.0f, foodItem.carbohydrates / 100.0f, foodItem.fats / 100.0f };
+        float grams = entries[i]->second;
+        std::vector<Node>& next = layers[i + 1];
+
+        for (int parent = 0; parent < static_cast<int>(layers[i].size()); ++parent)
+        {
+            const Node& node = layers[i][parent];
+            for (int c = 0; c < static_cast<int>(entryChoices[i].size()); ++c)
+            {
+                const Choice& choice = entryChoices[i][c];
+                Node child;
+                for (int m = 0; m < FoodCatalog::MACRO_COUNT; ++m)
+                {
+                    child.deviation[m] = node.deviation[m] + (choice.grams - grams) * rows[m];
+                }
+                child.bucket = bucketOf(child.deviation[FoodCatalog::CALORIES], child.deviation[FoodCatalog::PROTEIN]);
+                child.penalty = node.penalty + choice.penalty;
+                child.rank = child.penalty + secondaryCost(child.deviation[FoodCatalog::CARBS], child.deviation[FoodCatalog::FATS]);
+                child.parent = parent;
+                child.choice = c;
+
+                int& slot = nodeInBucket[child.bucket];
+                if (slot < 0)
+                {
+                    slot = static_cast<int>(next.size());
+                    next.push_back(child);
+                }
+                else if (child.rank < next[slot].rank)
+                {
+                    next[slot] = child;
+                }
+            }
+        }
+
+        // Clear only the buckets this layer touched
+        for (const auto& node : next)
+        {
+            nodeInBucket[node.bucket] = -1;
+        }
+    }
+
+    // Prefer the best ranked result within tolerance, otherwise the one closest to the targets
+    const float calorieTolerance = std::max(targetCalories * targets.tolerances[FoodCatalog::CALORIES], settings.minCalorieTolerance);
+    const float proteinTolerance = std::max(targetProtein * targets.tolerances[FoodCatalog::PROTEIN], settings.minProteinTolerance);
+    const std::vector<Node>& last = layers.back();
+    int bestNode = 0;
+    float bestScore = 0;
+
+    for (int n = 0; n < static_cast<int>(last.size()); ++n)
+    {
+        float calorieError = last[n].deviation[FoodCatalog::CALORIES] / calorieTolerance;
+        float proteinError = last[n].deviation[FoodCatalog::PROTEIN] / proteinTolerance;
+        float primaryDeviation = calorieError * calorieError + proteinError * proteinError;
+        bool withinTolerance = std::abs(calorieError) <= 1 && std::abs(proteinError) <= 1;
+        float score = withinTolerance ? last[n].rank + primaryDeviation / 2 : 1e6f + primaryDeviation;
+
+        if (n == 0 || score < bestScore)
+        {
+            bestNode = n;
+            bestScore = score;
+        }
+    }
+
+    for (size_t i = entries.size(); i > 0; --i)
+    {
+        const Node& node = layers[i][bestNode];
+        entries[i - 1]->second = entryChoices[i - 1][node.choice].grams;
+        bestNode = node.parent;
+    }
+    return static_cast<int>(entries.size());
+}
@@ -0,0 +1,76 @@
+#ifndef PORTION_DISCRETIZER_H
+#define PORTION_DISCRETIZER_H
+
+#include <vector>
+#include "NutritionPlan.h"
+#include "FoodItem.h"
+#include "MacroTargets.h"
+#include "PortionBalancer.h"
+
+/**
+ * @brief Snaps the portions of a generated plan to realistic serving units.
+ *
+ * Every portion is rounded to whole servings, half servings (using FoodItem::portion) or
+ * 5 gram steps. The combination of roundings is chosen by dynamic programming over the
+ * calorie and protein deviation from the targets, preferring whole servings as long as
+ * the plan stays within the macro tolerance. Carbohydrates and fats are carried along
+ * each path and break ties between paths with similar calories and protein.
+ */
+class PortionDiscretizer
+{
+public:
+    /**
+     * @brief Tunable parameters of the discretizer.
+     */
+    struct Settings
+    {
+        float minCalorieTolerance = 25.0f; ///< Smallest calorie tolerance in kcal, for small targets.
+        float minProteinTolerance = 3.0f; ///< Smallest protein tolerance in grams, for small targets.
+        float secondaryWeight = 0.25f; ///< Weight of the carbohydrate and fat deviation relative to the rounding penalty.
+        float gramStep = 5.0f; ///< Step in grams used when no serving unit fits.
+        float calorieResolution = 5.0f; ///< Width of a calorie bucket of the DP state in kcal.
+        float proteinResolution = 1.0f; ///< Width of a protein bucket of the DP state in grams.
+    };
+
+    /**
+     * @brief Constructs a discretizer with default settings.
+     */
+    PortionDiscretizer() = default;
+
+    /**
+     * @brief Constructs a discretizer with the given settings.
+     * @param settings The discretizer settings.
+     */
+    explicit PortionDiscretizer(Settings settings);
+
+    /**
+     * @brief Replaces the portions of a plan with serving-based amounts.
+     * @param plan The nutrition plan to modify.
+     * @param targets The macro targets and tolerances.
+     * @param locked Portions kept as they are; they still count towards the totals.
+     * @return The number of portions rounded, one DP stage each.
+     */
+    int discretize(NutritionPlan& plan, const MacroTargets& targets, const PortionBalancer::LockedPortions& locked = PortionBalancer::LockedPortions()) const;
+
+private:
+    /**
+     * @brief One rounded amount a portion may be snapped to.
+     */
+    struct Choice
+    {
+        float grams; ///< Amount in grams.
+        float penalty; ///< How unnatural the amount is, lower is better.
+    };
+
+    Settings settings; ///< The discretizer settings.
+
+    /**
+     * @brief Lists the rounded amounts around a portion.
+     * @param foodItem The food item of the portion.
+     * @param grams The current amount in grams.
+     * @return The candidate amounts.
+     */
+    std::vector<Choice> choicesFor(const FoodItem& foodItem, float grams) const;
+};
+
+#endif // PORTION_DISCRETIZER_H
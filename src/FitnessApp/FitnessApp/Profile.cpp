@@ -1,4 +1,5 @@
 #include "Profile.h"
+#include "Utils.h"
 
 /**
  * @brief Constructs a new Profile object with default values.
@@ -66,37 +67,52 @@ void Profile::displayProfileInformation() const
  */
 float Profile::calculateDailyCalories() const
 {
-    float bmr;
-    if (gender == Gender::MALE)
-    {
-        bmr = 10 * weight + 6.25f * height - 5 * age + 5;
-    }
-    else
-    {
-        bmr = 10 * weight + 6.25f * height - 5 * age - 161;
-    }
+    return calculateBasalMetabolicRate() * activityFactor(activityLevel);
+}
+
+/**
+ * @brief Calculates the basal metabolic rate with the Mifflin-St Jeor equation.
+ *
+ * @return float The calories burned per day at rest.
+ */
+float Profile::calculateBasalMetabolicRate() const
+{
+    return 10 * weight + 6.25f * height - 5 * age + genderOffset(gender);
+}
 
-    float activityFactor{};
+/**
+ * @brief Gets the multiplier of the basal metabolic rate for an activity level.
+ *
+ * @param activityLevel The activity level.
+ * @return float The multiplier.
+ */
+float Profile::activityFactor(ActivityLevel activityLevel)
+{
     switch (activityLevel)
     {
     case ActivityLevel::SEDENTARY:
-        activityFactor = 1.2f;
-        break;
+        return 1.2f;
     case ActivityLevel::LIGHTLY_ACTIVE:
-        activityFactor = 1.375f;
-        break;
+        return 1.375f;
     case ActivityLevel::MODERATELY_ACTIVE:
-        activityFactor = 1.55f;
-        break;
+        return 1.55f;
     case ActivityLevel::VERY_ACTIVE:
-        activityFactor = 1.725f;
-        break;
+        return 1.725f;
     case ActivityLevel::EXTRA_ACTIVE:
-        activityFactor = 1.9f;
-        break;
+        return 1.9f;
     }
+    return 1.0f;
+}
 
-    return bmr * activityFactor;
+/**
+ * @brief Gets the constant the Mifflin-St Jeor equation adds for a gender.
+ *
+ * @param gender The gender.
+ * @return float The constant, in kcal per day.
+ */
+float Profile::genderOffset(Gender gender)
+{
+    return gender == Gender::MALE ? 5.0f : -161.0f;
 }
 
 /**
@@ -109,9 +125,8 @@ void Profile::saveToCSV(const std::string& filename) const
     std::ofstream file(filename);
     if (file.is_open())
     {
-        file << name << ',' << age << ',' << (gender == Gender::MALE ? "Male" : "Female") << ','
-            << height << ',' << weight << ','
-            << static_cast<int>(activityLevel) << '\n';
+        toCSV(file);
+        file << '\n';
         file.close();
     }
     else
@@ -125,7 +140,7 @@ void Profile::saveToCSV(const std::string& filename) const
  *
  * @param filename The name of the file to load the profile information.
  * @return true If the file was successfully loaded.
- * @return false If the file could not be opened.
+ * @return false If the file could not be opened or is malformed.
  */
 bool Profile::loadFromCSV(const std::string& filename)
 {
@@ -136,19 +151,11 @@ bool Profile::loadFromCSV(const std::string& filename)
         if (std::getline(file, line))
         {
             std::istringstream ss(line);
-            std::string token;
-
-            std::getline(ss, name, ',');
-            std::getline(ss, token, ',');
-            age = std::stoi(token);
-            std::getline(ss, token, ',');
-            gender = (token == "Male" ? Gender::MALE : Gender::FEMALE);
-            std::getline(ss, token, ',');
-            height = std::stof(token);
-            std::getline(ss, token, ',');
-            weight = std::stof(token);
-            std::getline(ss, token, ',');
-            activityLevel = static_cast<ActivityLevel>(std::stoi(token));
+            if (!fromCSV(ss))
+            {
+                std::cerr << "Malformed profile in " << filename << ": " << line << std::endl;
+                return false;
+            }
         }
         file.close();
         return true;
@@ -160,6 +167,54 @@ bool Profile::loadFromCSV(const std::string& filename)
     }
 }
 
+/**
+ * @brief Writes the profile information as comma-separated fields, without a line break.
+ *
+ * @param os The stream to write to.
+ */
+void Profile::toCSV(std::ostream& os) const
+{
+    os << name << ',' << age << ',' << (gender == Gender::MALE ? "Male" : "Female") << ','
+        << height << ',' << weight << ','
+        << static_cast<int>(activityLevel);
+}
+
+/**
+ * @brief Reads the profile information written by toCSV, leaving the stream after its last field.
+ *
+ * The profile is left unchanged unless every field is valid.
+ *
+ * @param is The stream to read from.
+ * @return true If every field was read.
+ * @return false If the stream ended early, a number is malformed, or the gender or activity level is unknown.
+ */
+bool Profile::fromCSV(std::istream& is)
+{
+    std::string nameField, ageField, genderField, heightField, weightField, activityField;
+    int ageValue = 0, activityValue = 0;
+    float heightValue = 0.0f, weightValue = 0.0f;
+    if (!std::getline(is, nameField, ',') || !std::getline(is, ageField, ',') || !std::getline(is, genderField, ',')
+        || !std::getline(is, heightField, ',') || !std::getline(is, weightField, ',') || !std::getline(is, activityField, ',')
+        || !stringToInt(ageField, ageValue) || !stringToFloat(heightField, heightValue) || !stringToFloat(weightField, weightValue)
+        || !stringToInt(activityField, activityValue))
+    {
+        return false;
+    }
+    if ((genderField != "Male" && genderField != "Female")
+        || activityValue < static_cast<int>(ActivityLevel::SEDENTARY) || activityValue > static_cast<int>(ActivityLevel::EXTRA_ACTIVE))
+    {
+        return false;
+    }
+
+    name = nameField;
+    age = ageValue;
+    gender = genderField == "Male" ? Gender::MALE : Gender::FEMALE;
+    height = heightValue;
+    weight = weightValue;
+    activityLevel = static_cast<ActivityLevel>(activityValue);
+    return true;
+}
+
 /**
  * @brief Gets the weight of the user.
  *
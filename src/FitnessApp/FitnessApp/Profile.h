@@ -62,6 +62,29 @@ public:
      */
     float calculateDailyCalories() const;
 
+    /**
+     * @brief Calculates the basal metabolic rate with the Mifflin-St Jeor equation.
+     *
+     * @return float The calories burned per day at rest.
+     */
+    float calculateBasalMetabolicRate() const;
+
+    /**
+     * @brief Gets the multiplier of the basal metabolic rate for an activity level.
+     *
+     * @param activityLevel The activity level.
+     * @return float The multiplier.
+     */
+    static float activityFactor(ActivityLevel activityLevel);
+
+    /**
+     * @brief Gets the constant the Mifflin-St Jeor equation adds for a gender.
+     *
+     * @param gender The gender.
+     * @return float The constant, in kcal per day.
+     */
+    static float genderOffset(Gender gender);
+
     /**
      * @brief Saves the profile information to a CSV file.
      *
@@ -74,10 +97,26 @@ public:
      *
      * @param filename The name of the file to load the profile information.
      * @return true If the file was successfully loaded.
-     * @return false If the file could not be opened.
+     * @return false If the file could not be opened or is malformed.
      */
     bool loadFromCSV(const std::string& filename);
 
+    /**
+     * @brief Writes the profile information as comma-separated fields, without a line break.
+     *
+     * @param os The stream to write to.
+     */
+    void toCSV(std::ostream& os) const;
+
+    /**
+     * @brief Reads the profile information written by toCSV, leaving the stream after its last field.
+     *
+     * @param is The stream to read from.
+     * @return true If every field was read.
+     * @return false If the stream ended early, a number is malformed, or the gender or activity level is unknown.
+     */
+    bool fromCSV(std::istream& is);
+
     /**
      * @brief Gets the weight of the user.
      *
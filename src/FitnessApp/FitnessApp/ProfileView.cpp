@@ -1,5 +1,7 @@
 #include "ProfileView.h"
 #include "Utils.h"
+#include "CalorieBatch.h"
+#include <fstream>
 
 /**
  * @brief Prompts the user for optional string input.
@@ -75,26 +77,23 @@ float getOptionalFloatInput(const std::string& prompt, float currentValue)
  *
  * @param profile Reference to the Profile object.
  * @param goals Reference to the Goals object.
+ * @param userRegistry Reference to the registry the profile and goals are loaded from and saved to.
  */
-ProfileView::ProfileView(Profile& profile, Goals& goals) : profile(profile), goals(goals)
+ProfileView::ProfileView(Profile& profile, Goals& goals, UserRegistry& userRegistry) : profile(profile), goals(goals), userRegistry(userRegistry)
 {
     menuOptions = {
-        {"View Profile", [this]() { printLabel("Viewing Profile"); this->profile.displayProfileInformation(); this->goals.displayGoals(); }},
+        {"View Profile", [this]() { printLabel("Viewing Profile"); this->profile.displayProfileInformation(); this->goals.displayGoals(); displayWorkoutBurn(); }},
         {"Set Profile Information", [this]() { printLabel("Setting Profile Information"); setProfileInformation(); }},
         {"Set Goals", [this]() { printLabel("Setting Goals"); setGoals(); }},
         {"Set Custom Calories", [this]() { printLabel("Setting Custom Calories"); setCustomCalories(); }},
         {"Reset to Calculated Calories", [this]() { printLabel("Resetting to Calculated Calories"); resetToCalculatedCalories(); }},
+        {"Set Workout Plan", [this]() { printLabel("Setting Workout Plan"); setWorkoutPlan(); }},
+        {"Manage Users", [this]() { printLabel("Managing Users"); manageUsers(); }},
         {"Back", [this]() { return; }}
     };
 
-    // Load profile information from file
-    if (profile.loadFromCSV("profile.csv"))
-    {
-        goals.setProfile(&profile);
-    }
-
-    // Load goals information from file
-    goals.loadFromCSV("goals.csv");
+    userRegistry.open();
+    loadActiveUser();
 }
 
 /**
@@ -105,6 +104,264 @@ void ProfileView::display()
     displayAndHandleSubMenu("Profile", menuOptions, true);
 }
 
+/**
+ * @brief Loads the active user, creating the first user from profile.csv and goals.csv if the registry is empty.
+ *
+ * The single-user files of earlier versions are imported once and left in place.
+ */
+void ProfileView::loadActiveUser()
+{
+    if (userRegistry.getUserCount() == 0)
+    {
+        profile = Profile();
+        goals = Goals();
+        if (std::ifstream("profile.csv").is_open() && profile.loadFromCSV("profile.csv"))
+        {
+            goals.setProfile(&profile);
+            if (std::ifstream("goals.csv").is_open())
+            {
+                goals.loadFromCSV("goals.csv");
+            }
+        }
+        userRegistry.create(profile, goals);
+    }
+
+    if (!userRegistry.load(userRegistry.getActiveUser(), profile, goals))
+    {
+        std::cerr << "Error loading user " << userRegistry.getActiveUser() << ".\n";
+    }
+    goals.setProfile(&profile);
+    refreshWorkoutBurn();
+}
+
+/**
+ * @brief Saves the profile and goals of the active user.
+ */
+void ProfileView::saveActiveUser()
+{
+    if (!userRegistry.save(userRegistry.getActiveUser(), profile, goals))
+    {
+        std::cerr << "Error saving user " << userRegistry.getActiveUser() << ".\n";
+    }
+}
+
+/**
+ * @brief Lets the user switch, create, remove, import or export users.
+ */
+void ProfileView::manageUsers()
+{
+    std::cout << "Active user: " << userRegistry.getActiveUser() << " (" << profile.getName() << "), "
+        << userRegistry.getUserCount() << " user(s) in total\n";
+    std::cout << "1. Switch User\n";
+    std::cout << "2. New User\n";
+    std::cout << "3. Remove User\n";
+    std::cout << "4. Import Users from CSV\n";
+    std::cout << "5. Export Users to CSV\n";
+    std::cout << "6. Export Calorie Targets to CSV\n";
+    std::cout << "7. Export Workout Burns to CSV\n";
+    std::cout << "8. Cancel\n";
+
+    int choice;
+    getValidInput(choice, "Enter choice: ", 1, 8);
+
+    int id;
+    std::string filename;
+    switch (choice)
+    {
+    case 1:
+        getValidInput(id, "Enter user id: ");
+        if (id < 0 || !userRegistry.setActiveUser(static_cast<UserRegistry::UserId>(id)))
+        {
+            std::cout << "User " << id << " not found.\n";
+            return;
+        }
+        loadActiveUser();
+        std::cout << "Switched to user " << id << " (" << profile.getName() << ").\n";
+        break;
+    case 2:
+    {
+        Profile newProfile;
+        Goals newGoals;
+        UserRegistry::UserId newId = userRegistry.create(newProfile, newGoals);
+        if (newId == UserRegistry::NO_USER || !userRegistry.setActiveUser(newId))
+        {
+            return;
+        }
+        loadActiveUser();
+        std::cout << "Created user " << newId << "; set the profile information to fill it in.\n";
+        break;
+    }
+    case 3:
+        getValidInput(id, "Enter user id: ");
+        if (id >= 0 && static_cast<UserRegistry::UserId>(id) == userRegistry.getActiveUser())
+        {
+            std::cout << "The active user cannot be removed; switch to another user first.\n";
+        }
+        else if (id < 0 || !userRegistry.remove(static_cast<UserRegistry::UserId>(id)))
+        {
+            std::cout << "User " << id << " not found.\n";
+        }
+        else
+        {
+            std::cout << "Removed user " << id << ".\n";
+        }
+        break;
+    case 4:
+        std::cout << "Enter the CSV filename: ";
+        std::getline(std::cin, filename);
+        std::cout << "Imported " << userRegistry.importCSV(filename) << " user(s).\n";
+        break;
+    case 5:
+        std::cout << "Enter the CSV filename: ";
+        std::getline(std::cin, filename);
+        std::cout << "Exported " << userRegistry.exportCSV(filename) << " user(s).\n";
+        break;
+    case 6:
+        std::cout << "Enter the CSV filename: ";
+        std::getline(std::cin, filename);
+        exportCalorieTargets(filename);
+        break;
+    case 7:
+        std::cout << "Enter the CSV filename: ";
+        std::getline(std::cin, filename);
+        exportWorkoutBurns(filename);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Writes the basal metabolic rate, energy expenditure and daily calories of every user to a CSV file.
+ *
+ * The file starts with a header row naming the columns. The users are read once and their figures computed together with CalorieBatch. The burn of
+ * a workout plan is found as in refreshWorkoutBurn, with the MET-hours of every plan computed
+ * once.
+ *
+ * @param filename The CSV file.
+ */
+void ProfileView::exportCalorieTargets(const std::string& filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Unable to open file for writing: " << filename << std::endl;
+        return;
+    }
+
+    auto plans = readFromCSV<WorkoutPlan>("workout_plans.csv");
+    BurnEstimator estimator{ BurnEstimator::Settings() };
+    estimator.setExercises(readFromCSV<Exercise>("exercises.csv"));
+    std::map<std::string, BurnEstimator::DailyValues> hoursByPlan;
+
+    CalorieBatch batch;
+    std::vector<UserRegistry::UserId> ids;
+    batch.reserve(userRegistry.getUserCount());
+    ids.reserve(userRegistry.getUserCount());
+    userRegistry.forEachUser([&](UserRegistry::UserId id, const Profile& userProfile, const Goals& userGoals) {
+        Goals trainingGoals = userGoals;
+        if (!trainingGoals.getWorkoutPlan().empty())
+        {
+            auto hours = hoursByPlan.find(trainingGoals.getWorkoutPlan());
+            if (hours == hoursByPlan.end())
+            {
+                auto plan = plans.find(trainingGoals.getWorkoutPlan());
+                if (plan != plans.end())
+                {
+                    hours = hoursByPlan.emplace(plan->first, estimator.metHours(plan->second)).first;
+                }
+            }
+
+            if (hours == hoursByPlan.end())
+            {
+                trainingGoals.setWorkoutPlan("");
+            }
+            else
+            {
+                float total = 0.0f;
+                for (float dayHours : hours->second)
+                {
+                    total += dayHours * userProfile.getWeight();
+                }
+                trainingGoals.setWorkoutBurn(total / hours->second.size());
+            }
+        }
+        ids.push_back(id);
+        batch.add(userProfile, trainingGoals);
+    });
+    batch.compute();
+
+    const auto& basalMetabolicRates = batch.getBasalMetabolicRates();
+    const auto& energyExpenditures = batch.getEnergyExpenditures();
+    const auto& dailyCalories = batch.getDailyCalories();
+    file << "id,basal metabolic rate,energy expenditure,daily calories\n";
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        file << ids[i] << "," << basalMetabolicRates[i] << "," << energyExpenditures[i] << "," << dailyCalories[i] << "\n";
+    }
+    std::cout << "Exported the calorie targets of " << ids.size() << " user(s).\n";
+}
+
+/**
+ * @brief Writes the daily calories every saved workout plan would burn for every user to a CSV file.
+ *
+ * The file starts with a header row, followed by one line per user and plan with the calories
+ * of every day. The weights of all users are read first, and the table is computed in one
+ * BurnEstimator::batch call, so the MET-hours of every plan are computed once.
+ *
+ * @param filename The CSV file.
+ */
+void ProfileView::exportWorkoutBurns(const std::string& filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Unable to open file for writing: " << filename << std::endl;
+        return;
+    }
+
+    auto plans = readFromCSV<WorkoutPlan>("workout_plans.csv");
+    std::vector<const WorkoutPlan*> planList;
+    planList.reserve(plans.size());
+    for (const auto& plan : plans)
+    {
+        planList.push_back(&plan.second);
+    }
+    BurnEstimator estimator{ BurnEstimator::Settings() };
+    estimator.setExercises(readFromCSV<Exercise>("exercises.csv"));
+
+    std::vector<UserRegistry::UserId> ids;
+    std::vector<float> weights;
+    ids.reserve(userRegistry.getUserCount());
+    weights.reserve(userRegistry.getUserCount());
+    userRegistry.forEachUser([&](UserRegistry::UserId id, const Profile& userProfile, const Goals&) {
+        ids.push_back(id);
+        weights.push_back(userProfile.getWeight());
+    });
+    const std::vector<float> burn = estimator.batch(weights, planList);
+
+    file << "id,plan";
+    for (const auto& day : DAYS_OF_WEEK)
+    {
+        file << ',' << day;
+    }
+    file << '\n';
+    const float* value = burn.data();
+    for (UserRegistry::UserId id : ids)
+    {
+        for (const WorkoutPlan* plan : planList)
+        {
+            file << id << ',' << plan->name;
+            for (size_t day = 0; day < BurnEstimator::DAY_COUNT; ++day)
+            {
+                file << ',' << *value++;
+            }
+            file << '\n';
+        }
+    }
+    std::cout << "Exported the workout burns of " << ids.size() << " user(s) and " << planList.size() << " plan(s).\n";
+}
+
 /**
  * @brief Prompts the user to select an activity level.
  *
@@ -210,9 +467,9 @@ void ProfileView::setProfileInformation()
     Profile::ActivityLevel activityLevel = getActivityLevel(profile.getActivityLevel());
 
     profile.setProfileInformation(name, age, gender, height, weight, activityLevel);
-    profile.saveToCSV("profile.csv");
     goals.setProfile(&profile);
-    goals.saveToCSV("goals.csv");
+    refreshWorkoutBurn();
+    saveActiveUser();
 }
 
 /**
@@ -288,7 +545,7 @@ void ProfileView::setGoals()
     Goals::FitnessGoal fitnessGoal = getFitnessGoal(goals.getFitnessGoal());
 
     goals.setGoals(targetWeight, bodyFatPercentage, fitnessGoal);
-    goals.saveToCSV("goals.csv");
+    saveActiveUser();
 }
 
 /**
@@ -299,7 +556,7 @@ void ProfileView::setCustomCalories()
     float customCalories;
     getValidInput(customCalories, "Enter custom daily calories: ");
     goals.setCustomCalories(customCalories);
-    goals.saveToCSV("goals.csv");
+    saveActiveUser();
 }
 
 /**
@@ -308,5 +565,76 @@ void ProfileView::setCustomCalories()
 void ProfileView::resetToCalculatedCalories()
 {
     goals.resetToCalculatedCalories();
-    goals.saveToCSV("goals.csv");
+    saveActiveUser();
+}
+
+/**
+ * @brief Lets the user choose the workout plan whose calorie burn replaces the activity level.
+ */
+void ProfileView::setWorkoutPlan()
+{
+    auto plans = readFromCSV<WorkoutPlan>("workout_plans.csv");
+
+    std::cout << "Select the workout plan you follow:\n";
+    std::vector<std::string> planNames;
+    int index = 1;
+    for (const auto& pair : plans)
+    {
+        std::cout << index << ". " << pair.first << "\n";
+        planNames.push_back(pair.first);
+        ++index;
+    }
+    std::cout << index << ". None (use the activity level)\n";
+
+    int choice;
+    getValidInput(choice, "Enter choice: ", 1, index);
+
+    goals.setWorkoutPlan(choice == index ? "" : planNames[choice - 1]);
+    refreshWorkoutBurn();
+    saveActiveUser();
+    displayWorkoutBurn();
+}
+
+/**
+ * @brief Recomputes the calorie burn of the chosen workout plan for the current weight.
+ */
+void ProfileView::refreshWorkoutBurn()
+{
+    workoutBurn.fill(0.0f);
+    if (goals.getWorkoutPlan().empty())
+    {
+        return;
+    }
+
+    if (!BurnEstimator::estimateSavedPlan(goals.getWorkoutPlan(), profile.getWeight(), workoutBurn))
+    {
+        std::cout << "Workout plan '" << goals.getWorkoutPlan() << "' no longer exists, using the activity level instead.\n";
+        goals.setWorkoutPlan("");
+        return;
+    }
+
+    float total = 0.0f;
+    for (float calories : workoutBurn)
+    {
+        total += calories;
+    }
+    goals.setWorkoutBurn(total / workoutBurn.size());
+}
+
+/**
+ * @brief Displays the calorie burn of the chosen workout plan on each day.
+ */
+void ProfileView::displayWorkoutBurn() const
+{
+    if (goals.getWorkoutPlan().empty())
+    {
+        return;
+    }
+
+    std::cout << "Training calories by day:";
+    for (size_t day = 0; day < workoutBurn.size(); ++day)
+    {
+        std::cout << " " << DAYS_OF_WEEK[day] << " " << static_cast<int>(workoutBurn[day] + 0.5f) << ";";
+    }
+    std::cout << "\n";
 }
@@ -4,6 +4,8 @@
 #include "View.h"
 #include "Profile.h"
 #include "Goals.h"
+#include "UserRegistry.h"
+#include "BurnEstimator.h"
 
 /**
  * @brief The ProfileView class is responsible for managing the profile and goals settings.
@@ -17,8 +19,9 @@ public:
      *
      * @param profile Reference to the Profile object.
      * @param goals Reference to the Goals object.
+     * @param userRegistry Reference to the registry the profile and goals are loaded from and saved to.
      */
-    ProfileView(Profile& profile, Goals& goals);
+    ProfileView(Profile& profile, Goals& goals, UserRegistry& userRegistry);
 
     /**
      * @brief Displays the profile view menu.
@@ -28,8 +31,39 @@ public:
 private:
     Profile& profile; ///< Reference to the Profile object.
     Goals& goals; ///< Reference to the Goals object.
+    UserRegistry& userRegistry; ///< Reference to the registry of all users.
+    BurnEstimator::DailyValues workoutBurn{}; ///< Calorie burn of the chosen workout plan on each day.
     std::vector<MenuOption> menuOptions; ///< Vector to store menu options.
 
+    /**
+     * @brief Loads the active user, creating the first user from profile.csv and goals.csv if the registry is empty.
+     */
+    void loadActiveUser();
+
+    /**
+     * @brief Saves the profile and goals of the active user.
+     */
+    void saveActiveUser();
+
+    /**
+     * @brief Lets the user switch, create, remove, import or export users.
+     */
+    void manageUsers();
+
+    /**
+     * @brief Writes the basal metabolic rate, energy expenditure and daily calories of every user to a CSV file.
+     *
+     * @param filename The CSV file.
+     */
+    void exportCalorieTargets(const std::string& filename);
+
+    /**
+     * @brief Writes the daily calories every saved workout plan would burn for every user to a CSV file.
+     *
+     * @param filename The CSV file.
+     */
+    void exportWorkoutBurns(const std::string& filename);
+
     /**
      * @brief Sets the profile information with optional inputs.
      */
@@ -50,6 +84,21 @@ private:
      */
     void resetToCalculatedCalories();
 
+    /**
+     * @brief Lets the user choose the workout plan whose calorie burn replaces the activity level.
+     */
+    void setWorkoutPlan();
+
+    /**
+     * @brief Recomputes the calorie burn of the chosen workout plan for the current weight.
+     */
+    void refreshWorkoutBurn();
+
+    /**
+     * @brief Displays the calorie burn of the chosen workout plan on each day.
+     */
+    void displayWorkoutBurn() const;
+
     /**
      * @brief Prompts the user to select a fitness goal.
      *
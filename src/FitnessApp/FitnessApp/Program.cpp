@@ -0,0 +1,201 @@
+#include "Program.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace
+{
+    /**
+     * @brief Reads the next comma-separated number of a CSV line.
+     * @tparam T The type of the number
+     * @param ss The stringstream to read from
+     * @param value Receives the number
+     * @return true if the field was a number, false otherwise
+     */
+    template<typename T>
+    bool readNumber(std::stringstream& ss, T& value)
+    {
+        std::string field;
+        if (!std::getline(ss, field, ','))
+        {
+            return false;
+        }
+        auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+        return result.ec == std::errc() && result.ptr == field.data() + field.size();
+    }
+
+    /**
+     * @brief Narrows a count to the range of the sets and reps of a plan entry.
+     * @param value The count
+     * @return The count, clamped to 0..65535
+     */
+    std::uint16_t toCount(long value)
+    {
+        return static_cast<std::uint16_t>(std::clamp(value, 0L, 65535L));
+    }
+}
+
+/**
+ * @brief Constructs a new Program object.
+ *
+ * @param name The name of the program.
+ * @param basePlan The workout plan of the first week.
+ * @param progression The rules that progress the base plan.
+ */
+Program::Program(std::string name, WorkoutPlan basePlan, Progression progression)
+    : name(std::move(name)), basePlan(std::move(basePlan)), progression(progression)
+{
+}
+
+/**
+ * @brief Checks whether a week is a deload week.
+ *
+ * A block of a single week has no deload week, as it would never load.
+ *
+ * @param week The week, 0 being the first.
+ * @return true if the week is a deload week, false otherwise.
+ */
+bool Program::isDeloadWeek(int week) const
+{
+    const int blockWeeks = std::max(1, progression.blockWeeks);
+    return progression.deload && blockWeeks > 1 && week % blockWeeks == blockWeeks - 1;
+}
+
+/**
+ * @brief Counts the weeks before a week that are not deload weeks.
+ *
+ * @param week The week, 0 being the first.
+ * @return The number of loading weeks before it.
+ */
+int Program::loadingWeeksBefore(int week) const
+{
+    const int blockWeeks = std::max(1, progression.blockWeeks);
+    const int loadingPerBlock = blockWeeks - (progression.deload && blockWeeks > 1 ? 1 : 0);
+    return week / blockWeeks * loadingPerBlock + std::min(week % blockWeeks, loadingPerBlock);
+}
+
+/**
+ * @brief Gets the planned intensity of a week.
+ *
+ * A deload week keeps Progression::deloadPercent of the intensity of the week before it.
+ *
+ * @param week The week, 0 being the first.
+ * @return The intensity in percent of the one-repetition maximum.
+ */
+float Program::intensity(int week) const
+{
+    if (isDeloadWeek(week))
+    {
+        float loaded = std::min(progression.maxIntensity, progression.startIntensity + (loadingWeeksBefore(week) - 1) * progression.intensityPerWeek);
+        return loaded * progression.deloadPercent / 100.0f;
+    }
+    return std::min(progression.maxIntensity, progression.startIntensity + loadingWeeksBefore(week) * progression.intensityPerWeek);
+}
+
+/**
+ * @brief Materializes the workout plan of a week.
+ *
+ * Every exercise gets the sets of its block and the repetitions of its position in the block.
+ * A deload week goes back to the base repetitions and keeps Progression::deloadPercent of the
+ * sets, but at least one.
+ *
+ * @param week The week, 0 being the first.
+ * @return The workout plan of the week.
+ */
+WorkoutPlan Program::week(int week) const
+{
+    const int blockWeeks = std::max(1, progression.blockWeeks);
+    const int block = week / blockWeeks;
+    const int position = week % blockWeeks;
+    const bool deload = isDeloadWeek(week);
+    const long extraSets = std::min(progression.maxExtraSets, block * progression.setsPerBlock);
+
+    WorkoutPlan plan = basePlan;
+    plan.name = basePlan.name + " - Week " + std::to_string(week + 1);
+    for (auto& day : plan.weeklyPlan)
+    {
+        for (auto& exercise : day.second)
+        {
+            long sets = exercise.sets + extraSets;
+            if (deload)
+            {
+                exercise.sets = toCount(std::max(1L, std::lround(sets * progression.deloadPercent / 100.0)));
+            }
+            else
+            {
+                exercise.sets = toCount(sets);
+                exercise.reps = toCount(exercise.reps + static_cast<long>(position) * progression.repsPerWeek);
+            }
+        }
+    }
+    return plan;
+}
+
+/**
+ * @brief Replaces an exercise in the base plan.
+ *
+ * @param oldId The id of the replaced exercise name.
+ * @param newId The id of the new exercise name.
+ * @return true if the base plan used the exercise, false otherwise.
+ */
+bool Program::replaceExercise(ExerciseId oldId, ExerciseId newId)
+{
+    bool replaced = false;
+    for (auto& day : basePlan.weeklyPlan)
+    {
+        for (auto& exercise : day.second)
+        {
+            if (exercise.exerciseId == oldId)
+            {
+                exercise.exerciseId = newId;
+                replaced = true;
+            }
+        }
+    }
+    return replaced;
+}
+
+/**
+ * @brief Writes the program to a CSV file.
+ *
+ * The line holds the name and the progression rules, followed by the base plan in the format
+ * of the workout plan file.
+ *
+ * @param file The ofstream object to write to.
+ */
+void Program::toCSV(std::ofstream& file) const
+{
+    file << name << "," << progression.weeks << "," << progression.blockWeeks << "," << (progression.deload ? 1 : 0) << ","
+        << progression.repsPerWeek << "," << progression.setsPerBlock << "," << progression.maxExtraSets << ","
+        << progression.startIntensity << "," << progression.intensityPerWeek << "," << progression.maxIntensity << ","
+        << progression.deloadPercent << ",";
+    basePlan.toCSV(file);
+}
+
+/**
+ * @brief Reads a program from a CSV string stream.
+ *
+ * @param ss The stringstream to read from.
+ * @return true if reading was successful, false otherwise.
+ */
+bool Program::fromCSV(std::stringstream& ss)
+{
+    int deload = 0;
+    if (std::getline(ss, name, ',')
+        && readNumber(ss, progression.weeks)
+        && readNumber(ss, progression.blockWeeks)
+        && readNumber(ss, deload)
+        && readNumber(ss, progression.repsPerWeek)
+        && readNumber(ss, progression.setsPerBlock)
+        && readNumber(ss, progression.maxExtraSets)
+        && readNumber(ss, progression.startIntensity)
+        && readNumber(ss, progression.intensityPerWeek)
+        && readNumber(ss, progression.maxIntensity)
+        && readNumber(ss, progression.deloadPercent)
+        && basePlan.fromCSV(ss))
+    {
+        progression.deload = deload != 0;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,110 @@
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "WorkoutPlan.h"
+
+/**
+ * @class Program
+ * @brief A multi-week training program: a base workout plan and the rules that progress it.
+ *
+ * The program is split into blocks of Progression::blockWeeks weeks. Within a block the
+ * repetitions and the intensity rise from week to week; every new block adds sets and starts
+ * the repetitions over, and the last week of a block can be a deload week with fewer sets and
+ * a lower intensity.
+ *
+ * Only the base plan and the rules are stored. A week is materialized from them when it is
+ * asked for, so a program costs the memory of one week however many weeks it has.
+ */
+class Program
+{
+public:
+    /**
+     * @struct Progression
+     * @brief Rules that turn the base plan into the weeks of the program.
+     */
+    struct Progression
+    {
+        int weeks = 12;                 ///< Number of weeks of the program
+        int blockWeeks = 4;             ///< Weeks per block
+        bool deload = true;             ///< Whether the last week of every block is a deload week
+        int repsPerWeek = 1;            ///< Repetitions added in every week of a block after its first
+        int setsPerBlock = 1;           ///< Sets added to every exercise in every block after the first
+        int maxExtraSets = 3;           ///< Most sets added to an exercise over the whole program
+        float startIntensity = 70.0f;   ///< Intensity of the first week, in percent of the one-repetition maximum
+        float intensityPerWeek = 1.5f;  ///< Intensity added with every week that is not a deload week
+        float maxIntensity = 90.0f;     ///< Highest intensity, in percent of the one-repetition maximum
+        int deloadPercent = 60;         ///< Share of the sets and the intensity kept in a deload week, in percent
+    };
+
+    /**
+     * @brief Default constructor.
+     */
+    Program() = default;
+
+    /**
+     * @brief Constructs a new Program object.
+     * @param name The name of the program
+     * @param basePlan The workout plan of the first week
+     * @param progression The rules that progress the base plan
+     */
+    Program(std::string name, WorkoutPlan basePlan, Progression progression);
+
+    std::string name;         ///< The name of the program
+    WorkoutPlan basePlan;     ///< The workout plan of the first week
+    Progression progression;  ///< The rules that progress the base plan
+
+    /**
+     * @brief Checks whether a week is a deload week.
+     * @param week The week, 0 being the first
+     * @return true if the week is a deload week, false otherwise
+     */
+    bool isDeloadWeek(int week) const;
+
+    /**
+     * @brief Gets the planned intensity of a week.
+     * @param week The week, 0 being the first
+     * @return The intensity in percent of the one-repetition maximum
+     */
+    float intensity(int week) const;
+
+    /**
+     * @brief Materializes the workout plan of a week.
+     * @param week The week, 0 being the first
+     * @return The workout plan of the week
+     */
+    WorkoutPlan week(int week) const;
+
+    /**
+     * @brief Replaces an exercise in the base plan.
+     * @param oldId The id of the replaced exercise name
+     * @param newId The id of the new exercise name
+     * @return true if the base plan used the exercise, false otherwise
+     */
+    bool replaceExercise(ExerciseId oldId, ExerciseId newId);
+
+    /**
+     * @brief Writes the program to a CSV file.
+     * @param file The ofstream object to write to
+     */
+    void toCSV(std::ofstream& file) const;
+
+    /**
+     * @brief Reads a program from a CSV string stream.
+     * @param ss The stringstream to read from
+     * @return true if reading was successful, false otherwise
+     */
+    bool fromCSV(std::stringstream& ss);
+
+private:
+    /**
+     * @brief Counts the weeks before a week that are not deload weeks.
+     * @param week The week, 0 being the first
+     * @return The number of loading weeks before it
+     */
+    int loadingWeeksBefore(int week) const;
+};
+
+#endif // PROGRAM_H
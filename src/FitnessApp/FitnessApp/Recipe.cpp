@@ -0,0 +1,65 @@
+#include "Recipe.h"
+#include <cstdlib>
+
+/**
+ * @brief Gets the total weight of the ingredients.
+ * @return The weight in grams.
+ */
+float Recipe::totalGrams() const
+{
+    float total = 0;
+    for (const auto& ingredient : ingredients)
+    {
+        total += ingredient.second;
+    }
+    return total;
+}
+
+/**
+ * @brief Serializes the recipe to a CSV stream.
+ *
+ * @param os Output stream to write to.
+ */
+void Recipe::toCSV(std::ostream& os) const
+{
+    os << name;
+    for (const auto& ingredient : ingredients)
+    {
+        os << "," << ingredient.first << "=" << ingredient.second;
+    }
+    os << "\n";
+}
+
+/**
+ * @brief Parses a recipe from a CSV stream.
+ *
+ * @param is Input stream to read from.
+ * @return True if parsing was successful, false otherwise.
+ */
+bool Recipe::fromCSV(std::istream& is)
+{
+    if (!std::getline(is, name, ',') || name.empty())
+    {
+        return false;
+    }
+
+    std::string field;
+    while (std::getline(is, field, ','))
+    {
+        size_t separator = field.rfind('=');
+        if (separator == std::string::npos || separator == 0)
+        {
+            return false;
+        }
+
+        const char* begin = field.c_str() + separator + 1;
+        char* end = nullptr;
+        float grams = std::strtof(begin, &end);
+        if (end == begin || grams <= 0)
+        {
+            return false;
+        }
+        ingredients.emplace_back(field.substr(0, separator), grams);
+    }
+    return !ingredients.empty();
+}
@@ -0,0 +1,49 @@
+#ifndef RECIPE_H
+#define RECIPE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+/**
+ * @brief A composite food made of weighted ingredients, which may be recipes themselves.
+ *
+ * The recipe only stores its ingredients; its nutritional values are derived by RecipeBook
+ * and kept in the food item of the same name.
+ */
+class Recipe
+{
+public:
+    std::string name; ///< Name of the recipe, equal to the name of its food item.
+    std::vector<std::pair<std::string, float>> ingredients; ///< Ingredient food names and their amounts in grams.
+
+    /**
+     * @brief Default constructor.
+     */
+    Recipe() = default;
+
+    /**
+     * @brief Gets the total weight of the ingredients.
+     * @return The weight in grams.
+     */
+    float totalGrams() const;
+
+    /**
+     * @brief Serializes the recipe to a CSV stream.
+     *
+     * The name is followed by one "ingredient=grams" column per ingredient.
+     *
+     * @param os Output stream to write to.
+     */
+    void toCSV(std::ostream& os) const;
+
+    /**
+     * @brief Parses a recipe from a CSV stream.
+     * @param is Input stream to read from.
+     * @return True if parsing was successful, false otherwise.
+     */
+    bool fromCSV(std::istream& is);
+};
+
+#endif // RECIPE_H
@@ -0,0 +1,375 @@
+#include "RecipeBook.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    /**
+     * @brief Checks whether two values differ by more than CSV rounding.
+     * @param a The first value.
+     * @param b The second value.
+     * @return True if the values differ.
+     */
+    bool differs(float a, float b)
+    {
+        return std::abs(a - b) > 1e-4f * std::max(1.0f, std::abs(b));
+    }
+}
+
+/**
+ * @brief Loads the recipes from a CSV file.
+ * @param file The file containing the recipes.
+ */
+RecipeBook::RecipeBook(const std::string& file) : filename(file)
+{
+    std::ifstream stream(filename);
+    if (stream.is_open())
+    {
+        stream.close();
+        recipes = readFromCSV<Recipe>(filename);
+    }
+    indexIngredients();
+}
+
+/**
+ * @brief Checks whether a food is a recipe.
+ * @param name The food name.
+ * @return True if the food is a recipe.
+ */
+bool RecipeBook::isRecipe(const std::string& name) const
+{
+    return recipes.count(name) > 0;
+}
+
+/**
+ * @brief Gets a recipe.
+ * @param name The recipe name.
+ * @return The recipe, or nullptr if there is none of that name.
+ */
+const Recipe* RecipeBook::find(const std::string& name) const
+{
+    auto it = recipes.find(name);
+    return it != recipes.end() ? &it->second : nullptr;
+}
+
+/**
+ * @brief Checks a recipe before it is stored.
+ *
+ * A recipe contains itself if its name is one of its ingredients or a dependent of one of
+ * them, which would make the roll-up recurse forever.
+ *
+ * @param recipe The recipe to check.
+ * @param foodItemMap The food items the ingredients refer to.
+ * @param error Receives the reason if the recipe is rejected.
+ * @return True if every ingredient exists and the recipe does not contain itself.
+ */
+bool RecipeBook::validate(const Recipe& recipe, const std::map<std::string, FoodItem>& foodItemMap, std::string& error) const
+{
+    if (recipe.ingredients.empty())
+    {
+        error = "A recipe needs at least one ingredient.";
+        return false;
+    }
+
+    std::set<std::string> dependents = dependentsOf(recipe.name);
+    for (const auto& ingredient : recipe.ingredients)
+    {
+        if (ingredient.first == recipe.name || dependents.count(ingredient.first) > 0)
+        {
+            error = "'" + ingredient.first + "' already contains '" + recipe.name + "'.";
+            return false;
+        }
+        if (foodItemMap.count(ingredient.first) == 0 && !isRecipe(ingredient.first))
+        {
+            error = "Unknown food item '" + ingredient.first + "'.";
+            return false;
+        }
+        if (ingredient.second <= 0)
+        {
+            error = "Ingredient amounts must be positive.";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Adds or replaces a recipe and writes the recipe file.
+ * @param recipe The recipe.
+ */
+void RecipeBook::setRecipe(const Recipe& recipe)
+{
+    invalidate(recipe.name);
+    recipes[recipe.name] = recipe;
+    indexIngredients();
+    save();
+}
+
+/**
+ * @brief Removes a recipe and writes the recipe file.
+ *
+ * Recipes using it keep their last values, as its food item may still exist.
+ *
+ * @param name The recipe name.
+ */
+void RecipeBook::removeRecipe(const std::string& name)
+{
+    if (recipes.erase(name) == 0)
+    {
+        return;
+    }
+    memo.erase(name);
+    indexIngredients();
+    save();
+}
+
+/**
+ * @brief Replaces a food name in all ingredient lists and writes the recipe file.
+ * @param oldName The previous food name.
+ * @param newName The new food name.
+ */
+void RecipeBook::renameFood(const std::string& oldName, const std::string& newName)
+{
+    if (oldName == newName)
+    {
+        return;
+    }
+
+    bool changed = false;
+    auto recipeIt = recipes.find(oldName);
+    if (recipeIt != recipes.end())
+    {
+        Recipe recipe = recipeIt->second;
+        recipe.name = newName;
+        recipes.erase(recipeIt);
+        recipes[newName] = recipe;
+        memo.erase(oldName);
+        changed = true;
+    }
+
+    auto usedIt = usedBy.find(oldName);
+    if (usedIt != usedBy.end())
+    {
+        for (const auto& user : usedIt->second)
+        {
+            for (auto& ingredient : recipes[user == oldName ? newName : user].ingredients)
+            {
+                if (ingredient.first == oldName)
+                {
+                    ingredient.first = newName;
+                }
+            }
+        }
+        changed = true;
+    }
+
+    if (changed)
+    {
+        indexIngredients();
+        save();
+    }
+}
+
+/**
+ * @brief Gets the recipes that use a food, directly or through other recipes.
+ * @param name The food name.
+ * @return The names of the dependent recipes.
+ */
+std::set<std::string> RecipeBook::dependentsOf(const std::string& name) const
+{
+    std::set<std::string> dependents;
+    std::vector<std::string> pending = { name };
+    while (!pending.empty())
+    {
+        std::string current = pending.back();
+        pending.pop_back();
+
+        auto it = usedBy.find(current);
+        if (it == usedBy.end())
+        {
+            continue;
+        }
+        for (const auto& user : it->second)
+        {
+            if (dependents.insert(user).second)
+            {
+                pending.push_back(user);
+            }
+        }
+    }
+    return dependents;
+}
+
+/**
+ * @brief Drops the memoized values of every recipe that depends on a food.
+ * @param name The food whose values changed; if it is a recipe, its own values are dropped as well.
+ * @return The number of recipes invalidated.
+ */
+size_t RecipeBook::invalidate(const std::string& name)
+{
+    size_t count = memo.erase(name);
+    for (const auto& dependent : dependentsOf(name))
+    {
+        count += memo.erase(dependent);
+    }
+    return count;
+}
+
+/**
+ * @brief Writes the derived values of all recipes into their food items.
+ * @param foodItemMap The food items, updated in place.
+ * @return The names of the recipes whose food item changed.
+ */
+std::vector<std::string> RecipeBook::refresh(std::map<std::string, FoodItem>& foodItemMap)
+{
+    std::vector<std::string> changed;
+    for (const auto& pair : recipes)
+    {
+        const Recipe& recipe = pair.second;
+        Composition composition;
+        if (!rollUp(recipe.name, foodItemMap, composition))
+        {
+            std::cerr << "Recipe '" << recipe.name << "' uses a missing food item, keeping its last values." << std::endl;
+            continue;
+        }
+
+        auto it = foodItemMap.find(recipe.name);
+        bool created = it == foodItemMap.end();
+        if (created)
+        {
+            FoodItem foodItem;
+            foodItem.name = recipe.name;
+            foodItem.portion = recipe.totalGrams();
+            it = foodItemMap.emplace(recipe.name, foodItem).first;
+        }
+
+        std::set<std::string> categories = composition.categories;
+        categories.insert("recipe");
+
+        FoodItem& foodItem = it->second;
+        bool modified = created || foodItem.categories != categories
+            || foodItem.calories != std::lround(composition.calories) || differs(foodItem.protein, composition.protein)
+            || differs(foodItem.carbohydrates, composition.carbohydrates) || differs(foodItem.fats, composition.fats)
+            || foodItem.nutrients.size() != composition.nutrients.size();
+        for (const auto& nutrient : composition.nutrients)
+        {
+            auto nutrientIt = foodItem.nutrients.find(nutrient.first);
+            modified = modified || nutrientIt == foodItem.nutrients.end() || differs(nutrientIt->second, nutrient.second);
+        }
+        if (!modified)
+        {
+            continue;
+        }
+
+        foodItem.calories = static_cast<int>(std::lround(composition.calories));
+        foodItem.protein = composition.protein;
+        foodItem.carbohydrates = composition.carbohydrates;
+        foodItem.fats = composition.fats;
+        foodItem.nutrients = composition.nutrients;
+        foodItem.categories = categories;
+        changed.push_back(recipe.name);
+    }
+    return changed;
+}
+
+/**
+ * @brief Gets the memoized composition of a recipe, computing it and its sub-recipes if needed.
+ *
+ * Ingredients that are recipes are rolled up first, so every recipe is computed at most once
+ * per invalidation no matter how many recipes share it.
+ *
+ * @param name The recipe name.
+ * @param foodItemMap The food items the ingredients refer to.
+ * @param composition Receives the composition.
+ * @return False if an ingredient is missing.
+ */
+bool RecipeBook::rollUp(const std::string& name, const std::map<std::string, FoodItem>& foodItemMap, Composition& composition)
+{
+    auto memoIt = memo.find(name);
+    if (memoIt != memo.end())
+    {
+        composition = memoIt->second;
+        return true;
+    }
+
+    const Recipe& recipe = recipes.at(name);
+    Composition total;
+    for (const auto& ingredient : recipe.ingredients)
+    {
+        // Values are given per 100 grams
+        float factor = ingredient.second / 100;
+        if (isRecipe(ingredient.first))
+        {
+            Composition part;
+            if (!rollUp(ingredient.first, foodItemMap, part))
+            {
+                return false;
+            }
+            total.calories += part.calories * factor;
+            total.protein += part.protein * factor;
+            total.carbohydrates += part.carbohydrates * factor;
+            total.fats += part.fats * factor;
+            for (const auto& nutrient : part.nutrients)
+            {
+                total.nutrients[nutrient.first] += nutrient.second * factor;
+            }
+            total.categories.insert(part.categories.begin(), part.categories.end());
+            continue;
+        }
+
+        auto foodIt = foodItemMap.find(ingredient.first);
+        if (foodIt == foodItemMap.end())
+        {
+            return false;
+        }
+        const FoodItem& foodItem = foodIt->second;
+        total.calories += foodItem.calories * factor;
+        total.protein += foodItem.protein * factor;
+        total.carbohydrates += foodItem.carbohydrates * factor;
+        total.fats += foodItem.fats * factor;
+        for (const auto& nutrient : foodItem.nutrients)
+        {
+            total.nutrients[nutrient.first] += nutrient.second * factor;
+        }
+        total.categories.insert(foodItem.categories.begin(), foodItem.categories.end());
+    }
+
+    // Scale the totals of the whole recipe to 100 grams
+    float scale = 100 / recipe.totalGrams();
+    total.calories *= scale;
+    total.protein *= scale;
+    total.carbohydrates *= scale;
+    total.fats *= scale;
+    for (auto& nutrient : total.nutrients)
+    {
+        nutrient.second *= scale;
+    }
+
+    memo[name] = total;
+    composition = total;
+    return true;
+}
+
+/**
+ * @brief Rebuilds the reverse edges from the ingredient lists.
+ */
+void RecipeBook::indexIngredients()
+{
+    usedBy.clear();
+    for (const auto& pair : recipes)
+    {
+        for (const auto& ingredient : pair.second.ingredients)
+        {
+            usedBy[ingredient.first].insert(pair.first);
+        }
+    }
+}
+
+/**
+ * @brief Writes all recipes to the recipe file.
+ */
+void RecipeBook::save() const
+{
+    overwriteCSV(filename, recipes);
+}
@@ -0,0 +1,142 @@
+#ifndef RECIPE_BOOK_H
+#define RECIPE_BOOK_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "FoodItem.h"
+#include "Recipe.h"
+
+/**
+ * @brief Stores the recipes and derives their nutritional values from their ingredients.
+ *
+ * Recipes may use other recipes as ingredients, so together they form a DAG with the plain
+ * food items as leaves. The per-100-gram composition of every recipe is memoized; when a food
+ * changes, only the recipes reachable from it through the reverse edges are invalidated and
+ * recomputed, while all other recipes keep their memoized values.
+ *
+ * Every recipe also has a food item of the same name, which holds the derived values so that
+ * plans, generation and the food lists treat recipes like any other food.
+ */
+class RecipeBook
+{
+public:
+    /**
+     * @brief Loads the recipes from a CSV file.
+     * @param file The file containing the recipes.
+     */
+    explicit RecipeBook(const std::string& file);
+
+    /**
+     * @brief Checks whether a food is a recipe.
+     * @param name The food name.
+     * @return True if the food is a recipe.
+     */
+    bool isRecipe(const std::string& name) const;
+
+    /**
+     * @brief Gets a recipe.
+     * @param name The recipe name.
+     * @return The recipe, or nullptr if there is none of that name.
+     */
+    const Recipe* find(const std::string& name) const;
+
+    /**
+     * @brief Checks a recipe before it is stored.
+     * @param recipe The recipe to check.
+     * @param foodItemMap The food items the ingredients refer to.
+     * @param error Receives the reason if the recipe is rejected.
+     * @return True if every ingredient exists and the recipe does not contain itself.
+     */
+    bool validate(const Recipe& recipe, const std::map<std::string, FoodItem>& foodItemMap, std::string& error) const;
+
+    /**
+     * @brief Adds or replaces a recipe and writes the recipe file.
+     *
+     * The recipe must have passed validate().
+     *
+     * @param recipe The recipe.
+     */
+    void setRecipe(const Recipe& recipe);
+
+    /**
+     * @brief Removes a recipe and writes the recipe file.
+     * @param name The recipe name.
+     */
+    void removeRecipe(const std::string& name);
+
+    /**
+     * @brief Replaces a food name in all ingredient lists and writes the recipe file.
+     * @param oldName The previous food name.
+     * @param newName The new food name.
+     */
+    void renameFood(const std::string& oldName, const std::string& newName);
+
+    /**
+     * @brief Gets the recipes that use a food, directly or through other recipes.
+     * @param name The food name.
+     * @return The names of the dependent recipes.
+     */
+    std::set<std::string> dependentsOf(const std::string& name) const;
+
+    /**
+     * @brief Drops the memoized values of every recipe that depends on a food.
+     * @param name The food whose values changed; if it is a recipe, its own values are dropped as well.
+     * @return The number of recipes invalidated.
+     */
+    size_t invalidate(const std::string& name);
+
+    /**
+     * @brief Writes the derived values of all recipes into their food items.
+     *
+     * Recipes with memoized values are copied; only invalidated recipes are recomputed. Food
+     * items are created for recipes that have none, and keep their portion size otherwise.
+     * Their categories are "recipe" and the categories of all ingredients, so excluding a
+     * category also excludes every recipe containing a food of it.
+     *
+     * @param foodItemMap The food items, updated in place.
+     * @return The names of the recipes whose food item changed.
+     */
+    std::vector<std::string> refresh(std::map<std::string, FoodItem>& foodItemMap);
+
+private:
+    /**
+     * @brief Composition of a recipe per 100 grams.
+     */
+    struct Composition
+    {
+        float calories = 0; ///< Calories per 100 grams.
+        float protein = 0; ///< Protein per 100 grams.
+        float carbohydrates = 0; ///< Carbohydrates per 100 grams.
+        float fats = 0; ///< Fats per 100 grams.
+        std::map<std::string, float> nutrients; ///< Further nutrients per 100 grams.
+        std::set<std::string> categories; ///< Categories of all ingredients, through sub-recipes.
+    };
+
+    /**
+     * @brief Gets the memoized composition of a recipe, computing it and its sub-recipes if needed.
+     * @param name The recipe name.
+     * @param foodItemMap The food items the ingredients refer to.
+     * @param composition Receives the composition.
+     * @return False if an ingredient is missing.
+     */
+    bool rollUp(const std::string& name, const std::map<std::string, FoodItem>& foodItemMap, Composition& composition);
+
+    /**
+     * @brief Rebuilds the reverse edges from the ingredient lists.
+     */
+    void indexIngredients();
+
+    /**
+     * @brief Writes all recipes to the recipe file.
+     */
+    void save() const;
+
+    std::string filename; ///< The file containing the recipes.
+    std::map<std::string, Recipe> recipes; ///< Recipes by name.
+    std::map<std::string, std::set<std::string>> usedBy; ///< Food name to the recipes using it directly.
+    std::map<std::string, Composition> memo; ///< Composition of the recipes computed since their last invalidation.
+};
+
+#endif // RECIPE_BOOK_H
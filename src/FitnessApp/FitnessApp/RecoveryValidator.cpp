@@ -0,0 +1,254 @@
+#include "RecoveryValidator.h"
+#include "Utils.h"
+#include <algorithm>
+#include <set>
+
+/**
+ * @brief Constructs a validator with the given limits.
+ * @param settings The limits of a session.
+ */
+RecoveryValidator::RecoveryValidator(Settings settings) : settings(settings)
+{
+}
+
+/**
+ * @brief Sets the exercises the plan entries refer to.
+ *
+ * Every muscle group of the exercise list gets a bit, and the muscle groups of every exercise
+ * are resolved once, into a table indexed by ExerciseId. Exercises of an unknown muscle group
+ * train none; full body exercises train every group of Settings::fullBodyMuscles.
+ *
+ * @param exerciseMap The exercises by name.
+ */
+void RecoveryValidator::setExercises(const std::map<std::string, Exercise>& exerciseMap)
+{
+    const std::string fullBody = toLower(settings.fullBodyGroup);
+
+    std::set<std::string> groups(settings.fullBodyMuscles.begin(), settings.fullBodyMuscles.end());
+    for (const auto& pair : exerciseMap)
+    {
+        std::string group = toLower(pair.second.muscleGroup);
+        if (group != fullBody && group != "unknown" && !group.empty())
+        {
+            groups.insert(group);
+        }
+    }
+    muscleGroups.assign(groups.begin(), groups.end());
+    if (muscleGroups.size() > 64)
+    {
+        muscleGroups.resize(64);
+    }
+
+    largeMask = maskOf(settings.largeGroups);
+    recoveryMask = ~maskOf(settings.quickRecoveryGroups);
+    const MuscleMask fullBodyMask = maskOf(settings.fullBodyMuscles);
+
+    musclesById.clear();
+    for (const auto& pair : exerciseMap)
+    {
+        ExerciseId id = ExerciseIdTable::intern(pair.first);
+        if (id >= musclesById.size())
+        {
+            musclesById.resize(id + 1, 0);
+        }
+        std::string group = toLower(pair.second.muscleGroup);
+        musclesById[id] = group == fullBody ? fullBodyMask : maskOf({ group });
+    }
+}
+
+/**
+ * @brief Gets the muscle groups the bits of a MuscleMask stand for.
+ * @return The muscle groups, sorted by name.
+ */
+const std::vector<std::string>& RecoveryValidator::getMuscleGroups() const
+{
+    return muscleGroups;
+}
+
+/**
+ * @brief Checks a plan.
+ *
+ * Every day is combined once; the checks are then a few bitwise operations per day.
+ *
+ * @param plan The workout plan.
+ * @return The conflicts, by day.
+ */
+std::vector<RecoveryValidator::Conflict> RecoveryValidator::validate(const WorkoutPlan& plan) const
+{
+    std::array<Session, DAY_COUNT> sessions;
+    for (size_t day = 0; day < DAY_COUNT; ++day)
+    {
+        sessions[day] = session(plan.weeklyPlan, day);
+    }
+
+    std::vector<Conflict> conflicts;
+    for (size_t day = 0; day < DAY_COUNT; ++day)
+    {
+        checkSession(day, sessions[day], conflicts);
+        checkConsecutive(day, sessions[day], sessions[(day + 1) % DAY_COUNT], conflicts);
+    }
+    return conflicts;
+}
+
+/**
+ * @brief Checks one day of a plan that is being edited.
+ * @param day The day, Monday being 0.
+ * @param exercises The exercises of the day.
+ * @param weeklyPlan The plan the day belongs to; only the days before and after it are read.
+ * @return The conflicts involving the day.
+ */
+std::vector<RecoveryValidator::Conflict> RecoveryValidator::validateDay(size_t day, const std::vector<WorkoutPlan::ExerciseDetails>& exercises,
+    const std::map<std::string, std::vector<WorkoutPlan::ExerciseDetails>>& weeklyPlan) const
+{
+    const size_t previousDay = (day + DAY_COUNT - 1) % DAY_COUNT;
+    const size_t nextDay = (day + 1) % DAY_COUNT;
+    Session current = session(exercises);
+
+    std::vector<Conflict> conflicts;
+    checkConsecutive(previousDay, session(weeklyPlan, previousDay), current, conflicts);
+    checkSession(day, current, conflicts);
+    checkConsecutive(day, current, session(weeklyPlan, nextDay), conflicts);
+    return conflicts;
+}
+
+/**
+ * @brief Describes a conflict in one line.
+ * @param conflict The conflict.
+ * @return The description.
+ */
+std::string RecoveryValidator::describe(const Conflict& conflict) const
+{
+    const std::string& day = DAYS_OF_WEEK[conflict.day];
+    if (conflict.kind == Conflict::Kind::CONSECUTIVE_DAYS)
+    {
+        return day + " and " + DAYS_OF_WEEK[(conflict.day + 1) % DAY_COUNT] + " both train " + describeMuscles(conflict.muscles);
+    }
+    return day + " has " + std::to_string(conflict.heavyEntries) + " heavy compound exercises (at most "
+        + std::to_string(settings.maxHeavyPerSession) + ") for " + describeMuscles(conflict.muscles);
+}
+
+/**
+ * @brief Prints the conflicts of every plan that has any.
+ * @param os The stream to print to.
+ * @param plans The workout plans by name.
+ */
+void RecoveryValidator::printReport(std::ostream& os, const std::map<std::string, WorkoutPlan>& plans) const
+{
+    size_t flaggedPlans = 0;
+    for (const auto& pair : plans)
+    {
+        auto conflicts = validate(pair.second);
+        if (conflicts.empty())
+        {
+            continue;
+        }
+        ++flaggedPlans;
+        os << pair.first << ":\n";
+        for (const auto& conflict : conflicts)
+        {
+            os << "  " << describe(conflict) << "\n";
+        }
+    }
+    os << flaggedPlans << " of " << plans.size() << " workout plan(s) have recovery conflicts.\n";
+}
+
+/**
+ * @brief Combines the entries of a session.
+ * @param exercises The exercises of the session.
+ * @return The session.
+ */
+RecoveryValidator::Session RecoveryValidator::session(const std::vector<WorkoutPlan::ExerciseDetails>& exercises) const
+{
+    Session result;
+    for (const auto& exercise : exercises)
+    {
+        MuscleMask muscles = exercise.exerciseId < musclesById.size() ? musclesById[exercise.exerciseId] : 0;
+        result.muscles |= muscles;
+        if ((muscles & largeMask) != 0 && exercise.reps <= settings.heavyMaxReps)
+        {
+            result.heavyMuscles |= muscles;
+            ++result.heavyEntries;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Combines the entries of a day of a plan.
+ * @param weeklyPlan The plan.
+ * @param day The day, Monday being 0.
+ * @return The session, empty if the plan has no such day.
+ */
+RecoveryValidator::Session RecoveryValidator::session(const std::map<std::string, std::vector<WorkoutPlan::ExerciseDetails>>& weeklyPlan, size_t day) const
+{
+    auto it = weeklyPlan.find(DAYS_OF_WEEK[day]);
+    return it != weeklyPlan.end() ? session(it->second) : Session();
+}
+
+/**
+ * @brief Adds the conflict of a session with too many heavy entries.
+ * @param day The day, Monday being 0.
+ * @param current The session.
+ * @param conflicts Receives the conflict, if any.
+ */
+void RecoveryValidator::checkSession(size_t day, const Session& current, std::vector<Conflict>& conflicts) const
+{
+    if (current.heavyEntries > settings.maxHeavyPerSession)
+    {
+        conflicts.push_back({ Conflict::Kind::HEAVY_SESSION, day, current.heavyMuscles, current.heavyEntries });
+    }
+}
+
+/**
+ * @brief Adds the conflict of two consecutive sessions training the same muscle groups.
+ * @param day The first day, Monday being 0.
+ * @param first The session of the first day.
+ * @param second The session of the day after it.
+ * @param conflicts Receives the conflict, if any.
+ */
+void RecoveryValidator::checkConsecutive(size_t day, const Session& first, const Session& second, std::vector<Conflict>& conflicts) const
+{
+    MuscleMask overlap = first.muscles & second.muscles & recoveryMask;
+    if (overlap != 0)
+    {
+        conflicts.push_back({ Conflict::Kind::CONSECUTIVE_DAYS, day, overlap, 0 });
+    }
+}
+
+/**
+ * @brief Lists the muscle groups of a mask.
+ * @param muscles The mask.
+ * @return The muscle groups, separated by commas.
+ */
+std::string RecoveryValidator::describeMuscles(MuscleMask muscles) const
+{
+    std::string text;
+    for (size_t bit = 0; bit < muscleGroups.size(); ++bit)
+    {
+        if ((muscles >> bit) & 1)
+        {
+            text += text.empty() ? "" : ", ";
+            text += muscleGroups[bit];
+        }
+    }
+    return text;
+}
+
+/**
+ * @brief Gets the bits of some muscle groups.
+ * @param groups The muscle groups; unknown groups are ignored.
+ * @return The mask.
+ */
+RecoveryValidator::MuscleMask RecoveryValidator::maskOf(const std::vector<std::string>& groups) const
+{
+    MuscleMask mask = 0;
+    for (const auto& group : groups)
+    {
+        auto it = std::lower_bound(muscleGroups.begin(), muscleGroups.end(), toLower(group));
+        if (it != muscleGroups.end() && *it == toLower(group))
+        {
+            mask |= MuscleMask(1) << (it - muscleGroups.begin());
+        }
+    }
+    return mask;
+}
@@ -0,0 +1,183 @@
+#ifndef RECOVERY_VALIDATOR_H
+#define RECOVERY_VALIDATOR_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Exercise.h"
+#include "WorkoutPlan.h"
+
+/**
+ * @brief Checks workout plans for sessions that leave too little recovery.
+ *
+ * Every exercise is reduced to a bitmask of the muscle groups it trains, one bit per group, so
+ * the muscles of a day are the OR of its entries and the muscles trained on two consecutive
+ * days are the AND of their masks. Two conflicts are reported:
+ * - a muscle group trained on two consecutive days, Sunday to Monday included, since a plan
+ *   repeats every week;
+ * - a session with more heavy compound entries than allowed, an entry being heavy when it
+ *   trains a large muscle group with few reps.
+ */
+class RecoveryValidator
+{
+public:
+    /**
+     * @brief Number of days of a plan, Monday first.
+     */
+    static const size_t DAY_COUNT = 7;
+
+    /**
+     * @brief Muscle groups as bits, in the order of getMuscleGroups(); at most 64 groups are told apart.
+     */
+    using MuscleMask = std::uint64_t;
+
+    /**
+     * @brief Limits of a session and the muscle groups they apply to.
+     */
+    struct Settings
+    {
+        int maxHeavyPerSession = 3; ///< Largest number of heavy compound entries in one session.
+        int heavyMaxReps = 6; ///< Entries with at most this many reps are heavy, if they train a large muscle group.
+        std::vector<std::string> largeGroups = { "back", "chest", "legs" }; ///< Muscle groups whose heavy work is taxing.
+        std::string fullBodyGroup = "full body"; ///< Muscle group of exercises that train every group of fullBodyMuscles.
+        std::vector<std::string> fullBodyMuscles = { "back", "chest", "legs", "shoulders" }; ///< Muscle groups a full body exercise trains.
+        std::vector<std::string> quickRecoveryGroups = { "core" }; ///< Muscle groups that may be trained on consecutive days.
+    };
+
+    /**
+     * @brief A recovery problem of a plan.
+     */
+    struct Conflict
+    {
+        /**
+         * @brief Kind of recovery problem.
+         */
+        enum class Kind
+        {
+            CONSECUTIVE_DAYS, ///< Muscle groups trained on day and the day after it.
+            HEAVY_SESSION ///< Too many heavy compound entries on day.
+        };
+
+        Kind kind; ///< The kind of problem.
+        size_t day; ///< The day, Monday being 0; the first of the two days for CONSECUTIVE_DAYS.
+        MuscleMask muscles; ///< The muscle groups trained on both days, or worked by the heavy entries.
+        int heavyEntries; ///< The number of heavy compound entries, for HEAVY_SESSION.
+    };
+
+    /**
+     * @brief Constructs a validator with the given limits.
+     * @param settings The limits of a session.
+     */
+    explicit RecoveryValidator(Settings settings);
+
+    /**
+     * @brief Sets the exercises the plan entries refer to.
+     * @param exerciseMap The exercises by name.
+     */
+    void setExercises(const std::map<std::string, Exercise>& exerciseMap);
+
+    /**
+     * @brief Gets the muscle groups the bits of a MuscleMask stand for.
+     * @return The muscle groups, sorted by name.
+     */
+    const std::vector<std::string>& getMuscleGroups() const;
+
+    /**
+     * @brief Checks a plan.
+     * @param plan The workout plan.
+     * @return The conflicts, by day.
+     */
+    std::vector<Conflict> validate(const WorkoutPlan& plan) const;
+
+    /**
+     * @brief Checks one day of a plan that is being edited.
+     * @param day The day, Monday being 0.
+     * @param exercises The exercises of the day.
+     * @param weeklyPlan The plan the day belongs to; only the days before and after it are read.
+     * @return The conflicts involving the day.
+     */
+    std::vector<Conflict> validateDay(size_t day, const std::vector<WorkoutPlan::ExerciseDetails>& exercises,
+        const std::map<std::string, std::vector<WorkoutPlan::ExerciseDetails>>& weeklyPlan) const;
+
+    /**
+     * @brief Describes a conflict in one line.
+     * @param conflict The conflict.
+     * @return The description.
+     */
+    std::string describe(const Conflict& conflict) const;
+
+    /**
+     * @brief Prints the conflicts of every plan that has any.
+     * @param os The stream to print to.
+     * @param plans The workout plans by name.
+     */
+    void printReport(std::ostream& os, const std::map<std::string, WorkoutPlan>& plans) const;
+
+private:
+    /**
+     * @brief Muscles and heavy entries of one session.
+     */
+    struct Session
+    {
+        MuscleMask muscles = 0; ///< Muscle groups trained.
+        MuscleMask heavyMuscles = 0; ///< Muscle groups worked by heavy entries.
+        int heavyEntries = 0; ///< Number of heavy compound entries.
+    };
+
+    /**
+     * @brief Combines the entries of a session.
+     * @param exercises The exercises of the session.
+     * @return The session.
+     */
+    Session session(const std::vector<WorkoutPlan::ExerciseDetails>& exercises) const;
+
+    /**
+     * @brief Combines the entries of a day of a plan.
+     * @param weeklyPlan The plan.
+     * @param day The day, Monday being 0.
+     * @return The session, empty if the plan has no such day.
+     */
+    Session session(const std::map<std::string, std::vector<WorkoutPlan::ExerciseDetails>>& weeklyPlan, size_t day) const;
+
+    /**
+     * @brief Adds the conflict of a session with too many heavy entries.
+     * @param day The day, Monday being 0.
+     * @param current The session.
+     * @param conflicts Receives the conflict, if any.
+     */
+    void checkSession(size_t day, const Session& current, std::vector<Conflict>& conflicts) const;
+
+    /**
+     * @brief Adds the conflict of two consecutive sessions training the same muscle groups.
+     * @param day The first day, Monday being 0.
+     * @param first The session of the first day.
+     * @param second The session of the day after it.
+     * @param conflicts Receives the conflict, if any.
+     */
+    void checkConsecutive(size_t day, const Session& first, const Session& second, std::vector<Conflict>& conflicts) const;
+
+    /**
+     * @brief Lists the muscle groups of a mask.
+     * @param muscles The mask.
+     * @return The muscle groups, separated by commas.
+     */
+    std::string describeMuscles(MuscleMask muscles) const;
+
+    /**
+     * @brief Gets the bits of some muscle groups.
+     * @param groups The muscle groups; unknown groups are ignored.
+     * @return The mask.
+     */
+    MuscleMask maskOf(const std::vector<std::string>& groups) const;
+
+    Settings settings; ///< The limits of a session.
+    std::vector<std::string> muscleGroups; ///< Muscle groups by bit, sorted by name.
+    std::vector<MuscleMask> musclesById; ///< Muscle groups of every exercise, indexed by ExerciseId; 0 if unknown.
+    MuscleMask largeMask = 0; ///< Bits of Settings::largeGroups.
+    MuscleMask recoveryMask = 0; ///< Bits of the muscle groups that need a day of rest.
+};
+
+#endif // RECOVERY_VALIDATOR_H
@@ -0,0 +1,138 @@
+#include "ShoppingList.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    /**
+     * @brief Partial sum of one food within a chunk of plans.
+     */
+    struct Tally
+    {
+        const FoodItem* foodItem = nullptr; ///< The food item of the first occurrence.
+        double grams = 0; ///< Grams summed so far.
+    };
+
+    using TallyTable = std::unordered_map<std::string, Tally>;
+
+    /**
+     * @brief Sums the grams per food of a chunk of plans.
+     * @param plans All plans.
+     * @param begin First plan of the chunk.
+     * @param end One past the last plan of the chunk.
+     * @param table Receives the sums of the chunk.
+     */
+    void tallyPlans(const std::vector<const NutritionPlan*>& plans, size_t begin, size_t end, TallyTable& table)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            for (const auto& meal : plans[i]->meals)
+            {
+                for (const auto& foodPair : meal.second)
+                {
+                    Tally& tally = table[foodPair.first.name];
+                    if (tally.foodItem == nullptr)
+                    {
+                        tally.foodItem = &foodPair.first;
+                    }
+                    tally.grams += foodPair.second;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Constructs an empty list.
+ * @param threadCount Number of threads used to build the list, 0 uses all hardware threads.
+ */
+ShoppingList::ShoppingList(unsigned threadCount) : threadCount(threadCount)
+{
+}
+
+/**
+ * @brief Replaces the list with the foods of the given plans.
+ * @param plans The plans to shop for; plans may appear several times.
+ * @param multiplier Factor applied to every amount, e.g. the number of people.
+ */
+void ShoppingList::build(const std::vector<const NutritionPlan*>& plans, float multiplier)
+{
+    // Starting a thread costs more than summing a few plans, so small lists are built inline
+    const size_t minPlansPerThread = 64;
+    unsigned chunkCount = threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    chunkCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(chunkCount, plans.size() / minPlansPerThread)));
+
+    // Map: every chunk fills its own table
+    std::vector<TallyTable> tables(chunkCount);
+    std::vector<std::thread> threads;
+    size_t chunkSize = (plans.size() + chunkCount - 1) / chunkCount;
+    for (unsigned chunk = 1; chunk < chunkCount; ++chunk)
+    {
+        size_t begin = std::min(plans.size(), chunk * chunkSize);
+        size_t end = std::min(plans.size(), begin + chunkSize);
+        threads.emplace_back(tallyPlans, std::cref(plans), begin, end, std::ref(tables[chunk]));
+    }
+    tallyPlans(plans, 0, std::min(plans.size(), chunkSize), tables[0]);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Reduce: merge the tables into the first one
+    TallyTable& merged = tables[0];
+    for (unsigned chunk = 1; chunk < chunkCount; ++chunk)
+    {
+        for (const auto& entry : tables[chunk])
+        {
+            Tally& tally = merged[entry.first];
+            if (tally.foodItem == nullptr)
+            {
+                tally.foodItem = entry.second.foodItem;
+            }
+            tally.grams += entry.second.grams;
+        }
+    }
+
+    categories.clear();
+    for (const auto& entry : merged)
+    {
+        if (entry.second.grams <= 0)
+        {
+            continue;
+        }
+
+        Item item;
+        item.foodItem = *entry.second.foodItem;
+        item.grams = static_cast<float>(entry.second.grams * multiplier);
+        item.servings = item.foodItem.portion > 0 ? item.grams / item.foodItem.portion : 0;
+
+        const std::string category = item.foodItem.categories.empty() ? "other" : *item.foodItem.categories.begin();
+        categories[category].push_back(item);
+    }
+
+    for (auto& category : categories)
+    {
+        std::sort(category.second.begin(), category.second.end(),
+            [](const Item& a, const Item& b) { return a.foodItem.name < b.foodItem.name; });
+    }
+}
+
+/**
+ * @brief Gets the items grouped by category.
+ * @return Category name to the items of that category.
+ */
+const std::map<std::string, std::vector<ShoppingList::Item>>& ShoppingList::getCategories() const
+{
+    return categories;
+}
+
+/**
+ * @brief Checks whether the list is empty.
+ * @return True if the list holds no items.
+ */
+bool ShoppingList::empty() const
+{
+    return categories.empty();
+}
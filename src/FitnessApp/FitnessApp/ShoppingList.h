@@ -0,0 +1,65 @@
+#ifndef SHOPPING_LIST_H
+#define SHOPPING_LIST_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "FoodItem.h"
+#include "NutritionPlan.h"
+
+/**
+ * @brief Grocery list summed over any number of nutrition plans.
+ *
+ * Building the list is a map-reduce: the plans are split into contiguous chunks, every
+ * thread sums the grams per food of its chunk into its own hash table, and the tables are
+ * merged once all threads are done. No table is shared while summing, so the work scales
+ * with the number of plans and threads.
+ */
+class ShoppingList
+{
+public:
+    /**
+     * @brief One food to buy.
+     */
+    struct Item
+    {
+        FoodItem foodItem; ///< The food item, as it appears in the first plan containing it.
+        float grams = 0; ///< Total amount in grams.
+        float servings = 0; ///< Total amount in servings of FoodItem::portion, 0 if the food has no serving size.
+    };
+
+    /**
+     * @brief Constructs an empty list.
+     * @param threadCount Number of threads used to build the list, 0 uses all hardware threads.
+     */
+    explicit ShoppingList(unsigned threadCount = 0);
+
+    /**
+     * @brief Replaces the list with the foods of the given plans.
+     * @param plans The plans to shop for; plans may appear several times.
+     * @param multiplier Factor applied to every amount, e.g. the number of people.
+     */
+    void build(const std::vector<const NutritionPlan*>& plans, float multiplier = 1);
+
+    /**
+     * @brief Gets the items grouped by category.
+     *
+     * A food is listed under its first category only, foods without a category are listed
+     * under "other". Items of a category are sorted by name.
+     *
+     * @return Category name to the items of that category.
+     */
+    const std::map<std::string, std::vector<Item>>& getCategories() const;
+
+    /**
+     * @brief Checks whether the list is empty.
+     * @return True if the list holds no items.
+     */
+    bool empty() const;
+
+private:
+    unsigned threadCount; ///< Number of threads used to build the list, 0 uses all hardware threads.
+    std::map<std::string, std::vector<Item>> categories; ///< Category name to the items of that category.
+};
+
+#endif // SHOPPING_LIST_H
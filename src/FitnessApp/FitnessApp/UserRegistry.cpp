@@ -0,0 +1,792 @@
+#include "UserRegistry.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    const std::uint32_t RECORD_MAGIC = 0x52525355; ///< Marks the start of a record, "USRR" in the file.
+    const std::uint32_t INDEX_MAGIC = 0x49525355; ///< Marks the start of the index file, "USRI" in the file.
+    const std::uint64_t HEADER_SIZE = 24; ///< Bytes of the index header.
+    const std::uint64_t SLOT_SIZE = 8; ///< Bytes of one index slot.
+    const std::uint32_t RECORD_HEADER_SIZE = 17; ///< Bytes of a record before its row.
+    const size_t IMPORT_BATCH = 4096; ///< Users imported per write.
+
+    /**
+     * @brief Writes a value in its in-memory representation.
+     * @param os The stream to write to.
+     * @param value The value.
+     */
+    template<typename T>
+    void writeValue(std::ostream& os, const T& value)
+    {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /**
+     * @brief Reads a value written by writeValue.
+     * @param is The stream to read from.
+     * @param value Receives the value.
+     * @return False if the stream ended.
+     */
+    template<typename T>
+    bool readValue(std::istream& is, T& value)
+    {
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    /**
+     * @brief Appends a value in its in-memory representation to a buffer.
+     * @param buffer The buffer.
+     * @param value The value.
+     */
+    template<typename T>
+    void appendValue(std::string& buffer, const T& value)
+    {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+/**
+ * @brief Constructs a registry over the given files, without reading them.
+ * @param dataFile The file holding the user records.
+ * @param indexFile The file holding the offset of every user.
+ * @param settings The size of the in-memory cache.
+ */
+UserRegistry::UserRegistry(std::string dataFile, std::string indexFile, Settings settings)
+    : dataFile(std::move(dataFile)), indexFile(std::move(indexFile)), settings(settings)
+{
+}
+
+/**
+ * @brief Opens the files, creating them if needed and rebuilding the index if it does not match the data.
+ * @return False if the files could not be opened or the data file is damaged.
+ */
+bool UserRegistry::open()
+{
+    recentUsers.clear();
+    cachedUsers.clear();
+    data.close();
+    index.close();
+
+    // fstream only opens existing files for reading and writing
+    std::ofstream(dataFile, std::ios::binary | std::ios::app).close();
+    std::ofstream(indexFile, std::ios::binary | std::ios::app).close();
+    data.open(dataFile, std::ios::in | std::ios::out | std::ios::binary);
+    index.open(indexFile, std::ios::in | std::ios::out | std::ios::binary);
+    if (!data.is_open() || !index.is_open())
+    {
+        std::cerr << "Unable to open user registry: " << dataFile << std::endl;
+        return false;
+    }
+
+    data.seekg(0, std::ios::end);
+    const std::uint64_t dataSize = static_cast<std::uint64_t>(data.tellg());
+    index.seekg(0, std::ios::end);
+    const std::uint64_t indexSize = static_cast<std::uint64_t>(index.tellg());
+    index.seekg(0);
+
+    header = IndexHeader();
+    if (indexSize >= HEADER_SIZE && readValue(index, header.magic) && readValue(index, header.activeUser)
+        && readValue(index, header.userCount) && readValue(index, header.dataSize)
+        && header.magic == INDEX_MAGIC && header.dataSize == dataSize && (indexSize - HEADER_SIZE) % SLOT_SIZE == 0)
+    {
+        idCount = static_cast<UserId>((indexSize - HEADER_SIZE) / SLOT_SIZE);
+        return true;
+    }
+    return rebuildIndex();
+}
+
+/**
+ * @brief Gets the number of users.
+ * @return The number of users that have not been removed.
+ */
+size_t UserRegistry::getUserCount() const
+{
+    return static_cast<size_t>(header.userCount);
+}
+
+/**
+ * @brief Gets the number of ids handed out, which is one more than the largest id.
+ * @return The number of ids.
+ */
+UserRegistry::UserId UserRegistry::getIdCount() const
+{
+    return idCount;
+}
+
+/**
+ * @brief Gets the user the application works with.
+ * @return The id of the user, or NO_USER if there are no users.
+ */
+UserRegistry::UserId UserRegistry::getActiveUser() const
+{
+    return header.activeUser;
+}
+
+/**
+ * @brief Sets the user the application works with.
+ * @param id The id of an existing user.
+ * @return False if there is no such user.
+ */
+bool UserRegistry::setActiveUser(UserId id)
+{
+    std::uint64_t offset;
+    if (!findOffset(id, offset))
+    {
+        return false;
+    }
+    header.activeUser = id;
+    return writeHeader();
+}
+
+/**
+ * @brief Reads a user.
+ *
+ * Cached users are copied from memory; the others cost one read of the index and one of the
+ * data file, and are cached.
+ *
+ * @param id The id of the user.
+ * @param profile Receives the profile.
+ * @param goals Receives the goals, linked to profile.
+ * @return False if there is no such user.
+ */
+bool UserRegistry::load(UserId id, Profile& profile, Goals& goals)
+{
+    auto it = cachedUsers.find(id);
+    if (it != cachedUsers.end())
+    {
+        recentUsers.splice(recentUsers.begin(), recentUsers, it->second);
+        profile = it->second->profile;
+        goals = it->second->goals;
+        goals.setProfile(&profile);
+        return true;
+    }
+
+    std::uint64_t offset;
+    UserId recordId;
+    bool removed;
+    std::string row;
+    std::uint32_t size;
+    if (!findOffset(id, offset) || !readRecord(offset, recordId, removed, row, size) || removed || recordId != id
+        || !fromRow(row, profile, goals))
+    {
+        return false;
+    }
+    goals.setProfile(&profile);
+    cache(id, profile, goals);
+    return true;
+}
+
+/**
+ * @brief Saves an existing user.
+ * @param id The id of the user.
+ * @param profile The profile.
+ * @param goals The goals.
+ * @return False if there is no such user or the files could not be written.
+ */
+bool UserRegistry::save(UserId id, const Profile& profile, const Goals& goals)
+{
+    std::uint64_t offset;
+    if (!findOffset(id, offset) || !appendRecords({ buildRecord(id, false, toRow(profile, goals)) }, { id }))
+    {
+        return false;
+    }
+    cache(id, profile, goals);
+    return true;
+}
+
+/**
+ * @brief Adds a user.
+ *
+ * The first user becomes the active user.
+ *
+ * @param profile The profile.
+ * @param goals The goals.
+ * @return The id of the new user, or NO_USER if the files could not be written.
+ */
+UserRegistry::UserId UserRegistry::create(const Profile& profile, const Goals& goals)
+{
+    const UserId id = idCount;
+    if (id == NO_USER || !appendRecords({ buildRecord(id, false, toRow(profile, goals)) }, { id }))
+    {
+        return NO_USER;
+    }
+    ++header.userCount;
+    if (header.activeUser == NO_USER)
+    {
+        header.activeUser = id;
+    }
+    if (!writeHeader())
+    {
+        return NO_USER;
+    }
+    cache(id, profile, goals);
+    return id;
+}
+
+/**
+ * @brief Removes a user; its id is not handed out again.
+ *
+ * A removal record is appended, so the index can be rebuilt without the user.
+ *
+ * @param id The id of the user.
+ * @return False if there is no such user or the files could not be written.
+ */
+bool UserRegistry::remove(UserId id)
+{
+    std::uint64_t offset;
+    if (!findOffset(id, offset) || !appendRecords({ buildRecord(id, true, "") }, { id }) || !writeSlot(id, 0))
+    {
+        return false;
+    }
+
+    auto it = cachedUsers.find(id);
+    if (it != cachedUsers.end())
+    {
+        recentUsers.erase(it->second);
+        cachedUsers.erase(it);
+    }
+    --header.userCount;
+    if (header.activeUser == id)
+    {
+        header.activeUser = NO_USER;
+    }
+    return writeHeader();
+}
+
+/**
+ * @brief Adds the users of a CSV file, one per line, with the profile fields followed by the goal fields.
+ *
+ * Users are written in batches, each batch with one write to the data file and one to the
+ * index. Malformed lines are reported and skipped. Imported users are not cached.
+ *
+ * @param filename The CSV file.
+ * @return The number of users added.
+ */
+size_t UserRegistry::importCSV(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Unable to open file for reading: " << filename << std::endl;
+        return 0;
+    }
+
+    size_t imported = 0;
+    std::vector<std::string> records;
+    std::vector<UserId> ids;
+    auto flush = [&]() {
+        if (records.empty())
+        {
+            return true;
+        }
+        if (!appendRecords(records, ids))
+        {
+            return false;
+        }
+        imported += records.size();
+        header.userCount += records.size();
+        records.clear();
+        ids.clear();
+        return true;
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    Profile profile;
+    Goals goals;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty())
+        {
+            continue;
+        }
+        if (!fromRow(line, profile, goals))
+        {
+            std::cerr << "Skipping line " << lineNumber << " of " << filename << ": " << line << "\n";
+            continue;
+        }
+
+        // The row is stored as written by toRow, so every record reads back the same way
+        ids.push_back(idCount + static_cast<UserId>(records.size()));
+        records.push_back(buildRecord(ids.back(), false, toRow(profile, goals)));
+        if (records.size() == IMPORT_BATCH && !flush())
+        {
+            break;
+        }
+    }
+    flush();
+
+    if (header.activeUser == NO_USER && imported > 0)
+    {
+        header.activeUser = idCount - static_cast<UserId>(imported);
+    }
+    writeHeader();
+    return imported;
+}
+
+/**
+ * @brief Writes every user to a CSV file in the format read by importCSV, by id.
+ *
+ * The index is read in one pass and the cache is left untouched.
+ *
+ * @param filename The CSV file.
+ * @return The number of users written.
+ */
+size_t UserRegistry::exportCSV(const std::string& filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Unable to open file for writing: " << filename << std::endl;
+        return 0;
+    }
+
+    std::vector<std::uint64_t> slots = readSlots();
+
+    size_t exported = 0;
+    for (UserId id = 0; id < idCount; ++id)
+    {
+        UserId recordId;
+        bool removed;
+        std::string row;
+        std::uint32_t size;
+        if (slots[id] != 0 && readRecord(slots[id] - 1, recordId, removed, row, size) && !removed)
+        {
+            file << row << '\n';
+            ++exported;
+        }
+    }
+    return exported;
+}
+
+/**
+ * @brief Reads every user by id, without caching them.
+ *
+ * The index is read in one pass, so scanning the users costs one read of the data file per user.
+ *
+ * @param visit Called with the id, profile and goals of every user; the goals are linked to the profile.
+ * @return The number of users read.
+ */
+size_t UserRegistry::forEachUser(const std::function<void(UserId, const Profile&, const Goals&)>& visit)
+{
+    std::vector<std::uint64_t> slots = readSlots();
+
+    size_t visited = 0;
+    Profile profile;
+    Goals goals;
+    for (UserId id = 0; id < idCount; ++id)
+    {
+        UserId recordId;
+        bool removed;
+        std::string row;
+        std::uint32_t size;
+        if (slots[id] == 0 || !readRecord(slots[id] - 1, recordId, removed, row, size) || removed || !fromRow(row, profile, goals))
+        {
+            continue;
+        }
+        goals.setProfile(&profile);
+        visit(id, profile, goals);
+        ++visited;
+    }
+    return visited;
+}
+
+/**
+ * @brief Rewrites the data file with the latest record of every user only.
+ *
+ * The records are copied in id order to a new file, which then replaces the data file, and
+ * the index is rewritten to match.
+ *
+ * @return False if the files could not be written.
+ */
+bool UserRegistry::compact()
+{
+    const std::string compactFile = dataFile + ".tmp";
+    std::ofstream out(compactFile, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        std::cerr << "Unable to open file for writing: " << compactFile << std::endl;
+        return false;
+    }
+
+    std::vector<std::uint64_t> slots = readSlots();
+
+    std::uint64_t offset = 0;
+    for (UserId id = 0; id < idCount; ++id)
+    {
+        UserId recordId;
+        bool removed;
+        std::string row;
+        std::uint32_t size;
+        if (slots[id] == 0 || !readRecord(slots[id] - 1, recordId, removed, row, size) || removed)
+        {
+            slots[id] = 0;
+            continue;
+        }
+        std::string record = buildRecord(id, false, row);
+        out.write(record.data(), static_cast<std::streamsize>(record.size()));
+        slots[id] = offset + 1;
+        offset += record.size();
+    }
+    out.close();
+    if (!out)
+    {
+        std::cerr << "Unable to write file: " << compactFile << std::endl;
+        return false;
+    }
+
+    data.close();
+    std::error_code error;
+    std::filesystem::rename(compactFile, dataFile, error);
+    data.open(dataFile, std::ios::in | std::ios::out | std::ios::binary);
+    if (error || !data.is_open())
+    {
+        std::cerr << "Unable to replace file: " << dataFile << std::endl;
+        return false;
+    }
+    header.dataSize = offset;
+    return writeIndex(slots);
+}
+
+/**
+ * @brief Builds the record of a user.
+ *
+ * A record is its magic number, its size, the user id, the removal flag, and the row with its
+ * length in front.
+ *
+ * @param id The id of the user.
+ * @param removed Whether the record marks the user as removed.
+ * @param row The profile and goals as one CSV row, empty for removed users.
+ * @return The record.
+ */
+std::string UserRegistry::buildRecord(UserId id, bool removed, const std::string& row)
+{
+    std::string record;
+    record.reserve(RECORD_HEADER_SIZE + row.size());
+    appendValue(record, RECORD_MAGIC);
+    appendValue(record, static_cast<std::uint32_t>(RECORD_HEADER_SIZE + row.size()));
+    appendValue(record, id);
+    appendValue(record, static_cast<std::uint8_t>(removed ? 1 : 0));
+    appendValue(record, static_cast<std::uint32_t>(row.size()));
+    record += row;
+    return record;
+}
+
+/**
+ * @brief Formats a user as one CSV row.
+ * @param profile The profile.
+ * @param goals The goals.
+ * @return The row, without a line break.
+ */
+std::string UserRegistry::toRow(const Profile& profile, const Goals& goals)
+{
+    std::ostringstream row;
+    profile.toCSV(row);
+    row << ',';
+    goals.toCSV(row);
+    return row.str();
+}
+
+/**
+ * @brief Parses a row written by toRow.
+ * @param row The row.
+ * @param profile Receives the profile.
+ * @param goals Receives the goals.
+ * @return False if the row is malformed.
+ */
+bool UserRegistry::fromRow(const std::string& row, Profile& profile, Goals& goals)
+{
+    std::istringstream ss(row);
+    return profile.fromCSV(ss) && goals.fromCSV(ss);
+}
+
+/**
+ * @brief Reads the record at an offset of the data file.
+ *
+ * The row size is checked against the rest of the file before the row is allocated, so a
+ * damaged size cannot ask for more memory than the file holds.
+ *
+ * @param offset The offset of the record.
+ * @param id Receives the id of the record.
+ * @param removed Receives whether the record marks the user as removed.
+ * @param row Receives the row.
+ * @param size Receives the size of the record in bytes.
+ * @return False if the record is damaged.
+ */
+bool UserRegistry::readRecord(std::uint64_t offset, UserId& id, bool& removed, std::string& row, std::uint32_t& size)
+{
+    data.clear();
+    data.seekg(0, std::ios::end);
+    const std::uint64_t dataSize = static_cast<std::uint64_t>(data.tellg());
+    data.seekg(static_cast<std::streamoff>(offset));
+
+    std::uint32_t magic = 0;
+    std::uint8_t removedFlag = 0;
+    std::uint32_t rowSize = 0;
+    if (!readValue(data, magic) || magic != RECORD_MAGIC || !readValue(data, size) || !readValue(data, id)
+        || !readValue(data, removedFlag) || !readValue(data, rowSize)
+        || offset + RECORD_HEADER_SIZE + rowSize > dataSize || size != RECORD_HEADER_SIZE + rowSize)
+    {
+        return false;
+    }
+    removed = removedFlag != 0;
+    row.resize(rowSize);
+    return static_cast<bool>(data.read(row.data(), rowSize));
+}
+
+/**
+ * @brief Gets the offset of the latest record of a user.
+ * @param id The id of the user.
+ * @param offset Receives the offset.
+ * @return False if there is no such user.
+ */
+bool UserRegistry::findOffset(UserId id, std::uint64_t& offset)
+{
+    if (id >= idCount)
+    {
+        return false;
+    }
+
+    std::uint64_t slot = 0;
+    index.clear();
+    index.seekg(static_cast<std::streamoff>(HEADER_SIZE + id * SLOT_SIZE));
+    if (!readValue(index, slot) || slot == 0)
+    {
+        return false;
+    }
+    offset = slot - 1;
+    return true;
+}
+
+/**
+ * @brief Reads every index slot.
+ * @return The slot of every id handed out.
+ */
+std::vector<std::uint64_t> UserRegistry::readSlots()
+{
+    std::vector<std::uint64_t> slots(idCount);
+    index.clear();
+    index.seekg(static_cast<std::streamoff>(HEADER_SIZE));
+    index.read(reinterpret_cast<char*>(slots.data()), static_cast<std::streamsize>(slots.size() * SLOT_SIZE));
+    return slots;
+}
+
+/**
+ * @brief Appends records to the data file in one write and points their index slots at them.
+ *
+ * Slots of consecutive ids are written together.
+ *
+ * @param records The records.
+ * @param ids The id of every record; new ids must follow the ids handed out.
+ * @return False if the files could not be written.
+ */
+bool UserRegistry::appendRecords(const std::vector<std::string>& records, const std::vector<UserId>& ids)
+{
+    std::string buffer;
+    std::vector<std::uint64_t> slots;
+    std::uint64_t offset = header.dataSize;
+    for (const auto& record : records)
+    {
+        slots.push_back(offset + 1);
+        offset += record.size();
+        buffer += record;
+    }
+
+    data.clear();
+    data.seekp(static_cast<std::streamoff>(header.dataSize));
+    data.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    data.flush();
+    if (!data)
+    {
+        std::cerr << "Unable to write file: " << dataFile << std::endl;
+        return false;
+    }
+    header.dataSize = offset;
+
+    size_t first = 0;
+    while (first < ids.size())
+    {
+        size_t last = first + 1;
+        while (last < ids.size() && ids[last] == ids[last - 1] + 1)
+        {
+            ++last;
+        }
+        index.clear();
+        index.seekp(static_cast<std::streamoff>(HEADER_SIZE + ids[first] * SLOT_SIZE));
+        index.write(reinterpret_cast<const char*>(slots.data() + first), static_cast<std::streamsize>((last - first) * SLOT_SIZE));
+        idCount = std::max(idCount, ids[last - 1] + 1);
+        first = last;
+    }
+    return writeHeader();
+}
+
+/**
+ * @brief Writes the index slot of a user.
+ * @param id The id of the user.
+ * @param slot The offset of its record plus one, or 0 if there is no such user.
+ * @return False if the index could not be written.
+ */
+bool UserRegistry::writeSlot(UserId id, std::uint64_t slot)
+{
+    index.clear();
+    index.seekp(static_cast<std::streamoff>(HEADER_SIZE + id * SLOT_SIZE));
+    writeValue(index, slot);
+    index.flush();
+    return static_cast<bool>(index);
+}
+
+/**
+ * @brief Writes the index header.
+ *
+ * The header records the size of the data file it describes, so it is written after the
+ * records and the slots.
+ *
+ * @return False if the index could not be written.
+ */
+bool UserRegistry::writeHeader()
+{
+    header.magic = INDEX_MAGIC;
+    index.clear();
+    index.seekp(0);
+    writeValue(index, header.magic);
+    writeValue(index, header.activeUser);
+    writeValue(index, header.userCount);
+    writeValue(index, header.dataSize);
+    index.flush();
+    if (!index)
+    {
+        std::cerr << "Unable to write file: " << indexFile << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Replaces the index file with the header and the given slots.
+ * @param slots The slot of every id.
+ * @return False if the index could not be written.
+ */
+bool UserRegistry::writeIndex(const std::vector<std::uint64_t>& slots)
+{
+    index.close();
+    std::ofstream(indexFile, std::ios::binary | std::ios::trunc).close();
+    index.open(indexFile, std::ios::in | std::ios::out | std::ios::binary);
+    if (!index.is_open())
+    {
+        std::cerr << "Unable to open file for writing: " << indexFile << std::endl;
+        return false;
+    }
+
+    idCount = static_cast<UserId>(slots.size());
+    header.userCount = static_cast<std::uint64_t>(std::count_if(slots.begin(), slots.end(), [](std::uint64_t slot) { return slot != 0; }));
+    if (header.activeUser != NO_USER && (header.activeUser >= slots.size() || slots[header.activeUser] == 0))
+    {
+        header.activeUser = NO_USER;
+    }
+    if (!writeHeader())
+    {
+        return false;
+    }
+    index.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * SLOT_SIZE));
+    index.flush();
+    return static_cast<bool>(index);
+}
+
+/**
+ * @brief Rebuilds the index from the records of the data file.
+ *
+ * The latest record of every user wins. A damaged tail of the data file is reported and cut
+ * off, so users saved afterwards are not lost behind it. The active user is kept if it still
+ * exists, and is otherwise the first user.
+ *
+ * @return False if a record is damaged.
+ */
+bool UserRegistry::rebuildIndex()
+{
+    data.clear();
+    data.seekg(0, std::ios::end);
+    const std::uint64_t dataSize = static_cast<std::uint64_t>(data.tellg());
+
+    std::vector<std::uint64_t> slots;
+    std::uint64_t offset = 0;
+    bool damaged = false;
+    while (offset < dataSize)
+    {
+        UserId id;
+        bool removed;
+        std::string row;
+        std::uint32_t size;
+        if (!readRecord(offset, id, removed, row, size) || id == NO_USER)
+        {
+            damaged = true;
+            break;
+        }
+        if (id >= slots.size())
+        {
+            slots.resize(static_cast<size_t>(id) + 1, 0);
+        }
+        slots[id] = removed ? 0 : offset + 1;
+        offset += size;
+    }
+
+    if (damaged)
+    {
+        std::cerr << "User registry " << dataFile << " is damaged after byte " << offset << "; the rest is discarded." << std::endl;
+        data.close();
+        std::error_code error;
+        std::filesystem::resize_file(dataFile, offset, error);
+        data.open(dataFile, std::ios::in | std::ios::out | std::ios::binary);
+    }
+
+    header.dataSize = offset;
+    if (header.activeUser == NO_USER || header.activeUser >= slots.size() || slots[header.activeUser] == 0)
+    {
+        auto first = std::find_if(slots.begin(), slots.end(), [](std::uint64_t slot) { return slot != 0; });
+        header.activeUser = first != slots.end() ? static_cast<UserId>(first - slots.begin()) : NO_USER;
+    }
+    return writeIndex(slots) && !damaged;
+}
+
+/**
+ * @brief Puts a user at the front of the cache, evicting the least recently used one if it is full.
+ * @param id The id of the user.
+ * @param profile The profile.
+ * @param goals The goals.
+ */
+void UserRegistry::cache(UserId id, const Profile& profile, const Goals& goals)
+{
+    if (settings.cacheCapacity == 0)
+    {
+        return;
+    }
+
+    auto it = cachedUsers.find(id);
+    if (it != cachedUsers.end())
+    {
+        recentUsers.splice(recentUsers.begin(), recentUsers, it->second);
+    }
+    else
+    {
+        recentUsers.push_front({ id, Profile(), Goals() });
+        cachedUsers[id] = recentUsers.begin();
+    }
+    CachedUser& user = recentUsers.front();
+    user.profile = profile;
+    user.goals = goals;
+    user.goals.setProfile(&user.profile);
+
+    if (recentUsers.size() > settings.cacheCapacity)
+    {
+        cachedUsers.erase(recentUsers.back().id);
+        recentUsers.pop_back();
+    }
+}
@@ -0,0 +1,275 @@
+#ifndef USER_REGISTRY_H
+#define USER_REGISTRY_H
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Profile.h"
+#include "Goals.h"
+
+/**
+ * @brief Profiles and goals of many users, kept on disk and looked up by user id.
+ *
+ * The data file is a sequence of records, each holding a user id and the profile and goals of
+ * the user as one CSV row, in the format of Profile::toCSV followed by Goals::toCSV. Saving a
+ * user appends a new record, so the file only grows until compact() rewrites it.
+ *
+ * The index file starts with a small header and then holds one 8-byte slot per user id, with
+ * the offset of the latest record of the user. Ids are handed out in order, so looking up a
+ * user is one seek into the index and one into the data, however many users there are. The
+ * index is rebuilt from the records if it is missing or does not match the data file.
+ *
+ * The users read or saved last are kept in memory, up to Settings::cacheCapacity of them.
+ */
+class UserRegistry
+{
+public:
+    /**
+     * @brief Identifier of a user.
+     */
+    using UserId = std::uint32_t;
+
+    /**
+     * @brief Id that never refers to a user.
+     */
+    static const UserId NO_USER = UINT32_MAX;
+
+    /**
+     * @brief Size of the in-memory cache.
+     */
+    struct Settings
+    {
+        size_t cacheCapacity = 1024; ///< Number of users kept in memory.
+    };
+
+    /**
+     * @brief Constructs a registry over the given files, without reading them.
+     * @param dataFile The file holding the user records.
+     * @param indexFile The file holding the offset of every user.
+     * @param settings The size of the in-memory cache.
+     */
+    UserRegistry(std::string dataFile, std::string indexFile, Settings settings);
+
+    /**
+     * @brief Opens the files, creating them if needed and rebuilding the index if it does not match the data.
+     * @return False if the files could not be opened or the data file is damaged.
+     */
+    bool open();
+
+    /**
+     * @brief Gets the number of users.
+     * @return The number of users that have not been removed.
+     */
+    size_t getUserCount() const;
+
+    /**
+     * @brief Gets the number of ids handed out, which is one more than the largest id.
+     * @return The number of ids.
+     */
+    UserId getIdCount() const;
+
+    /**
+     * @brief Gets the user the application works with.
+     * @return The id of the user, or NO_USER if there are no users.
+     */
+    UserId getActiveUser() const;
+
+    /**
+     * @brief Sets the user the application works with.
+     * @param id The id of an existing user.
+     * @return False if there is no such user.
+     */
+    bool setActiveUser(UserId id);
+
+    /**
+     * @brief Reads a user.
+     * @param id The id of the user.
+     * @param profile Receives the profile.
+     * @param goals Receives the goals, linked to profile.
+     * @return False if there is no such user.
+     */
+    bool load(UserId id, Profile& profile, Goals& goals);
+
+    /**
+     * @brief Saves an existing user.
+     * @param id The id of the user.
+     * @param profile The profile.
+     * @param goals The goals.
+     * @return False if there is no such user or the files could not be written.
+     */
+    bool save(UserId id, const Profile& profile, const Goals& goals);
+
+    /**
+     * @brief Adds a user.
+     * @param profile The profile.
+     * @param goals The goals.
+     * @return The id of the new user, or NO_USER if the files could not be written.
+     */
+    UserId create(const Profile& profile, const Goals& goals);
+
+    /**
+     * @brief Removes a user; its id is not handed out again.
+     * @param id The id of the user.
+     * @return False if there is no such user or the files could not be written.
+     */
+    bool remove(UserId id);
+
+    /**
+     * @brief Adds the users of a CSV file, one per line, with the profile fields followed by the goal fields.
+     * @param filename The CSV file.
+     * @return The number of users added.
+     */
+    size_t importCSV(const std::string& filename);
+
+    /**
+     * @brief Writes every user to a CSV file in the format read by importCSV, by id.
+     * @param filename The CSV file.
+     * @return The number of users written.
+     */
+    size_t exportCSV(const std::string& filename);
+
+    /**
+     * @brief Reads every user by id, without caching them.
+     * @param visit Called with the id, profile and goals of every user; the goals are linked to the profile.
+     * @return The number of users read.
+     */
+    size_t forEachUser(const std::function<void(UserId, const Profile&, const Goals&)>& visit);
+
+    /**
+     * @brief Rewrites the data file with the latest record of every user only.
+     * @return False if the files could not be written.
+     */
+    bool compact();
+
+private:
+    /**
+     * @brief A user kept in memory.
+     */
+    struct CachedUser
+    {
+        UserId id; ///< The id of the user.
+        Profile profile; ///< The profile.
+        Goals goals; ///< The goals, linked to profile.
+    };
+
+    /**
+     * @brief Start of the index file.
+     */
+    struct IndexHeader
+    {
+        std::uint32_t magic = 0; ///< Marks the index file.
+        UserId activeUser = NO_USER; ///< The user the application works with.
+        std::uint64_t userCount = 0; ///< Number of users that have not been removed.
+        std::uint64_t dataSize = 0; ///< Size of the data file the index describes.
+    };
+
+    /**
+     * @brief Builds the record of a user.
+     * @param id The id of the user.
+     * @param removed Whether the record marks the user as removed.
+     * @param row The profile and goals as one CSV row, empty for removed users.
+     * @return The record.
+     */
+    static std::string buildRecord(UserId id, bool removed, const std::string& row);
+
+    /**
+     * @brief Formats a user as one CSV row.
+     * @param profile The profile.
+     * @param goals The goals.
+     * @return The row, without a line break.
+     */
+    static std::string toRow(const Profile& profile, const Goals& goals);
+
+    /**
+     * @brief Parses a row written by toRow.
+     * @param row The row.
+     * @param profile Receives the profile.
+     * @param goals Receives the goals.
+     * @return False if the row is malformed.
+     */
+    static bool fromRow(const std::string& row, Profile& profile, Goals& goals);
+
+    /**
+     * @brief Reads the record at an offset of the data file.
+     * @param offset The offset of the record.
+     * @param id Receives the id of the record.
+     * @param removed Receives whether the record marks the user as removed.
+     * @param row Receives the row.
+     * @param size Receives the size of the record in bytes.
+     * @return False if the record is damaged.
+     */
+    bool readRecord(std::uint64_t offset, UserId& id, bool& removed, std::string& row, std::uint32_t& size);
+
+    /**
+     * @brief Gets the offset of the latest record of a user.
+     * @param id The id of the user.
+     * @param offset Receives the offset.
+     * @return False if there is no such user.
+     */
+    bool findOffset(UserId id, std::uint64_t& offset);
+
+    /**
+     * @brief Reads every index slot.
+     * @return The slot of every id handed out.
+     */
+    std::vector<std::uint64_t> readSlots();
+
+    /**
+     * @brief Appends records to the data file in one write and points their index slots at them.
+     * @param records The records.
+     * @param ids The id of every record; new ids must follow the ids handed out.
+     * @return False if the files could not be written.
+     */
+    bool appendRecords(const std::vector<std::string>& records, const std::vector<UserId>& ids);
+
+    /**
+     * @brief Writes the index slot of a user.
+     * @param id The id of the user.
+     * @param slot The offset of its record plus one, or 0 if there is no such user.
+     * @return False if the index could not be written.
+     */
+    bool writeSlot(UserId id, std::uint64_t slot);
+
+    /**
+     * @brief Replaces the index file with the header and the given slots.
+     * @param slots The slot of every id.
+     * @return False if the index could not be written.
+     */
+    bool writeIndex(const std::vector<std::uint64_t>& slots);
+
+    /**
+     * @brief Writes the index header.
+     * @return False if the index could not be written.
+     */
+    bool writeHeader();
+
+    /**
+     * @brief Rebuilds the index from the records of the data file.
+     * @return False if a record is damaged.
+     */
+    bool rebuildIndex();
+
+    /**
+     * @brief Puts a user at the front of the cache, evicting the least recently used one if it is full.
+     * @param id The id of the user.
+     * @param profile The profile.
+     * @param goals The goals.
+     */
+    void cache(UserId id, const Profile& profile, const Goals& goals);
+
+    std::string dataFile; ///< The file holding the user records.
+    std::string indexFile; ///< The file holding the offset of every user.
+    Settings settings; ///< The size of the in-memory cache.
+    std::fstream data; ///< The open data file.
+    std::fstream index; ///< The open index file.
+    IndexHeader header; ///< The header of the index file.
+    UserId idCount = 0; ///< Number of ids handed out.
+    std::list<CachedUser> recentUsers; ///< Cached users, most recently used first.
+    std::unordered_map<UserId, std::list<CachedUser>::iterator> cachedUsers; ///< Position of every cached user in recentUsers.
+};
+
+#endif // USER_REGISTRY_H
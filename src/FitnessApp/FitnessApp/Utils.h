@@ -414,7 +414,7 @@ inline void printWindowSizedSeparator()
 /**
  * @brief Prints a window-sized separator line for Unix-like systems.
  */
-void printWindowSizedSeparator()
+inline void printWindowSizedSeparator()
 {
 	struct winsize w;
 	ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
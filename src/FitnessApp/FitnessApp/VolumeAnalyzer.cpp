@@ -0,0 +1,372 @@
+#include "VolumeAnalyzer.h"
+#include "ExerciseIdTable.h"
+#include <algorithm>
+#include <numeric>
+#include <set>
+
+namespace
+{
+    /**
+     * @brief Number of exercise types, including UNKNOWN.
+     */
+    const size_t TYPE_COUNT = static_cast<size_t>(Exercise::ExerciseType::UNKNOWN) + 1;
+}
+
+const std::string VolumeAnalyzer::UNLISTED = "unlisted";
+
+/**
+ * @brief Constructs an analyzer with the given limits.
+ * @param settings The limits used to flag muscle groups.
+ */
+VolumeAnalyzer::VolumeAnalyzer(Settings settings) : settings(std::move(settings))
+{
+}
+
+/**
+ * @brief Computes the volume of every plan.
+ *
+ * Every exercise is resolved to its muscle group and type once, into tables indexed by
+ * ExerciseId, so the pass over the plan entries does no string lookups.
+ *
+ * @param plans The workout plans by name.
+ * @param exerciseMap The exercises the plan entries refer to.
+ */
+void VolumeAnalyzer::analyze(const std::map<std::string, WorkoutPlan>& plans, const std::map<std::string, Exercise>& exerciseMap)
+{
+    std::set<std::string> groups;
+    for (const auto& pair : exerciseMap)
+    {
+        groups.insert(pair.second.muscleGroup);
+    }
+    muscleGroups.assign(groups.begin(), groups.end());
+
+    // Entries whose exercise is missing go to an extra column, dropped again if it stays empty
+    const size_t unlisted = muscleGroups.size();
+    std::vector<std::int16_t> muscleOf;
+    std::vector<std::uint8_t> typeOf;
+    for (const auto& pair : exerciseMap)
+    {
+        ExerciseId id = ExerciseIdTable::intern(pair.first);
+        if (id >= muscleOf.size())
+        {
+            muscleOf.resize(id + 1, -1);
+            typeOf.resize(id + 1, static_cast<std::uint8_t>(Exercise::ExerciseType::UNKNOWN));
+        }
+        muscleOf[id] = static_cast<std::int16_t>(std::lower_bound(muscleGroups.begin(), muscleGroups.end(), pair.second.muscleGroup) - muscleGroups.begin());
+        typeOf[id] = static_cast<std::uint8_t>(pair.second.type);
+    }
+
+    planNames.clear();
+    for (const auto& pair : plans)
+    {
+        planNames.push_back(pair.first);
+    }
+
+    const size_t planCount = planNames.size();
+    const size_t columns = muscleGroups.size() + 1;
+    sets.assign(columns * planCount, 0.0f);
+    reps.assign(columns * planCount, 0.0f);
+    frequency.assign(columns * planCount, 0);
+    typeSets.assign(TYPE_COUNT * planCount, 0.0f);
+
+    std::vector<std::uint8_t> trainedToday(columns, 0);
+    std::vector<size_t> trainedList;
+    size_t plan = 0;
+    for (const auto& pair : plans)
+    {
+        for (const auto& day : pair.second.weeklyPlan)
+        {
+            for (const auto& entry : day.second)
+            {
+                bool listed = entry.exerciseId < muscleOf.size() && muscleOf[entry.exerciseId] >= 0;
+                size_t muscle = listed ? static_cast<size_t>(muscleOf[entry.exerciseId]) : unlisted;
+                size_t type = listed ? typeOf[entry.exerciseId] : TYPE_COUNT - 1;
+
+                size_t index = muscle * planCount + plan;
+                sets[index] += entry.sets;
+                reps[index] += static_cast<float>(entry.sets) * entry.reps;
+                typeSets[type * planCount + plan] += entry.sets;
+                if (!trainedToday[muscle])
+                {
+                    trainedToday[muscle] = 1;
+                    trainedList.push_back(muscle);
+                    ++frequency[index];
+                }
+            }
+
+            for (size_t muscle : trainedList)
+            {
+                trainedToday[muscle] = 0;
+            }
+            trainedList.clear();
+        }
+        ++plan;
+    }
+
+    bool unlistedUsed = std::any_of(sets.begin() + unlisted * planCount, sets.end(), [](float value) { return value > 0; });
+    if (unlistedUsed)
+    {
+        muscleGroups.push_back(UNLISTED);
+    }
+    else
+    {
+        sets.resize(unlisted * planCount);
+        reps.resize(unlisted * planCount);
+        frequency.resize(unlisted * planCount);
+    }
+
+    computeFlags();
+}
+
+/**
+ * @brief Gets the number of analyzed plans.
+ * @return The number of plans.
+ */
+size_t VolumeAnalyzer::getPlanCount() const
+{
+    return planNames.size();
+}
+
+/**
+ * @brief Gets the name of an analyzed plan.
+ * @param plan The plan index.
+ * @return The plan name.
+ */
+const std::string& VolumeAnalyzer::getPlanName(size_t plan) const
+{
+    return planNames.at(plan);
+}
+
+/**
+ * @brief Gets the muscle groups, sorted by name.
+ *
+ * UNLISTED comes last, if any plan uses an exercise missing from the exercise list.
+ *
+ * @return The muscle groups.
+ */
+const std::vector<std::string>& VolumeAnalyzer::getMuscleGroups() const
+{
+    return muscleGroups;
+}
+
+/**
+ * @brief Gets the index of a muscle group.
+ * @param muscleGroup The muscle group.
+ * @param index Receives the index if the muscle group is known.
+ * @return True if the muscle group is known.
+ */
+bool VolumeAnalyzer::findMuscleGroup(const std::string& muscleGroup, size_t& index) const
+{
+    auto it = std::find(muscleGroups.begin(), muscleGroups.end(), muscleGroup);
+    if (it == muscleGroups.end())
+    {
+        return false;
+    }
+    index = static_cast<size_t>(it - muscleGroups.begin());
+    return true;
+}
+
+/**
+ * @brief Gets the weekly sets of a muscle group in a plan.
+ * @param plan The plan index.
+ * @param muscle The muscle group index.
+ * @return The weekly sets.
+ */
+float VolumeAnalyzer::getSets(size_t plan, size_t muscle) const
+{
+    return sets[cell(plan, muscle)];
+}
+
+/**
+ * @brief Gets the weekly repetitions of a muscle group in a plan.
+ * @param plan The plan index.
+ * @param muscle The muscle group index.
+ * @return The weekly repetitions, summed over all sets.
+ */
+float VolumeAnalyzer::getReps(size_t plan, size_t muscle) const
+{
+    return reps[cell(plan, muscle)];
+}
+
+/**
+ * @brief Gets the number of days per week a muscle group is trained in a plan.
+ * @param plan The plan index.
+ * @param muscle The muscle group index.
+ * @return The number of days.
+ */
+int VolumeAnalyzer::getFrequency(size_t plan, size_t muscle) const
+{
+    return frequency[cell(plan, muscle)];
+}
+
+/**
+ * @brief Gets the findings about a muscle group in a plan.
+ * @param plan The plan index.
+ * @param muscle The muscle group index.
+ * @return The Flag bits.
+ */
+std::uint8_t VolumeAnalyzer::getFlags(size_t plan, size_t muscle) const
+{
+    return flags[cell(plan, muscle)];
+}
+
+/**
+ * @brief Gets the weekly sets of an exercise type in a plan.
+ * @param plan The plan index.
+ * @param type The exercise type.
+ * @return The weekly sets.
+ */
+float VolumeAnalyzer::getTypeSets(size_t plan, Exercise::ExerciseType type) const
+{
+    return typeSets[static_cast<size_t>(type) * planNames.size() + plan];
+}
+
+/**
+ * @brief Orders the plans by the weekly sets of a muscle group, most first.
+ * @param muscle The muscle group index.
+ * @return The plan indices.
+ */
+std::vector<size_t> VolumeAnalyzer::rankBySets(size_t muscle) const
+{
+    const float* column = sets.data() + muscle * planNames.size();
+    std::vector<size_t> order(planNames.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [column](size_t a, size_t b) { return column[a] > column[b]; });
+    return order;
+}
+
+/**
+ * @brief Selects the plans whose weekly sets of a muscle group lie within a range.
+ * @param muscle The muscle group index.
+ * @param minSets The smallest number of weekly sets.
+ * @param maxSets The largest number of weekly sets.
+ * @return The plan indices, in plan name order.
+ */
+std::vector<size_t> VolumeAnalyzer::filterBySets(size_t muscle, float minSets, float maxSets) const
+{
+    const float* column = sets.data() + muscle * planNames.size();
+    std::vector<size_t> selected;
+    for (size_t plan = 0; plan < planNames.size(); ++plan)
+    {
+        if (column[plan] >= minSets && column[plan] <= maxSets)
+        {
+            selected.push_back(plan);
+        }
+    }
+    return selected;
+}
+
+/**
+ * @brief Prints the volume of one plan per muscle group and exercise type, with its findings.
+ * @param os The stream to print to.
+ * @param plan The plan index.
+ */
+void VolumeAnalyzer::printReport(std::ostream& os, size_t plan) const
+{
+    os << "Weekly volume of " << planNames.at(plan) << ":\n";
+    for (size_t muscle = 0; muscle < muscleGroups.size(); ++muscle)
+    {
+        if (getSets(plan, muscle) <= 0)
+        {
+            continue;
+        }
+        os << "  " << muscleGroups[muscle] << ": " << getSets(plan, muscle) << " sets, " << getReps(plan, muscle)
+            << " reps, " << getFrequency(plan, muscle) << " day(s)";
+        std::string findings = describeFlags(getFlags(plan, muscle));
+        if (!findings.empty())
+        {
+            os << " - " << findings;
+        }
+        os << "\n";
+    }
+
+    os << "Sets by exercise type:";
+    for (size_t type = 0; type < TYPE_COUNT; ++type)
+    {
+        float value = typeSets[type * planNames.size() + plan];
+        if (value > 0)
+        {
+            os << " " << Exercise::exerciseTypeToString(static_cast<Exercise::ExerciseType>(type)) << " " << value << ";";
+        }
+    }
+    os << "\n";
+}
+
+/**
+ * @brief Describes Flag bits.
+ * @param flags The Flag bits.
+ * @return The findings separated by commas, or an empty string.
+ */
+std::string VolumeAnalyzer::describeFlags(std::uint8_t flags)
+{
+    static const std::pair<Flag, const char*> names[] = {
+        { LOW_VOLUME, "low volume" },
+        { HIGH_VOLUME, "high volume" },
+        { LOW_FREQUENCY, "low frequency" },
+        { IMBALANCED, "imbalanced against its opposing group" }
+    };
+
+    std::string description;
+    for (const auto& name : names)
+    {
+        if (flags & name.first)
+        {
+            description += description.empty() ? "" : ", ";
+            description += name.second;
+        }
+    }
+    return description;
+}
+
+/**
+ * @brief Sets the Flag bits of every plan and muscle group.
+ *
+ * Every check runs down whole columns, so it is a branch-free pass over contiguous values.
+ */
+void VolumeAnalyzer::computeFlags()
+{
+    const size_t planCount = planNames.size();
+    flags.assign(sets.size(), NONE);
+
+    const float minSets = settings.minWeeklySets;
+    const float maxSets = settings.maxWeeklySets;
+    const int minFrequency = settings.minFrequency;
+    for (size_t index = 0; index < sets.size(); ++index)
+    {
+        bool trained = sets[index] > 0;
+        flags[index] = static_cast<std::uint8_t>((trained && sets[index] < minSets ? LOW_VOLUME : 0)
+            | (sets[index] > maxSets ? HIGH_VOLUME : 0)
+            | (trained && frequency[index] < minFrequency ? LOW_FREQUENCY : 0));
+    }
+
+    for (const auto& groups : settings.opposingGroups)
+    {
+        size_t first, second;
+        if (!findMuscleGroup(groups.first, first) || !findMuscleGroup(groups.second, second))
+        {
+            continue;
+        }
+
+        const float* firstSets = sets.data() + first * planCount;
+        const float* secondSets = sets.data() + second * planCount;
+        std::uint8_t* firstFlags = flags.data() + first * planCount;
+        std::uint8_t* secondFlags = flags.data() + second * planCount;
+        const float maxRatio = settings.maxRatio;
+        for (size_t plan = 0; plan < planCount; ++plan)
+        {
+            firstFlags[plan] |= firstSets[plan] > maxRatio * secondSets[plan] ? IMBALANCED : 0;
+            secondFlags[plan] |= secondSets[plan] > maxRatio * firstSets[plan] ? IMBALANCED : 0;
+        }
+    }
+}
+
+/**
+ * @brief Gets the position of a value in the column-wise tables.
+ * @param plan The plan index.
+ * @param muscle The muscle group index.
+ * @return The position.
+ */
+size_t VolumeAnalyzer::cell(size_t plan, size_t muscle) const
+{
+    return muscle * planNames.size() + plan;
+}
@@ -0,0 +1,187 @@
+#ifndef VOLUME_ANALYZER_H
+#define VOLUME_ANALYZER_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Exercise.h"
+#include "WorkoutPlan.h"
+
+/**
+ * @brief Weekly training volume of every workout plan per muscle group and exercise type.
+ *
+ * The plan entries are joined against the exercise list once, through a table indexed by
+ * ExerciseId. The results are stored column by column, one contiguous array per muscle group
+ * holding a value for every plan, so ranking or filtering the whole plan library by one
+ * muscle group is a single linear pass over plain floats.
+ */
+class VolumeAnalyzer
+{
+public:
+    /**
+     * @brief Limits used to flag a muscle group of a plan.
+     */
+    struct Settings
+    {
+        float minWeeklySets = 10.0f; ///< Fewer weekly sets than this is flagged as low volume.
+        float maxWeeklySets = 20.0f; ///< More weekly sets than this is flagged as high volume.
+        int minFrequency = 2; ///< Training a muscle group on fewer days than this is flagged.
+        float maxRatio = 1.5f; ///< Largest ratio of weekly sets between two opposing muscle groups.
+        std::vector<std::pair<std::string, std::string>> opposingGroups = { { "chest", "back" }, { "biceps", "triceps" } }; ///< Muscle groups that should be trained evenly.
+    };
+
+    /**
+     * @brief Findings about one muscle group of a plan, combined as bits.
+     */
+    enum Flag : std::uint8_t
+    {
+        NONE = 0, ///< Nothing to report.
+        LOW_VOLUME = 1, ///< Trained, but with fewer sets than Settings::minWeeklySets.
+        HIGH_VOLUME = 2, ///< More sets than Settings::maxWeeklySets.
+        LOW_FREQUENCY = 4, ///< Trained, but on fewer days than Settings::minFrequency.
+        IMBALANCED = 8 ///< More than Settings::maxRatio times the sets of its opposing muscle group.
+    };
+
+    /**
+     * @brief Name of the muscle group of entries whose exercise is missing from the exercise list.
+     */
+    static const std::string UNLISTED;
+
+    /**
+     * @brief Constructs an analyzer with the given limits.
+     * @param settings The limits used to flag muscle groups.
+     */
+    explicit VolumeAnalyzer(Settings settings);
+
+    /**
+     * @brief Computes the volume of every plan.
+     * @param plans The workout plans by name.
+     * @param exerciseMap The exercises the plan entries refer to.
+     */
+    void analyze(const std::map<std::string, WorkoutPlan>& plans, const std::map<std::string, Exercise>& exerciseMap);
+
+    /**
+     * @brief Gets the number of analyzed plans.
+     * @return The number of plans.
+     */
+    size_t getPlanCount() const;
+
+    /**
+     * @brief Gets the name of an analyzed plan.
+     * @param plan The plan index.
+     * @return The plan name.
+     */
+    const std::string& getPlanName(size_t plan) const;
+
+    /**
+     * @brief Gets the muscle groups, sorted by name.
+     * @return The muscle groups.
+     */
+    const std::vector<std::string>& getMuscleGroups() const;
+
+    /**
+     * @brief Gets the index of a muscle group.
+     * @param muscleGroup The muscle group.
+     * @param index Receives the index if the muscle group is known.
+     * @return True if the muscle group is known.
+     */
+    bool findMuscleGroup(const std::string& muscleGroup, size_t& index) const;
+
+    /**
+     * @brief Gets the weekly sets of a muscle group in a plan.
+     * @param plan The plan index.
+     * @param muscle The muscle group index.
+     * @return The weekly sets.
+     */
+    float getSets(size_t plan, size_t muscle) const;
+
+    /**
+     * @brief Gets the weekly repetitions of a muscle group in a plan.
+     * @param plan The plan index.
+     * @param muscle The muscle group index.
+     * @return The weekly repetitions, summed over all sets.
+     */
+    float getReps(size_t plan, size_t muscle) const;
+
+    /**
+     * @brief Gets the number of days per week a muscle group is trained in a plan.
+     * @param plan The plan index.
+     * @param muscle The muscle group index.
+     * @return The number of days.
+     */
+    int getFrequency(size_t plan, size_t muscle) const;
+
+    /**
+     * @brief Gets the findings about a muscle group in a plan.
+     * @param plan The plan index.
+     * @param muscle The muscle group index.
+     * @return The Flag bits.
+     */
+    std::uint8_t getFlags(size_t plan, size_t muscle) const;
+
+    /**
+     * @brief Gets the weekly sets of an exercise type in a plan.
+     * @param plan The plan index.
+     * @param type The exercise type.
+     * @return The weekly sets.
+     */
+    float getTypeSets(size_t plan, Exercise::ExerciseType type) const;
+
+    /**
+     * @brief Orders the plans by the weekly sets of a muscle group, most first.
+     * @param muscle The muscle group index.
+     * @return The plan indices.
+     */
+    std::vector<size_t> rankBySets(size_t muscle) const;
+
+    /**
+     * @brief Selects the plans whose weekly sets of a muscle group lie within a range.
+     * @param muscle The muscle group index.
+     * @param minSets The smallest number of weekly sets.
+     * @param maxSets The largest number of weekly sets.
+     * @return The plan indices, in plan name order.
+     */
+    std::vector<size_t> filterBySets(size_t muscle, float minSets, float maxSets) const;
+
+    /**
+     * @brief Prints the volume of one plan per muscle group and exercise type, with its findings.
+     * @param os The stream to print to.
+     * @param plan The plan index.
+     */
+    void printReport(std::ostream& os, size_t plan) const;
+
+    /**
+     * @brief Describes Flag bits.
+     * @param flags The Flag bits.
+     * @return The findings separated by commas, or an empty string.
+     */
+    static std::string describeFlags(std::uint8_t flags);
+
+private:
+    /**
+     * @brief Sets the Flag bits of every plan and muscle group.
+     */
+    void computeFlags();
+
+    /**
+     * @brief Gets the position of a value in the column-wise tables.
+     * @param plan The plan index.
+     * @param muscle The muscle group index.
+     * @return The position.
+     */
+    size_t cell(size_t plan, size_t muscle) const;
+
+    Settings settings; ///< The limits used to flag muscle groups.
+    std::vector<std::string> planNames; ///< Name of every analyzed plan.
+    std::vector<std::string> muscleGroups; ///< Name of every muscle group.
+    std::vector<float> sets; ///< Weekly sets, one column of planNames.size() values per muscle group.
+    std::vector<float> reps; ///< Weekly repetitions, laid out like sets.
+    std::vector<std::uint8_t> frequency; ///< Training days per week, laid out like sets.
+    std::vector<std::uint8_t> flags; ///< Flag bits, laid out like sets.
+    std::vector<float> typeSets; ///< Weekly sets, one column of planNames.size() values per exercise type.
+};
+
+#endif // VOLUME_ANALYZER_H
@@ -0,0 +1,61 @@
+#include "WeeklyNutritionPlan.h"
+#include <sstream>
+#include "Utils.h"
+
+/**
+ * @brief Converts the weekly nutrition plan to CSV format and writes it to the given output stream.
+ * @param os The output stream to write the CSV data to.
+ */
+void WeeklyNutritionPlan::toCSV(std::ostream& os) const
+{
+    os << name << ",";
+
+    for (const auto& day : DAYS_OF_WEEK)
+    {
+        auto it = dailyPlans.find(day);
+        if (it != dailyPlans.end())
+        {
+            it->second.mealsToCSV(os);
+        }
+        else
+        {
+            // Keep the column layout intact for days without a plan
+            for (size_t i = 0; i < MEAL_NAMES.size(); ++i)
+            {
+                os << ",";
+            }
+        }
+    }
+    os << "\n";
+}
+
+/**
+ * @brief Loads the weekly nutrition plan from CSV format from the given input stream.
+ * @param is The input stream to read the CSV data from.
+ * @param items A map of available food items to look up by name.
+ * @return True if the weekly nutrition plan was successfully loaded, false otherwise.
+ */
+bool WeeklyNutritionPlan::fromCSV(std::istream& is, const std::map<std::string, FoodItem>& items)
+{
+    std::string line;
+    if (std::getline(is, line))
+    {
+        std::istringstream ss(line);
+        if (std::getline(ss, name, ','))
+        {
+            dailyPlans.clear();
+            for (const auto& day : DAYS_OF_WEEK)
+            {
+                NutritionPlan plan;
+                plan.name = day;
+                for (const auto& mealName : MEAL_NAMES)
+                {
+                    plan.getNewNutritionPlan(ss, items, mealName);
+                }
+                dailyPlans[day] = plan;
+            }
+            return true;
+        }
+    }
+    return false;
+}
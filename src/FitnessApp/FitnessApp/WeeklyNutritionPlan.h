@@ -0,0 +1,51 @@
+#ifndef WEEKLY_NUTRITION_PLAN_H
+#define WEEKLY_NUTRITION_PLAN_H
+
+#include <string>
+#include <map>
+#include "NutritionPlan.h"
+#include "FoodItem.h"
+
+/**
+ * @brief Represents seven coordinated daily nutrition plans, one for each day of the week.
+ */
+class WeeklyNutritionPlan
+{
+public:
+    std::string name; ///< The name of the weekly nutrition plan.
+    std::map<std::string, NutritionPlan> dailyPlans; ///< Day of the week to the nutrition plan of that day.
+
+    /**
+     * @brief Default constructor for WeeklyNutritionPlan.
+     */
+    WeeklyNutritionPlan() = default;
+
+    /**
+     * @brief Parameterized constructor for WeeklyNutritionPlan.
+     * @param name The name of the weekly nutrition plan.
+     * @param dailyPlans A map of days of the week to their nutrition plans.
+     */
+    WeeklyNutritionPlan(std::string name, std::map<std::string, NutritionPlan> dailyPlans)
+        : name(std::move(name)), dailyPlans(std::move(dailyPlans))
+    {
+    }
+
+    /**
+     * @brief Converts the weekly nutrition plan to CSV format and writes it to the given output stream.
+     *
+     * The plan is written as a single line: the name followed by the meals of every day of the week.
+     *
+     * @param os The output stream to write the CSV data to.
+     */
+    void toCSV(std::ostream& os) const;
+
+    /**
+     * @brief Loads the weekly nutrition plan from CSV format from the given input stream.
+     * @param is The input stream to read the CSV data from.
+     * @param items A map of available food items to look up by name.
+     * @return True if the weekly nutrition plan was successfully loaded, false otherwise.
+     */
+    bool fromCSV(std::istream& is, const std::map<std::string, FoodItem>& items);
+};
+
+#endif // WEEKLY_NUTRITION_PLAN_H
@@ -0,0 +1,428 @@
+#include "WorkoutGenerator.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    /**
+     * @brief Counts the set bits of a mask.
+     * @param mask The mask.
+     * @return The number of set bits.
+     */
+    int countBits(unsigned mask)
+    {
+        int count = 0;
+        for (; mask != 0; mask &= mask - 1)
+        {
+            ++count;
+        }
+        return count;
+    }
+}
+
+/**
+ * @brief Builds the candidate tables from the exercise catalog.
+ *
+ * Exercises without a type or without default sets and repetitions, such as placeholders,
+ * are left out.
+ *
+ * @param exerciseMap The exercise catalog.
+ * @param settings The limits and rules of the generation.
+ */
+WorkoutGenerator::WorkoutGenerator(const std::map<std::string, Exercise>& exerciseMap, Settings settings) : settings(std::move(settings))
+{
+    std::map<std::string, std::vector<Candidate>> byGroup;
+    for (const auto& pair : exerciseMap)
+    {
+        const Exercise& exercise = pair.second;
+        if (exercise.type == Exercise::ExerciseType::UNKNOWN || exercise.sets <= 0 || exercise.repetitions <= 0)
+        {
+            continue;
+        }
+        byGroup[exercise.muscleGroup].push_back({ ExerciseIdTable::intern(pair.first), exercise.type, exercise.sets, exercise.repetitions });
+    }
+
+    for (auto& pair : byGroup)
+    {
+        muscleGroups.push_back(pair.first);
+        candidates.push_back(std::move(pair.second));
+    }
+}
+
+/**
+ * @brief Gets the muscle groups a plan type trains.
+ * @param type The plan type.
+ * @return The muscle groups that have exercises in the catalog.
+ */
+std::vector<std::string> WorkoutGenerator::muscleGroupsFor(WorkoutPlan::PlanType type) const
+{
+    std::set<std::string> wanted;
+    switch (type)
+    {
+    case WorkoutPlan::PlanType::PUSH:
+        wanted = settings.pushGroups;
+        break;
+    case WorkoutPlan::PlanType::PULL:
+        wanted = settings.pullGroups;
+        break;
+    case WorkoutPlan::PlanType::LEGS:
+        wanted = { "legs", "core" };
+        break;
+    case WorkoutPlan::PlanType::CONDITIONING:
+        wanted = { "full body", "core", "legs" };
+        break;
+    default:
+        wanted.insert(muscleGroups.begin(), muscleGroups.end());
+        wanted.erase("full body");
+        break;
+    }
+
+    std::vector<std::string> groups;
+    for (const auto& group : muscleGroups)
+    {
+        if (wanted.count(group) > 0)
+        {
+            groups.push_back(group);
+        }
+    }
+    return groups;
+}
+
+/**
+ * @brief Generates a plan.
+ * @param request What to generate.
+ * @param result Receives the plan and how well it meets the targets.
+ * @return False if the catalog has no exercises for the plan type.
+ */
+bool WorkoutGenerator::generate(const Request& request, Result& result) const
+{
+    std::vector<std::string> groups = muscleGroupsFor(request.type);
+    if (groups.empty())
+    {
+        return false;
+    }
+
+    Search search;
+    search.trainingDays = spreadDays(std::clamp(request.trainingDays, 1, 7));
+    search.dayLoad.assign(search.trainingDays.size(), 0);
+    search.sessionCapacity = std::max(1, static_cast<int>(request.sessionMinutes / settings.minutesPerSet));
+
+    for (const auto& group : groups)
+    {
+        GroupSlot slot;
+        slot.group = static_cast<size_t>(std::lower_bound(muscleGroups.begin(), muscleGroups.end(), group) - muscleGroups.begin());
+        auto overrideIt = request.weeklySetsOverrides.find(group);
+        slot.target = std::max(0, overrideIt != request.weeklySetsOverrides.end() ? overrideIt->second : request.weeklySets);
+        slot.side = settings.pushGroups.count(group) > 0 ? 1 : (settings.pullGroups.count(group) > 0 ? -1 : 0);
+        search.slots.push_back(slot);
+    }
+
+    // When the sessions cannot hold every target, all targets shrink by the same factor, so
+    // the search shares the available sets between the muscle groups instead of dropping some.
+    // Shrunk targets are rounded down to whole sessions on Settings::minFrequency days.
+    const int step = std::max(1, std::min(settings.minFrequency, static_cast<int>(search.trainingDays.size())));
+    int totalTarget = 0;
+    for (const auto& slot : search.slots)
+    {
+        totalTarget += slot.target;
+    }
+    const int totalCapacity = search.sessionCapacity * static_cast<int>(search.trainingDays.size());
+    std::vector<int> requested;
+    for (auto& slot : search.slots)
+    {
+        requested.push_back(slot.target);
+        if (totalTarget > totalCapacity)
+        {
+            slot.target = slot.target * totalCapacity / totalTarget / step * step;
+        }
+    }
+
+    // Muscle groups with the most sets are the hardest to place, so they are assigned first
+    std::map<size_t, int> requestedSets;
+    for (size_t index = 0; index < search.slots.size(); ++index)
+    {
+        requestedSets[search.slots[index].group] = requested[index];
+    }
+    std::stable_sort(search.slots.begin(), search.slots.end(), [](const GroupSlot& a, const GroupSlot& b) { return a.target > b.target; });
+    assign(search, 0);
+
+    std::map<std::string, std::vector<WorkoutPlan::ExerciseDetails>> weeklyPlan;
+    for (const auto& day : DAYS_OF_WEEK)
+    {
+        weeklyPlan[day];
+    }
+
+    const std::vector<Exercise::ExerciseType> preferred = preferredTypes(request.type);
+    result.plannedSets.clear();
+    result.shortfalls.clear();
+    for (const auto& slot : search.best)
+    {
+        size_t session = 0;
+        for (size_t day = 0; day < search.trainingDays.size(); ++day)
+        {
+            if (slot.dayMask & (1u << day))
+            {
+                auto& exercises = weeklyPlan[DAYS_OF_WEEK[search.trainingDays[day]]];
+                fillSession(slot.group, slot.setsPerSession, session++, preferred, exercises);
+            }
+        }
+
+        int planned = countBits(slot.dayMask) * slot.setsPerSession;
+        result.plannedSets[muscleGroups[slot.group]] = planned;
+        if (planned < requestedSets[slot.group])
+        {
+            result.shortfalls.push_back(muscleGroups[slot.group]);
+        }
+    }
+
+    result.plan = WorkoutPlan(request.name, request.type, weeklyPlan);
+    result.searchNodes = search.nodes;
+    return true;
+}
+
+/**
+ * @brief Assigns training days to the muscle groups from a slot on, recursively.
+ *
+ * Each muscle group first tries to be trained on at least Settings::minFrequency days, then
+ * on fewer days, and finally not at all, so a complete assignment always exists. Complete
+ * assignments are scored by the sets they meet of every target, with a bonus for each muscle
+ * group trained often enough, and the search stops at the first one meeting everything.
+ *
+ * @param search The search state.
+ * @param slot The slot to assign.
+ * @return True once an assignment meeting every target has been found or the search budget is spent.
+ */
+bool WorkoutGenerator::assign(Search& search, size_t slot) const
+{
+    if (++search.nodes > settings.maxSearchNodes && search.bestScore >= 0)
+    {
+        return true;
+    }
+
+    if (slot == search.slots.size())
+    {
+        int pushSets = 0, pullSets = 0, score = 0, perfect = 0;
+        for (const auto& assigned : search.slots)
+        {
+            int planned = countBits(assigned.dayMask) * assigned.setsPerSession;
+            pushSets += assigned.side > 0 ? planned : 0;
+            pullSets += assigned.side < 0 ? planned : 0;
+            score += 10 * std::min(planned, assigned.target) + (countBits(assigned.dayMask) >= settings.minFrequency ? 1 : 0);
+            perfect += 10 * assigned.target + 1;
+        }
+
+        if (pushSets > 0 && pullSets > 0
+            && (pushSets > settings.maxPushPullRatio * pullSets || pullSets > settings.maxPushPullRatio * pushSets))
+        {
+            return false;
+        }
+        if (score > search.bestScore)
+        {
+            search.bestScore = score;
+            search.best = search.slots;
+        }
+        return score == perfect;
+    }
+
+    GroupSlot& current = search.slots[slot];
+    const int dayCount = static_cast<int>(search.trainingDays.size());
+    int needed = (current.target + settings.maxSetsPerSession - 1) / settings.maxSetsPerSession;
+    int preferredDays = std::min(dayCount, std::max(needed, settings.minFrequency));
+
+    for (int days = preferredDays; days >= 0; --days)
+    {
+        if (days == 0)
+        {
+            current.dayMask = 0;
+            current.setsPerSession = 0;
+            if (assign(search, slot + 1))
+            {
+                return true;
+            }
+            continue;
+        }
+
+        int perSession = std::min(settings.maxSetsPerSession, (current.target + days - 1) / days);
+        if (perSession <= 0)
+        {
+            continue;
+        }
+
+        // Try the least loaded days first, so sessions stay similar in length
+        std::vector<std::pair<int, unsigned>> masks;
+        for (unsigned mask = 1; mask < (1u << dayCount); ++mask)
+        {
+            if (countBits(mask) != days || !isSpread(search, mask))
+            {
+                continue;
+            }
+            int load = 0;
+            bool fits = true;
+            for (int day = 0; day < dayCount; ++day)
+            {
+                if (mask & (1u << day))
+                {
+                    load += search.dayLoad[day];
+                    fits = fits && search.dayLoad[day] + perSession <= search.sessionCapacity;
+                }
+            }
+            if (fits)
+            {
+                masks.push_back({ load, mask });
+            }
+        }
+        std::stable_sort(masks.begin(), masks.end(), [](const std::pair<int, unsigned>& a, const std::pair<int, unsigned>& b) { return a.first < b.first; });
+
+        for (const auto& candidate : masks)
+        {
+            current.dayMask = candidate.second;
+            current.setsPerSession = perSession;
+            for (int day = 0; day < dayCount; ++day)
+            {
+                search.dayLoad[day] += (candidate.second & (1u << day)) ? perSession : 0;
+            }
+
+            bool done = assign(search, slot + 1);
+
+            for (int day = 0; day < dayCount; ++day)
+            {
+                search.dayLoad[day] -= (candidate.second & (1u << day)) ? perSession : 0;
+            }
+            if (done)
+            {
+                return true;
+            }
+        }
+    }
+
+    current.dayMask = 0;
+    current.setsPerSession = 0;
+    return false;
+}
+
+/**
+ * @brief Checks whether a set of training days has no two consecutive weekdays.
+ *
+ * The week repeats, so Sunday and Monday count as consecutive.
+ *
+ * @param search The search state.
+ * @param mask The chosen training days as bits of the training day list.
+ * @return True if no two chosen days follow each other.
+ */
+bool WorkoutGenerator::isSpread(const Search& search, unsigned mask) const
+{
+    unsigned weekdays = 0;
+    for (size_t day = 0; day < search.trainingDays.size(); ++day)
+    {
+        if (mask & (1u << day))
+        {
+            weekdays |= 1u << search.trainingDays[day];
+        }
+    }
+
+    unsigned rotated = ((weekdays << 1) | (weekdays >> 6)) & 0x7F;
+    return countBits(weekdays) < 2 || (weekdays & rotated) == 0;
+}
+
+/**
+ * @brief Fills the sets of one muscle group on one day with exercises.
+ *
+ * Exercises of the preferred types come first; which of them starts the session rotates with
+ * each session of the muscle group. Each exercise keeps its default repetitions and gets its
+ * default sets, or what is left of the session's sets.
+ *
+ * @param group Index into muscleGroups.
+ * @param sets The sets to fill.
+ * @param rotation Offset into the candidates, so consecutive sessions use different exercises.
+ * @param preferred The exercise types that suit the plan type, best first.
+ * @param exercises Receives the exercises.
+ */
+void WorkoutGenerator::fillSession(size_t group, int sets, size_t rotation, const std::vector<Exercise::ExerciseType>& preferred,
+    std::vector<WorkoutPlan::ExerciseDetails>& exercises) const
+{
+    if (sets <= 0)
+    {
+        return;
+    }
+
+    auto rank = [&preferred](const Candidate& candidate)
+        {
+            return static_cast<size_t>(std::find(preferred.begin(), preferred.end(), candidate.type) - preferred.begin());
+        };
+
+    std::vector<const Candidate*> order;
+    for (const auto& candidate : candidates[group])
+    {
+        order.push_back(&candidate);
+    }
+    std::stable_sort(order.begin(), order.end(), [&rank](const Candidate* a, const Candidate* b) { return rank(*a) < rank(*b); });
+
+    size_t preferredCount = static_cast<size_t>(std::count_if(order.begin(), order.end(), [&](const Candidate* candidate) { return rank(*candidate) < preferred.size(); }));
+    if (preferredCount == 0)
+    {
+        preferredCount = order.size();
+    }
+    std::rotate(order.begin(), order.begin() + (rotation * 2) % preferredCount, order.begin() + preferredCount);
+
+    size_t first = exercises.size();
+    int remaining = sets;
+    for (const Candidate* candidate : order)
+    {
+        if (remaining <= 0)
+        {
+            break;
+        }
+        WorkoutPlan::ExerciseDetails details;
+        details.exerciseId = candidate->id;
+        details.sets = static_cast<std::uint16_t>(std::min(candidate->sets, remaining));
+        details.reps = static_cast<std::uint16_t>(candidate->reps);
+        exercises.push_back(details);
+        remaining -= details.sets;
+    }
+
+    // Too few exercises for the sets: add the rest to the exercises of this session
+    size_t index = first;
+    while (remaining > 0 && first < exercises.size())
+    {
+        ++exercises[index].sets;
+        --remaining;
+        index = index + 1 < exercises.size() ? index + 1 : first;
+    }
+}
+
+/**
+ * @brief Gets the exercise types that suit a plan type.
+ * @param type The plan type.
+ * @return The exercise types, best first.
+ */
+std::vector<Exercise::ExerciseType> WorkoutGenerator::preferredTypes(WorkoutPlan::PlanType type)
+{
+    using Type = Exercise::ExerciseType;
+    switch (type)
+    {
+    case WorkoutPlan::PlanType::STRENGTH:
+        return { Type::STRENGTH, Type::POWER, Type::HYPERTROPHY };
+    case WorkoutPlan::PlanType::POWER:
+        return { Type::POWER, Type::STRENGTH, Type::ANAEROBIC };
+    case WorkoutPlan::PlanType::CONDITIONING:
+        return { Type::ENDURANCE, Type::AEROBIC, Type::ANAEROBIC, Type::FUNCTIONAL };
+    default:
+        return { Type::HYPERTROPHY, Type::STRENGTH };
+    }
+}
+
+/**
+ * @brief Spreads training days over the week as evenly as possible.
+ * @param count The number of training days.
+ * @return The weekday indices, 0 being Monday.
+ */
+std::vector<int> WorkoutGenerator::spreadDays(int count)
+{
+    std::vector<int> days;
+    for (int day = 0; day < count; ++day)
+    {
+        days.push_back(day * 7 / count);
+    }
+    return days;
+}
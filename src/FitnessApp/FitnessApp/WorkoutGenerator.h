@@ -0,0 +1,173 @@
+#ifndef WORKOUT_GENERATOR_H
+#define WORKOUT_GENERATOR_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "Exercise.h"
+#include "ExerciseIdTable.h"
+#include "WorkoutPlan.h"
+
+/**
+ * @brief Builds a weekly workout plan from the exercise catalog.
+ *
+ * Generation runs in two steps. A backtracking search first decides on which training days
+ * each muscle group is worked and with how many sets, under these constraints:
+ * - a muscle group is never trained on two consecutive days, including Sunday to Monday;
+ * - no session has more sets than fit into the session length;
+ * - the weekly sets of push and pull muscle groups stay within a ratio of each other.
+ * The sessions are then filled with exercises of each muscle group, preferring the exercise
+ * types that suit the plan type and rotating through them from day to day.
+ *
+ * The catalog is reduced to per-muscle-group candidate tables when the generator is built,
+ * so the search itself works on indices only.
+ */
+class WorkoutGenerator
+{
+public:
+    /**
+     * @brief Limits and rules of the generation.
+     */
+    struct Settings
+    {
+        float minutesPerSet = 3.0f; ///< Time of a set including rest.
+        int maxSetsPerSession = 10; ///< Most sets of one muscle group in one session.
+        int minFrequency = 2; ///< Preferred number of days per week each muscle group is trained.
+        float maxPushPullRatio = 1.5f; ///< Largest ratio between the weekly sets of push and pull muscle groups.
+        size_t maxSearchNodes = 200000; ///< Search steps after which the best assignment found so far is used.
+        std::set<std::string> pushGroups = { "chest", "shoulders", "triceps" }; ///< Muscle groups worked by pushing.
+        std::set<std::string> pullGroups = { "back", "biceps" }; ///< Muscle groups worked by pulling.
+    };
+
+    /**
+     * @brief What to generate.
+     */
+    struct Request
+    {
+        std::string name; ///< Name of the plan.
+        WorkoutPlan::PlanType type = WorkoutPlan::PlanType::STRENGTH; ///< Type of the plan.
+        int trainingDays = 3; ///< Training days per week, 1 to 7.
+        int sessionMinutes = 60; ///< Length of a session.
+        int weeklySets = 12; ///< Target weekly sets of every muscle group of the plan type.
+        std::map<std::string, int> weeklySetsOverrides; ///< Target weekly sets of particular muscle groups.
+    };
+
+    /**
+     * @brief Outcome of a generation.
+     */
+    struct Result
+    {
+        WorkoutPlan plan; ///< The generated plan.
+        std::map<std::string, int> plannedSets; ///< Weekly sets given to each muscle group.
+        std::vector<std::string> shortfalls; ///< Muscle groups whose target could not be met.
+        size_t searchNodes = 0; ///< Search steps taken.
+    };
+
+    /**
+     * @brief Builds the candidate tables from the exercise catalog.
+     * @param exerciseMap The exercise catalog.
+     * @param settings The limits and rules of the generation.
+     */
+    WorkoutGenerator(const std::map<std::string, Exercise>& exerciseMap, Settings settings);
+
+    /**
+     * @brief Gets the muscle groups a plan type trains.
+     * @param type The plan type.
+     * @return The muscle groups that have exercises in the catalog.
+     */
+    std::vector<std::string> muscleGroupsFor(WorkoutPlan::PlanType type) const;
+
+    /**
+     * @brief Generates a plan.
+     * @param request What to generate.
+     * @param result Receives the plan and how well it meets the targets.
+     * @return False if the catalog has no exercises for the plan type.
+     */
+    bool generate(const Request& request, Result& result) const;
+
+private:
+    /**
+     * @brief An exercise usable by the generator.
+     */
+    struct Candidate
+    {
+        ExerciseId id; ///< Id of the exercise name.
+        Exercise::ExerciseType type; ///< Type of the exercise.
+        int sets; ///< Default sets of the exercise.
+        int reps; ///< Default repetitions of the exercise.
+    };
+
+    /**
+     * @brief Assignment of one muscle group during the search.
+     */
+    struct GroupSlot
+    {
+        size_t group; ///< Index into muscleGroups.
+        int target; ///< Target weekly sets.
+        int side; ///< 1 for push, -1 for pull, 0 otherwise.
+        unsigned dayMask = 0; ///< Chosen training days as bits of the training day list.
+        int setsPerSession = 0; ///< Sets on each chosen day.
+    };
+
+    /**
+     * @brief State of the backtracking search.
+     */
+    struct Search
+    {
+        std::vector<GroupSlot> slots; ///< Muscle groups in search order.
+        std::vector<int> trainingDays; ///< Weekday indices of the training days, 0 being Monday.
+        std::vector<int> dayLoad; ///< Sets planned on each training day.
+        int sessionCapacity = 0; ///< Most sets that fit into a session.
+        size_t nodes = 0; ///< Search steps taken.
+        int bestScore = -1; ///< Score of the best complete assignment.
+        std::vector<GroupSlot> best; ///< Best complete assignment.
+    };
+
+    /**
+     * @brief Assigns training days to the muscle groups from a slot on, recursively.
+     * @param search The search state.
+     * @param slot The slot to assign.
+     * @return True once an assignment meeting every target has been found or the search budget is spent.
+     */
+    bool assign(Search& search, size_t slot) const;
+
+    /**
+     * @brief Checks whether a set of training days has no two consecutive weekdays.
+     * @param search The search state.
+     * @param mask The chosen training days as bits of the training day list.
+     * @return True if no two chosen days follow each other.
+     */
+    bool isSpread(const Search& search, unsigned mask) const;
+
+    /**
+     * @brief Fills the sets of one muscle group on one day with exercises.
+     * @param group Index into muscleGroups.
+     * @param sets The sets to fill.
+     * @param rotation Offset into the candidates, so consecutive sessions use different exercises.
+     * @param preferred The exercise types that suit the plan type, best first.
+     * @param exercises Receives the exercises.
+     */
+    void fillSession(size_t group, int sets, size_t rotation, const std::vector<Exercise::ExerciseType>& preferred,
+        std::vector<WorkoutPlan::ExerciseDetails>& exercises) const;
+
+    /**
+     * @brief Gets the exercise types that suit a plan type.
+     * @param type The plan type.
+     * @return The exercise types, best first.
+     */
+    static std::vector<Exercise::ExerciseType> preferredTypes(WorkoutPlan::PlanType type);
+
+    /**
+     * @brief Spreads training days over the week as evenly as possible.
+     * @param count The number of training days.
+     * @return The weekday indices, 0 being Monday.
+     */
+    static std::vector<int> spreadDays(int count);
+
+    Settings settings; ///< The limits and rules of the generation.
+    std::vector<std::string> muscleGroups; ///< Muscle groups with usable exercises, sorted by name.
+    std::vector<std::vector<Candidate>> candidates; ///< Usable exercises of every muscle group, sorted by name.
+};
+
+#endif // WORKOUT_GENERATOR_H
@@ -0,0 +1,602 @@
+#include "WorkoutLog.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+
+namespace
+{
+    const std::uint32_t BLOCK_MAGIC = 0x424C4B57; ///< Marks the start of a block, "WKLB" in the file.
+    const std::uint32_t INDEX_MAGIC = 0x494C4B57; ///< Marks the start of the index file, "WKLI" in the file.
+
+    /**
+     * @brief Header of a block, as stored before its columns.
+     */
+    struct BlockHeader
+    {
+        std::uint32_t size = 0; ///< Size of the whole block in bytes.
+        std::int32_t firstDay = 0; ///< Earliest day in the block.
+        std::int32_t lastDay = 0; ///< Latest day in the block.
+        std::uint32_t count = 0; ///< Number of sets in the block.
+        std::vector<std::string> names; ///< Exercise names the exercise column refers to.
+    };
+
+    /**
+     * @brief Writes a value in its in-memory representation.
+     * @param os The stream to write to.
+     * @param value The value.
+     */
+    template<typename T>
+    void writeValue(std::ostream& os, const T& value)
+    {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /**
+     * @brief Reads a value written by writeValue.
+     * @param is The stream to read from.
+     * @param value Receives the value.
+     * @return False if the stream ended.
+     */
+    template<typename T>
+    bool readValue(std::istream& is, T& value)
+    {
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    /**
+     * @brief Writes a column of values.
+     * @param os The stream to write to.
+     * @param column The values.
+     */
+    template<typename T>
+    void writeColumn(std::ostream& os, const std::vector<T>& column)
+    {
+        os.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+    }
+
+    /**
+     * @brief Reads a column written by writeColumn.
+     * @param is The stream to read from.
+     * @param count The number of values.
+     * @param column Receives the values.
+     * @return False if the stream ended.
+     */
+    template<typename T>
+    bool readColumn(std::istream& is, size_t count, std::vector<T>& column)
+    {
+        column.resize(count);
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(column.data()), static_cast<std::streamsize>(count * sizeof(T))));
+    }
+
+    /**
+     * @brief Reads a block header, leaving the stream at the first column.
+     * @param is The stream to read from, at the start of a block.
+     * @param header Receives the header.
+     * @return False if the header is damaged or the stream ended.
+     */
+    bool readBlockHeader(std::istream& is, BlockHeader& header)
+    {
+        std::uint32_t magic = 0;
+        std::uint16_t nameCount = 0;
+        if (!readValue(is, magic) || magic != BLOCK_MAGIC || !readValue(is, header.size) || !readValue(is, header.firstDay)
+            || !readValue(is, header.lastDay) || !readValue(is, header.count) || !readValue(is, nameCount))
+        {
+            return false;
+        }
+
+        header.names.resize(nameCount);
+        for (auto& name : header.names)
+        {
+            std::uint16_t length = 0;
+            if (!readValue(is, length))
+            {
+                return false;
+            }
+            name.resize(length);
+            if (!is.read(name.data(), length))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Converts a calendar date to days since 1970-01-01.
+     * @param year The year.
+     * @param month The month, 1 to 12.
+     * @param dayOfMonth The day of the month, 1 to 31.
+     * @return The number of days.
+     */
+    std::int32_t daysFromCivil(int year, int month, int dayOfMonth)
+    {
+        year -= month <= 2 ? 1 : 0;
+        const int era = (year >= 0 ? year : year - 399) / 400;
+        const int yearOfEra = year - era * 400;
+        const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + dayOfMonth - 1;
+        const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    /**
+     * @brief Converts days since 1970-01-01 to a calendar date.
+     * @param days The number of days.
+     * @param year Receives the year.
+     * @param month Receives the month, 1 to 12.
+     * @param dayOfMonth Receives the day of the month, 1 to 31.
+     */
+    void civilFromDays(std::int32_t days, int& year, int& month, int& dayOfMonth)
+    {
+        days += 719468;
+        const int era = (days >= 0 ? days : days - 146096) / 146097;
+        const int dayOfEra = days - era * 146097;
+        const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const int shiftedMonth = (5 * dayOfYear + 2) / 153;
+        dayOfMonth = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+        month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+        year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+    }
+
+    /**
+     * @brief Gets the calendar month of a date, as a key that orders months.
+     * @param day The date in days since 1970-01-01.
+     * @return The year times 12 plus the month.
+     */
+    int monthKey(std::int32_t day)
+    {
+        int year, month, dayOfMonth;
+        civilFromDays(day, year, month, dayOfMonth);
+        return year * 12 + month;
+    }
+}
+
+/**
+ * @brief Constructs a log over the given files, without reading them.
+ * @param dataFile The file holding the blocks.
+ * @param indexFile The file holding the block index.
+ */
+WorkoutLog::WorkoutLog(std::string dataFile, std::string indexFile) : dataFile(std::move(dataFile)), indexFile(std::move(indexFile))
+{
+}
+
+/**
+ * @brief Loads the block index, rebuilding it if needed.
+ *
+ * The index is trusted if its blocks end exactly where the log file ends. Otherwise, for
+ * example after an append that was interrupted before the index was written, it is rebuilt.
+ *
+ * @return False if the log file is damaged and could not be repaired; a missing log is an empty one.
+ */
+bool WorkoutLog::open()
+{
+    blocks.clear();
+    aggregates = Aggregates();
+    aggregated = false;
+
+    std::ifstream data(dataFile, std::ios::binary | std::ios::ate);
+    if (!data.is_open())
+    {
+        return true;
+    }
+    const std::uint64_t dataSize = static_cast<std::uint64_t>(data.tellg());
+
+    std::ifstream index(indexFile, std::ios::binary);
+    std::uint32_t magic = 0;
+    if (index.is_open() && readValue(index, magic) && magic == INDEX_MAGIC)
+    {
+        BlockEntry entry;
+        while (readValue(index, entry.firstDay) && readValue(index, entry.lastDay) && readValue(index, entry.offset)
+            && readValue(index, entry.size) && readValue(index, entry.count))
+        {
+            blocks.push_back(entry);
+        }
+    }
+
+    std::uint64_t indexedSize = blocks.empty() ? 0 : blocks.back().offset + blocks.back().size;
+    if (indexedSize == dataSize)
+    {
+        return true;
+    }
+    return rebuildIndex();
+}
+
+/**
+ * @brief Rebuilds the block index from the block headers of the log file.
+ *
+ * Only the headers are read; the columns are skipped using the block sizes. A damaged or
+ * partial tail, left by an interrupted append, is reported and cut off at the end of the last
+ * good block, so the next append starts where the index says the log ends.
+ *
+ * @return False if the damaged tail could not be cut off or the index could not be written.
+ */
+bool WorkoutLog::rebuildIndex()
+{
+    blocks.clear();
+    std::ifstream data(dataFile, std::ios::binary | std::ios::ate);
+    const std::uint64_t dataSize = static_cast<std::uint64_t>(data.tellg());
+    data.seekg(0);
+
+    std::uint64_t offset = 0;
+    bool damaged = false;
+    while (offset < dataSize)
+    {
+        BlockHeader header;
+        if (!readBlockHeader(data, header) || header.size == 0 || offset + header.size > dataSize)
+        {
+            damaged = true;
+            break;
+        }
+        blocks.push_back({ header.firstDay, header.lastDay, offset, header.size, header.count });
+        offset += header.size;
+        data.seekg(static_cast<std::streamoff>(offset));
+    }
+
+    if (damaged)
+    {
+        std::cerr << "The workout log " << dataFile << " is damaged after " << blocks.size() << " block(s); the rest is discarded.\n";
+        data.close();
+        std::error_code error;
+        std::filesystem::resize_file(dataFile, offset, error);
+        if (error)
+        {
+            std::cerr << "Unable to truncate file: " << dataFile << std::endl;
+            return false;
+        }
+    }
+
+    std::ofstream index(indexFile, std::ios::binary | std::ios::trunc);
+    if (!index.is_open())
+    {
+        std::cerr << "Unable to open file for writing: " << indexFile << std::endl;
+        return false;
+    }
+    writeValue(index, INDEX_MAGIC);
+    for (const auto& entry : blocks)
+    {
+        writeValue(index, entry.firstDay);
+        writeValue(index, entry.lastDay);
+        writeValue(index, entry.offset);
+        writeValue(index, entry.size);
+        writeValue(index, entry.count);
+    }
+    return true;
+}
+
+/**
+ * @brief Appends sets to the log.
+ *
+ * The sets are written as one block per calendar month at the end of the indexed blocks, and
+ * the block entries are appended to the index after the blocks, so an interrupted append is
+ * repaired by the next open().
+ *
+ * @param sets The sets, in any order.
+ * @return False if the files could not be written.
+ */
+bool WorkoutLog::append(std::vector<SetRecord> sets)
+{
+    if (sets.empty())
+    {
+        return true;
+    }
+    std::stable_sort(sets.begin(), sets.end(), [](const SetRecord& a, const SetRecord& b) { return a.day < b.day; });
+
+    // fstream only opens existing files for reading and writing
+    std::ofstream(dataFile, std::ios::binary | std::ios::app).close();
+    std::fstream data(dataFile, std::ios::in | std::ios::out | std::ios::binary);
+    if (!data.is_open())
+    {
+        std::cerr << "Unable to open file for writing: " << dataFile << std::endl;
+        return false;
+    }
+
+    std::uint64_t offset = blocks.empty() ? 0 : blocks.back().offset + blocks.back().size;
+    data.seekp(static_cast<std::streamoff>(offset));
+    std::vector<BlockEntry> written;
+    for (size_t start = 0; start < sets.size();)
+    {
+        size_t end = start;
+        while (end < sets.size() && monthKey(sets[end].day) == monthKey(sets[start].day))
+        {
+            ++end;
+        }
+
+        std::map<ExerciseId, std::uint16_t> localIndex;
+        std::vector<std::string> names;
+        std::vector<std::uint8_t> dayOffsets;
+        std::vector<std::uint16_t> exercises, reps;
+        std::vector<float> loads;
+        const std::int32_t firstDay = sets[start].day;
+        for (size_t i = start; i < end; ++i)
+        {
+            auto inserted = localIndex.emplace(sets[i].exerciseId, static_cast<std::uint16_t>(names.size()));
+            if (inserted.second)
+            {
+                names.push_back(ExerciseIdTable::name(sets[i].exerciseId));
+            }
+            dayOffsets.push_back(static_cast<std::uint8_t>(sets[i].day - firstDay));
+            exercises.push_back(inserted.first->second);
+            reps.push_back(sets[i].reps);
+            loads.push_back(sets[i].load);
+        }
+
+        const std::uint32_t count = static_cast<std::uint32_t>(end - start);
+        std::uint32_t size = 4 + 4 + 4 + 4 + 4 + 2;
+        for (const auto& name : names)
+        {
+            size += 2 + static_cast<std::uint32_t>(name.size());
+        }
+        size += count * (1 + 2 + 2 + 4);
+
+        writeValue(data, BLOCK_MAGIC);
+        writeValue(data, size);
+        writeValue(data, firstDay);
+        writeValue(data, sets[end - 1].day);
+        writeValue(data, count);
+        writeValue(data, static_cast<std::uint16_t>(names.size()));
+        for (const auto& name : names)
+        {
+            writeValue(data, static_cast<std::uint16_t>(name.size()));
+            data.write(name.data(), static_cast<std::streamsize>(name.size()));
+        }
+        writeColumn(data, dayOffsets);
+        writeColumn(data, exercises);
+        writeColumn(data, reps);
+        writeColumn(data, loads);
+
+        written.push_back({ firstDay, sets[end - 1].day, offset, size, count });
+        offset += size;
+        start = end;
+    }
+    data.close();
+    if (!data)
+    {
+        std::cerr << "Unable to write the workout log " << dataFile << std::endl;
+        return false;
+    }
+
+    bool newIndex = blocks.empty();
+    std::ofstream index(indexFile, std::ios::binary | (newIndex ? std::ios::trunc : std::ios::app));
+    if (!index.is_open())
+    {
+        std::cerr << "Unable to open file for writing: " << indexFile << std::endl;
+        return false;
+    }
+    if (newIndex)
+    {
+        writeValue(index, INDEX_MAGIC);
+    }
+    for (const auto& entry : written)
+    {
+        writeValue(index, entry.firstDay);
+        writeValue(index, entry.lastDay);
+        writeValue(index, entry.offset);
+        writeValue(index, entry.size);
+        writeValue(index, entry.count);
+        blocks.push_back(entry);
+    }
+
+    if (aggregated)
+    {
+        for (const auto& set : sets)
+        {
+            aggregate(set);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the sets within a date range.
+ *
+ * Blocks outside the range are not read at all, and blocks without the exercise asked for
+ * are skipped after their header.
+ *
+ * @param firstDay The first day of the range.
+ * @param lastDay The last day of the range.
+ * @param exercise The exercise name to read, or an empty string for all.
+ * @param sets Receives the sets, by date.
+ * @return The number of blocks read.
+ */
+size_t WorkoutLog::scan(std::int32_t firstDay, std::int32_t lastDay, const std::string& exercise, std::vector<SetRecord>& sets) const
+{
+    sets.clear();
+    std::ifstream data(dataFile, std::ios::binary);
+    if (!data.is_open())
+    {
+        return 0;
+    }
+
+    size_t blocksRead = 0;
+    std::vector<std::uint8_t> dayOffsets;
+    std::vector<std::uint16_t> exercises, reps;
+    std::vector<float> loads;
+    for (const auto& entry : blocks)
+    {
+        if (entry.lastDay < firstDay || entry.firstDay > lastDay)
+        {
+            continue;
+        }
+
+        data.seekg(static_cast<std::streamoff>(entry.offset));
+        BlockHeader header;
+        if (!readBlockHeader(data, header))
+        {
+            std::cerr << "Skipping a damaged block of the workout log " << dataFile << "\n";
+            data.clear();
+            continue;
+        }
+        ++blocksRead;
+
+        size_t wanted = header.names.size();
+        if (!exercise.empty())
+        {
+            wanted = static_cast<size_t>(std::find(header.names.begin(), header.names.end(), exercise) - header.names.begin());
+            if (wanted == header.names.size())
+            {
+                continue;
+            }
+        }
+
+        if (!readColumn(data, header.count, dayOffsets) || !readColumn(data, header.count, exercises)
+            || !readColumn(data, header.count, reps) || !readColumn(data, header.count, loads))
+        {
+            std::cerr << "Skipping a damaged block of the workout log " << dataFile << "\n";
+            data.clear();
+            continue;
+        }
+
+        std::vector<ExerciseId> ids;
+        for (const auto& name : header.names)
+        {
+            ids.push_back(ExerciseIdTable::intern(name));
+        }
+        for (size_t i = 0; i < header.count; ++i)
+        {
+            std::int32_t day = header.firstDay + dayOffsets[i];
+            if (day < firstDay || day > lastDay || exercises[i] >= ids.size() || (wanted != header.names.size() && exercises[i] != wanted))
+            {
+                continue;
+            }
+            sets.push_back({ day, ids[exercises[i]], reps[i], loads[i] });
+        }
+    }
+
+    std::stable_sort(sets.begin(), sets.end(), [](const SetRecord& a, const SetRecord& b) { return a.day < b.day; });
+    return blocksRead;
+}
+
+/**
+ * @brief Gets the number of blocks in the log.
+ * @return The number of blocks.
+ */
+size_t WorkoutLog::getBlockCount() const
+{
+    return blocks.size();
+}
+
+/**
+ * @brief Gets the aggregates, computing them from the whole log on first use.
+ * @return The aggregates.
+ */
+const WorkoutLog::Aggregates& WorkoutLog::getAggregates()
+{
+    if (!aggregated)
+    {
+        std::vector<SetRecord> sets;
+        scan(std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max(), "", sets);
+        for (const auto& set : sets)
+        {
+            aggregate(set);
+        }
+        aggregated = true;
+    }
+    return aggregates;
+}
+
+/**
+ * @brief Adds a set to the aggregates.
+ *
+ * Both aggregates are updated in constant time, so appending never rescans the log.
+ *
+ * @param set The set.
+ */
+void WorkoutLog::aggregate(const SetRecord& set)
+{
+    if (set.exerciseId >= aggregates.bestEstimatedMax.size())
+    {
+        aggregates.bestEstimatedMax.resize(set.exerciseId + 1, 0.0f);
+    }
+    float& best = aggregates.bestEstimatedMax[set.exerciseId];
+    best = std::max(best, estimateMax(set.load, set.reps));
+    aggregates.weeklyTonnage[weekStart(set.day)] += static_cast<double>(set.reps) * set.load;
+}
+
+/**
+ * @brief Estimates the one-repetition maximum of a set with the Epley formula.
+ * @param load The load lifted.
+ * @param reps The repetitions performed.
+ * @return The estimated maximum; the load itself for a single repetition.
+ */
+float WorkoutLog::estimateMax(float load, int reps)
+{
+    if (reps <= 0)
+    {
+        return 0.0f;
+    }
+    return reps == 1 ? load : load * (1.0f + reps / 30.0f);
+}
+
+/**
+ * @brief Parses a date of the form YYYY-MM-DD.
+ * @param text The date.
+ * @param day Receives the date in days since 1970-01-01.
+ * @return False if the text is not a valid date.
+ */
+bool WorkoutLog::parseDate(const std::string& text, std::int32_t& day)
+{
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-')
+    {
+        return false;
+    }
+
+    int year = 0, month = 0, dayOfMonth = 0;
+    const char* begin = text.data();
+    if (std::from_chars(begin, begin + 4, year).ptr != begin + 4
+        || std::from_chars(begin + 5, begin + 7, month).ptr != begin + 7
+        || std::from_chars(begin + 8, begin + 10, dayOfMonth).ptr != begin + 10
+        || month < 1 || month > 12 || dayOfMonth < 1 || dayOfMonth > 31)
+    {
+        return false;
+    }
+
+    // Dates such as February 30 come back as a different date
+    std::int32_t days = daysFromCivil(year, month, dayOfMonth);
+    int checkYear, checkMonth, checkDay;
+    civilFromDays(days, checkYear, checkMonth, checkDay);
+    if (checkYear != year || checkMonth != month || checkDay != dayOfMonth)
+    {
+        return false;
+    }
+    day = days;
+    return true;
+}
+
+/**
+ * @brief Formats a date as YYYY-MM-DD.
+ * @param day The date in days since 1970-01-01.
+ * @return The formatted date.
+ */
+std::string WorkoutLog::formatDate(std::int32_t day)
+{
+    int year, month, dayOfMonth;
+    civilFromDays(day, year, month, dayOfMonth);
+    char buffer[36]; // Room for three full ints, so nothing is ever cut off
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, dayOfMonth);
+    return buffer;
+}
+
+/**
+ * @brief Gets the current date.
+ * @return The date in days since 1970-01-01, in UTC.
+ */
+std::int32_t WorkoutLog::today()
+{
+    return static_cast<std::int32_t>(std::time(nullptr) / 86400);
+}
+
+/**
+ * @brief Gets the Monday starting the week of a date.
+ * @param day The date in days since 1970-01-01, which was a Thursday.
+ * @return The Monday in days since 1970-01-01.
+ */
+std::int32_t WorkoutLog::weekStart(std::int32_t day)
+{
+    return day - ((day + 3) % 7 + 7) % 7;
+}
@@ -0,0 +1,159 @@
+#ifndef WORKOUT_LOG_H
+#define WORKOUT_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ExerciseIdTable.h"
+
+/**
+ * @brief Append-only history of the sets actually performed.
+ *
+ * The log is a binary file of blocks. Every append writes one block per calendar month it
+ * touches, so a block never spans two months. A block starts with a header holding its date
+ * range and the names of the exercises in it, followed by one column per field:
+ * day offsets, exercise indices into the names, repetitions and loads.
+ *
+ * A small index file keeps the date range, offset and size of every block. A range scan reads
+ * the index, seeks to the blocks overlapping the range, and skips blocks whose names do not
+ * include the exercise asked for after reading their header only. The index is rebuilt from
+ * the block headers if it is missing or does not match the log.
+ *
+ * The aggregates, estimated one-repetition maximum per exercise and tonnage per week, are
+ * computed from the whole history once, on first use, and then updated with every new set.
+ */
+class WorkoutLog
+{
+public:
+    /**
+     * @brief One performed set.
+     */
+    struct SetRecord
+    {
+        std::int32_t day = 0; ///< Date of the set, in days since 1970-01-01.
+        ExerciseId exerciseId = 0; ///< Id of the exercise name in the ExerciseIdTable.
+        std::uint16_t reps = 0; ///< Repetitions performed.
+        float load = 0.0f; ///< Load lifted, in kg.
+    };
+
+    /**
+     * @brief Totals kept up to date with every appended set.
+     */
+    struct Aggregates
+    {
+        std::vector<float> bestEstimatedMax; ///< Best estimated one-repetition maximum, indexed by ExerciseId.
+        std::unordered_map<std::int32_t, double> weeklyTonnage; ///< Repetitions times load, by the first day of the week.
+    };
+
+    /**
+     * @brief Constructs a log over the given files, without reading them.
+     * @param dataFile The file holding the blocks.
+     * @param indexFile The file holding the block index.
+     */
+    WorkoutLog(std::string dataFile, std::string indexFile);
+
+    /**
+     * @brief Loads the block index, rebuilding it if needed.
+     * @return False if the log file is damaged and could not be repaired; a missing log is an empty one.
+     */
+    bool open();
+
+    /**
+     * @brief Appends sets to the log.
+     * @param sets The sets, in any order.
+     * @return False if the files could not be written.
+     */
+    bool append(std::vector<SetRecord> sets);
+
+    /**
+     * @brief Reads the sets within a date range.
+     * @param firstDay The first day of the range.
+     * @param lastDay The last day of the range.
+     * @param exercise The exercise name to read, or an empty string for all.
+     * @param sets Receives the sets, by date.
+     * @return The number of blocks read.
+     */
+    size_t scan(std::int32_t firstDay, std::int32_t lastDay, const std::string& exercise, std::vector<SetRecord>& sets) const;
+
+    /**
+     * @brief Gets the number of blocks in the log.
+     * @return The number of blocks.
+     */
+    size_t getBlockCount() const;
+
+    /**
+     * @brief Gets the aggregates, computing them from the whole log on first use.
+     * @return The aggregates.
+     */
+    const Aggregates& getAggregates();
+
+    /**
+     * @brief Estimates the one-repetition maximum of a set with the Epley formula.
+     * @param load The load lifted.
+     * @param reps The repetitions performed.
+     * @return The estimated maximum.
+     */
+    static float estimateMax(float load, int reps);
+
+    /**
+     * @brief Parses a date of the form YYYY-MM-DD.
+     * @param text The date.
+     * @param day Receives the date in days since 1970-01-01.
+     * @return False if the text is not a valid date.
+     */
+    static bool parseDate(const std::string& text, std::int32_t& day);
+
+    /**
+     * @brief Formats a date as YYYY-MM-DD.
+     * @param day The date in days since 1970-01-01.
+     * @return The formatted date.
+     */
+    static std::string formatDate(std::int32_t day);
+
+    /**
+     * @brief Gets the current date.
+     * @return The date in days since 1970-01-01.
+     */
+    static std::int32_t today();
+
+    /**
+     * @brief Gets the Monday starting the week of a date.
+     * @param day The date in days since 1970-01-01.
+     * @return The Monday in days since 1970-01-01.
+     */
+    static std::int32_t weekStart(std::int32_t day);
+
+private:
+    /**
+     * @brief Position and date range of one block.
+     */
+    struct BlockEntry
+    {
+        std::int32_t firstDay; ///< Earliest day in the block.
+        std::int32_t lastDay; ///< Latest day in the block.
+        std::uint64_t offset; ///< Position of the block in the log file.
+        std::uint32_t size; ///< Size of the block in bytes.
+        std::uint32_t count; ///< Number of sets in the block.
+    };
+
+    /**
+     * @brief Rebuilds the block index from the block headers of the log file.
+     * @return False if the damaged tail could not be cut off or the index could not be written.
+     */
+    bool rebuildIndex();
+
+    /**
+     * @brief Adds a set to the aggregates.
+     * @param set The set.
+     */
+    void aggregate(const SetRecord& set);
+
+    std::string dataFile; ///< The file holding the blocks.
+    std::string indexFile; ///< The file holding the block index.
+    std::vector<BlockEntry> blocks; ///< The block index, in file order.
+    Aggregates aggregates; ///< Totals of the whole log, valid once aggregated is set.
+    bool aggregated = false; ///< Whether the aggregates have been computed.
+};
+
+#endif // WORKOUT_LOG_H
@@ -0,0 +1,38 @@
+#include "WorkoutLogView.h"
+#include "Utils.h"
+#include <iostream>
+
+/**
+ * @brief Constructs a new WorkoutLogView object.
+ * @param vm The WorkoutLogViewModel to be used by this view.
+ */
+WorkoutLogView::WorkoutLogView(WorkoutLogViewModel& vm) : viewModel(vm)
+{
+    menuOptions = {
+        {"View Logged Sets", [this]() { printLabel("Viewing Logged Sets"); viewModel.view(); }},
+        {"Log Workout Session", [this]() { printLabel("Logging Workout Session"); viewModel.add(); }},
+        {"View Progress", [this]() { printLabel("Viewing Progress"); viewModel.viewProgress(); }},
+        {"Import Sets from File", [this]() { importFromFile(); }},
+        {"Back", [this]() { return; }}
+    };
+}
+
+/**
+ * @brief Displays the workout log view menu and handles user interaction.
+ */
+void WorkoutLogView::display()
+{
+    viewModel.reload();
+    displayAndHandleSubMenu("Workout Log", menuOptions, true);
+}
+
+/**
+ * @brief Prompts the user to enter a filename and imports logged sets from the specified file.
+ */
+void WorkoutLogView::importFromFile()
+{
+    std::string filename;
+    std::cout << "Enter the filename to import sets from: ";
+    std::getline(std::cin >> std::ws, filename);
+    viewModel.importFromFile(filename);
+}
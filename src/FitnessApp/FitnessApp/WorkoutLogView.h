@@ -0,0 +1,35 @@
+#ifndef WORKOUT_LOG_VIEW_H
+#define WORKOUT_LOG_VIEW_H
+
+#include "WorkoutLogViewModel.h"
+#include "View.h"
+
+/**
+ * @brief The WorkoutLogView class represents the view for the workout log.
+ * It provides a user interface for logging sessions and reviewing the logged sets and progress.
+ */
+class WorkoutLogView : public View
+{
+public:
+    /**
+     * @brief Constructs a new WorkoutLogView object.
+     * @param vm The WorkoutLogViewModel to be used by this view.
+     */
+    WorkoutLogView(WorkoutLogViewModel& vm);
+
+    /**
+     * @brief Displays the workout log view menu and handles user interaction.
+     */
+    void display();
+
+private:
+    WorkoutLogViewModel& viewModel; ///< Reference to the view model for the workout log.
+    std::vector<MenuOption> menuOptions; ///< List of menu options for user interaction.
+
+    /**
+     * @brief Prompts the user to enter a filename and imports logged sets from the specified file.
+     */
+    void importFromFile();
+};
+
+#endif // WORKOUT_LOG_VIEW_H
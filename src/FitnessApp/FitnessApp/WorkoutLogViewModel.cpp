@@ -0,0 +1,286 @@
+#include "WorkoutLogViewModel.h"
+#include "Utils.h"
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @brief Construct a new Workout Log ViewModel object
+ *
+ * @param file The filename of the workout log; its index is kept next to it
+ */
+WorkoutLogViewModel::WorkoutLogViewModel(const std::string& file) : workoutLog(file, file + ".idx")
+{
+    reload();
+}
+
+/**
+ * @brief Display the logged sets of a date range, optionally of one exercise
+ */
+void WorkoutLogViewModel::view()
+{
+    if (workoutLog.getBlockCount() == 0)
+    {
+        std::cout << "No workout sessions logged.\n";
+        return;
+    }
+
+    std::string exercise;
+    std::cout << "Enter exercise name (or press enter for all exercises): ";
+    std::getline(std::cin, exercise);
+    std::int32_t today = WorkoutLog::today();
+    std::int32_t firstDay = getDateInput("Enter first date (YYYY-MM-DD, or press enter for 30 days ago): ", today - 30);
+    std::int32_t lastDay = getDateInput("Enter last date (YYYY-MM-DD, or press enter for today): ", today);
+
+    std::vector<WorkoutLog::SetRecord> sets;
+    size_t blocksRead = workoutLog.scan(firstDay, lastDay, exercise, sets);
+
+    double tonnage = 0.0;
+    std::int32_t shownDay = firstDay - 1;
+    for (const auto& set : sets)
+    {
+        if (set.day != shownDay)
+        {
+            std::cout << WorkoutLog::formatDate(set.day) << ":\n";
+            shownDay = set.day;
+        }
+        std::cout << "  " << ExerciseIdTable::name(set.exerciseId) << " - " << set.reps << " x " << set.load << " kg\n";
+        tonnage += static_cast<double>(set.reps) * set.load;
+    }
+
+    std::cout << sets.size() << " set(s), " << tonnage << " kg lifted in total. Read " << blocksRead << " of "
+        << workoutLog.getBlockCount() << " block(s) of the log.\n";
+}
+
+/**
+ * @brief Log the sets of a workout session
+ *
+ * Exercises are entered one at a time, with the number of sets and the reps and load of
+ * each set, until an empty name is entered.
+ */
+void WorkoutLogViewModel::add()
+{
+    std::int32_t day = getDateInput("Enter session date (YYYY-MM-DD, or press enter for today): ", WorkoutLog::today());
+
+    std::vector<WorkoutLog::SetRecord> sets;
+    while (true)
+    {
+        std::string name;
+        std::cout << "Enter exercise name (or press enter to finish): ";
+        std::getline(std::cin, name);
+        if (name.empty())
+        {
+            break;
+        }
+        if (exerciseMap.find(name) == exerciseMap.end())
+        {
+            std::cout << "Exercise '" << name << "' is not in the exercise list.\n";
+            continue;
+        }
+
+        int setCount = 0;
+        getValidInput(setCount, "Enter number of sets: ", 1, 50);
+        for (int set = 1; set <= setCount; ++set)
+        {
+            int reps = 0;
+            float load = 0.0f;
+            std::cout << "Set " << set << ":\n";
+            getValidInput(reps, "  Enter reps: ", 0, 1000);
+            do
+            {
+                getValidInput(load, "  Enter load in kg: ");
+            } while (load < 0);
+            sets.push_back({ day, ExerciseIdTable::intern(name), static_cast<std::uint16_t>(reps), load });
+        }
+    }
+
+    if (sets.empty())
+    {
+        std::cout << "No sets logged.\n";
+        return;
+    }
+    appendAndReport(sets);
+}
+
+/**
+ * @brief Explain that logged sets cannot be modified
+ */
+void WorkoutLogViewModel::modify()
+{
+    std::cout << "The workout log only grows; log a new session to record what changed.\n";
+}
+
+/**
+ * @brief Explain that logged sets cannot be removed
+ */
+void WorkoutLogViewModel::remove()
+{
+    std::cout << "The workout log only grows; logged sets cannot be deleted.\n";
+}
+
+/**
+ * @brief Import sets from a CSV file of date, exercise, reps and load lines
+ *
+ * Lines that cannot be read, and sets of exercises missing from the exercise list, are
+ * reported and skipped, as add() does.
+ *
+ * @param filename The name of the CSV file to import sets from
+ */
+void WorkoutLogViewModel::importFromFile(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Unable to open file for reading: " << filename << std::endl;
+        return;
+    }
+
+    std::vector<WorkoutLog::SetRecord> sets;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        std::stringstream ss(line);
+        std::string date, name, repsStr, loadStr;
+        std::int32_t day = 0;
+        int reps = 0;
+        float load = 0.0f;
+        if (!std::getline(ss, date, ',') || !std::getline(ss, name, ',') || !std::getline(ss, repsStr, ',') || !std::getline(ss, loadStr, ',')
+            || !WorkoutLog::parseDate(date, day) || !stringToInt(repsStr, reps) || reps < 0 || reps > 65535 || !stringToFloat(loadStr, load) || load < 0)
+        {
+            std::cerr << "Skipping line " << lineNumber << " of " << filename << ": " << line << "\n";
+            continue;
+        }
+        if (exerciseMap.find(name) == exerciseMap.end())
+        {
+            std::cerr << "Skipping line " << lineNumber << " of " << filename << ": exercise '" << name << "' is not in the exercise list\n";
+            continue;
+        }
+        sets.push_back({ day, ExerciseIdTable::intern(name), static_cast<std::uint16_t>(reps), load });
+    }
+
+    appendAndReport(sets);
+}
+
+/**
+ * @brief Reload the exercises and the workout log index
+ */
+void WorkoutLogViewModel::reload()
+{
+    exerciseMap = readFromCSV<Exercise>("exercises.csv");
+    logOpen = workoutLog.open();
+    if (!logOpen)
+    {
+        std::cerr << "Unable to open the workout log; no sets can be logged until it is repaired.\n";
+    }
+}
+
+/**
+ * @brief Display the estimated one-repetition maximum of every exercise and the recent weekly tonnage
+ */
+void WorkoutLogViewModel::viewProgress()
+{
+    if (workoutLog.getBlockCount() == 0)
+    {
+        std::cout << "No workout sessions logged.\n";
+        return;
+    }
+
+    const WorkoutLog::Aggregates& aggregates = workoutLog.getAggregates();
+
+    std::vector<std::pair<float, ExerciseId>> maxima;
+    for (ExerciseId id = 0; id < aggregates.bestEstimatedMax.size(); ++id)
+    {
+        if (aggregates.bestEstimatedMax[id] > 0)
+        {
+            maxima.push_back({ aggregates.bestEstimatedMax[id], id });
+        }
+    }
+    std::sort(maxima.begin(), maxima.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::cout << "Best estimated one-repetition maximum:\n";
+    for (const auto& pair : maxima)
+    {
+        std::cout << "  " << ExerciseIdTable::name(pair.second) << ": " << pair.first << " kg\n";
+    }
+
+    int weeks;
+    getValidInput(weeks, "Enter number of recent weeks to show the tonnage of: ", 1, 520);
+    std::cout << "Weekly tonnage:\n";
+    std::int32_t week = WorkoutLog::weekStart(WorkoutLog::today());
+    for (int i = 0; i < weeks; ++i, week -= 7)
+    {
+        auto it = aggregates.weeklyTonnage.find(week);
+        std::cout << "  Week of " << WorkoutLog::formatDate(week) << ": " << (it != aggregates.weeklyTonnage.end() ? it->second : 0.0) << " kg\n";
+    }
+}
+
+/**
+ * @brief Ask for a date
+ *
+ * @param prompt The prompt message
+ * @param fallback The date used when the user presses enter
+ * @return std::int32_t The date in days since 1970-01-01
+ */
+std::int32_t WorkoutLogViewModel::getDateInput(const std::string& prompt, std::int32_t fallback) const
+{
+    while (true)
+    {
+        std::string input;
+        std::cout << prompt;
+        std::getline(std::cin, input);
+        if (input.empty())
+        {
+            return fallback;
+        }
+
+        std::int32_t day;
+        if (WorkoutLog::parseDate(input, day))
+        {
+            return day;
+        }
+        std::cout << "Invalid date. ";
+    }
+}
+
+/**
+ * @brief Append sets to the log and report the exercises whose estimated maximum improved
+ *
+ * @param sets The sets to append
+ */
+void WorkoutLogViewModel::appendAndReport(const std::vector<WorkoutLog::SetRecord>& sets)
+{
+    if (sets.empty())
+    {
+        std::cout << "No sets to log.\n";
+        return;
+    }
+    if (!logOpen)
+    {
+        std::cout << "The workout log could not be opened, so no sets were logged.\n";
+        return;
+    }
+
+    std::vector<float> before = workoutLog.getAggregates().bestEstimatedMax;
+    if (!workoutLog.append(sets))
+    {
+        return;
+    }
+    std::cout << sets.size() << " set(s) logged.\n";
+
+    const std::vector<float>& after = workoutLog.getAggregates().bestEstimatedMax;
+    for (ExerciseId id = 0; id < after.size(); ++id)
+    {
+        float previous = id < before.size() ? before[id] : 0.0f;
+        if (after[id] > previous && previous > 0)
+        {
+            std::cout << "New best estimated one-repetition maximum for " << ExerciseIdTable::name(id) << ": " << after[id] << " kg\n";
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef WORKOUTLOGVIEWMODEL_H
+#define WORKOUTLOGVIEWMODEL_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include "Exercise.h"
+#include "WorkoutLog.h"
+#include "ViewModel.h"
+
+class WorkoutLogViewModel : public ViewModel
+{
+public:
+    /**
+     * @brief Construct a new WorkoutLogViewModel object
+     *
+     * @param file The filename of the workout log; its index is kept next to it
+     */
+    WorkoutLogViewModel(const std::string& file);
+
+    /**
+     * @brief Display the logged sets of a date range, optionally of one exercise
+     */
+    void view() override;
+
+    /**
+     * @brief Log the sets of a workout session
+     */
+    void add() override;
+
+    /**
+     * @brief Explain that logged sets cannot be modified
+     */
+    void modify() override;
+
+    /**
+     * @brief Explain that logged sets cannot be removed
+     */
+    void remove() override;
+
+    /**
+     * @brief Import sets from a CSV file of date, exercise, reps and load lines
+     *
+     * @param filename The name of the CSV file to import sets from
+     */
+    void importFromFile(const std::string& filename) override;
+
+    /**
+     * @brief Reload the exercises and the workout log index
+     */
+    void reload() override;
+
+    /**
+     * @brief Display the estimated one-repetition maximum of every exercise and the recent weekly tonnage
+     */
+    void viewProgress();
+
+private:
+    WorkoutLog workoutLog;  ///< The logged sets
+    bool logOpen = false;  ///< Whether the workout log was opened, so sets may be appended
+    std::map<std::string, Exercise> exerciseMap;  ///< The map of exercises
+
+    /**
+     * @brief Ask for a date
+     *
+     * @param prompt The prompt message
+     * @param fallback The date used when the user presses enter
+     * @return std::int32_t The date in days since 1970-01-01
+     */
+    std::int32_t getDateInput(const std::string& prompt, std::int32_t fallback) const;
+
+    /**
+     * @brief Append sets to the log and report the exercises whose estimated maximum improved
+     *
+     * @param sets The sets to append
+     */
+    void appendAndReport(const std::vector<WorkoutLog::SetRecord>& sets);
+};
+
+#endif // WORKOUTLOGVIEWMODEL_H
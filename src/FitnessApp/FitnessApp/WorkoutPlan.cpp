@@ -1,7 +1,23 @@
 #include "WorkoutPlan.h"
+#include <algorithm>
+#include <charconv>
 #include <sstream>
 #include "Utils.h"
 
+/**
+ * @brief Parse an entry of the form name=SETSxREPS without copying the name.
+ *
+ * @param text The entry.
+ * @param ed The ExerciseDetails object to read into.
+ * @return true if the entry was well-formed, false otherwise.
+ */
+bool WorkoutPlan::ExerciseDetails::parse(std::string_view text, ExerciseDetails& ed)
+{
+    size_t position = 0;
+    ParseError error;
+    return parseEntry(text, position, ed, error) == EntryStatus::PARSED && position == text.size();
+}
+
 /**
  * @brief Constructs a new WorkoutPlan object.
  *
@@ -70,34 +86,248 @@ WorkoutPlan::PlanType WorkoutPlan::stringToPlanType(const std::string& str)
     return PlanType::STRENGTH; // Default
 }
 
+/**
+ * @brief Parses the exercises of a day, in the format name=SETSxREPS;name=SETSxREPS;...
+ *
+ * Names are interned straight from the text, so only the exercise list and the error list may
+ * allocate. Malformed entries are reported and skipped; blank entries are ignored.
+ *
+ * @param text The exercises of the day.
+ * @param exercises Receives the well-formed entries, appended in order.
+ * @param errors Receives one error per malformed entry.
+ * @return true if every entry was well-formed, false otherwise.
+ */
+bool WorkoutPlan::parseDay(std::string_view text, std::vector<ExerciseDetails>& exercises, std::vector<ParseError>& errors)
+{
+    bool wellFormed = true;
+    size_t position = 0;
+    while (true)
+    {
+        ExerciseDetails details;
+        ParseError error;
+        switch (parseEntry(text, position, details, error))
+        {
+        case EntryStatus::PARSED:
+            exercises.push_back(details);
+            break;
+        case EntryStatus::MALFORMED:
+            errors.push_back(error);
+            wellFormed = false;
+            break;
+        case EntryStatus::BLANK:
+            break;
+        }
+
+        if (position >= text.size())
+        {
+            return wellFormed;
+        }
+        ++position; // Past the ';'
+    }
+}
+
+/**
+ * @brief Parses one entry of a day, up to the next ';' or the end of the text.
+ *
+ * The ';' and the '=' are found with memchr-backed searches, then the counts are read by a
+ * state machine: the sets up to 'x', then the reps. Blanks are allowed around each count.
+ *
+ * @param text The exercises of the day.
+ * @param position The position of the entry; receives the position of its ';' or the end of the text.
+ * @param ed Receives the entry if it is well-formed.
+ * @param error Receives the reason if it is malformed.
+ * @return Whether the entry was well-formed, blank or malformed.
+ */
+WorkoutPlan::EntryStatus WorkoutPlan::parseEntry(std::string_view text, size_t& position, ExerciseDetails& ed, ParseError& error)
+{
+    const size_t start = position;
+    const size_t end = std::min(text.find(';', start), text.size());
+    position = end;
+
+    const std::string_view entry = text.substr(start, end - start);
+    const size_t equals = start + std::min(entry.find('='), entry.size());
+    const bool blankName = text.substr(start, equals - start).find_first_not_of(" \t\r") == std::string_view::npos;
+    if (equals == end)
+    {
+        if (blankName)
+        {
+            return EntryStatus::BLANK;
+        }
+        error = { end, start, end, "'=' after the exercise name" };
+        return EntryStatus::MALFORMED;
+    }
+    if (blankName)
+    {
+        error = { equals, start, end, "an exercise name" };
+        return EntryStatus::MALFORMED;
+    }
+
+    enum class State
+    {
+        SETS,     // Up to 'x' or a blank
+        TIMES,    // Blanks before 'x'
+        REPS,     // Up to the end or a blank
+        TRAILING, // Blanks after the reps
+    };
+
+    State state = State::SETS;
+    bool digits = false;
+    std::uint32_t value = 0;
+    std::uint16_t sets = 0;
+    const char* reason = nullptr;
+    size_t offset = equals + 1;
+
+    for (; offset < end && reason == nullptr; ++offset)
+    {
+        const char c = text[offset];
+        const bool isBlank = c == ' ' || c == '\t' || c == '\r';
+        switch (state)
+        {
+        case State::SETS:
+        case State::REPS:
+            if (c >= '0' && c <= '9')
+            {
+                value = value * 10 + static_cast<std::uint32_t>(c - '0');
+                digits = true;
+                if (value > static_cast<std::uint32_t>(ExerciseDetails::MAX_COUNT))
+                {
+                    reason = "a count of at most 65535";
+                }
+            }
+            else if (isBlank && !digits)
+            {
+                // Blanks before the count
+            }
+            else if (!digits)
+            {
+                reason = state == State::SETS ? "the number of sets" : "the number of reps";
+            }
+            else if (state == State::SETS)
+            {
+                sets = static_cast<std::uint16_t>(value);
+                if (c == 'x')
+                {
+                    value = 0;
+                    digits = false;
+                    state = State::REPS;
+                }
+                else if (isBlank)
+                {
+                    state = State::TIMES;
+                }
+                else
+                {
+                    reason = "'x' after the sets";
+                }
+            }
+            else if (isBlank)
+            {
+                state = State::TRAILING;
+            }
+            else
+            {
+                reason = "';' after the reps";
+            }
+            break;
+
+        case State::TIMES:
+            if (c == 'x')
+            {
+                value = 0;
+                digits = false;
+                state = State::REPS;
+            }
+            else if (!isBlank)
+            {
+                reason = "'x' after the sets";
+            }
+            break;
+
+        case State::TRAILING:
+            if (!isBlank)
+            {
+                reason = "';' after the reps";
+            }
+            break;
+        }
+    }
+
+    if (reason != nullptr)
+    {
+        --offset; // The loop stepped past the offending character
+    }
+    else if (state == State::SETS || state == State::TIMES)
+    {
+        reason = digits ? "'x' after the sets" : "the number of sets";
+    }
+    else if (state == State::REPS && !digits)
+    {
+        reason = "the number of reps";
+    }
+
+    if (reason != nullptr)
+    {
+        error = { offset, start, end, reason };
+        return EntryStatus::MALFORMED;
+    }
+
+    ed.exerciseId = ExerciseIdTable::intern(text.substr(start, equals - start));
+    ed.sets = sets;
+    ed.reps = static_cast<std::uint16_t>(value);
+    return EntryStatus::PARSED;
+}
+
+/**
+ * @brief Appends the exercises of a day in the format read by parseDay.
+ *
+ * @param out The string to append to.
+ * @param exercises The exercises of the day.
+ */
+void WorkoutPlan::appendDay(std::string& out, const std::vector<ExerciseDetails>& exercises)
+{
+    char buffer[8];
+    for (size_t i = 0; i < exercises.size(); ++i)
+    {
+        const auto& exercise = exercises[i];
+        if (i > 0)
+        {
+            out += ';';
+        }
+        out += exercise.exerciseName();
+        out += '=';
+        out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), exercise.sets).ptr);
+        out += 'x';
+        out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), exercise.reps).ptr);
+    }
+}
+
 /**
  * @brief Writes the workout plan to a CSV file.
  *
+ * The line is built in one string and written at once.
+ *
  * @param file The ofstream object to write to.
  */
 void WorkoutPlan::toCSV(std::ofstream& file) const
 {
-    file << name << "," << planTypeToString(type) << ",";
+    std::string line;
+    line.reserve(256);
+    line += name;
+    line += ',';
+    line += planTypeToString(type);
+    line += ',';
 
     for (const auto& day : DAYS_OF_WEEK)
     {
         auto it = weeklyPlan.find(day);
         if (it != weeklyPlan.end())
         {
-            for (size_t i = 0; i < it->second.size(); ++i)
-            {
-                const auto& exercise = it->second[i];
-                file << exercise.exerciseName << "=" << exercise.sets << "x" << exercise.reps;
-                if (i < it->second.size() - 1)
-                {
-                    file << ";";
-                }
-            }
-
-            file << ",";
+            appendDay(line, it->second);
+            line += ',';
         }
     }
-    file << "\n";
+    line += '\n';
+    file.write(line.data(), static_cast<std::streamsize>(line.size()));
 }
 
 /**
@@ -107,28 +337,22 @@ void WorkoutPlan::toCSV(std::ofstream& file) const
  * @param dayExercises The exercises for the day in string format.
  * @param weeklyPlan The map to add the processed exercises to.
  */
-void WorkoutPlan::processExercises(const std::string& day, const std::string& dayExercises, std::map<std::string, std::vector<ExerciseDetails>>& weeklyPlan)
+void WorkoutPlan::processExercises(const std::string& day, std::string_view dayExercises, std::map<std::string, std::vector<ExerciseDetails>>& weeklyPlan)
 {
-    std::vector<ExerciseDetails> exercises;
-    if (dayExercises.empty() || dayExercises == " ")
+    std::vector<ExerciseDetails>& exercises = weeklyPlan[day];
+    exercises.clear();
+
+    std::vector<ParseError> errors;
+    if (parseDay(dayExercises, exercises, errors))
     {
-        weeklyPlan[day] = exercises;
         return;
     }
-    std::stringstream ess(dayExercises);
-    std::string exerciseDetails;
-    while (std::getline(ess, exerciseDetails, ';'))
+    for (const auto& error : errors)
     {
-        if (exerciseDetails.empty()) continue; // Skip empty entries
-        ExerciseDetails details;
-        std::string exerciseName = exerciseDetails.substr(0, exerciseDetails.find('='));
-        std::string setsReps = exerciseDetails.substr(exerciseDetails.find('=') + 1);
-        details.exerciseName = exerciseName;
-        details.sets = std::stoi(setsReps.substr(0, setsReps.find('x')));
-        details.reps = std::stoi(setsReps.substr(setsReps.find('x') + 1));
-        exercises.push_back(details);
+        std::cerr << "Skipping malformed exercise '" << dayExercises.substr(error.entryStart, error.entryEnd - error.entryStart)
+            << "' on " << day << " in workout plan " << name << ": expected " << error.reason
+            << " at character " << error.offset - error.entryStart + 1 << std::endl;
     }
-    weeklyPlan[day] = exercises;
 }
 
 /**
@@ -144,14 +368,26 @@ bool WorkoutPlan::fromCSV(std::stringstream& ss)
     {
         type = stringToPlanType(typeStr);
         weeklyPlan.clear();
-        std::string dayExercises;
+
+        // The days are parsed as views into the rest of the line
+        std::string rest;
+        std::getline(ss, rest);
+        std::string_view days(rest);
+        size_t start = 0;
 
         for (const auto& day : DAYS_OF_WEEK)
         {
-            if (std::getline(ss, dayExercises, ','))
+            if (start >= days.size())
+            {
+                break;
+            }
+            size_t end = days.find(',', start);
+            if (end == std::string_view::npos)
             {
-                processExercises(day, dayExercises, weeklyPlan);
+                end = days.size();
             }
+            processExercises(day, days.substr(start, end - start), weeklyPlan);
+            start = end + 1;
         }
 
         return true;
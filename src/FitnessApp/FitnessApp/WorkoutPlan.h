@@ -1,10 +1,13 @@
 #ifndef WORKOUT_PLAN_H
 #define WORKOUT_PLAN_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <fstream>
+#include "ExerciseIdTable.h"
 
 /**
  * @class WorkoutPlan
@@ -32,15 +35,39 @@ public:
     /**
      * @struct ExerciseDetails
      * @brief Represents details of an exercise including name, sets, and reps.
+     *
+     * The name is stored as an id of the ExerciseIdTable, so an entry takes 8 bytes.
      */
     struct ExerciseDetails
     {
-        std::string exerciseName; ///< Name of the exercise
-        int sets;                 ///< Number of sets
-        int reps;                 ///< Number of reps
+        ExerciseId exerciseId = 0; ///< Id of the exercise name in the ExerciseIdTable
+        std::uint16_t sets = 0;    ///< Number of sets
+        std::uint16_t reps = 0;    ///< Number of reps
+
+        static const int MAX_COUNT = UINT16_MAX; ///< Largest number of sets or reps an entry can hold
+
+        /**
+         * @brief Get the name of the exercise.
+         * @return The exercise name
+         */
+        const std::string& exerciseName() const
+        {
+            return ExerciseIdTable::name(exerciseId);
+        }
 
         /**
-         * @brief Overload the >> operator for ExerciseDetails to read from a stream.
+         * @brief Parse an entry of the form name=SETSxREPS without copying the name.
+         * @param text The entry
+         * @param ed The ExerciseDetails object to read into
+         * @return true if the entry was well-formed, false otherwise
+         */
+        static bool parse(std::string_view text, ExerciseDetails& ed);
+
+        /**
+         * @brief Overload the >> operator for ExerciseDetails to read one name=SETSxREPS entry from a stream.
+         *
+         * The entry ends at the next ';' or at the end of the stream; the failbit is set if it is malformed.
+         *
          * @param is The input stream
          * @param ed The ExerciseDetails object to read into
          * @return The input stream
@@ -48,16 +75,26 @@ public:
         friend std::istream& operator>>(std::istream& is, ExerciseDetails& ed)
         {
             std::string token;
-            std::getline(is, token, '-');
-            ed.exerciseName = token;
-            std::getline(is, token, 'x');
-            ed.sets = std::stoi(token);
-            std::getline(is, token);
-            ed.reps = std::stoi(token);
+            if (std::getline(is, token, ';') && !parse(token, ed))
+            {
+                is.setstate(std::ios::failbit);
+            }
             return is;
         }
     };
 
+    /**
+     * @struct ParseError
+     * @brief A malformed entry of a day, found by parseDay.
+     */
+    struct ParseError
+    {
+        size_t offset;      ///< Position in the day text where the entry stopped making sense
+        size_t entryStart;  ///< Position in the day text where the entry starts
+        size_t entryEnd;    ///< Position in the day text just past the entry
+        const char* reason; ///< What was expected at the offset
+    };
+
     /**
      * @brief Default constructor.
      */
@@ -89,6 +126,25 @@ public:
      */
     static PlanType stringToPlanType(const std::string& str);
 
+    /**
+     * @brief Parses the exercises of a day, in the format name=SETSxREPS;name=SETSxREPS;...
+     *
+     * Malformed entries are reported and skipped; blank entries are ignored.
+     *
+     * @param text The exercises of the day
+     * @param exercises Receives the well-formed entries, appended in order
+     * @param errors Receives one error per malformed entry
+     * @return true if every entry was well-formed, false otherwise
+     */
+    static bool parseDay(std::string_view text, std::vector<ExerciseDetails>& exercises, std::vector<ParseError>& errors);
+
+    /**
+     * @brief Appends the exercises of a day in the format read by parseDay.
+     * @param out The string to append to
+     * @param exercises The exercises of the day
+     */
+    static void appendDay(std::string& out, const std::vector<ExerciseDetails>& exercises);
+
     /**
      * @brief Writes the workout plan to a CSV file.
      * @param file The ofstream object to write to
@@ -103,13 +159,36 @@ public:
     bool fromCSV(std::stringstream& ss);
 
 private:
+    /**
+     * @enum EntryStatus
+     * @brief Outcome of parsing one entry of a day.
+     */
+    enum class EntryStatus
+    {
+        PARSED,    ///< The entry was well-formed
+        BLANK,     ///< The entry held only blanks
+        MALFORMED, ///< The entry was malformed
+    };
+
+    /**
+     * @brief Parses one entry of a day, up to the next ';' or the end of the text.
+     * @param text The exercises of the day
+     * @param position The position of the entry; receives the position of its ';' or the end of the text
+     * @param ed Receives the entry if it is well-formed
+     * @param error Receives the reason if it is malformed
+     * @return Whether the entry was well-formed, blank or malformed
+     */
+    static EntryStatus parseEntry(std::string_view text, size_t& position, ExerciseDetails& ed, ParseError& error);
+
     /**
      * @brief Processes exercises for a given day and adds them to the weekly plan.
      * @param day The day of the week
      * @param dayExercises The exercises for the day in string format
      * @param weeklyPlan The map to add the processed exercises to
      */
-    void processExercises(const std::string& day, const std::string& dayExercises, std::map<std::string, std::vector<ExerciseDetails>>& weeklyPlan);
+    void processExercises(const std::string& day, std::string_view dayExercises, std::map<std::string, std::vector<ExerciseDetails>>& weeklyPlan);
 };
 
+static_assert(sizeof(WorkoutPlan::ExerciseDetails) == 8, "ExerciseDetails is meant to stay packed");
+
 #endif // WORKOUT_PLAN_H
@@ -14,6 +14,7 @@ WorkoutPlanView::WorkoutPlanView(WorkoutPlanViewModel& vm) : viewModel(vm)
         {"Modify Workout Plan", [this]() { printLabel("Modifying Workout Plan"); viewModel.modify(); }},
         {"Delete Workout Plan", [this]() { printLabel("Deleting Workout Plan"); viewModel.remove(); }},
         {"Import Workout Plan from File", [this]() { importFromFile(); }},
+        {"Workout Programs", [this]() { printLabel("Workout Programs"); viewModel.managePrograms(); }},
         {"Back", [this]() { return; }}
     };
 }
@@ -3,17 +3,42 @@
 #include <iostream>
 #include <sstream>
 #include <set>
+#include <limits>
+#include <algorithm>
+#include <fstream>
 
 /**
  * @brief Construct a new Workout Plan ViewModel object
  *
  * @param file The filename to read workout plans from
  */
-WorkoutPlanViewModel::WorkoutPlanViewModel(const std::string& file) : filename(file)
+WorkoutPlanViewModel::WorkoutPlanViewModel(const std::string& file) : filename(file), programsFilename("workout_programs.csv"), similarityIndex(PlanSimilarityIndex::Settings()), volumeAnalyzer(VolumeAnalyzer::Settings()), recoveryValidator(RecoveryValidator::Settings())
 {
     reload();
 }
 
+/**
+ * @brief Checks a number of sets or repetitions of an exercise before it is stored in a plan entry.
+ *
+ * Values outside 1 to WorkoutPlan::ExerciseDetails::MAX_COUNT do not fit an entry, so the user
+ * is asked for another one.
+ *
+ * @param exerciseName The name of the exercise
+ * @param count The number of sets or repetitions
+ * @param what "sets" or "repetitions"
+ * @return std::uint16_t The count, within range
+ */
+std::uint16_t entryCount(const std::string& exerciseName, int count, const std::string& what)
+{
+    if (count < 1 || count > WorkoutPlan::ExerciseDetails::MAX_COUNT)
+    {
+        std::cout << exerciseName << " has " << count << " " << what << ", which a workout plan cannot hold.\n";
+        getValidInput(count, "Enter " + what + " (1-" + std::to_string(WorkoutPlan::ExerciseDetails::MAX_COUNT) + "): ",
+            1, WorkoutPlan::ExerciseDetails::MAX_COUNT);
+    }
+    return static_cast<std::uint16_t>(count);
+}
+
 /**
  * @brief Print view options for the workout plans
  *
@@ -24,9 +49,12 @@ int printViewOptions()
     std::cout << "View Options:\n";
     std::cout << "1. View All\n";
     std::cout << "2. View by Type\n";
-    std::cout << "3. Cancel\n";
+    std::cout << "3. View Training Volume\n";
+    std::cout << "4. Find Near-Duplicate Plans\n";
+    std::cout << "5. Check Recovery\n";
+    std::cout << "6. Cancel\n";
 
-    return 3;
+    return 6;
 }
 
 /**
@@ -45,7 +73,7 @@ void WorkoutPlanViewModel::view()
 
     getValidInput(viewChoice, "Enter choice: ", 1, count);
 
-    if (viewChoice == 3)
+    if (viewChoice == 6)
     {
         return;
     }
@@ -58,6 +86,202 @@ void WorkoutPlanViewModel::view()
     {
         displayWorkoutPlansByType();
     }
+    else if (viewChoice == 3)
+    {
+        displayTrainingVolume();
+    }
+    else if (viewChoice == 4)
+    {
+        displayNearDuplicates();
+    }
+    else if (viewChoice == 5)
+    {
+        displayRecoveryReport();
+    }
+}
+
+/**
+ * @brief Display the weekly training volume of a plan, or rank all plans by the volume of a muscle group
+ */
+void WorkoutPlanViewModel::displayTrainingVolume()
+{
+    volumeAnalyzer.analyze(workoutPlanMap, exerciseMap);
+
+    std::cout << "1. Volume of a plan\n";
+    std::cout << "2. Rank plans by muscle group\n";
+    std::cout << "3. Cancel\n";
+
+    int choice;
+    getValidInput(choice, "Enter choice: ", 1, 3);
+
+    if (choice == 1)
+    {
+        for (size_t plan = 0; plan < volumeAnalyzer.getPlanCount(); ++plan)
+        {
+            std::cout << plan + 1 << ". " << volumeAnalyzer.getPlanName(plan) << "\n";
+        }
+        int planChoice;
+        getValidInput(planChoice, "Enter the number of the workout plan: ", 1, static_cast<int>(volumeAnalyzer.getPlanCount()));
+        printWindowSizedSeparator();
+        volumeAnalyzer.printReport(std::cout, planChoice - 1);
+        printWindowSizedSeparator();
+    }
+    else if (choice == 2)
+    {
+        const auto& muscleGroups = volumeAnalyzer.getMuscleGroups();
+        for (size_t muscle = 0; muscle < muscleGroups.size(); ++muscle)
+        {
+            std::cout << muscle + 1 << ". " << muscleGroups[muscle] << "\n";
+        }
+        int muscleChoice;
+        getValidInput(muscleChoice, "Enter the number of the muscle group: ", 1, static_cast<int>(muscleGroups.size()));
+        size_t muscle = muscleChoice - 1;
+
+        float minSets = 0;
+        float maxSets = std::numeric_limits<float>::max();
+        getOptionalInput(minSets, "Enter the minimum weekly sets (or press enter for no minimum): ");
+        getOptionalInput(maxSets, "Enter the maximum weekly sets (or press enter for no maximum): ");
+
+        std::vector<bool> inRange(volumeAnalyzer.getPlanCount(), false);
+        for (size_t plan : volumeAnalyzer.filterBySets(muscle, minSets, maxSets))
+        {
+            inRange[plan] = true;
+        }
+
+        printWindowSizedSeparator();
+        std::cout << "Workout plans by weekly sets for " << muscleGroups[muscle] << ":\n";
+        int rank = 1;
+        for (size_t plan : volumeAnalyzer.rankBySets(muscle))
+        {
+            if (!inRange[plan])
+            {
+                continue;
+            }
+            std::cout << rank++ << ". " << volumeAnalyzer.getPlanName(plan) << ": " << volumeAnalyzer.getSets(plan, muscle) << " sets, "
+                << volumeAnalyzer.getFrequency(plan, muscle) << " day(s)";
+            std::string findings = VolumeAnalyzer::describeFlags(volumeAnalyzer.getFlags(plan, muscle));
+            if (!findings.empty())
+            {
+                std::cout << " - " << findings;
+            }
+            std::cout << "\n";
+        }
+        if (rank == 1)
+        {
+            std::cout << "No workout plans in this range.\n";
+        }
+        printWindowSizedSeparator();
+    }
+}
+
+/**
+ * @brief Display the recovery conflicts of every workout plan
+ */
+void WorkoutPlanViewModel::displayRecoveryReport() const
+{
+    printWindowSizedSeparator();
+    recoveryValidator.printReport(std::cout, workoutPlanMap);
+    printWindowSizedSeparator();
+}
+
+/**
+ * @brief Display the clusters of near-duplicate plans and offer to merge each into one plan
+ *
+ * Merging keeps one plan of the cluster and deletes the others; the differences of every
+ * other plan from the kept one are shown first, so entries worth keeping can be added to it.
+ */
+void WorkoutPlanViewModel::displayNearDuplicates()
+{
+    auto clusters = similarityIndex.clusters();
+    if (clusters.empty())
+    {
+        std::cout << "No near-duplicate workout plans found.\n";
+        return;
+    }
+
+    for (size_t cluster = 0; cluster < clusters.size(); ++cluster)
+    {
+        const auto& planNames = clusters[cluster];
+        printWindowSizedSeparator();
+        std::cout << "Cluster " << cluster + 1 << " of " << clusters.size() << ":\n";
+        for (size_t plan = 0; plan < planNames.size(); ++plan)
+        {
+            std::cout << plan + 1 << ". " << planNames[plan] << "\n";
+        }
+        std::cout << planNames.size() + 1 << ". Keep all\n";
+
+        int keepChoice;
+        getValidInput(keepChoice, "Enter the number of the plan to keep: ", 1, static_cast<int>(planNames.size() + 1));
+        if (keepChoice == static_cast<int>(planNames.size() + 1))
+        {
+            continue;
+        }
+
+        const std::string keptName = planNames[keepChoice - 1];
+        const WorkoutPlan& kept = workoutPlanMap[keptName];
+        for (const auto& planName : planNames)
+        {
+            if (planName == keptName)
+            {
+                continue;
+            }
+            const WorkoutPlan& other = workoutPlanMap[planName];
+            std::cout << "'" << planName << "' is " << static_cast<int>(PlanSimilarityIndex::similarity(kept, other) * 100)
+                << "% similar; to match it, '" << keptName << "' would need:\n";
+            for (const auto& line : PlanSimilarityIndex::describeDifferences(kept, other))
+            {
+                std::cout << "  " << line << "\n";
+            }
+        }
+
+        std::string mergeChoice;
+        do
+        {
+            std::cout << "Delete every plan of the cluster except '" << keptName << "'? (yes/no): ";
+            std::getline(std::cin >> std::ws, mergeChoice);
+        } while (mergeChoice != "yes" && mergeChoice != "no");
+        if (mergeChoice == "no")
+        {
+            continue;
+        }
+
+        for (const auto& planName : planNames)
+        {
+            if (planName == keptName)
+            {
+                continue;
+            }
+            exerciseUsage.removePlan(planName, workoutPlanMap[planName]);
+            similarityIndex.removePlan(planName);
+            workoutPlanMap.erase(planName);
+        }
+        overwriteCSV(filename, workoutPlanMap);
+        std::cout << "Merged " << planNames.size() << " workout plans into '" << keptName << "'.\n";
+    }
+    printWindowSizedSeparator();
+}
+
+/**
+ * @brief Print the near-duplicates of a plan in the library
+ *
+ * @param plan The plan to look up
+ * @param ignoredName A plan to leave out, usually the plan itself
+ * @return true if near-duplicates were found, false otherwise
+ */
+bool WorkoutPlanViewModel::reportNearDuplicates(const WorkoutPlan& plan, const std::string& ignoredName) const
+{
+    auto matches = similarityIndex.findSimilar(plan, ignoredName);
+    if (matches.empty())
+    {
+        return false;
+    }
+
+    std::cout << "Workout plan '" << plan.name << "' is a near-duplicate of:\n";
+    for (const auto& match : matches)
+    {
+        std::cout << "  " << match.plan << " (" << static_cast<int>(match.similarity * 100) << "% similar)\n";
+    }
+    return true;
 }
 
 /**
@@ -125,7 +349,12 @@ void WorkoutPlanViewModel::displayWorkoutPlan(const WorkoutPlan& plan) const
             {
                 for (const auto& exercise : it->second)
                 {
-                    std::cout << "    " << exercise.exerciseName << " - " << exercise.sets << "x" << exercise.reps << "\n";
+                    std::cout << "    " << exercise.exerciseName() << " - " << exercise.sets << "x" << exercise.reps;
+                    if (findExercise(exercise.exerciseId) == nullptr)
+                    {
+                        std::cout << " (missing from the exercise list)";
+                    }
+                    std::cout << "\n";
                 }
             }
         }
@@ -137,12 +366,17 @@ void WorkoutPlanViewModel::displayWorkoutPlan(const WorkoutPlan& plan) const
 /**
  * @brief Edit the daily exercises for a specific day
  *
+ * The recovery conflicts of the day with its neighbouring days are shown after every change.
+ *
  * @param day The day to edit exercises for
  * @param exercises The list of exercises for the day
  * @param exerciseMap The map of all available exercises
+ * @param weeklyPlan The plan being edited, whose neighbouring days are checked for recovery conflicts
  */
-void WorkoutPlanViewModel::editDailyExercises(const std::string& day, std::vector<WorkoutPlan::ExerciseDetails>& exercises, std::map<std::string, Exercise>& exerciseMap)
+void WorkoutPlanViewModel::editDailyExercises(const std::string& day, std::vector<WorkoutPlan::ExerciseDetails>& exercises, std::map<std::string, Exercise>& exerciseMap,
+    const std::map<std::string, std::vector<WorkoutPlan::ExerciseDetails>>& weeklyPlan)
 {
+    const size_t dayIndex = static_cast<size_t>(std::find(DAYS_OF_WEEK.begin(), DAYS_OF_WEEK.end(), day) - DAYS_OF_WEEK.begin());
     bool modifyingExercises = true;
 
     while (modifyingExercises)
@@ -150,6 +384,13 @@ void WorkoutPlanViewModel::editDailyExercises(const std::string& day, std::vecto
         clearScreen();
         printLabel("Exercises for " + day);
         displayCurrentExercisesForDay(day, exercises);
+        if (dayIndex < DAYS_OF_WEEK.size())
+        {
+            for (const auto& conflict : recoveryValidator.validateDay(dayIndex, exercises, weeklyPlan))
+            {
+                std::cout << "Warning: " << recoveryValidator.describe(conflict) << "\n";
+            }
+        }
 
         std::cout << "Options:\n1. Add an exercise\n2. Delete an exercise\n3. Done\n";
         int exerciseChoice;
@@ -183,7 +424,7 @@ void WorkoutPlanViewModel::displayCurrentExercisesForDay(const std::string& day,
     std::cout << "Current exercises for " << day << ":\n";
     for (size_t i = 0; i < exercises.size(); ++i)
     {
-        std::cout << i + 1 << ". " << exercises[i].exerciseName << " - " << exercises[i].sets << "x" << exercises[i].reps << "\n";
+        std::cout << i + 1 << ". " << exercises[i].exerciseName() << " - " << exercises[i].sets << "x" << exercises[i].reps << "\n";
     }
     printWindowSizedSeparator();
 }
@@ -289,16 +530,17 @@ void WorkoutPlanViewModel::addCustomExercise(const std::string& day, std::vector
     getValidInput(typeChoice, "Enter choice: ", 1, count);
     newExercise.type = static_cast<Exercise::ExerciseType>(typeChoice - 1);
 
-    getValidInput(newExercise.repetitions, "Enter repetitions: ");
-    getValidInput(newExercise.sets, "Enter sets: ");
+    getValidInput(newExercise.repetitions, "Enter repetitions: ", 1, WorkoutPlan::ExerciseDetails::MAX_COUNT);
+    getValidInput(newExercise.sets, "Enter sets: ", 1, WorkoutPlan::ExerciseDetails::MAX_COUNT);
 
     exerciseMap[newExercise.name] = newExercise;
+    recoveryValidator.setExercises(exerciseMap);
     writeToCSV("exercises.csv", newExercise);
 
     WorkoutPlan::ExerciseDetails ed;
-    ed.exerciseName = newExercise.name;
-    ed.reps = newExercise.repetitions;
-    ed.sets = newExercise.sets;
+    ed.exerciseId = ExerciseIdTable::intern(newExercise.name);
+    ed.reps = static_cast<std::uint16_t>(newExercise.repetitions);
+    ed.sets = static_cast<std::uint16_t>(newExercise.sets);
     exercises.push_back(ed);
 }
 
@@ -372,10 +614,12 @@ void WorkoutPlanViewModel::addExistingExerciseToDay(const std::string& muscleGro
             continue;
         }
 
+        // The exercise list may hold counts an entry cannot, so they are checked before narrowing
+        const Exercise& exercise = filteredExercises[exerciseChoice - 1];
         WorkoutPlan::ExerciseDetails ed;
-        ed.exerciseName = filteredExercises[exerciseChoice - 1].name;
-        ed.reps = filteredExercises[exerciseChoice - 1].repetitions;
-        ed.sets = filteredExercises[exerciseChoice - 1].sets;
+        ed.exerciseId = ExerciseIdTable::intern(exercise.name);
+        ed.reps = entryCount(exercise.name, exercise.repetitions, "repetitions");
+        ed.sets = entryCount(exercise.name, exercise.sets, "sets");
         exercises.push_back(ed);
 
         std::cout << "Exercise added.\n";
@@ -431,7 +675,6 @@ void WorkoutPlanViewModel::add()
 {
     std::string name;
     std::map<std::string, std::vector<WorkoutPlan::ExerciseDetails>> weeklyPlan;
-    std::map<std::string, Exercise> exerciseMap = readFromCSV<Exercise>("exercises.csv");
 
     std::cout << "Enter workout plan name: ";
     std::getline(std::cin >> std::ws, name);
@@ -445,19 +688,45 @@ void WorkoutPlanViewModel::add()
     int typeChoice;
     std::cout << "\nSelect workout plan type:\n";
     displayWorkoutPlanTypes();
-    getValidInput(typeChoice, "Enter choice: ", 1, 6);
+    getValidInput(typeChoice, "Enter choice: ", 1, 7);
 
     WorkoutPlan::PlanType type = static_cast<WorkoutPlan::PlanType>(typeChoice - 1);
 
-    for (const auto& day : DAYS_OF_WEEK)
+    std::string generateChoice;
+    do
     {
-        std::vector<WorkoutPlan::ExerciseDetails> exercises;
-        editDailyExercises(day, exercises, exerciseMap);
-        weeklyPlan[day] = exercises;
+        std::cout << "Generate the exercises from the exercise list? (yes/no): ";
+        std::getline(std::cin >> std::ws, generateChoice);
+    } while (generateChoice != "yes" && generateChoice != "no");
+
+    WorkoutPlan plan;
+    if (generateChoice == "yes")
+    {
+        if (!generateWorkoutPlan(name, type, plan))
+        {
+            return;
+        }
+    }
+    else
+    {
+        for (const auto& day : DAYS_OF_WEEK)
+        {
+            std::vector<WorkoutPlan::ExerciseDetails> exercises;
+            editDailyExercises(day, exercises, exerciseMap, weeklyPlan);
+            weeklyPlan[day] = exercises;
+        }
+        plan = WorkoutPlan(name, type, weeklyPlan);
     }
 
-    WorkoutPlan plan(name, type, weeklyPlan);
+    auto existing = workoutPlanMap.find(name);
+    if (existing != workoutPlanMap.end())
+    {
+        exerciseUsage.removePlan(name, existing->second);
+    }
+    reportNearDuplicates(plan, name);
     workoutPlanMap[name] = plan;
+    exerciseUsage.indexPlan(name, plan);
+    similarityIndex.indexPlan(name, plan);
     overwriteCSV(filename, workoutPlanMap);
 }
 
@@ -467,11 +736,72 @@ void WorkoutPlanViewModel::add()
 void WorkoutPlanViewModel::displayWorkoutPlanTypes() const
 {
     std::cout << "1. Strength\n";
-    std::cout << "2. Hypertrophy\n";
-    std::cout << "3. Conditioning\n";
-    std::cout << "4. Push\n";
-    std::cout << "5. Pull\n";
-    std::cout << "6. Legs\n";
+    std::cout << "2. Power\n";
+    std::cout << "3. Hypertrophy\n";
+    std::cout << "4. Conditioning\n";
+    std::cout << "5. Push\n";
+    std::cout << "6. Pull\n";
+    std::cout << "7. Legs\n";
+}
+
+/**
+ * @brief Generate a workout plan from the exercise list
+ *
+ * @param name The name of the workout plan
+ * @param type The type of the workout plan
+ * @param plan Receives the generated workout plan
+ * @return true If the user accepts the generated plan
+ * @return false If no plan could be generated or the user rejects it
+ */
+bool WorkoutPlanViewModel::generateWorkoutPlan(const std::string& name, WorkoutPlan::PlanType type, WorkoutPlan& plan)
+{
+    WorkoutGenerator::Request request;
+    request.name = name;
+    request.type = type;
+    getValidInput(request.trainingDays, "Enter training days per week: ", 1, 7);
+    getValidInput(request.sessionMinutes, "Enter session length in minutes: ", 10, 300);
+    getOptionalInput(request.weeklySets, "Enter target weekly sets per muscle group (or press enter for 12): ");
+
+    WorkoutGenerator generator(exerciseMap, WorkoutGenerator::Settings());
+    WorkoutGenerator::Result result;
+    if (!generator.generate(request, result))
+    {
+        std::cout << "The exercise list has no exercises for this plan type.\n";
+        return false;
+    }
+
+    printWindowSizedSeparator();
+    displayWorkoutPlan(result.plan);
+    std::cout << "Weekly sets:";
+    for (const auto& pair : result.plannedSets)
+    {
+        std::cout << " " << pair.first << " " << pair.second << ";";
+    }
+    std::cout << "\n";
+    if (!result.shortfalls.empty())
+    {
+        std::cout << "Below the target of " << request.weeklySets << " sets:";
+        for (const auto& group : result.shortfalls)
+        {
+            std::cout << " " << group << ";";
+        }
+        std::cout << "\nAdd training days or lengthen the sessions to reach it.\n";
+    }
+
+    std::string choice;
+    do
+    {
+        std::cout << "Save this workout plan? (yes/no): ";
+        std::getline(std::cin >> std::ws, choice);
+    } while (choice != "yes" && choice != "no");
+
+    if (choice != "yes")
+    {
+        std::cout << "Workout plan not saved.\n";
+        return false;
+    }
+    plan = result.plan;
+    return true;
 }
 
 /**
@@ -509,8 +839,10 @@ void WorkoutPlanViewModel::modify()
     std::string selectedPlanName = planNames[choice - 1];
     auto& selectedPlan = workoutPlanMap[selectedPlanName];
 
+    exerciseUsage.removePlan(selectedPlanName, selectedPlan);
     modifyWorkoutPlan(selectedPlan);
-    workoutPlanMap[selectedPlanName] = selectedPlan;
+    exerciseUsage.indexPlan(selectedPlanName, selectedPlan);
+    similarityIndex.indexPlan(selectedPlanName, selectedPlan);
     overwriteCSV(filename, workoutPlanMap);
     std::cout << "Workout plan modified.\n";
 }
@@ -541,7 +873,7 @@ void WorkoutPlanViewModel::modifyWorkoutPlan(WorkoutPlan& plan)
     if (!typeInput.empty())
     {
         typeChoice = std::stoi(typeInput);
-        if (typeChoice >= 1 && typeChoice <= 6)
+        if (typeChoice >= 1 && typeChoice <= 7)
         {
             plan.type = static_cast<WorkoutPlan::PlanType>(typeChoice - 1);
             std::cout << "Current workout plan type: " << WorkoutPlan::planTypeToString(plan.type) << "\n";
@@ -560,7 +892,7 @@ void WorkoutPlanViewModel::modifyWorkoutPlan(WorkoutPlan& plan)
     for (const auto& day : DAYS_OF_WEEK)
     {
         std::vector<WorkoutPlan::ExerciseDetails> exercises = plan.weeklyPlan[day];
-        editDailyExercises(day, exercises, exerciseMap);
+        editDailyExercises(day, exercises, exerciseMap, plan.weeklyPlan);
         plan.weeklyPlan[day] = exercises;
     }
 }
@@ -597,6 +929,8 @@ void WorkoutPlanViewModel::remove()
     }
 
     std::string selectedPlanName = planNames[choice - 1];
+    exerciseUsage.removePlan(selectedPlanName, workoutPlanMap[selectedPlanName]);
+    similarityIndex.removePlan(selectedPlanName);
     workoutPlanMap.erase(selectedPlanName);
     overwriteCSV(filename, workoutPlanMap);
 
@@ -606,6 +940,8 @@ void WorkoutPlanViewModel::remove()
 /**
  * @brief Import workout plans from a CSV file
  *
+ * New plans that are near-duplicates of a plan in the library are only imported once confirmed.
+ *
  * @param filename The name of the CSV file to import workout plans from
  */
 void WorkoutPlanViewModel::importFromFile(const std::string& filename)
@@ -620,23 +956,29 @@ void WorkoutPlanViewModel::importFromFile(const std::string& filename)
         }
         else
         {
-            workoutPlanMap[item.first] = item.second;
-        }
-
-        for (const auto& day : item.second.weeklyPlan)
-        {
-            for (const auto& exercise : day.second)
+            if (reportNearDuplicates(item.second, item.first))
             {
-                if (exerciseMap.find(exercise.exerciseName) == exerciseMap.end())
+                std::string importChoice;
+                do
                 {
-                    addExerciseToList(exercise.exerciseName, exerciseMap);
+                    std::cout << "Import '" << item.first << "' anyway? (yes/no): ";
+                    std::getline(std::cin >> std::ws, importChoice);
+                } while (importChoice != "yes" && importChoice != "no");
+                if (importChoice == "no")
+                {
+                    continue;
                 }
             }
+            workoutPlanMap[item.first] = item.second;
+            similarityIndex.indexPlan(item.first, item.second);
         }
+
+        reportMissingExercises(item.second);
     }
 
+    exerciseUsage.build(workoutPlanMap);
+    similarityIndex.build(workoutPlanMap);
     overwriteCSV("workout_plans.csv", workoutPlanMap);
-    overwriteCSV("exercises.csv", exerciseMap);
 }
 
 /**
@@ -668,23 +1010,369 @@ void WorkoutPlanViewModel::reload()
 {
     exerciseMap = readFromCSV<Exercise>("exercises.csv");
     workoutPlanMap = readFromCSV<WorkoutPlan>(filename);
+    exerciseUsage.build(workoutPlanMap);
+    similarityIndex.build(workoutPlanMap);
+    indexExercises();
+
+    // The programs file only exists once a program has been created
+    programMap.clear();
+    std::ifstream programsFile(programsFilename);
+    if (programsFile.is_open())
+    {
+        programsFile.close();
+        programMap = readFromCSV<Program>(programsFilename);
+    }
 }
 
 /**
- * @brief Add a new exercise to the exercise list
+ * @brief Rename an exercise in the workout plans using it
  *
- * @param exerciseName The name of the exercise to add
- * @param exerciseMap The map of all available exercises
+ * Only the plan entries listed in the usage index are touched, and the plan file is written
+ * once, only if a plan changed.
+ *
+ * @param oldName The previous exercise name
+ * @param newName The new exercise name
  */
-void WorkoutPlanViewModel::addExerciseToList(const std::string& exerciseName, std::map<std::string, Exercise>& exerciseMap)
+void WorkoutPlanViewModel::exerciseRenamed(const std::string& oldName, const std::string& newName)
 {
-    Exercise newExercise;
-    newExercise.name = exerciseName;
-    newExercise.muscleGroup = "Unknown"; // Or ask for this information
-    newExercise.repetitions = 0; // Default value, should be updated
-    newExercise.sets = 0; // Default value, should be updated
-    newExercise.type = Exercise::ExerciseType::UNKNOWN; // Default value, should be updated
-
-    exerciseMap[exerciseName] = newExercise;
-    overwriteCSV("exercises.csv", exerciseMap);
+    auto exerciseIt = exerciseMap.find(oldName);
+    if (exerciseIt != exerciseMap.end())
+    {
+        Exercise exercise = exerciseIt->second;
+        exercise.name = newName;
+        exerciseMap.erase(exerciseIt);
+        exerciseMap[newName] = exercise;
+        indexExercises();
+    }
+
+    auto touched = exerciseUsage.renameExercise(workoutPlanMap, oldName, newName);
+    if (!touched.empty())
+    {
+        for (const auto& planName : touched)
+        {
+            similarityIndex.indexPlan(planName, workoutPlanMap[planName]);
+        }
+        overwriteCSV(filename, workoutPlanMap);
+        std::cout << "Renamed '" << oldName << "' in " << touched.size() << " workout plan(s).\n";
+    }
+
+    // Programs hold their own copy of the base plan
+    ExerciseId oldId, newId = ExerciseIdTable::intern(newName);
+    if (!ExerciseIdTable::find(oldName, oldId))
+    {
+        return;
+    }
+    size_t renamedPrograms = 0;
+    for (auto& pair : programMap)
+    {
+        renamedPrograms += pair.second.replaceExercise(oldId, newId) ? 1 : 0;
+    }
+    if (renamedPrograms > 0)
+    {
+        overwriteCSV(programsFilename, programMap);
+        std::cout << "Renamed '" << oldName << "' in " << renamedPrograms << " workout program(s).\n";
+    }
+}
+
+/**
+ * @brief Flag a deleted exercise in the workout plans using it
+ *
+ * The plans keep their sets and reps for the exercise, and show it as missing until it is
+ * added again or removed from them.
+ *
+ * @param name The name of the deleted exercise
+ */
+void WorkoutPlanViewModel::exerciseRemoved(const std::string& name)
+{
+    exerciseMap.erase(name);
+    indexExercises();
+
+    auto plans = exerciseUsage.plansUsing(name);
+    if (!plans.empty())
+    {
+        std::cout << "'" << name << "' is flagged as missing in " << plans.size() << " workout plan(s).\n";
+    }
+}
+
+/**
+ * @brief List the workout plans using an exercise
+ *
+ * @param name The exercise name
+ * @return std::vector<std::string> The names of the workout plans
+ */
+std::vector<std::string> WorkoutPlanViewModel::usersOf(const std::string& name) const
+{
+    auto plans = exerciseUsage.plansUsing(name);
+    return std::vector<std::string>(plans.begin(), plans.end());
+}
+
+/**
+ * @brief Report the exercises of a workout plan that are missing from the exercise list
+ *
+ * @param plan The workout plan to check
+ */
+void WorkoutPlanViewModel::reportMissingExercises(const WorkoutPlan& plan) const
+{
+    std::set<std::string> missing;
+    for (const auto& day : plan.weeklyPlan)
+    {
+        for (const auto& exercise : day.second)
+        {
+            if (findExercise(exercise.exerciseId) == nullptr)
+            {
+                missing.insert(exercise.exerciseName());
+            }
+        }
+    }
+
+    if (missing.empty())
+    {
+        return;
+    }
+
+    std::cout << "Workout plan '" << plan.name << "' uses exercises missing from the exercise list:";
+    for (const auto& name : missing)
+    {
+        std::cout << " " << name << ";";
+    }
+    std::cout << "\n";
+}
+
+/**
+ * @brief Rebuild the lookup of the exercises by the ids used in the workout plans, and their muscle groups for the recovery checks
+ */
+void WorkoutPlanViewModel::indexExercises()
+{
+    exercisesById.clear();
+    for (const auto& pair : exerciseMap)
+    {
+        ExerciseId id = ExerciseIdTable::intern(pair.first);
+        if (id >= exercisesById.size())
+        {
+            exercisesById.resize(id + 1, nullptr);
+        }
+        exercisesById[id] = &pair.second;
+    }
+    recoveryValidator.setExercises(exerciseMap);
+}
+
+/**
+ * @brief Find the exercise an id of a workout plan entry refers to
+ *
+ * Exercises added since the last indexExercises() are looked up by name.
+ *
+ * @param id The id of the exercise name
+ * @return const Exercise* The exercise, or nullptr if it is missing from the exercise list
+ */
+const Exercise* WorkoutPlanViewModel::findExercise(ExerciseId id) const
+{
+    if (id < exercisesById.size() && exercisesById[id] != nullptr)
+    {
+        return exercisesById[id];
+    }
+    auto it = exerciseMap.find(ExerciseIdTable::name(id));
+    return it != exerciseMap.end() ? &it->second : nullptr;
+}
+
+/**
+ * @brief View, create or delete multi-week workout programs
+ */
+void WorkoutPlanViewModel::managePrograms()
+{
+    std::cout << "1. View Program\n";
+    std::cout << "2. Create Program\n";
+    std::cout << "3. Delete Program\n";
+    std::cout << "4. Cancel\n";
+
+    int choice;
+    getValidInput(choice, "Enter choice: ", 1, 4);
+
+    if (choice == 1)
+    {
+        viewProgram();
+    }
+    else if (choice == 2)
+    {
+        createProgram();
+    }
+    else if (choice == 3)
+    {
+        deleteProgram();
+    }
+}
+
+/**
+ * @brief Let the user pick a workout program
+ *
+ * @return std::string The name of the program, or an empty string if cancelled
+ */
+std::string WorkoutPlanViewModel::selectProgram() const
+{
+    std::vector<std::string> programNames;
+    int index = 1;
+    for (const auto& pair : programMap)
+    {
+        std::cout << index << ". " << pair.first << " (" << pair.second.progression.weeks << " weeks, based on " << pair.second.basePlan.name << ")\n";
+        programNames.push_back(pair.first);
+        ++index;
+    }
+    std::cout << index << ". Cancel\n";
+
+    int choice;
+    getValidInput(choice, "Enter choice: ", 1, index);
+    return choice == index ? "" : programNames[choice - 1];
+}
+
+/**
+ * @brief Display a workout program week by week, and the full plan of chosen weeks
+ *
+ * Every week is materialized from the base plan only while it is displayed.
+ */
+void WorkoutPlanViewModel::viewProgram() const
+{
+    if (programMap.empty())
+    {
+        std::cout << "No workout programs available.\n";
+        return;
+    }
+
+    std::string name = selectProgram();
+    if (name.empty())
+    {
+        return;
+    }
+
+    const Program& program = programMap.at(name);
+    std::cout << "Program: " << program.name << ", based on " << program.basePlan.name << ", "
+        << WorkoutPlan::planTypeToString(program.basePlan.type) << "\n";
+    for (int week = 0; week < program.progression.weeks; ++week)
+    {
+        int sets = 0;
+        for (const auto& day : program.week(week).weeklyPlan)
+        {
+            for (const auto& exercise : day.second)
+            {
+                sets += exercise.sets;
+            }
+        }
+        std::cout << "  Week " << week + 1 << ": " << sets << " sets at " << program.intensity(week) << "% intensity"
+            << (program.isDeloadWeek(week) ? " (deload)" : "") << "\n";
+    }
+
+    int week;
+    while (true)
+    {
+        getValidInput(week, "Enter a week to display (or 0 to finish): ", 0, program.progression.weeks);
+        if (week == 0)
+        {
+            break;
+        }
+        printWindowSizedSeparator();
+        displayWorkoutPlan(program.week(week - 1));
+        std::cout << "Intensity: " << program.intensity(week - 1) << "% of the one-repetition maximum"
+            << (program.isDeloadWeek(week - 1) ? ", deload week" : "") << "\n";
+    }
+}
+
+/**
+ * @brief Create a workout program from an existing workout plan and progression rules
+ *
+ * The program keeps a copy of the plan, so later changes to the plan do not alter it.
+ */
+void WorkoutPlanViewModel::createProgram()
+{
+    if (workoutPlanMap.empty())
+    {
+        std::cout << "No workout plans available to build a program from.\n";
+        return;
+    }
+
+    std::string name;
+    std::cout << "Enter program name: ";
+    std::getline(std::cin >> std::ws, name);
+
+    if (programMap.find(name) != programMap.end())
+    {
+        std::string choice;
+        do
+        {
+            std::cout << "A program with this name already exists. Overwrite it? (yes/no): ";
+            std::getline(std::cin >> std::ws, choice);
+        } while (choice != "yes" && choice != "no");
+
+        if (choice != "yes")
+        {
+            std::cout << "Program not created.\n";
+            return;
+        }
+    }
+
+    std::cout << "Select the workout plan of the first week:\n";
+    std::vector<std::string> planNames;
+    int index = 1;
+    for (const auto& pair : workoutPlanMap)
+    {
+        std::cout << index << ". " << pair.first << "\n";
+        planNames.push_back(pair.first);
+        ++index;
+    }
+    int planChoice;
+    getValidInput(planChoice, "Enter choice: ", 1, index - 1);
+
+    Program::Progression progression;
+    getValidInput(progression.weeks, "Enter number of weeks: ", 1, 520);
+    getOptionalInput(progression.blockWeeks, "Enter weeks per block (or press enter for 4): ");
+    std::string deloadChoice;
+    do
+    {
+        std::cout << "End every block with a deload week? (yes/no): ";
+        std::getline(std::cin >> std::ws, deloadChoice);
+    } while (deloadChoice != "yes" && deloadChoice != "no");
+    progression.deload = deloadChoice == "yes";
+    getOptionalInput(progression.repsPerWeek, "Enter reps added per week of a block (or press enter for 1): ");
+    getOptionalInput(progression.setsPerBlock, "Enter sets added per block (or press enter for 1): ");
+    getOptionalInput(progression.maxExtraSets, "Enter most sets added to an exercise (or press enter for 3): ");
+    getOptionalInput(progression.startIntensity, "Enter intensity of the first week in % of the one-repetition maximum (or press enter for 70): ");
+    getOptionalInput(progression.intensityPerWeek, "Enter intensity added per week in % (or press enter for 1.5): ");
+    getOptionalInput(progression.maxIntensity, "Enter highest intensity in % (or press enter for 90): ");
+    if (progression.deload)
+    {
+        getOptionalInput(progression.deloadPercent, "Enter % of sets and intensity kept in a deload week (or press enter for 60): ");
+    }
+
+    progression.blockWeeks = std::clamp(progression.blockWeeks, 1, progression.weeks);
+    progression.repsPerWeek = std::max(0, progression.repsPerWeek);
+    progression.setsPerBlock = std::max(0, progression.setsPerBlock);
+    progression.maxExtraSets = std::max(0, progression.maxExtraSets);
+    progression.startIntensity = std::clamp(progression.startIntensity, 0.0f, 100.0f);
+    progression.maxIntensity = std::clamp(progression.maxIntensity, progression.startIntensity, 100.0f);
+    progression.deloadPercent = std::clamp(progression.deloadPercent, 0, 100);
+
+    programMap[name] = Program(name, workoutPlanMap[planNames[planChoice - 1]], progression);
+    overwriteCSV(programsFilename, programMap);
+    std::cout << "Program '" << name << "' created.\n";
+}
+
+/**
+ * @brief Delete a workout program
+ */
+void WorkoutPlanViewModel::deleteProgram()
+{
+    if (programMap.empty())
+    {
+        std::cout << "No workout programs available to delete.\n";
+        return;
+    }
+
+    std::cout << "Select a workout program to delete:\n";
+    std::string name = selectProgram();
+    if (name.empty())
+    {
+        std::cout << "Delete operation cancelled.\n";
+        return;
+    }
+
+    programMap.erase(name);
+    overwriteCSV(programsFilename, programMap);
+    std::cout << "Workout program '" << name << "' deleted.\n";
 }
@@ -6,9 +6,16 @@
 #include <vector>
 #include "WorkoutPlan.h"
 #include "Exercise.h"
+#include "ExerciseObserver.h"
+#include "ExerciseUsageIndex.h"
+#include "PlanSimilarityIndex.h"
+#include "Program.h"
+#include "RecoveryValidator.h"
+#include "VolumeAnalyzer.h"
+#include "WorkoutGenerator.h"
 #include "ViewModel.h"
 
-class WorkoutPlanViewModel : public ViewModel
+class WorkoutPlanViewModel : public ViewModel, public ExerciseObserver
 {
 public:
     /**
@@ -50,10 +57,45 @@ public:
      */
     void reload() override;
 
+    /**
+     * @brief View, create or delete multi-week workout programs
+     */
+    void managePrograms();
+
+    /**
+     * @brief Rename an exercise in the workout plans using it
+     *
+     * @param oldName The previous exercise name
+     * @param newName The new exercise name
+     */
+    void exerciseRenamed(const std::string& oldName, const std::string& newName) override;
+
+    /**
+     * @brief Flag a deleted exercise in the workout plans using it
+     *
+     * @param name The name of the deleted exercise
+     */
+    void exerciseRemoved(const std::string& name) override;
+
+    /**
+     * @brief List the workout plans using an exercise
+     *
+     * @param name The exercise name
+     * @return std::vector<std::string> The names of the workout plans
+     */
+    std::vector<std::string> usersOf(const std::string& name) const override;
+
 private:
     std::string filename;  ///< The filename to read/write workout plans
     std::map<std::string, WorkoutPlan> workoutPlanMap;  ///< The map of workout plans
+    std::string programsFilename;  ///< The filename to read/write workout programs
+    std::map<std::string, Program> programMap;  ///< The map of workout programs
     std::map<std::string, Exercise> exerciseMap;  ///< The map of exercises
+    ExerciseUsageIndex exerciseUsage;  ///< Where each exercise is used in the workout plans, kept in step with workoutPlanMap
+    PlanSimilarityIndex similarityIndex;  ///< MinHash signatures of the workout plans, kept in step with workoutPlanMap
+    VolumeAnalyzer volumeAnalyzer;  ///< Weekly training volume of the workout plans, recomputed when displayed
+    RecoveryValidator recoveryValidator;  ///< Recovery checks of the workout plans, given the muscle groups of exerciseMap
+    std::vector<const Exercise*> exercisesById;  ///< Entries of exerciseMap by ExerciseId, rebuilt whenever entries are removed
 
     /**
      * @brief Display all workout plans
@@ -65,6 +107,30 @@ private:
      */
     void displayWorkoutPlansByType() const;
 
+    /**
+     * @brief Display the weekly training volume of a plan, or rank all plans by the volume of a muscle group
+     */
+    void displayTrainingVolume();
+
+    /**
+     * @brief Display the clusters of near-duplicate plans and offer to merge each into one plan
+     */
+    void displayNearDuplicates();
+
+    /**
+     * @brief Display the recovery conflicts of every workout plan
+     */
+    void displayRecoveryReport() const;
+
+    /**
+     * @brief Print the near-duplicates of a plan in the library
+     *
+     * @param plan The plan to look up
+     * @param ignoredName A plan to leave out, usually the plan itself
+     * @return true if near-duplicates were found, false otherwise
+     */
+    bool reportNearDuplicates(const WorkoutPlan& plan, const std::string& ignoredName) const;
+
     /**
      * @brief Display the details of a specific workout plan
      *
@@ -78,8 +144,10 @@ private:
      * @param day The day of the week
      * @param exercises The list of exercises for the day
      * @param exerciseMap The map of all available exercises
+     * @param weeklyPlan The plan being edited, whose neighbouring days are checked for recovery conflicts
      */
-    void editDailyExercises(const std::string& day, std::vector<WorkoutPlan::ExerciseDetails>& exercises, std::map<std::string, Exercise>& exerciseMap);
+    void editDailyExercises(const std::string& day, std::vector<WorkoutPlan::ExerciseDetails>& exercises, std::map<std::string, Exercise>& exerciseMap,
+        const std::map<std::string, std::vector<WorkoutPlan::ExerciseDetails>>& weeklyPlan);
 
     /**
      * @brief Display the current exercises for a specific day
@@ -164,6 +232,17 @@ private:
      */
     int displayExerciseTypes() const;
 
+    /**
+     * @brief Generate a workout plan from the exercise list
+     *
+     * @param name The name of the workout plan
+     * @param type The type of the workout plan
+     * @param plan Receives the generated workout plan
+     * @return true If the user accepts the generated plan
+     * @return false If no plan could be generated or the user rejects it
+     */
+    bool generateWorkoutPlan(const std::string& name, WorkoutPlan::PlanType type, WorkoutPlan& plan);
+
     /**
      * @brief Modify the details of a workout plan
      *
@@ -179,12 +258,46 @@ private:
     void overwriteWorkoutPlan(const std::pair<std::string, WorkoutPlan>& item);
 
     /**
-     * @brief Add a new exercise to the exercise list
+     * @brief Report the exercises of a workout plan that are missing from the exercise list
      *
-     * @param exerciseName The name of the exercise to add
-     * @param exerciseMap The map of all available exercises
+     * @param plan The workout plan to check
+     */
+    void reportMissingExercises(const WorkoutPlan& plan) const;
+
+    /**
+     * @brief Let the user pick a workout program
+     *
+     * @return std::string The name of the program, or an empty string if cancelled
+     */
+    std::string selectProgram() const;
+
+    /**
+     * @brief Display a workout program week by week, and the full plan of chosen weeks
+     */
+    void viewProgram() const;
+
+    /**
+     * @brief Create a workout program from an existing workout plan and progression rules
+     */
+    void createProgram();
+
+    /**
+     * @brief Delete a workout program
+     */
+    void deleteProgram();
+
+    /**
+     * @brief Rebuild the lookup of the exercises by the ids used in the workout plans, and their muscle groups for the recovery checks
+     */
+    void indexExercises();
+
+    /**
+     * @brief Find the exercise an id of a workout plan entry refers to
+     *
+     * @param id The id of the exercise name
+     * @return const Exercise* The exercise, or nullptr if it is missing from the exercise list
      */
-    void addExerciseToList(const std::string& exerciseName, std::map<std::string, Exercise>& exerciseMap);
+    const Exercise* findExercise(ExerciseId id) const;
 };
 
 #endif // WORKOUTPLANVIEWMODEL_H
@@ -0,0 +1,124 @@
+/**
+ * @file CalorieBatchBenchmark.cpp
+ * @brief Times CalorieBatch::compute over 2M users against calling Goals::getDailyCalories user by user.
+ *
+ * The users are random but fixed by the seed. Every daily calorie target of the batch is
+ * compared with the scalar one before anything is timed. The scalar loop gives the daily
+ * calories only, while compute() also gives the basal metabolic rates and energy
+ * expenditures, so the comparison favours the scalar path.
+ *
+ * Built and run by run_tests.sh --bench, or by hand from this directory:
+ * g++ -std=c++20 -O2 -I../FitnessApp CalorieBatchBenchmark.cpp ../FitnessApp/CalorieBatch.cpp ../FitnessApp/Profile.cpp
+ *     ../FitnessApp/Goals.cpp
+ */
+#include "CalorieBatch.h"
+#include "TestCheck.h"
+#include <chrono>
+#include <memory>
+#include <random>
+
+using TestCheck::check;
+
+namespace
+{
+    const size_t USER_COUNT = 2000000; ///< Number of users.
+    const int RUN_COUNT = 5; ///< Runs per path; the fastest one is reported.
+
+    /**
+     * @brief Times a function over several runs.
+     * @param run The function, called once per run.
+     * @return The fastest run, in milliseconds.
+     */
+    template<typename Run>
+    double fastestRun(Run run)
+    {
+        double best = 0;
+        for (int i = 0; i < RUN_COUNT; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            if (i == 0 || elapsed.count() < best)
+            {
+                best = elapsed.count();
+            }
+        }
+        return best;
+    }
+}
+
+int main()
+{
+    // Goals keep a pointer to their profile, so the profiles must not move once set
+    std::unique_ptr<Profile[]> profiles(new Profile[USER_COUNT]);
+    std::vector<Goals> goals(USER_COUNT);
+    std::mt19937 random(50);
+    std::uniform_real_distribution<float> weightDistribution(45.0f, 140.0f);
+    std::uniform_real_distribution<float> heightDistribution(150.0f, 200.0f);
+    std::uniform_int_distribution<int> ageDistribution(18, 90);
+    std::uniform_int_distribution<int> genderDistribution(0, 1);
+    std::uniform_int_distribution<int> activityDistribution(0, 4);
+    std::uniform_int_distribution<int> goalDistribution(0, 2);
+    std::uniform_int_distribution<int> percentDistribution(0, 99);
+    for (size_t i = 0; i < USER_COUNT; ++i)
+    {
+        profiles[i].setProfileInformation("User", ageDistribution(random), static_cast<Profile::Gender>(genderDistribution(random)),
+            heightDistribution(random), weightDistribution(random), static_cast<Profile::ActivityLevel>(activityDistribution(random)));
+        goals[i].setProfile(&profiles[i]);
+        goals[i].setGoals(70.0f, 20.0f, static_cast<Goals::FitnessGoal>(goalDistribution(random)));
+        // A fifth of the users follow a workout plan and a tenth set custom calories
+        if (percentDistribution(random) < 20)
+        {
+            goals[i].setWorkoutPlan("Plan");
+            goals[i].setWorkoutBurn(200.0f + percentDistribution(random) * 3.0f);
+        }
+        if (percentDistribution(random) < 10)
+        {
+            goals[i].setCustomCalories(1800.0f + percentDistribution(random) * 10.0f);
+        }
+    }
+
+    CalorieBatch batch;
+    const double addTime = fastestRun([&]() {
+        batch.clear();
+        batch.reserve(USER_COUNT);
+        for (size_t i = 0; i < USER_COUNT; ++i)
+        {
+            batch.add(profiles[i], goals[i]);
+        }
+    });
+
+    // The timings only mean something if both paths give the same targets
+    std::vector<float> scalarCalories(USER_COUNT);
+    batch.compute();
+    size_t mismatches = 0;
+    for (size_t i = 0; i < USER_COUNT; ++i)
+    {
+        scalarCalories[i] = goals[i].getDailyCalories();
+        mismatches += batch.getDailyCalories()[i] != scalarCalories[i] ? 1 : 0;
+    }
+    check(mismatches == 0, "the batch gives the scalar daily calories of every user");
+    if (TestCheck::failures > 0)
+    {
+        return TestCheck::finish("calorie batch benchmark");
+    }
+
+    const double computeTime = fastestRun([&]() { batch.compute(); });
+    const double scalarTime = fastestRun([&]() {
+        for (size_t i = 0; i < USER_COUNT; ++i)
+        {
+            scalarCalories[i] = goals[i].getDailyCalories();
+        }
+    });
+
+    double checksum = 0;
+    for (size_t i = 0; i < USER_COUNT; i += 1000)
+    {
+        checksum += batch.getDailyCalories()[i] + scalarCalories[i];
+    }
+    std::cout << USER_COUNT << " users, fastest of " << RUN_COUNT << " runs (checksum " << checksum << ")\n";
+    std::cout << "Goals::getDailyCalories, user by user: " << scalarTime << " ms\n";
+    std::cout << "CalorieBatch::compute: " << computeTime << " ms, " << scalarTime / computeTime << "x\n";
+    std::cout << "CalorieBatch::add of every user, once per batch: " << addTime << " ms\n";
+    return TestCheck::finish("calorie batch benchmark");
+}
@@ -0,0 +1,153 @@
+/**
+ * @file CalorieBatchTest.cpp
+ * @brief Checks that CalorieBatch gives the same figures as Profile and Goals user by user,
+ * including for enum values out of range, and that such values are rejected when rows are read.
+ *
+ * Built and run by run_tests.sh, or by hand from this directory:
+ * g++ -std=c++20 -I../FitnessApp CalorieBatchTest.cpp ../FitnessApp/CalorieBatch.cpp ../FitnessApp/Profile.cpp
+ *     ../FitnessApp/Goals.cpp
+ */
+#include "CalorieBatch.h"
+#include "TestCheck.h"
+#include <sstream>
+#include <vector>
+
+using TestCheck::check;
+
+namespace
+{
+    /**
+     * @brief One user, with the figures the scalar path gives it.
+     */
+    struct User
+    {
+        Profile profile; ///< The profile.
+        Goals goals; ///< The goals, without a profile set.
+        float basalMetabolicRate; ///< Profile::calculateBasalMetabolicRate.
+        float energyExpenditure; ///< The activity level or workout plan part of Goals::calculateDailyCalories.
+        float dailyCalories; ///< Goals::getDailyCalories.
+        std::string description; ///< The inputs, for failure messages.
+    };
+
+    /**
+     * @brief Checks every combination of gender, activity level, fitness goal, workout plan and custom calories.
+     */
+    void checkAgainstScalarPath()
+    {
+        // The last values of every enum are out of range, as read from a damaged file
+        const std::vector<int> genders = { 0, 1, 2, -1 };
+        const std::vector<int> activityLevels = { 0, 1, 2, 3, 4, 5, 7, 200, -1 };
+        const std::vector<int> fitnessGoals = { 0, 1, 2, 3, 9, -1 };
+        const std::vector<float> workoutBurns = { -1.0f, 0.0f, 312.5f }; // Negative for no workout plan
+        const std::vector<float> weights = { 45.5f, 80.0f, 130.2f };
+        const std::vector<float> heights = { 150.0f, 181.5f };
+        const std::vector<int> ages = { 18, 47, 90 };
+
+        const size_t combinations = 2 * genders.size() * activityLevels.size() * fitnessGoals.size() * workoutBurns.size()
+            * weights.size() * heights.size() * ages.size();
+        std::vector<User> users(combinations);
+        for (size_t combination = 0; combination < combinations; ++combination)
+        {
+            // Every value of the combination index picks one value of every input
+            size_t rest = combination;
+            auto pick = [&rest](const auto& values) {
+                const auto& value = values[rest % values.size()];
+                rest /= values.size();
+                return value;
+            };
+            const int gender = pick(genders);
+            const int activityLevel = pick(activityLevels);
+            const int fitnessGoal = pick(fitnessGoals);
+            const float workoutBurn = pick(workoutBurns);
+            const float weight = pick(weights);
+            const float height = pick(heights);
+            const int age = pick(ages);
+            const bool custom = rest % 2 == 1;
+
+            User& user = users[combination];
+            user.profile.setProfileInformation("User", age, static_cast<Profile::Gender>(gender), height, weight,
+                static_cast<Profile::ActivityLevel>(activityLevel));
+            user.goals.setGoals(70.0f, 20.0f, static_cast<Goals::FitnessGoal>(fitnessGoal));
+            if (workoutBurn >= 0.0f)
+            {
+                user.goals.setWorkoutPlan("Plan");
+                user.goals.setWorkoutBurn(workoutBurn);
+            }
+            if (custom)
+            {
+                user.goals.setCustomCalories(2750.0f);
+            }
+
+            std::ostringstream description;
+            description << "gender " << gender << ", activity level " << activityLevel << ", fitness goal " << fitnessGoal
+                << ", workout burn " << workoutBurn << ", custom " << custom << ", weight " << weight
+                << ", height " << height << ", age " << age;
+            user.description = description.str();
+        }
+
+        CalorieBatch batch;
+        batch.reserve(users.size());
+        for (User& user : users)
+        {
+            Goals goals = user.goals;
+            goals.setProfile(&user.profile);
+            user.basalMetabolicRate = user.profile.calculateBasalMetabolicRate();
+            user.energyExpenditure = goals.getWorkoutPlan().empty()
+                ? user.profile.calculateDailyCalories()
+                : user.basalMetabolicRate * Profile::activityFactor(Profile::ActivityLevel::SEDENTARY) + goals.getWorkoutBurn();
+            user.dailyCalories = goals.getDailyCalories();
+            batch.add(user.profile, user.goals);
+        }
+        batch.compute();
+
+        check(batch.size() == users.size(), "every user is added");
+        for (size_t i = 0; i < users.size() && i < batch.size(); ++i)
+        {
+            // The same expressions in the same order give the same bits
+            check(batch.getBasalMetabolicRates()[i] == users[i].basalMetabolicRate, "basal metabolic rate of " + users[i].description);
+            check(batch.getEnergyExpenditures()[i] == users[i].energyExpenditure, "energy expenditure of " + users[i].description);
+            check(batch.getDailyCalories()[i] == users[i].dailyCalories, "daily calories of " + users[i].description);
+        }
+
+        batch.clear();
+        check(batch.size() == 0, "clear() removes every user");
+    }
+
+    /**
+     * @brief Checks that rows with malformed numbers or unknown enum values are rejected.
+     */
+    void checkRowValidation()
+    {
+        Profile profile;
+        std::istringstream goodProfile("Anna,30,Female,165,60,4");
+        check(profile.fromCSV(goodProfile) && profile.getActivityLevel() == Profile::ActivityLevel::EXTRA_ACTIVE, "a valid profile row is read");
+        for (const std::string row : { "Anna,30,Female,165,60,5", "Anna,30,Female,165,60,-1", "Anna,30,Other,165,60,2",
+            "Anna,thirty,Female,165,60,2", "Anna,30,Female,tall,60,2", "Anna,30,Female,165,60,2x", "Anna,30,Female,165,60", "" })
+        {
+            std::istringstream ss(row);
+            check(!profile.fromCSV(ss), "the profile row \"" + row + "\" is rejected");
+        }
+        check(profile.getActivityLevel() == Profile::ActivityLevel::EXTRA_ACTIVE && profile.getAge() == 30, "a rejected row leaves the profile unchanged");
+
+        Goals goals;
+        std::istringstream goodGoals("70,20,0,2200,1,Push Pull Legs");
+        check(goals.fromCSV(goodGoals) && goals.getFitnessGoal() == Goals::FitnessGoal::WEIGHT_LOSS && goals.usesCustomCalories()
+            && goals.getWorkoutPlan() == "Push Pull Legs", "a valid goals row is read");
+        std::istringstream oldGoals("70,20,1,2200,0");
+        check(goals.fromCSV(oldGoals) && goals.getWorkoutPlan().empty(), "a goals row without a workout plan is read");
+        for (const std::string row : { "70,20,3,2200,0", "70,20,-1,2200,0", "70,20,1,2200,2", "70,20,1,lots,0", "70,20,one,2200,0", "70,20" })
+        {
+            std::istringstream ss(row);
+            check(!goals.fromCSV(ss), "the goals row \"" + row + "\" is rejected");
+        }
+        check(goals.getFitnessGoal() == Goals::FitnessGoal::MUSCLE_GAIN, "a rejected row leaves the goals unchanged");
+    }
+}
+
+int main()
+{
+    checkAgainstScalarPath();
+    checkRowValidation();
+
+    return TestCheck::finish("calorie batch");
+}
@@ -0,0 +1,61 @@
+/**
+ * @file RecipeExclusionTest.cpp
+ * @brief Checks that excluding a category also excludes the recipes containing a food of it.
+ *
+ * Built and run by run_tests.sh, or by hand from this directory:
+ * g++ -std=c++20 -I../FitnessApp RecipeExclusionTest.cpp ../FitnessApp/RecipeBook.cpp ../FitnessApp/Recipe.cpp
+ *     ../FitnessApp/FoodItem.cpp ../FitnessApp/FoodCatalog.cpp ../FitnessApp/MacroKdTree.cpp
+ *     ../FitnessApp/ExclusionFilter.cpp ../FitnessApp/Nutrients.cpp
+ */
+#include "RecipeBook.h"
+#include "FoodCatalog.h"
+#include "ExclusionFilter.h"
+#include "TestCheck.h"
+#include <cstdio>
+
+using TestCheck::check;
+
+int main()
+{
+    const std::string recipeFile = "recipe_exclusion_test.csv";
+    std::remove(recipeFile.c_str());
+
+    std::map<std::string, FoodItem> foodItemMap;
+    foodItemMap["Milk"] = FoodItem("Milk", { "dairy" }, 64, 3.4f, 4.8f, 3.6f);
+    foodItemMap["Oats"] = FoodItem("Oats", { "grains" }, 389, 16.9f, 66.3f, 6.9f);
+    foodItemMap["Banana"] = FoodItem("Banana", { "fruit" }, 89, 1.1f, 22.8f, 0.3f);
+
+    // Porridge contains milk; Breakfast Bowl contains milk only through Porridge
+    RecipeBook recipeBook(recipeFile);
+    Recipe porridge;
+    porridge.name = "Porridge";
+    porridge.ingredients = { { "Oats", 50 }, { "Milk", 200 } };
+    recipeBook.setRecipe(porridge);
+    Recipe bowl;
+    bowl.name = "Breakfast Bowl";
+    bowl.ingredients = { { "Porridge", 250 }, { "Banana", 100 } };
+    recipeBook.setRecipe(bowl);
+    recipeBook.refresh(foodItemMap);
+
+    const std::set<std::string>& bowlCategories = foodItemMap.at("Breakfast Bowl").categories;
+    check(bowlCategories.count("recipe") == 1, "nested recipe keeps the recipe category");
+    check(bowlCategories.count("dairy") == 1, "nested recipe inherits the category of an ingredient of its sub-recipe");
+    check(bowlCategories.count("fruit") == 1, "nested recipe inherits the category of its own ingredient");
+
+    FoodCatalog catalog(foodItemMap);
+    ExclusionFilter dairyFree(catalog, { "dairy" });
+    size_t index = 0;
+    check(catalog.findIndex("Breakfast Bowl", index) && dairyFree.excludesFood(index), "excluding dairy excludes the nested recipe");
+    check(catalog.findIndex("Porridge", index) && dairyFree.excludesFood(index), "excluding dairy excludes the recipe");
+    check(catalog.findIndex("Oats", index) && !dairyFree.excludesFood(index), "excluding dairy keeps other foods");
+    check(dairyFree.excludesItem(foodItemMap.at("Breakfast Bowl")), "excluding dairy excludes the nested recipe item");
+
+    // Removing the milk from the sub-recipe drops the category from both recipes after a refresh
+    porridge.ingredients = { { "Oats", 50 } };
+    recipeBook.setRecipe(porridge);
+    recipeBook.refresh(foodItemMap);
+    check(foodItemMap.at("Breakfast Bowl").categories.count("dairy") == 0, "nested recipe loses the category of a removed ingredient");
+
+    std::remove(recipeFile.c_str());
+    return TestCheck::finish("recipe exclusion");
+}
@@ -0,0 +1,48 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Failure counting shared by the test programs.
+ *
+ * Every test program is a main() that calls check() for each condition and returns finish(),
+ * so run_tests.sh can tell from the exit code whether every check passed.
+ */
+namespace TestCheck
+{
+    inline int failures = 0; ///< Number of failed checks.
+
+    /**
+     * @brief Reports a failed check.
+     * @param condition The checked condition.
+     * @param description What was checked.
+     */
+    inline void check(bool condition, const std::string& description)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << description << "\n";
+            ++failures;
+        }
+    }
+
+    /**
+     * @brief Reports whether every check passed.
+     * @param suite What the checks cover, for the success message.
+     * @return The exit code of the test program: 0 if every check passed, 1 otherwise.
+     */
+    inline int finish(const std::string& suite)
+    {
+        if (failures == 0)
+        {
+            std::cout << "All " << suite << " checks passed.\n";
+            return 0;
+        }
+        std::cerr << failures << " " << suite << " check(s) failed.\n";
+        return 1;
+    }
+}
+
+#endif // TEST_CHECK_H
@@ -0,0 +1,216 @@
+/**
+ * @file WorkoutPlanDayFormatBenchmark.cpp
+ * @brief Times WorkoutPlan::parseDay and WorkoutPlan::appendDay against the substr and
+ * stringstream code they replaced.
+ *
+ * The previous code is copied below as it was: processExercises split a day with getline on a
+ * stringstream, cut every entry with substr and read the counts with std::stoi, and toCSV
+ * wrote every field with operator<<. Both paths read and write the same days, and the entries
+ * they read are compared before anything is timed.
+ *
+ * Built and run by run_tests.sh --bench, or by hand from this directory:
+ * g++ -std=c++20 -O2 -I../FitnessApp WorkoutPlanDayFormatBenchmark.cpp ../FitnessApp/WorkoutPlan.cpp
+ *     ../FitnessApp/ExerciseIdTable.cpp
+ */
+#include "WorkoutPlan.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <sstream>
+
+using TestCheck::check;
+
+namespace
+{
+    const int DAY_COUNT = 20000; ///< Number of days parsed and written per run.
+    const int RUN_COUNT = 7; ///< Runs per path; the fastest one is reported.
+
+    /**
+     * @brief An entry of a day as the previous code stored it.
+     */
+    struct PreviousEntry
+    {
+        std::string exerciseName; ///< Name of the exercise
+        int sets; ///< Number of sets
+        int reps; ///< Number of reps
+    };
+
+    /**
+     * @brief Parses a day as the previous WorkoutPlan::processExercises did.
+     * @param dayExercises The exercises of the day.
+     * @return The entries of the day.
+     */
+    std::vector<PreviousEntry> previousParseDay(const std::string& dayExercises)
+    {
+        std::vector<PreviousEntry> exercises;
+        if (dayExercises.empty() || dayExercises == " ")
+        {
+            return exercises;
+        }
+        std::stringstream ess(dayExercises);
+        std::string exerciseDetails;
+        while (std::getline(ess, exerciseDetails, ';'))
+        {
+            if (exerciseDetails.empty()) continue; // Skip empty entries
+            PreviousEntry details;
+            std::string exerciseName = exerciseDetails.substr(0, exerciseDetails.find('='));
+            std::string setsReps = exerciseDetails.substr(exerciseDetails.find('=') + 1);
+            details.exerciseName = exerciseName;
+            details.sets = std::stoi(setsReps.substr(0, setsReps.find('x')));
+            details.reps = std::stoi(setsReps.substr(setsReps.find('x') + 1));
+            exercises.push_back(details);
+        }
+        return exercises;
+    }
+
+    /**
+     * @brief Writes a day as the previous WorkoutPlan::toCSV did.
+     * @param os The stream to write to.
+     * @param exercises The entries of the day.
+     */
+    void previousWriteDay(std::ostream& os, const std::vector<PreviousEntry>& exercises)
+    {
+        for (size_t i = 0; i < exercises.size(); ++i)
+        {
+            const auto& exercise = exercises[i];
+            os << exercise.exerciseName << "=" << exercise.sets << "x" << exercise.reps;
+            if (i < exercises.size() - 1)
+            {
+                os << ";";
+            }
+        }
+    }
+
+    /**
+     * @brief Builds days shaped like the bundled workout plans: 3 to 8 entries of common names.
+     * @return The days, in the file format.
+     */
+    std::vector<std::string> buildDays()
+    {
+        const std::vector<std::string> names = { "Bench Press", "Back Squat", "Deadlift", "Overhead Press", "Pull-Up",
+            "Barbell Row", "Romanian Deadlift", "Lateral Raise", "Bicep Curl", "Tricep Pushdown", "Leg Press", "Plank" };
+        std::mt19937 random(47);
+        std::uniform_int_distribution<size_t> lengthDistribution(3, 8);
+        std::uniform_int_distribution<size_t> nameDistribution(0, names.size() - 1);
+        std::uniform_int_distribution<int> setsDistribution(1, 6);
+        std::uniform_int_distribution<int> repsDistribution(1, 20);
+
+        std::vector<std::string> days(DAY_COUNT);
+        for (auto& day : days)
+        {
+            const size_t length = lengthDistribution(random);
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (i > 0)
+                {
+                    day += ';';
+                }
+                day += names[nameDistribution(random)] + "=" + std::to_string(setsDistribution(random)) + "x" + std::to_string(repsDistribution(random));
+            }
+        }
+        return days;
+    }
+
+    /**
+     * @brief Times a function over several runs.
+     * @param run The function, called once per run.
+     * @return The fastest run, in nanoseconds per day.
+     */
+    template<typename Run>
+    double fastestRun(Run run)
+    {
+        double best = 0;
+        for (int i = 0; i < RUN_COUNT; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            if (i == 0 || elapsed.count() < best)
+            {
+                best = elapsed.count();
+            }
+        }
+        return best / DAY_COUNT;
+    }
+
+    /**
+     * @brief Prints the timings of both paths.
+     * @param what What was timed.
+     * @param previous The previous path, in nanoseconds per day.
+     * @param current The current path, in nanoseconds per day.
+     */
+    void report(const std::string& what, double previous, double current)
+    {
+        std::cout << what << ": " << previous << " ns per day before, " << current << " ns per day now, "
+            << previous / current << "x\n";
+    }
+}
+
+int main()
+{
+    const std::vector<std::string> days = buildDays();
+
+    // Both paths must read the same entries for the timings to mean anything
+    std::vector<std::vector<PreviousEntry>> previousDays;
+    std::vector<std::vector<WorkoutPlan::ExerciseDetails>> currentDays(days.size());
+    for (size_t i = 0; i < days.size(); ++i)
+    {
+        previousDays.push_back(previousParseDay(days[i]));
+        std::vector<WorkoutPlan::ParseError> errors;
+        WorkoutPlan::parseDay(days[i], currentDays[i], errors);
+        bool same = errors.empty() && previousDays[i].size() == currentDays[i].size();
+        for (size_t j = 0; same && j < currentDays[i].size(); ++j)
+        {
+            same = previousDays[i][j].exerciseName == currentDays[i][j].exerciseName()
+                && previousDays[i][j].sets == currentDays[i][j].sets && previousDays[i][j].reps == currentDays[i][j].reps;
+        }
+        check(same, "both paths read \"" + days[i] + "\" the same way");
+    }
+    if (TestCheck::failures > 0)
+    {
+        return TestCheck::finish("workout plan day format benchmark");
+    }
+
+    size_t checksum = 0;
+    const double previousParse = fastestRun([&]() {
+        for (const auto& day : days)
+        {
+            checksum += previousParseDay(day).size();
+        }
+    });
+    const double currentParse = fastestRun([&]() {
+        std::vector<WorkoutPlan::ExerciseDetails> exercises;
+        std::vector<WorkoutPlan::ParseError> errors;
+        for (const auto& day : days)
+        {
+            exercises.clear();
+            WorkoutPlan::parseDay(day, exercises, errors);
+            checksum += exercises.size();
+        }
+    });
+
+    const double previousWrite = fastestRun([&]() {
+        std::ostringstream os;
+        for (const auto& day : previousDays)
+        {
+            previousWriteDay(os, day);
+            os << ",";
+        }
+        checksum += os.str().size();
+    });
+    const double currentWrite = fastestRun([&]() {
+        std::string line;
+        for (const auto& day : currentDays)
+        {
+            WorkoutPlan::appendDay(line, day);
+            line += ',';
+        }
+        checksum += line.size();
+    });
+
+    std::cout << DAY_COUNT << " days, fastest of " << RUN_COUNT << " runs (checksum " << checksum << ")\n";
+    report("Parsing", previousParse, currentParse);
+    report("Writing", previousWrite, currentWrite);
+    return TestCheck::finish("workout plan day format benchmark");
+}
@@ -0,0 +1,206 @@
+/**
+ * @file WorkoutPlanDayFormatTest.cpp
+ * @brief Checks that WorkoutPlan::parseDay reads back what WorkoutPlan::appendDay writes, and
+ * that it reports malformed text instead of misreading it.
+ *
+ * Built and run by run_tests.sh, or by hand from this directory:
+ * g++ -std=c++20 -I../FitnessApp WorkoutPlanDayFormatTest.cpp ../FitnessApp/WorkoutPlan.cpp
+ *     ../FitnessApp/ExerciseIdTable.cpp
+ */
+#include "WorkoutPlan.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+using TestCheck::check;
+
+namespace
+{
+    /**
+     * @brief Creates an entry of a day.
+     * @param name The exercise name.
+     * @param sets The number of sets.
+     * @param reps The number of reps.
+     * @return The entry.
+     */
+    WorkoutPlan::ExerciseDetails entry(const std::string& name, std::uint16_t sets, std::uint16_t reps)
+    {
+        WorkoutPlan::ExerciseDetails details;
+        details.exerciseId = ExerciseIdTable::intern(name);
+        details.sets = sets;
+        details.reps = reps;
+        return details;
+    }
+
+    /**
+     * @brief Compares two lists of entries.
+     * @param a The first list.
+     * @param b The second list.
+     * @return Whether both hold the same entries in the same order.
+     */
+    bool sameEntries(const std::vector<WorkoutPlan::ExerciseDetails>& a, const std::vector<WorkoutPlan::ExerciseDetails>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].exerciseId != b[i].exerciseId || a[i].sets != b[i].sets || a[i].reps != b[i].reps)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Parses a day and checks the number of entries and errors.
+     * @param text The exercises of the day.
+     * @param parsed The expected number of well-formed entries.
+     * @param malformed The expected number of malformed entries.
+     * @return The well-formed entries.
+     */
+    std::vector<WorkoutPlan::ExerciseDetails> expectParse(const std::string& text, size_t parsed, size_t malformed)
+    {
+        std::vector<WorkoutPlan::ExerciseDetails> exercises;
+        std::vector<WorkoutPlan::ParseError> errors;
+        const bool wellFormed = WorkoutPlan::parseDay(text, exercises, errors);
+        check(exercises.size() == parsed, "\"" + text + "\" has " + std::to_string(parsed) + " well-formed entries");
+        check(errors.size() == malformed, "\"" + text + "\" has " + std::to_string(malformed) + " malformed entries");
+        check(wellFormed == (malformed == 0), "\"" + text + "\" is reported as " + (malformed == 0 ? "well-formed" : "malformed"));
+        return exercises;
+    }
+
+    /**
+     * @brief Checks parseDay on text with known content.
+     */
+    void checkKnownDays()
+    {
+        // Blanks
+        expectParse("", 0, 0);
+        expectParse(";;", 0, 0);
+        expectParse(" \t; ", 0, 0);
+        check(sameEntries(expectParse(" ; Squat=3x5 ;", 1, 0), { entry(" Squat", 3, 5) }), "blank entries around an entry are skipped");
+        check(sameEntries(expectParse("Squat=3x5;;Deadlift=1x5;", 2, 0), { entry("Squat", 3, 5), entry("Deadlift", 1, 5) }), "empty entries are skipped");
+        check(sameEntries(expectParse("Squat= 3 x 5 ", 1, 0), { entry("Squat", 3, 5) }), "blanks around the counts are allowed");
+
+        // The 65535 boundary
+        check(sameEntries(expectParse("Squat=65535x65535", 1, 0), { entry("Squat", 65535, 65535) }), "counts of 65535 are read");
+        expectParse("Squat=65536x5", 0, 1);
+        expectParse("Squat=5x65536", 0, 1);
+        expectParse("Squat=99999999999999999999x5", 0, 1);
+
+        // Malformed entries
+        expectParse("Squat", 0, 1);
+        expectParse("=3x5", 0, 1);
+        expectParse(" =3x5", 0, 1);
+        expectParse("Squat=", 0, 1);
+        expectParse("Squat=x5", 0, 1);
+        expectParse("Squat=3x", 0, 1);
+        expectParse("Squat=3y5", 0, 1);
+        expectParse("Squat=3 5", 0, 1);
+        expectParse("Squat=3x5z", 0, 1);
+        expectParse("Squat=3x5 5", 0, 1);
+        expectParse("Squat=-3x5", 0, 1);
+        check(sameEntries(expectParse("Squat=3x5;bad;Deadlift=1x5;=;Row=4x", 2, 3), { entry("Squat", 3, 5), entry("Deadlift", 1, 5) }),
+            "well-formed entries around malformed ones are kept");
+
+        // Names with blanks are kept as written; a name with '=' cannot be told from its counts
+        check(sameEntries(expectParse("Bench Press=4x8", 1, 0), { entry("Bench Press", 4, 8) }), "names may contain blanks");
+        expectParse("Leg=Press=3x5", 0, 1);
+
+        // Every error lies within its entry
+        std::vector<WorkoutPlan::ExerciseDetails> exercises;
+        std::vector<WorkoutPlan::ParseError> errors;
+        const std::string text = "Squat=3x;Row=4x8;Press";
+        WorkoutPlan::parseDay(text, exercises, errors);
+        check(errors.size() == 2 && errors[0].entryStart == 0 && errors[0].entryEnd == 8 && errors[0].offset == 8
+            && errors[1].entryStart == 17 && errors[1].entryEnd == text.size() && errors[1].offset == text.size(),
+            "errors give the span of the entry and the position of the problem");
+    }
+
+    /**
+     * @brief Checks that random entries are read back as written.
+     * @param random The random number generator.
+     */
+    void checkRoundTrips(std::mt19937& random)
+    {
+        const std::vector<std::string> names = { "Squat", "Bench Press", " Leading blank", "Trailing blank ", "Farmer's Walk", "x", "3x5" };
+        const std::vector<std::uint16_t> counts = { 0, 1, 5, 9, 10, 99, 100, 65534, 65535 };
+        std::uniform_int_distribution<size_t> lengthDistribution(0, 8);
+        std::uniform_int_distribution<size_t> nameDistribution(0, names.size() - 1);
+        std::uniform_int_distribution<size_t> countDistribution(0, counts.size() - 1);
+
+        for (int round = 0; round < 2000; ++round)
+        {
+            std::vector<WorkoutPlan::ExerciseDetails> written;
+            const size_t length = lengthDistribution(random);
+            for (size_t i = 0; i < length; ++i)
+            {
+                written.push_back(entry(names[nameDistribution(random)], counts[countDistribution(random)], counts[countDistribution(random)]));
+            }
+
+            std::string text;
+            WorkoutPlan::appendDay(text, written);
+            std::vector<WorkoutPlan::ExerciseDetails> read;
+            std::vector<WorkoutPlan::ParseError> errors;
+            const bool wellFormed = WorkoutPlan::parseDay(text, read, errors);
+            check(wellFormed && errors.empty() && sameEntries(read, written), "\"" + text + "\" is read back as written");
+        }
+    }
+
+    /**
+     * @brief Checks parseDay on random text made of the characters of the format.
+     *
+     * Whatever the text, every entry is either read or reported, every error lies within the
+     * text, and what was read is written and read back unchanged.
+     *
+     * @param random The random number generator.
+     */
+    void checkRandomText(std::mt19937& random)
+    {
+        const std::string alphabet = "ab =x;0123456789\t\r";
+        std::uniform_int_distribution<size_t> lengthDistribution(0, 40);
+        std::uniform_int_distribution<size_t> characterDistribution(0, alphabet.size() - 1);
+
+        for (int round = 0; round < 20000; ++round)
+        {
+            std::string text(lengthDistribution(random), ' ');
+            for (char& c : text)
+            {
+                c = alphabet[characterDistribution(random)];
+            }
+
+            std::vector<WorkoutPlan::ExerciseDetails> read;
+            std::vector<WorkoutPlan::ParseError> errors;
+            const bool wellFormed = WorkoutPlan::parseDay(text, read, errors);
+            const size_t entryCount = static_cast<size_t>(std::count(text.begin(), text.end(), ';')) + 1;
+            check(read.size() + errors.size() <= entryCount, "\"" + text + "\" has no more results than entries");
+            check(wellFormed == errors.empty(), "\"" + text + "\" is well-formed exactly if it has no errors");
+            for (const auto& error : errors)
+            {
+                check(error.entryStart <= error.offset && error.offset <= error.entryEnd && error.entryEnd <= text.size(),
+                    "an error of \"" + text + "\" lies within its entry");
+            }
+
+            std::string written;
+            WorkoutPlan::appendDay(written, read);
+            std::vector<WorkoutPlan::ExerciseDetails> reread;
+            std::vector<WorkoutPlan::ParseError> rereadErrors;
+            WorkoutPlan::parseDay(written, reread, rereadErrors);
+            check(rereadErrors.empty() && sameEntries(reread, read), "the entries read from \"" + text + "\" are read back as written");
+        }
+    }
+}
+
+int main()
+{
+    std::mt19937 random(47);
+    checkKnownDays();
+    checkRoundTrips(random);
+    checkRandomText(random);
+
+    return TestCheck::finish("workout plan day format");
+}
@@ -0,0 +1,33 @@
+#!/bin/sh
+# Builds and runs every test program with g++ (or $CXX), stopping at the first that fails.
+# With --bench, the benchmark programs are built and run as well; their timings are printed,
+# not checked, as they depend on the machine.
+# Usage, from any directory: sh src/FitnessApp/Tests/run_tests.sh [--bench]
+set -e
+cd "$(dirname "$0")"
+APP=../FitnessApp
+CXX=${CXX:-g++}
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+
+# Builds a test program from its source and the application sources it uses, then runs it
+# in the build directory, so files it writes do not end up in the tree.
+run_test()
+{
+    name=$1
+    shift
+    echo "== $name"
+    "$CXX" -std=c++20 -O2 -I"$APP" -I. "$name.cpp" "$@" -o "$BUILD/$name"
+    (cd "$BUILD" && "./$name")
+}
+
+run_test RecipeExclusionTest $APP/RecipeBook.cpp $APP/Recipe.cpp $APP/FoodItem.cpp $APP/FoodCatalog.cpp \
+    $APP/MacroKdTree.cpp $APP/ExclusionFilter.cpp $APP/Nutrients.cpp
+run_test WorkoutPlanDayFormatTest $APP/WorkoutPlan.cpp $APP/ExerciseIdTable.cpp
+run_test CalorieBatchTest $APP/CalorieBatch.cpp $APP/Profile.cpp $APP/Goals.cpp
+
+if [ "$1" = "--bench" ]
+then
+    run_test WorkoutPlanDayFormatBenchmark $APP/WorkoutPlan.cpp $APP/ExerciseIdTable.cpp
+    run_test CalorieBatchBenchmark $APP/CalorieBatch.cpp $APP/Profile.cpp $APP/Goals.cpp
+fi